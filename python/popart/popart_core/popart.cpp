@@ -36,6 +36,7 @@
 #include <popart/error.hpp>
 #include <popart/graphtransformer.hpp>
 #include <popart/ir.hpp>
+#include <popart/memoryestimate.hpp>
 #include <popart/numerics.hpp>
 #include <popart/op/init.hpp>
 #include <popart/op/scatterreduce.hpp>
@@ -48,6 +49,7 @@
 #include <popart/session.hpp>
 #include <popart/sessionoptions.hpp>
 #include <popart/sgd.hpp>
+#include <popart/shardedcheckpoint.hpp>
 #include <popart/stepio_generic.hpp>
 #include <popart/tensorlocation.hpp>
 #include <popart/tensornames.hpp>
@@ -695,6 +697,25 @@ PYBIND11_MODULE(popart_core, m) {
       py::class_<PyWeightsIO> cls(m, "PyWeightsIO", weightsio);
       cls.def(py::init<std::map<TensorId, py::array>>(), py::arg("weights"));
     }
+    {
+      py::class_<shardedcheckpoint::Reader> cls(
+          m,
+          "ShardedCheckpointReader",
+          weightsio,
+          DOC(popart, shardedcheckpoint, Reader));
+      cls.def(py::init<std::string>(), py::arg("dir"));
+      cls.def("contains", &shardedcheckpoint::Reader::contains);
+      cls.def(
+          "getTensorIds",
+          [](const shardedcheckpoint::Reader &reader) {
+            std::vector<TensorId> ids;
+            for (const auto &entry : reader.getEntries()) {
+              ids.push_back(entry.id);
+            }
+            return ids;
+          },
+          DOC(popart, shardedcheckpoint, Reader, getEntries));
+    }
   }
   {
     py::class_<AnchorReturnType> cls(m, "AnchorReturnType");
@@ -1098,6 +1119,33 @@ PYBIND11_MODULE(popart_core, m) {
             TensorLocationSettings,
             minElementsForReplicatedTensorSharding));
   }
+  {
+    py::class_<TensorLocationPlannerSettings> cls(
+        m,
+        "TensorLocationPlannerSettings",
+        DOC(popart, TensorLocationPlannerSettings));
+    cls.def(py::init<>());
+    cls.def(py::init<bool, int64_t, double, double>(),
+            py::arg("enabled"),
+            py::arg("memoryBudget")        = 0,
+            py::arg("remoteBandwidth")     = 16.0e9,
+            py::arg("replicatedBandwidth") = 64.0e9);
+    cls.def_readwrite("enabled",
+                      &TensorLocationPlannerSettings::enabled,
+                      DOC(popart, TensorLocationPlannerSettings, enabled));
+    cls.def_readwrite(
+        "memoryBudget",
+        &TensorLocationPlannerSettings::memoryBudget,
+        DOC(popart, TensorLocationPlannerSettings, memoryBudget));
+    cls.def_readwrite(
+        "remoteBandwidth",
+        &TensorLocationPlannerSettings::remoteBandwidth,
+        DOC(popart, TensorLocationPlannerSettings, remoteBandwidth));
+    cls.def_readwrite(
+        "replicatedBandwidth",
+        &TensorLocationPlannerSettings::replicatedBandwidth,
+        DOC(popart, TensorLocationPlannerSettings, replicatedBandwidth));
+  }
   {
     // This setting is experimental and may change.
     py::enum_<BatchSerializationTransformContext> en(
@@ -1190,14 +1238,16 @@ PYBIND11_MODULE(popart_core, m) {
                  bool,
                  BatchSerializationTransformContext,
                  BatchSerializationMethod,
-                 BatchSerializationBatchSchedule>(),
+                 BatchSerializationBatchSchedule,
+                 int64_t>(),
         py::arg("factor"),
         py::arg("concatOnVirtualGraphChange"),
         py::arg("concatOnExecutionPhaseChange"),
         py::arg("concatOnPipelineStageChange"),
         py::arg("transformContext") = BatchSerializationTransformContext::Fwd,
         py::arg("method")           = BatchSerializationMethod::UnrollDynamic,
-        py::arg("batchSchedule") = BatchSerializationBatchSchedule::Isomorphic);
+        py::arg("batchSchedule") = BatchSerializationBatchSchedule::Isomorphic,
+        py::arg("memoryBudget")  = 0);
     cls.def_readwrite("factor",
                       &BatchSerializationSettings::factor,
                       DOC(popart, BatchSerializationSettings, factor));
@@ -1224,6 +1274,9 @@ PYBIND11_MODULE(popart_core, m) {
     cls.def_readwrite("batchSchedule",
                       &BatchSerializationSettings::batchSchedule,
                       DOC(popart, BatchSerializationSettings, batchSchedule));
+    cls.def_readwrite("memoryBudget",
+                      &BatchSerializationSettings::memoryBudget,
+                      DOC(popart, BatchSerializationSettings, memoryBudget));
   }
   {
     // This setting is experimental and may change.
@@ -1262,6 +1315,46 @@ PYBIND11_MODULE(popart_core, m) {
                       // DOC(popart, AutodiffSettings, stitchStrategy)
     );
   }
+  {
+    py::class_<AutocastSettings> cls(
+        m, "AutocastSettings", DOC(popart, AutocastSettings));
+    cls.def(py::init<>());
+    cls.def(py::init<bool,
+                     const std::vector<std::string> &,
+                     const std::vector<std::string> &,
+                     const std::vector<std::string> &>(),
+            py::arg("enabled"),
+            py::arg("allowOpTypes"),
+            py::arg("denyOpTypes"),
+            py::arg("promoteOpTypes"));
+    cls.def_readwrite("enabled",
+                      &AutocastSettings::enabled,
+                      DOC(popart, AutocastSettings, enabled));
+    cls.def_readwrite("allowOpTypes",
+                      &AutocastSettings::allowOpTypes,
+                      DOC(popart, AutocastSettings, allowOpTypes));
+    cls.def_readwrite("denyOpTypes",
+                      &AutocastSettings::denyOpTypes,
+                      DOC(popart, AutocastSettings, denyOpTypes));
+    cls.def_readwrite("promoteOpTypes",
+                      &AutocastSettings::promoteOpTypes,
+                      DOC(popart, AutocastSettings, promoteOpTypes));
+  }
+  {
+    py::class_<AutoVirtualGraphSettings> cls(
+        m, "AutoVirtualGraphSettings", DOC(popart, AutoVirtualGraphSettings));
+    cls.def(py::init<>());
+    cls.def(py::init<bool, float>(),
+            py::arg("balanceStages"),
+            py::arg("maxMemoryProportion"));
+    cls.def_readwrite("balanceStages",
+                      &AutoVirtualGraphSettings::balanceStages,
+                      DOC(popart, AutoVirtualGraphSettings, balanceStages));
+    cls.def_readwrite(
+        "maxMemoryProportion",
+        &AutoVirtualGraphSettings::maxMemoryProportion,
+        DOC(popart, AutoVirtualGraphSettings, maxMemoryProportion));
+  }
   {
     py::class_<ExecutionPhaseSettings> cls(m, "ExecutionPhaseSettings");
     cls.def(py::init<>());
@@ -1389,6 +1482,15 @@ PYBIND11_MODULE(popart_core, m) {
     cls.def_readwrite("enableOutlining",
                       &SessionOptions::enableOutlining,
                       DOC(popart, SessionOptions, enableOutlining));
+    cls.def_readwrite("enableElementwiseFusion",
+                      &SessionOptions::enableElementwiseFusion,
+                      DOC(popart, SessionOptions, enableElementwiseFusion));
+    cls.def_readwrite("enableGlobalValueNumbering",
+                      &SessionOptions::enableGlobalValueNumbering,
+                      DOC(popart, SessionOptions, enableGlobalValueNumbering));
+    cls.def_readwrite("enableTransposeSinking",
+                      &SessionOptions::enableTransposeSinking,
+                      DOC(popart, SessionOptions, enableTransposeSinking));
     cls.def_readwrite(
         "enableOutliningCopyCostPruning",
         &SessionOptions::enableOutliningCopyCostPruning,
@@ -1427,6 +1529,10 @@ PYBIND11_MODULE(popart_core, m) {
     cls.def_readwrite("autoRecomputation",
                       &SessionOptions::autoRecomputation,
                       DOC(popart, SessionOptions, autoRecomputation));
+    cls.def_readwrite(
+        "autoRecomputationMemoryBudget",
+        &SessionOptions::autoRecomputationMemoryBudget,
+        DOC(popart, SessionOptions, autoRecomputationMemoryBudget));
     cls.def_readwrite("mergeVarUpdate",
                       &SessionOptions::mergeVarUpdate,
                       DOC(popart, SessionOptions, mergeVarUpdate));
@@ -1457,6 +1563,9 @@ PYBIND11_MODULE(popart_core, m) {
     cls.def_readwrite("batchSerializationSettings",
                       &SessionOptions::batchSerializationSettings,
                       DOC(popart, SessionOptions, batchSerializationSettings));
+    cls.def_readwrite("autocastSettings",
+                      &SessionOptions::autocastSettings,
+                      DOC(popart, SessionOptions, autocastSettings));
     cls.def_readwrite("aliasZeroCopy",
                       &SessionOptions::aliasZeroCopy,
                       DOC(popart, SessionOptions, aliasZeroCopy));
@@ -1497,6 +1606,9 @@ PYBIND11_MODULE(popart_core, m) {
     cls.def_readwrite("virtualGraphMode",
                       &SessionOptions::virtualGraphMode,
                       DOC(popart, SessionOptions, virtualGraphMode));
+    cls.def_readwrite("autoVirtualGraphSettings",
+                      &SessionOptions::autoVirtualGraphSettings,
+                      DOC(popart, SessionOptions, autoVirtualGraphSettings));
     cls.def_readwrite("enableReplicatedGraphs",
                       &SessionOptions::enableReplicatedGraphs,
                       DOC(popart, SessionOptions, enableReplicatedGraphs));
@@ -1542,6 +1654,12 @@ PYBIND11_MODULE(popart_core, m) {
     cls.def_readwrite("cachePath",
                       &SessionOptions::cachePath,
                       DOC(popart, SessionOptions, cachePath));
+    cls.def_readwrite("engineCacheIgnoreOpNames",
+                      &SessionOptions::engineCacheIgnoreOpNames,
+                      DOC(popart, SessionOptions, engineCacheIgnoreOpNames));
+    cls.def_readwrite("engineCacheMaxBytes",
+                      &SessionOptions::engineCacheMaxBytes,
+                      DOC(popart, SessionOptions, engineCacheMaxBytes));
     cls.def_readwrite("enableEngineCaching",
                       &SessionOptions::enableEngineCaching,
                       DOC(popart, SessionOptions, enableEngineCaching));
@@ -1643,6 +1761,10 @@ PYBIND11_MODULE(popart_core, m) {
         "_tensorLocationSettingsOverride",
         &SessionOptions::tensorLocationSettingsOverride,
         DOC(popart, SessionOptions, tensorLocationSettingsOverride));
+    cls.def_readwrite(
+        "tensorLocationPlannerSettings",
+        &SessionOptions::tensorLocationPlannerSettings,
+        DOC(popart, SessionOptions, tensorLocationPlannerSettings));
     cls.def_readwrite(
         "accumulateOuterFragmentSettings",
         &SessionOptions::accumulateOuterFragmentSettings,
@@ -1697,6 +1819,15 @@ PYBIND11_MODULE(popart_core, m) {
         "throwIfLog2ScaleTensorNotInRange",
         &SessionOptions::throwIfLog2ScaleTensorNotInRange,
         DOC(popart, SessionOptions, throwIfLog2ScaleTensorNotInRange));
+    cls.def_readwrite("weightTransferThreads",
+                      &SessionOptions::weightTransferThreads,
+                      DOC(popart, SessionOptions, weightTransferThreads));
+    cls.def_readwrite("enablePlanningCacheReuse",
+                      &SessionOptions::enablePlanningCacheReuse,
+                      DOC(popart, SessionOptions, enablePlanningCacheReuse));
+    cls.def_readwrite("mapExternalTensorData",
+                      &SessionOptions::mapExternalTensorData,
+                      DOC(popart, SessionOptions, mapExternalTensorData));
   }
   {
     py::enum_<PatternsLevel> en(m, "PatternsLevel", DOC(popart, PatternsLevel));
@@ -1730,6 +1861,9 @@ PYBIND11_MODULE(popart_core, m) {
     en.value("Pipeline",
              RecomputationType::Pipeline,
              SINGLE_LINE_DOC(popart, RecomputationType, Pipeline));
+    en.value("MemoryBudget",
+             RecomputationType::MemoryBudget,
+             SINGLE_LINE_DOC(popart, RecomputationType, MemoryBudget));
   }
   {
     py::enum_<RecomputeType> en(m, "RecomputeType", DOC(popart, RecomputeType));
@@ -1940,6 +2074,31 @@ PYBIND11_MODULE(popart_core, m) {
     });
     cls.def("enableRuntimeAsserts", &Patterns::enableRuntimeAsserts);
   }
+  {
+    py::class_<MemoryEstimate> cls(
+        m, "MemoryEstimate", DOC(popart, MemoryEstimate));
+    cls.def_readonly("peakBytesPerVirtualGraph",
+                     &MemoryEstimate::peakBytesPerVirtualGraph,
+                     DOC(popart, MemoryEstimate, peakBytesPerVirtualGraph));
+    cls.def_readonly("peakBytesPerPipelineStage",
+                     &MemoryEstimate::peakBytesPerPipelineStage,
+                     DOC(popart, MemoryEstimate, peakBytesPerPipelineStage));
+    cls.def_readonly("peakBytesPerExecutionPhase",
+                     &MemoryEstimate::peakBytesPerExecutionPhase,
+                     DOC(popart, MemoryEstimate, peakBytesPerExecutionPhase));
+    cls.def_readonly("topContributors",
+                     &MemoryEstimate::topContributors,
+                     DOC(popart, MemoryEstimate, topContributors));
+    cls.def_readonly("bytesPerIpu",
+                     &MemoryEstimate::bytesPerIpu,
+                     DOC(popart, MemoryEstimate, bytesPerIpu));
+    cls.def("fits", &MemoryEstimate::fits, DOC(popart, MemoryEstimate, fits));
+    cls.def("__repr__", [](const MemoryEstimate &estimate) {
+      std::stringstream ss;
+      ss << estimate;
+      return ss.str();
+    });
+  }
   {
     py::class_<OutOfMemoryError> cls(m, "OutOfMemoryError");
     cls.def(py::init<>());
@@ -2003,6 +2162,10 @@ PYBIND11_MODULE(popart_core, m) {
         },
         py::arg("filename"),
         DOC(popart, Session, loadExecutableFromFile));
+    cls.def("setLoweringOptions",
+            &InferenceSession::setLoweringOptions,
+            py::arg("userOptions"),
+            DOC(popart, Session, setLoweringOptions));
     cls.def(
         "prepareDevice",
         [](InferenceSession &session,
@@ -2068,6 +2231,11 @@ PYBIND11_MODULE(popart_core, m) {
     cls.def("modelToHost",
             &InferenceSession::modelToHost,
             DOC(popart, Session, modelToHost));
+    cls.def("weightsToCheckpoint",
+            &InferenceSession::weightsToCheckpoint,
+            py::arg("dir"),
+            py::arg("numShards") = 0,
+            DOC(popart, Session, weightsToCheckpoint));
     cls.def("updateExternallySavedTensorLocations",
             &InferenceSession::updateExternallySavedTensorLocations,
             DOC(popart, Session, updateExternallySavedTensorLocations));
@@ -2080,6 +2248,10 @@ PYBIND11_MODULE(popart_core, m) {
             &InferenceSession::getSummaryReport,
             py::arg("resetProfile") = true,
             DOC(popart, Session, getSummaryReport));
+    cls.def("getMemoryEstimate",
+            &InferenceSession::getMemoryEstimate,
+            py::arg("numTopContributors") = 10,
+            DOC(popart, Session, getMemoryEstimate));
     cls.def("getSerializedGraph", [](const InferenceSession &session) {
       auto report = session.getSerializedGraph();
       return py::bytes(report);
@@ -2201,6 +2373,10 @@ PYBIND11_MODULE(popart_core, m) {
         },
         py::arg("filename"),
         DOC(popart, Session, loadExecutableFromFile));
+    cls.def("setLoweringOptions",
+            &TrainingSession::setLoweringOptions,
+            py::arg("userOptions"),
+            DOC(popart, Session, setLoweringOptions));
     cls.def(
         "prepareDevice",
         [](TrainingSession &session,
@@ -2269,6 +2445,11 @@ PYBIND11_MODULE(popart_core, m) {
     cls.def("modelToHost",
             &TrainingSession::modelToHost,
             DOC(popart, Session, modelToHost));
+    cls.def("weightsToCheckpoint",
+            &TrainingSession::weightsToCheckpoint,
+            py::arg("dir"),
+            py::arg("numShards") = 0,
+            DOC(popart, Session, weightsToCheckpoint));
     cls.def("updateExternallySavedTensorLocations",
             &TrainingSession::updateExternallySavedTensorLocations,
             DOC(popart, Session, updateExternallySavedTensorLocations));
@@ -2281,6 +2462,10 @@ PYBIND11_MODULE(popart_core, m) {
             &TrainingSession::getSummaryReport,
             py::arg("resetProfile") = true,
             DOC(popart, Session, getSummaryReport));
+    cls.def("getMemoryEstimate",
+            &TrainingSession::getMemoryEstimate,
+            py::arg("numTopContributors") = 10,
+            DOC(popart, Session, getMemoryEstimate));
     cls.def("getReport",
             &TrainingSession::getReport,
             DOC(popart, Session, getReport));
@@ -0,0 +1,68 @@
+// Copyright (c) 2022 Graphcore Ltd. All rights reserved.
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+#include <popart/builder.hpp>
+#include <popart/error.hpp>
+#include <popart/names.hpp>
+#include <popart/tensorinfo.hpp>
+#include <popart/voiddata.hpp>
+
+#include "popart/builder.gen.hpp"
+
+using namespace popart;
+
+namespace {
+
+// Add numNodes nodes to a new builder, querying the builder as the Python
+// builder does while building a model, and return the nodes added per second.
+double buildChain(int numNodes) {
+  auto builder = Builder::create();
+  auto aiOnnx  = builder->aiOnnxOpset9();
+
+  const std::vector<int64_t> shape{4, 16};
+  TensorInfo info{"FLOAT", shape};
+  TensorInfo shapeInfo{"INT64", std::vector<int64_t>{2}};
+  const std::vector<float> biasData(4 * 16, 1.0f);
+  ConstVoidData biasCVData{biasData.data(), info};
+
+  const auto start = std::chrono::steady_clock::now();
+
+  auto x    = builder->addInputTensor(info);
+  auto bias = builder->addInitializedInputTensor(biasCVData);
+  // The shape input of the reshapes, which shape inference needs the value
+  // of.
+  auto newShape = aiOnnx.constant(ConstVoidData{shape.data(), shapeInfo});
+  for (int i = 0; i < numNodes / 3; ++i) {
+    x = aiOnnx.add({x, bias});
+    x = aiOnnx.relu({x});
+    x = aiOnnx.reshape({x, newShape});
+    builder->setInplacePreferences(x, {{"ReshapeInplace", 10.0f}});
+    if (builder->getTensorShape(x) != shape) {
+      throw error("Unexpected shape of {}", x);
+    }
+  }
+  builder->addOutputTensor(x);
+
+  const std::chrono::duration<double> seconds =
+      std::chrono::steady_clock::now() - start;
+
+  return numNodes / seconds.count();
+}
+
+} // namespace
+
+// Reports the number of nodes added to a builder per second for models of
+// increasing size. Finding nodes and tensors takes constant time, so the
+// rate should not fall as the model grows.
+int main() {
+  for (int numNodes : {1000, 10000, 50000}) {
+    const double nodesPerSecond = buildChain(numNodes);
+    std::cout << numNodes << " nodes: " << nodesPerSecond << " nodes/s"
+              << std::endl;
+  }
+  return 0;
+}
@@ -0,0 +1,57 @@
+// Copyright (c) 2022 Graphcore Ltd. All rights reserved.
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <halfconversion.hpp>
+#include <iostream>
+#include <vector>
+
+#include "popart/half.hpp"
+
+using namespace popart;
+using halfconversion::Isa;
+
+// Reports the throughput of the bulk half <-> float conversions for each
+// instruction set supported by the host, counting bytes read plus written.
+// Their results are checked by the unit tests in test_half.cpp.
+int main() {
+  const size_t nelms   = size_t{1} << 26;
+  const int iterations = 5;
+
+  std::vector<float> fs(nelms);
+  for (size_t i = 0; i < nelms; ++i) {
+    fs[i] = static_cast<float>(i % 4096) * 0.25f - 512.0f;
+  }
+  std::vector<uint16_t> hs(nelms);
+  std::vector<float> back(nelms);
+
+  auto gbPerSecond = [nelms, iterations](double seconds) {
+    const double bytes =
+        static_cast<double>(nelms * (sizeof(float) + sizeof(uint16_t)));
+    return bytes * iterations / seconds / 1e9;
+  };
+
+  for (auto isa : {Isa::Scalar, Isa::F16C, Isa::Avx512}) {
+    if (!halfconversion::isSupported(isa)) {
+      continue;
+    }
+
+    auto t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+      halfconversion::floatToHalf(isa, fs.data(), hs.data(), nelms);
+    }
+    auto t1 = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+      halfconversion::halfToFloat(isa, hs.data(), back.data(), nelms);
+    }
+    auto t2 = std::chrono::steady_clock::now();
+
+    const std::chrono::duration<double> toHalf  = t1 - t0;
+    const std::chrono::duration<double> toFloat = t2 - t1;
+    std::cout << halfconversion::toString(isa)
+              << ": floatToHalf " << gbPerSecond(toHalf.count())
+              << " GB/s, halfToFloat " << gbPerSecond(toFloat.count())
+              << " GB/s" << std::endl;
+  }
+  return 0;
+}
@@ -0,0 +1,85 @@
+// Copyright (c) 2022 Graphcore Ltd. All rights reserved.
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filereader.hpp>
+#include <iostream>
+#include <memory>
+#include <onnx/onnx_pb.h>
+#include <string>
+#include <utility>
+#include <vector>
+#include <popart/builder.hpp>
+#include <popart/dataflow.hpp>
+#include <popart/error.hpp>
+#include <popart/graph.hpp>
+#include <popart/ir.hpp>
+#include <popart/names.hpp>
+#include <popart/tensorinfo.hpp>
+#include <popart/voiddata.hpp>
+
+#include "popart/builder.gen.hpp"
+
+using namespace popart;
+
+namespace {
+
+// An ONNX model of about numNodes nodes, mixing ops of the ai.onnx domain.
+ONNX_NAMESPACE::ModelProto createModel(int numNodes) {
+  auto builder = Builder::create();
+  auto aiOnnx  = builder->aiOnnxOpset11();
+
+  TensorInfo info{"FLOAT", std::vector<int64_t>{4, 16}};
+  const std::vector<float> scaleData(4 * 16, 0.5f);
+  ConstVoidData scaleCVData{scaleData.data(), info};
+
+  auto x     = builder->addInputTensor(info);
+  auto scale = builder->addInitializedInputTensor(scaleCVData);
+  for (int i = 0; i < numNodes / 4; ++i) {
+    x = aiOnnx.add({x, scale});
+    x = aiOnnx.relu({x});
+    x = aiOnnx.mul({x, scale});
+    x = aiOnnx.sigmoid({x});
+  }
+  builder->addOutputTensor(x);
+
+  return io::getModelFromString(builder->getModelProto());
+}
+
+// Grow the ops of model into the main graph of a new Ir, and return the
+// nodes grown per second.
+double importModel(ONNX_NAMESPACE::ModelProto model) {
+  const auto output     = model.graph().output(0).name();
+  const size_t numNodes = model.graph().node_size();
+
+  Ir ir;
+  ir.setOnnxModel(std::move(model));
+  ir.setDataFlow(DataFlow(1, {{output, AnchorReturnType("All")}}));
+  ir.registerInputTensors();
+
+  const auto start = std::chrono::steady_clock::now();
+  ir.getMainGraph().constructFromOnnxGraph(ir.getModel().graph());
+  const std::chrono::duration<double> seconds =
+      std::chrono::steady_clock::now() - start;
+
+  if (ir.getMainGraph().getOps().size() != numNodes) {
+    throw error("Grew {} ops from {} nodes",
+                ir.getMainGraph().getOps().size(),
+                numNodes);
+  }
+  return numNodes / seconds.count();
+}
+
+} // namespace
+
+// Reports the number of ONNX nodes grown into a graph per second for models
+// of increasing size. Finding the op of each node takes constant time, so
+// the rate should not fall as the model grows.
+int main() {
+  for (int numNodes : {1000, 10000, 50000}) {
+    const double nodesPerSecond = importModel(createModel(numNodes));
+    std::cout << numNodes << " nodes: " << nodesPerSecond << " nodes/s"
+              << std::endl;
+  }
+  return 0;
+}
@@ -0,0 +1,94 @@
+# Copyright (c) 2022 Graphcore Ltd. All rights reserved.
+import json
+import numpy as np
+import popart
+import test_util as tu
+
+
+def _count_ops(session, opType):
+    ir = json.loads(session._serializeIr(popart.IrSerializationFormat.JSON))
+    return len([op for op in ir["maingraph"] if op["type"] == opType])
+
+
+def test_autocast_inference():
+    x = np.random.rand(4, 16).astype(np.float32)
+    w = np.random.rand(16, 8).astype(np.float32) - 0.5
+    b = np.random.rand(8).astype(np.float32)
+
+    def run(enabled):
+        builder = popart.Builder()
+        xId = builder.addInputTensor(popart.TensorInfo("FLOAT", x.shape))
+        wId = builder.addInitializedInputTensor(w)
+        bId = builder.addInitializedInputTensor(b)
+        a = builder.aiOnnx.matmul([xId, wId])
+        a = builder.aiOnnx.add([a, bId])
+        out = builder.aiOnnx.softmax([a], axis=1)
+        builder.addOutputTensor(out)
+
+        opts = popart.SessionOptions()
+        opts.autocastSettings.enabled = enabled
+
+        with tu.create_test_device() as device:
+            session = popart.InferenceSession(
+                fnModel=builder.getModelProto(),
+                dataFlow=popart.DataFlow(1, {out: popart.AnchorReturnType("All")}),
+                userOptions=opts,
+                deviceInfo=device,
+            )
+            session.prepareDevice()
+            session.weightsFromHost()
+            anchors = session.initAnchorArrays()
+            session.run(popart.PyStepIO({xId: x}, anchors))
+            return anchors[out], _count_ops(session, "Cast")
+
+    reference, casts = run(False)
+    result, autocasts = run(True)
+
+    assert casts == 0
+    assert autocasts > 0
+    # The model's output keeps its data type.
+    assert result.dtype == np.float32
+    assert np.allclose(result, reference, rtol=1e-2, atol=1e-3)
+
+
+def test_autocast_training_with_auto_loss_scaling():
+    x = np.random.rand(4, 16).astype(np.float32)
+    w = np.random.rand(16, 8).astype(np.float32) - 0.5
+    label = np.random.randint(0, 8, 4).astype(np.int32)
+
+    builder = popart.Builder()
+    xId = builder.addInputTensor(popart.TensorInfo("FLOAT", x.shape))
+    lId = builder.addInputTensor(popart.TensorInfo("INT32", label.shape))
+    wId = builder.addInitializedInputTensor(w)
+    a = builder.aiOnnx.matmul([xId, wId])
+    a = builder.aiOnnx.softmax([a], axis=1)
+    loss = builder.aiGraphcore.nllloss([a, lId])
+
+    opts = popart.SessionOptions()
+    opts.autocastSettings.enabled = True
+    opts.automaticLossScalingSettings.enabled = True
+
+    ls_id = "finalLossScale"
+    with tu.create_test_device() as device:
+        session = popart.TrainingSession(
+            fnModel=builder.getModelProto(),
+            dataFlow=popart.DataFlow(1, [loss, ls_id]),
+            loss=loss,
+            optimizer=popart.SGD({"lossScaling": (16.0, False)}),
+            userOptions=opts,
+            deviceInfo=device,
+        )
+        session.prepareDevice()
+        session.weightsFromHost()
+        anchors = session.initAnchorArrays()
+        session.run(popart.PyStepIO({xId: x, lId: label}, anchors))
+
+        # The master weights are updated in FLOAT.
+        weights = {wId: np.zeros(w.shape, dtype=np.float32)}
+        session.weightsToHost()
+        session.readWeights(popart.PyWeightsIO(weights))
+
+    assert _count_ops(session, "Cast") > 0
+    assert anchors[loss].dtype == np.float32
+    assert np.isfinite(anchors[ls_id]).all()
+    assert not np.allclose(weights[wId], w)
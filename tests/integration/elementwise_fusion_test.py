@@ -0,0 +1,92 @@
+# Copyright (c) 2022 Graphcore Ltd. All rights reserved.
+import json
+import numpy as np
+import popart
+import test_util as tu
+
+
+def _count_ops(session, opType):
+    ir = json.loads(session._serializeIr(popart.IrSerializationFormat.JSON))
+    return len([op for op in ir["maingraph"] if op["type"] == opType])
+
+
+def _run(build, inputs, enableElementwiseFusion):
+    builder = popart.Builder()
+    ids, out = build(builder)
+
+    opts = popart.SessionOptions()
+    opts.enableElementwiseFusion = enableElementwiseFusion
+    opts.reportOptions = {"showExecutionSteps": "true"}
+    opts.engineOptions["debug.retainDebugInformation"] = "true"
+
+    with tu.create_test_device() as device:
+        session = popart.InferenceSession(
+            fnModel=builder.getModelProto(),
+            dataFlow=popart.DataFlow(1, {out: popart.AnchorReturnType("All")}),
+            userOptions=opts,
+            deviceInfo=device,
+        )
+        session.prepareDevice()
+        anchors = session.initAnchorArrays()
+        stepio = popart.PyStepIO(dict(zip(ids, inputs)), anchors)
+        session.run(stepio)
+
+        numFused = _count_ops(session, "FusedElementwise")
+        computeSets = tu.get_compute_sets_from_report(session.getSummaryReport())
+
+    print(
+        f"enableElementwiseFusion={enableElementwiseFusion}: "
+        f"{numFused} fused ops, {len(computeSets)} compute sets"
+    )
+    return anchors[out], numFused, len(computeSets)
+
+
+def test_fused_chain_matches_unfused():
+    x = np.random.rand(4, 16).astype(np.float32) - 0.5
+    b = np.random.rand(16).astype(np.float32)
+
+    def build(builder):
+        xId = builder.addInputTensor(popart.TensorInfo("FLOAT", x.shape))
+        bId = builder.addInitializedInputTensor(b)
+        a = builder.aiOnnx.add([xId, bId])
+        a = builder.aiOnnx.relu([a])
+        a = builder.aiGraphcore.scale([a], 0.5)
+        a = builder.aiOnnx.sigmoid([a])
+        a = builder.aiOnnx.div([a, bId])
+        a = builder.aiOnnx.sub([a, xId])
+        a = builder.aiOnnx.exp([builder.aiOnnx.neg([builder.aiOnnx.abs([a])])])
+        out = builder.aiOnnx.tanh([a])
+        builder.addOutputTensor(out)
+        return [xId], out
+
+    reference, unfusedOps, unfusedComputeSets = _run(build, [x], False)
+    result, fusedOps, fusedComputeSets = _run(build, [x], True)
+
+    assert unfusedOps == 0
+    assert fusedOps == 1
+    assert fusedComputeSets < unfusedComputeSets
+
+    sig = 1 / (1 + np.exp(-0.5 * np.maximum(x + b, 0)))
+    expected = np.tanh(np.exp(-np.abs(sig / b - x)))
+    assert np.allclose(reference, expected, rtol=1e-5, atol=1e-6)
+    assert np.allclose(result, reference, rtol=1e-5, atol=1e-6)
+
+
+def test_fused_casts_match_unfused():
+    x = np.random.rand(2, 8).astype(np.float32) + 0.1
+
+    def build(builder):
+        xId = builder.addInputTensor(popart.TensorInfo("FLOAT", x.shape))
+        h = builder.aiOnnx.cast([xId], "FLOAT16")
+        h = builder.aiOnnx.sqrt([h])
+        h = builder.aiOnnx.reciprocal([h])
+        out = builder.aiOnnx.cast([h], "FLOAT")
+        out = builder.aiOnnx.log([out])
+        builder.addOutputTensor(out)
+        return [xId], out
+
+    reference, _, _ = _run(build, [x], False)
+    result, fusedOps, _ = _run(build, [x], True)
+
+    assert fusedOps == 1
+    assert np.allclose(result, reference, rtol=1e-3, atol=1e-3)
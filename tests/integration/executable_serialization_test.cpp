@@ -519,6 +519,80 @@ BOOST_AUTO_TEST_CASE(serialize_deserialize) {
   BOOST_CHECK(boost::filesystem::remove_all(testDir));
 }
 
+// Load an executable with many tensors through a Reader that maps the file,
+// so that all the tensor data blobs are read from one stream, and check that
+// every tensor has the data it was saved with.
+BOOST_AUTO_TEST_CASE(serialize_deserialize_many_tensors) {
+  const int numLayers = 64;
+  const int64_t N     = 16;
+
+  int seed = 1013;
+  DefaultRandomEngine eng(seed);
+  UniformRealDistribution<float> fdis(-4.f, +4.f);
+
+  auto bder   = Builder::create();
+  auto aiOnnx = bder->aiOnnxOpset9();
+
+  TensorInfo info{"FLOAT", std::vector<int64_t>{N, N}};
+  auto x = bder->addInputTensor(info);
+  std::vector<std::vector<float>> weights(numLayers);
+  for (auto &weight : weights) {
+    weight.resize(info.nelms());
+    for (auto &val : weight) {
+      val = fdis(eng);
+    }
+    auto w = bder->addInitializedInputTensor({weight.data(), info});
+    x      = aiOnnx.matmul({x, w});
+  }
+  auto l1 = bder->aiGraphcoreOpset1().l1loss({x}, 0.1, ReductionType::Sum);
+  bder->addOutputTensor(l1);
+
+  auto proto      = bder->getModelProto();
+  auto modelProto = io::getModelFromString(proto);
+  auto dataFlow   = DataFlow(1, {{l1, AnchorReturnType("All")}});
+
+  auto device = popart::createTestDevice(TestDeviceType::Hw);
+
+  auto opts                  = SessionOptions();
+  opts.compileEngine         = false;
+  opts.weightTransferThreads = 4;
+
+  auto optimizer = SGD({{"defaultLearningRate", {0.01, false}}});
+
+  auto session = popart::TrainingSession::createFromOnnxModel(
+      proto,
+      dataFlow,
+      l1,
+      optimizer,
+      device,
+      popart::InputShapeInfo(),
+      opts,
+      popart::Patterns(PatternsLevel::Default));
+
+  session->prepareDevice();
+
+  const std::string testDir        = createDirForTest();
+  const std::string executablePath = getExecutablePath(testDir);
+  const auto &executable           = session->getExecutable();
+  session->saveExecutable(executablePath);
+  BOOST_CHECK(executable.getWeightTensors().size() >= numLayers);
+
+  {
+    Ir ir;
+    ir.setDataFlow(dataFlow);
+    ir.setUserOptions(opts);
+    ir.setOnnxModel(modelProto);
+    popx::serialization::Reader reader(executablePath);
+
+    bool skipGraphCompilation = true;
+    popx::IrLowering ir_lowering(ir, device, skipGraphCompilation);
+    auto deserializedExecutable = reader.deserializeExecutable(ir, ir_lowering);
+    compareExecutables(executable, *deserializedExecutable);
+  }
+
+  BOOST_CHECK(boost::filesystem::remove_all(testDir));
+}
+
 // ~T36910~ identified that the Accum tensor was getting saved in the
 // executable. This is not needed in the current implementation. This test sets
 // the above but with an Adam optimizer and gradient accumulation to ensure the
@@ -185,6 +185,53 @@ def test_save_back_externally_saved_tensors():
             assert np.array_equal(anchors[weightsIds[layer]].flatten(), saved_weights)
 
 
+def test_map_externally_saved_tensors():
+    """
+    Test that with SessionOptions.mapExternalTensorData, initializers stored
+    externally are loaded correctly, can be trained, and are only written back
+    to their file by modelToHost.
+    """
+    builder = popart.Builder()
+    shape = [4, 4]
+    in0 = builder.addInputTensor(popart.TensorInfo("FLOAT", shape))
+    w_init = np.random.rand(*shape).astype("float32")
+    w = builder.addInitializedInputTensor(w_init)
+    out = builder.aiOnnx.matmul([in0, w])
+    loss = builder.aiGraphcore.identityloss([out])
+
+    with TemporaryDirectory() as tmpdir:
+        tmpfile_weights = os.path.join(tmpdir, "weights.onnx")
+        builder.saveInitializersExternally([w], tmpfile_weights)
+
+        opts = popart.SessionOptions()
+        opts.mapExternalTensorData = True
+        session = popart.TrainingSession(
+            fnModel=builder.getModelProto(),
+            dataFlow=popart.DataFlow(1, {w: popart.AnchorReturnType("All")}),
+            deviceInfo=popart.DeviceManager().createCpuDevice(),
+            optimizer=popart.ConstSGD(10),
+            loss=loss,
+            userOptions=opts,
+        )
+
+        anchors = session.initAnchorArrays()
+        inputs = {in0: np.random.rand(*shape).astype("float32")}
+        session.prepareDevice()
+        session.weightsFromHost()
+        session.run(popart.PyStepIO(inputs, anchors))
+        assert not np.allclose(anchors[w], w_init)
+
+        # The mapping is private, so the file is unchanged by training and by
+        # copying the weights back to the host.
+        session.weightsToHost()
+        saved_weights = np.fromfile(tmpfile_weights, dtype=np.float32)
+        assert np.array_equal(w_init.flatten(), saved_weights)
+
+        session.modelToHost(os.path.join(tmpdir, "model.onnx"))
+        saved_weights = np.fromfile(tmpfile_weights, dtype=np.float32)
+        assert np.array_equal(anchors[w].flatten(), saved_weights)
+
+
 optimizerInfos = []
 # 1. SGD with momentum
 optimizerInfos.append(
@@ -36,7 +36,7 @@ using namespace popart;
  This test verifies that this is the case
 */
 
-ONNX_NAMESPACE::ModelProto getProto() {
+ONNX_NAMESPACE::ModelProto getProto(const std::string &addName = "") {
   // Build a basic onnx model
   auto builder     = Builder::create();
   auto aiOnnx      = builder->aiOnnxOpset9();
@@ -46,7 +46,7 @@ ONNX_NAMESPACE::ModelProto getProto() {
   ConstVoidData data = {vals.data(), info};
   auto inId0         = builder->addInitializedInputTensor(data);
   auto inId1         = builder->addInputTensor(info);
-  auto outId         = aiOnnx.add({inId0, inId1});
+  auto outId         = aiOnnx.add({inId0, inId1}, addName);
   builder->addOutputTensor(outId);
 
   auto proto = builder->getModelProto();
@@ -132,3 +132,69 @@ BOOST_AUTO_TEST_CASE(test0) {
   BOOST_CHECK(irHash0_0 != irHash6); // Different user opts, different hash (1)
   BOOST_CHECK(irHash0_0 != irHash7); // Different user opts, different hash (2)
 }
+
+BOOST_AUTO_TEST_CASE(testOpNames) {
+  auto isi     = InputShapeInfo();
+  auto device0 = createTestDevice(TEST_TARGET, 1, 20);
+
+  auto getHashAndFingerprint = [&](const std::string &addName,
+                                   bool ignoreOpNames) {
+    auto proto = getProto(addName);
+    auto outId = proto.graph().output()[0].name();
+    auto df    = DataFlow(1, {{outId, AnchorReturnType("All")}});
+    SessionOptions opts;
+    opts.engineCacheIgnoreOpNames = ignoreOpNames;
+
+    Ir ir;
+    ir.prepare({proto, isi, df, {}, nullptr, *device0, opts, Patterns()});
+    return std::make_pair(ir.getHash(), ir.getFingerprint());
+  };
+
+  // Renaming an op only changes the op names component of the fingerprint.
+  auto ref     = getHashAndFingerprint("add", false);
+  auto renamed = getHashAndFingerprint("sum", false);
+  BOOST_CHECK(ref.first != renamed.first);
+  for (const auto &component : ref.second) {
+    BOOST_CHECK_EQUAL(component.second == renamed.second.at(component.first),
+                      component.first != "graph(main).opNames");
+  }
+
+  // Unless op names are ignored.
+  auto ignored        = getHashAndFingerprint("add", true);
+  auto ignoredRenamed = getHashAndFingerprint("sum", true);
+  BOOST_CHECK(ignored.first == ignoredRenamed.first);
+  BOOST_CHECK(ignored.second.count("graph(main).opNames") == 0);
+}
+
+BOOST_AUTO_TEST_CASE(testSessionOptionsFingerprint) {
+  auto isi     = InputShapeInfo();
+  auto device0 = createTestDevice(TEST_TARGET, 1, 20);
+  auto proto   = getProto();
+  auto outId   = proto.graph().output()[0].name();
+  auto df      = DataFlow(1, {{outId, AnchorReturnType("All")}});
+
+  auto getFingerprint = [&](const SessionOptions &opts) {
+    Ir ir;
+    ir.prepare({proto, isi, df, {}, nullptr, *device0, opts, Patterns()});
+    return ir.getFingerprint();
+  };
+
+  // Each session option is a component of the fingerprint, and changing
+  // options only changes their own components.
+  SessionOptions opts;
+  auto ref = getFingerprint(opts);
+  BOOST_CHECK(ref.count("sessionOptions.enableOutlining") == 1);
+  BOOST_CHECK(ref.count("sessionOptions") == 0);
+
+  opts.syntheticDataMode                   = SyntheticDataMode::Zeros;
+  opts.engineOptions["opt.enableInlining"] = "false";
+  auto changed                             = getFingerprint(opts);
+  for (const auto &component : ref) {
+    if (component.first.find("sessionOptions.") != 0) {
+      continue;
+    }
+    BOOST_CHECK_EQUAL(component.second == changed.at(component.first),
+                      component.first != "sessionOptions.syntheticDataMode" &&
+                          component.first != "sessionOptions.engineOptions");
+  }
+}
@@ -0,0 +1,48 @@
+# Copyright (c) 2022 Graphcore Ltd. All rights reserved.
+import numpy as np
+import popart
+import test_util as tu
+
+
+def test_memory_estimate_per_virtual_graph():
+    """
+    Estimate the memory of a model sharded over two IPUs, before compiling it.
+    The weight of the first matmul is four times the size of the second.
+    """
+    w0 = np.random.rand(64, 64).astype(np.float32)
+    w1 = np.random.rand(64, 16).astype(np.float32)
+
+    builder = popart.Builder()
+    x = builder.addInputTensor(popart.TensorInfo("FLOAT", [8, 64]))
+    with builder.virtualGraph(0):
+        w0Id = builder.addInitializedInputTensor(w0)
+        a = builder.aiOnnx.matmul([x, w0Id])
+        a = builder.aiOnnx.relu([a])
+    with builder.virtualGraph(1):
+        w1Id = builder.addInitializedInputTensor(w1)
+        out = builder.aiOnnx.matmul([a, w1Id])
+    builder.addOutputTensor(out)
+
+    opts = popart.SessionOptions()
+    opts.virtualGraphMode = popart.VirtualGraphMode.Manual
+
+    with tu.create_test_device(numIpus=2) as device:
+        session = popart.InferenceSession(
+            fnModel=builder.getModelProto(),
+            dataFlow=popart.DataFlow(1, {out: popart.AnchorReturnType("All")}),
+            userOptions=opts,
+            deviceInfo=device,
+        )
+        estimate = session.getMemoryEstimate(numTopContributors=2)
+
+    print(estimate)
+    assert set(estimate.peakBytesPerVirtualGraph.keys()) == {0, 1}
+    assert estimate.peakBytesPerVirtualGraph[0] >= w0.nbytes
+    assert estimate.peakBytesPerVirtualGraph[1] >= w1.nbytes
+    assert estimate.peakBytesPerVirtualGraph[0] > estimate.peakBytesPerVirtualGraph[1]
+
+    assert estimate.topContributors[0][0] == (w0Id, w0.nbytes)
+    assert len(estimate.topContributors[0]) == 2
+
+    assert estimate.bytesPerIpu > 0
+    assert estimate.fits()
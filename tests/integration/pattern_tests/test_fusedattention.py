@@ -0,0 +1,153 @@
+# Copyright (c) 2022 Graphcore Ltd. All rights reserved.
+import json
+import numpy as np
+import pytest
+import popart
+import torch
+
+# pva is needed when calling session.getReport()
+import pva  # pylint: disable=unused-import
+
+# `import op_tester` requires adding to sys.path
+import sys
+from pathlib import Path
+
+sys.path.append(str(Path(__file__).resolve().parent.parent / "operators_test"))
+
+# pylint is disabled as op_tester is used as a fixture
+from conftest import op_tester  # pylint: disable=unused-import
+
+# Two tiles of 128 keys, the second of them partial.
+batch, heads, queries, depth, keys = 2, 2, 32, 16, 200
+
+
+def _count_ops(session, opType):
+    ir = json.loads(session._serializeIr(popart.IrSerializationFormat.JSON))
+    return len([op for op in ir["maingraph"] if op["type"] == opType])
+
+
+def _total_memory(session):
+    report = session.getReport()
+    return sum(t.memory.total.includingGaps for t in report.compilation.tiles)
+
+
+@pytest.mark.parametrize("step_type", ("infer", "train"))
+@pytest.mark.parametrize("masked", (True, False))
+def test_fusedattention(op_tester, step_type, masked):
+    q = np.random.randn(batch, heads, queries, depth).astype(np.float32)
+    kT = np.random.randn(batch, heads, depth, keys).astype(np.float32)
+    v = np.random.randn(batch, heads, keys, depth).astype(np.float32)
+    mask = np.where(np.random.rand(batch, 1, 1, keys) < 0.2, -1000.0, 0.0).astype(
+        np.float32
+    )
+    scale = 1 / np.sqrt(depth)
+
+    def run(fused):
+        def init_builder(builder):
+            qId = builder.addInputTensor(q)
+            kTId = builder.addInputTensor(kT)
+            vId = builder.addInputTensor(v)
+            s = builder.aiOnnx.matmul([qId, kTId])
+            s = builder.aiGraphcore.scale([s], scale)
+            if masked:
+                s = builder.aiOnnx.add([s, builder.addInputTensor(mask)])
+            p = builder.aiOnnx.softmax([s], axis=-1)
+            out = builder.aiOnnx.matmul([p, vId])
+            builder.addOutputTensor(out)
+            result = [out]
+            if step_type == "train":
+                result += [
+                    popart.reservedGradientPrefix() + out,
+                    popart.reservedGradientPrefix() + qId,
+                    popart.reservedGradientPrefix() + kTId,
+                    popart.reservedGradientPrefix() + vId,
+                ]
+            return result
+
+        def reference(ref_data):
+            q_t = torch.tensor(q, requires_grad=True)
+            kT_t = torch.tensor(kT, requires_grad=True)
+            v_t = torch.tensor(v, requires_grad=True)
+            s = torch.matmul(q_t, kT_t) * scale
+            if masked:
+                s = s + torch.tensor(mask)
+            out = torch.matmul(torch.softmax(s, dim=-1), v_t)
+            if step_type == "infer":
+                return [out]
+            d__o = ref_data.getOutputTensorGrad(0)
+            out.backward(torch.tensor(d__o))
+            return [out, d__o, q_t.grad, kT_t.grad, v_t.grad]
+
+        patterns = popart.Patterns(popart.PatternsLevel.Default)
+        patterns.enablePattern("FusedAttention", fused)
+        op_tester.setPatterns(patterns)
+        op_tester.atol = 1e-5
+        op_tester.options.engineOptions["debug.retainDebugInformation"] = "true"
+        session = op_tester.run(init_builder, reference, step_type)
+
+        assert _count_ops(session, "Attention") == (1 if fused else 0)
+        if step_type == "train":
+            assert _count_ops(session, "AttentionGrad") == (1 if fused else 0)
+        return _total_memory(session)
+
+    unfusedMemory = run(False)
+    fusedMemory = run(True)
+    print(f"Total memory unfused: {unfusedMemory}, fused: {fusedMemory}")
+    if step_type == "train":
+        # The scores are no longer stashed for the backwards pass.
+        assert fusedMemory < unfusedMemory
+
+
+@pytest.mark.parametrize("step_type", ("infer", "train"))
+def test_fusedattention_masked_first_tile(op_tester, step_type):
+    """
+    The first tile of 128 keys is masked with -inf for every query, which
+    must not give NaNs.
+    """
+    q = np.random.randn(batch, heads, queries, depth).astype(np.float32)
+    kT = np.random.randn(batch, heads, depth, keys).astype(np.float32)
+    v = np.random.randn(batch, heads, keys, depth).astype(np.float32)
+    mask = np.zeros((batch, 1, 1, keys), dtype=np.float32)
+    mask[..., :128] = -np.inf
+    scale = 1 / np.sqrt(depth)
+
+    def init_builder(builder):
+        qId = builder.addInputTensor(q)
+        kTId = builder.addInputTensor(kT)
+        vId = builder.addInputTensor(v)
+        s = builder.aiOnnx.matmul([qId, kTId])
+        s = builder.aiGraphcore.scale([s], scale)
+        s = builder.aiOnnx.add([s, builder.addInputTensor(mask)])
+        p = builder.aiOnnx.softmax([s], axis=-1)
+        out = builder.aiOnnx.matmul([p, vId])
+        builder.addOutputTensor(out)
+        result = [out]
+        if step_type == "train":
+            result += [
+                popart.reservedGradientPrefix() + out,
+                popart.reservedGradientPrefix() + qId,
+                popart.reservedGradientPrefix() + kTId,
+                popart.reservedGradientPrefix() + vId,
+            ]
+        return result
+
+    def reference(ref_data):
+        q_t = torch.tensor(q, requires_grad=True)
+        kT_t = torch.tensor(kT, requires_grad=True)
+        v_t = torch.tensor(v, requires_grad=True)
+        s = torch.matmul(q_t, kT_t) * scale + torch.tensor(mask)
+        out = torch.matmul(torch.softmax(s, dim=-1), v_t)
+        assert torch.isfinite(out).all()
+        if step_type == "infer":
+            return [out]
+        d__o = ref_data.getOutputTensorGrad(0)
+        out.backward(torch.tensor(d__o))
+        return [out, d__o, q_t.grad, kT_t.grad, v_t.grad]
+
+    patterns = popart.Patterns(popart.PatternsLevel.Default)
+    patterns.enablePattern("FusedAttention", True)
+    op_tester.setPatterns(patterns)
+    op_tester.atol = 1e-5
+    session = op_tester.run(init_builder, reference, step_type)
+
+    assert _count_ops(session, "Attention") == 1
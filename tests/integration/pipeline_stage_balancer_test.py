@@ -0,0 +1,101 @@
+# Copyright (c) 2022 Graphcore Ltd. All rights reserved.
+import json
+import numpy as np
+import popart
+import pytest
+import test_util as tu
+
+numLayers = 8
+
+
+def _build_model():
+    """
+    A chain of identical matmuls, so the balanced split of it over two IPUs
+    puts the first half of the layers on the first IPU, and the second half on
+    the second.
+    """
+    builder = popart.Builder()
+    x = builder.addInputTensor(popart.TensorInfo("FLOAT", [16, 64]))
+    for i in range(numLayers):
+        w = builder.addInitializedInputTensor(
+            np.random.rand(64, 64).astype(np.float32), f"TESTID-{i}"
+        )
+        x = builder.aiOnnx.matmul([x, w])
+    return builder, x
+
+
+def _check_layers(session):
+    ir = json.loads(session._serializeIr(popart.IrSerializationFormat.JSON))
+    ipus = set()
+    for op in ir["maingraph"]:
+        ipu = int(op["attributes"]["__ipu_number"])
+        ipus.add(ipu)
+        for input in op["inputs"]:
+            for i in range(numLayers):
+                if f"TESTID-{i}" in input["name"]:
+                    assert ipu == (0 if i < numLayers // 2 else 1)
+    assert ipus == {0, 1}
+    return ir
+
+
+def test_balance_stages_inference():
+    builder, out = _build_model()
+    builder.addOutputTensor(out)
+
+    opts = popart.SessionOptions()
+    opts.virtualGraphMode = popart.VirtualGraphMode.Auto
+    opts.autoVirtualGraphSettings.balanceStages = True
+
+    with tu.create_test_device(numIpus=2) as device:
+        session = popart.InferenceSession(
+            fnModel=builder.getModelProto(),
+            dataFlow=popart.DataFlow(1, {out: popart.AnchorReturnType("All")}),
+            userOptions=opts,
+            deviceInfo=device,
+        )
+        _check_layers(session)
+
+
+def test_balance_stages_pipelined_training():
+    builder, out = _build_model()
+    loss = builder.aiGraphcore.l1loss([out], 0.1)
+
+    opts = popart.SessionOptions()
+    opts.virtualGraphMode = popart.VirtualGraphMode.Auto
+    opts.autoVirtualGraphSettings.balanceStages = True
+    opts.enablePipelining = True
+
+    with tu.create_test_device(numIpus=2) as device:
+        session = popart.TrainingSession(
+            fnModel=builder.getModelProto(),
+            dataFlow=popart.DataFlow(10, {loss: popart.AnchorReturnType("All")}),
+            loss=loss,
+            optimizer=popart.ConstSGD(0.1),
+            userOptions=opts,
+            deviceInfo=device,
+        )
+        ir = _check_layers(session)
+
+    for op in ir["maingraph"]:
+        assert "__pipeline_stage" in op["attributes"]
+
+
+def test_balance_stages_too_few_ops():
+    builder = popart.Builder()
+    x = builder.addInputTensor(popart.TensorInfo("FLOAT", [4]))
+    out = builder.aiOnnx.relu([x])
+    builder.addOutputTensor(out)
+
+    opts = popart.SessionOptions()
+    opts.virtualGraphMode = popart.VirtualGraphMode.Auto
+    opts.autoVirtualGraphSettings.balanceStages = True
+
+    with tu.create_test_device(numIpus=2) as device:
+        with pytest.raises(popart.popart_exception) as e_info:
+            popart.InferenceSession(
+                fnModel=builder.getModelProto(),
+                dataFlow=popart.DataFlow(1, {out: popart.AnchorReturnType("All")}),
+                userOptions=opts,
+                deviceInfo=device,
+            )
+    assert "Cannot split 1 ops into 2 stages" in e_info.value.args[0]
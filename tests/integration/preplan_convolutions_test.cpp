@@ -9,6 +9,7 @@
 #include <onnx/onnx_pb.h>
 #include <string>
 #include <testdevice.hpp>
+#include <utility>
 #include <vector>
 #include <popart/builder.hpp>
 #include <popart/dataflow.hpp>
@@ -96,3 +97,46 @@ BOOST_AUTO_TEST_CASE(PrePlanConvolutions_0) {
   compileModel(true); // No run-time exception; pre-planning works
   BOOST_CHECK_EXCEPTION(compileModel(false), internal_error, prePlanningFailed);
 }
+
+BOOST_AUTO_TEST_CASE(PrePlanConvolutions_ReusePlanningCache) {
+  // Lower the same convolution for two sessions, and verify that with
+  // enablePlanningCacheReuse the second session reuses the plan made by the
+  // first one instead of planning it again.
+  auto builder    = Builder::create();
+  auto ip0        = builder->addInputTensor("FLOAT", Shape{1, 1, 8, 8});
+  auto w0         = builder->addInputTensor("FLOAT", Shape{1, 1, 3, 3});
+  auto out        = builder->aiOnnxOpset10().conv({ip0, w0});
+  auto modelProto = io::getModelFromString(builder->getModelProto());
+
+  auto compileModel = [&](bool reuse) {
+    SessionOptions opts;
+    opts.enablePlanningCacheReuse = reuse;
+    auto device                   = createTestDevice(TEST_TARGET);
+
+    Ir ir;
+    ir.prepare({modelProto,
+                InputShapeInfo(),
+                DataFlow(1, {out}),
+                {},
+                nullptr,
+                *device,
+                opts,
+                Patterns(PatternsLevel::Default)});
+
+    popx::IrLowering lowering(ir, device);
+    auto executable = popx::Executablex::createFromLoweredIr(lowering);
+    popx::Devicex devicex(*executable, device);
+    devicex.prepare();
+    return std::make_pair(&devicex.convCache, devicex.convCache.size());
+  };
+
+  const auto first  = compileModel(true);
+  const auto second = compileModel(true);
+  BOOST_CHECK_GT(first.second, 0);
+  BOOST_CHECK_EQUAL(first.first, second.first);
+  BOOST_CHECK_EQUAL(first.second, second.second);
+
+  // Without the option every session starts with an empty cache.
+  const auto unshared = compileModel(false);
+  BOOST_CHECK_NE(unshared.first, first.first);
+}
@@ -0,0 +1,111 @@
+// Copyright (c) 2022 Graphcore Ltd. All rights reserved.
+#define BOOST_TEST_MODULE RecomputeTestIrMemoryBudgetAnnotation0
+
+#include <boost/test/unit_test.hpp>
+#include <cstdint>
+#include <filereader.hpp>
+#include <map>
+#include <memory>
+#include <string>
+#include <testdevice.hpp>
+#include <vector>
+#include <popart/builder.hpp>
+#include <popart/dataflow.hpp>
+#include <popart/error.hpp>
+#include <popart/ir.hpp>
+#include <popart/sessionoptions.hpp>
+#include <popart/sgd.hpp>
+
+#include "popart/builder.gen.hpp"
+#include "popart/inputshapeinfo.hpp"
+#include "popart/names.hpp"
+#include "popart/op.hpp"
+#include "popart/operatoridentifier.hpp"
+#include "popart/patterns/patterns.hpp"
+#include "popart/scheduler_requireoptimal.hpp"
+#include "popart/tensordebuginfo.hpp"
+#include "popart/tensorinfo.hpp"
+#include "popart/voiddata.hpp"
+
+using namespace popart;
+
+namespace {
+
+TensorId conv(Builder *b, TensorId act, ConstVoidData wdata) {
+  auto aiOnnx  = b->aiOnnxOpset9();
+  auto weights = b->addInitializedInputTensor(wdata);
+  act = aiOnnx.conv({act, weights}, {1, 1}, 1, {}, {1, 1, 1, 1}, {1, 1});
+  return act;
+}
+
+// The number of ops of each type annotated Recompute, for a model of 16
+// convolutions, each followed by a relu, prepared with the given budget.
+std::map<std::string, int> getNumRecomputed(int64_t budget) {
+  auto builder = Builder::create();
+  auto aiOnnx  = builder->aiOnnxOpset9();
+
+  TensorInfo input_shape{"FLOAT", std::vector<int64_t>{1, 4, 32, 32}};
+
+  TensorInfo weights_shape{"FLOAT", std::vector<int64_t>{4, 4, 3, 3}};
+  float weight_vals[4 * 4 * 3 * 3] = {0};
+  ConstVoidData weight_data        = {weight_vals, weights_shape};
+
+  auto act = builder->addInputTensor(input_shape);
+  for (int i = 0; i < 16; ++i) {
+    act = conv(builder.get(), act, weight_data);
+    act = aiOnnx.relu({act});
+  }
+  auto l1 = builder->aiGraphcoreOpset1().l1loss({act}, 0.1);
+
+  auto proto      = builder->getModelProto();
+  auto modelProto = io::getModelFromString(proto);
+
+  auto dataFlow  = DataFlow(1, {{act, AnchorReturnType("All")}});
+  auto optimizer = ConstSGD(0.01);
+  auto device    = createTestDevice(TEST_TARGET);
+
+  SessionOptions opts;
+  opts.autoRecomputation             = RecomputationType::MemoryBudget;
+  opts.autoRecomputationMemoryBudget = budget;
+  opts.enableOutlining               = false;
+  opts.mergeVarUpdate                = MergeVarUpdateType::None;
+
+  Ir ir;
+  ir.prepare({modelProto,
+              InputShapeInfo(),
+              dataFlow,
+              l1,
+              &optimizer,
+              *device,
+              opts,
+              Patterns::create({"OpToIdentity", "PostNRepl"})
+                  .enableRuntimeAsserts(false)});
+
+  std::map<std::string, int> numRecomputed;
+  for (auto op : ir.getOpSchedule({}, RequireOptimalSchedule::Yes)) {
+    if (op->settings.recomputeType == RecomputeType::Recompute) {
+      BOOST_CHECK(op->toLoss == PathToLoss::Yes);
+      numRecomputed[op->opid.type]++;
+    }
+  }
+  return numRecomputed;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(MemoryBudgetRecomputeTest) {
+  // Each activation is 16KB. Without recomputation, the output of each relu
+  // is kept for the backward pass, which fits in 1GB.
+  BOOST_CHECK(getNumRecomputed(1 << 30).empty());
+
+  // To fit in the bytes of 10 relu outputs, some relus are recomputed. The
+  // output of a convolution is not kept for the backward pass, so it is
+  // recomputed along with the relu that consumes it.
+  auto numRecomputed = getNumRecomputed(10 * 16 * 1024);
+  BOOST_CHECK(numRecomputed["Relu"] > 0);
+  BOOST_CHECK_EQUAL(numRecomputed["Relu"], numRecomputed["Conv"]);
+}
+
+BOOST_AUTO_TEST_CASE(MemoryBudgetNotSetTest) {
+  BOOST_CHECK_THROW(getNumRecomputed(0), error);
+}
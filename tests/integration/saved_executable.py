@@ -331,6 +331,56 @@ def test_cache_miss_on_engine_option_change(
     assert loaded_saved_executable(capfd) is False
 
 
+@tu.requires_ipu
+def test_set_lowering_options(tmp_path: Path, capfd: pytest.CaptureFixture) -> None:
+    """
+    Test that the engine options of a prepared session can be changed without
+    preparing the IR again, and that the executable is then cached under the
+    same hash as for a new session with those options.
+
+    Args:
+        tmp_path (Path): Temporary directory
+        capfd (pytest.CaptureFixture): The output captured from the file descriptors
+    """
+    # Need to activate the logger in order to check whether we are compiling or loading from cache
+    popart.getLogger().setLevel("DEBUG")
+
+    opts1 = popart.SessionOptions()
+    opts1.enableEngineCaching = True
+    opts1.cachePath = str(tmp_path / "saved_graph")
+    opts1.engineOptions["opt.enableInlining"] = "false"
+
+    opts2 = popart.SessionOptions()
+    opts2.enableEngineCaching = True
+    opts2.cachePath = str(tmp_path / "saved_graph")
+    opts2.engineOptions["opt.enableInlining"] = "true"
+
+    opts3 = popart.SessionOptions()
+    opts3.enableEngineCaching = True
+    opts3.cachePath = str(tmp_path / "saved_graph")
+    opts3.enableOutlining = False
+
+    bps = 2
+    with tu.create_test_device() as device:
+        session, lhs, rhs, output = create_inference_session(
+            device=device, bps=bps, opts=opts1
+        )
+
+        # Options the IR depends on can not be changed.
+        with pytest.raises(popart.popart_exception) as e_info:
+            session.setLoweringOptions(opts3)
+        assert "without preparing the IR again" in e_info.value.args[0]
+
+        session.setLoweringOptions(opts2)
+        run_session_and_check_result(session, bps, lhs, rhs, output)
+        assert loaded_saved_executable(capfd) is False
+
+    # The executable compiled after changing the options is found by a new
+    # session with those options.
+    run_model_test(bps, opts2)
+    assert loaded_saved_executable(capfd) is True
+
+
 @tu.requires_ipu
 @pytest.mark.parametrize("varname", ["POPART_CACHE_DIR", "POPXL_CACHE_DIR"])
 def test_cache_environment_variable(
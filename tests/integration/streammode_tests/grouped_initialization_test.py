@@ -661,6 +661,87 @@ def test_onnx_checkpointing(config):
         assert np.allclose(array_two, buffer_two)
 
 
+@pytest.mark.parametrize("config", onnx_configs)
+@tu.requires_ipu
+def test_sharded_checkpointing(config):
+    """
+    Write the weights of a session with grouped variables to a sharded
+    checkpoint, and check that a new session has the same weights after
+    resetting its host weights from it.
+    """
+    location = remote_config[0]
+    with TemporaryDirectory() as tmpdir:
+        var_set = get_variable_settings(config)
+        returned = var_set.numReplicasReturningVariable(int(config["repl"]))
+        groups = [] if returned == 1 else get_group_idxs(config, var_set, returned)
+
+        def read_weights(session, w1, w2, array_one, array_two):
+            buffer_one = np.zeros(array_one.shape).astype(np.float32)
+            buffer_two = np.zeros(array_two.shape).astype(np.float32)
+            if config["retrieval"] == "AllReplicas":
+                buffer_two = np.zeros((returned,) + array_two.shape).astype(
+                    np.float32
+                )
+            session.weightsToHost()
+            session.readWeights(popart.PyWeightsIO({w1: buffer_one, w2: buffer_two}))
+            return buffer_one, buffer_two
+
+        builder = popart.Builder()
+        builder.embedReplicationFactor(int(config["repl"]))
+        opts, deviceContext = user_options(config, location)
+        check_device(deviceContext, config)
+        with deviceContext as device:
+            session, tensors, arrays, _, _ = get_model(
+                config,
+                builder,
+                groups,
+                var_set,
+                location,
+                "training",
+                initialize=True,
+                device=device,
+                opts=opts,
+            )
+            _, _, w1, w2 = tensors
+            session.weightsFromHost()
+            initial = read_weights(session, w1, w2, *arrays)
+
+            # Change the weights, so they differ from the initial weights of
+            # the new session.
+            changed = [2 * buffer + 1 for buffer in initial]
+            session.writeWeights(popart.PyWeightsIO({w1: changed[0], w2: changed[1]}))
+            session.weightsFromHost()
+            expected = read_weights(session, w1, w2, *arrays)
+            session.weightsToCheckpoint(tmpdir, 2)
+
+        del session
+        del builder
+
+        builder = popart.Builder()
+        opts, deviceContext = user_options(config, location)
+        check_device(deviceContext, config)
+        with deviceContext as device:
+            session, tensors, arrays, _, _ = get_model(
+                config,
+                builder,
+                groups,
+                var_set,
+                location,
+                "training",
+                initialize=True,
+                device=device,
+                opts=opts,
+            )
+            _, _, w1, w2 = tensors
+            session.resetHostWeights(tmpdir, True)
+            session.weightsFromHost()
+            actual = read_weights(session, w1, w2, *arrays)
+
+        for e, a, i in zip(expected, actual, initial):
+            assert np.allclose(e, a)
+            assert not np.allclose(i, a)
+
+
 DATA_SIZE = 5
 
 
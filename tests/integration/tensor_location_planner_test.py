@@ -0,0 +1,84 @@
+# Copyright (c) 2022 Graphcore Ltd. All rights reserved.
+import json
+import numpy as np
+import popart
+import test_util as tu
+
+numLayers = 4
+
+
+def _build_model():
+    """
+    A chain of matmuls, each with a 64KB weight.
+    """
+    builder = popart.Builder()
+    x = builder.addInputTensor(popart.TensorInfo("FLOAT", [4, 128]))
+    for i in range(numLayers):
+        w = builder.addInitializedInputTensor(
+            np.random.rand(128, 128).astype(np.float32), f"TESTID-{i}"
+        )
+        x = builder.aiOnnx.matmul([x, w])
+    builder.addOutputTensor(x)
+    return builder, x
+
+
+def _create_session(memoryBudget, weightLocation=None):
+    builder, out = _build_model()
+
+    opts = popart.SessionOptions()
+    if weightLocation is not None:
+        opts.weightTensorLocationSettings.location = weightLocation
+        opts.weightTensorLocationSettings.minElementsForOffChip = 0
+    if memoryBudget is not None:
+        opts.tensorLocationPlannerSettings.enabled = True
+        opts.tensorLocationPlannerSettings.memoryBudget = memoryBudget
+
+    with tu.create_test_device() as device:
+        session = popart.InferenceSession(
+            fnModel=builder.getModelProto(),
+            dataFlow=popart.DataFlow(1, {out: popart.AnchorReturnType("All")}),
+            userOptions=opts,
+            deviceInfo=device,
+        )
+        return session, session.getMemoryEstimate()
+
+
+def _loaded_layers(session):
+    ir = json.loads(session._serializeIr(popart.IrSerializationFormat.JSON))
+    loaded = set()
+    for op in ir["maingraph"]:
+        if "RemoteLoad" in op["type"]:
+            for input in op["inputs"]:
+                for i in range(numLayers):
+                    if f"TESTID-{i}" in input["name"]:
+                        loaded.add(i)
+    return loaded
+
+
+def test_planner_keeps_tensors_on_chip_within_budget():
+    session, estimate = _create_session(None)
+    peak = estimate.peakBytesPerVirtualGraph[0]
+
+    session, _ = _create_session(peak)
+    assert _loaded_layers(session) == set()
+
+
+def test_planner_moves_weights_off_chip():
+    session, estimate = _create_session(None)
+    peak = estimate.peakBytesPerVirtualGraph[0]
+    weightBytes = 128 * 128 * 4
+
+    # Two weights have to be moved off chip to save more than 1.5 weights.
+    session, _ = _create_session(peak - 3 * weightBytes // 2)
+    assert len(_loaded_layers(session)) == 2
+
+
+def test_planner_keeps_category_locations():
+    session, estimate = _create_session(None)
+    peak = estimate.peakBytesPerVirtualGraph[0]
+
+    # The weights are off chip by the user's settings, even though they fit.
+    session, _ = _create_session(
+        peak, popart.TensorLocation(popart.TensorStorage.OffChip)
+    )
+    assert _loaded_layers(session) == set(range(numLayers))
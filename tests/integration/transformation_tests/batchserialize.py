@@ -1,7 +1,9 @@
 # Copyright (c) 2021 Graphcore Ltd. All rights reserved.
+import json
 import popart
 import numpy as np
 import onnx
+import pytest
 from onnx import numpy_helper
 
 # `import test_util` requires adding to sys.path
@@ -220,3 +222,120 @@ def test_lstm():
             session.run(stepio)
 
     run()
+
+
+"""
+With a memory budget, the batch serialization factor and method are chosen
+so that the predicted peak activation memory fits in the budget. The hidden
+layer of this model is 16 times larger than its input and output, so it is
+serialized to fit in a budget smaller than the hidden layer.
+"""
+
+
+def test_memory_budget():
+    bsize = 8
+    dsize = 16
+    hsize = 256
+    np.random.seed(0)
+    w1_data = np.random.rand(dsize, hsize).astype(np.float32)
+    w2_data = np.random.rand(hsize, dsize).astype(np.float32)
+    ip_data = np.random.rand(bsize, dsize, dsize).astype(np.float32)
+
+    def run(factor, memoryBudget):
+        builder = popart.Builder()
+        ip = builder.addInputTensor(popart.TensorInfo("FLOAT", [bsize, dsize, dsize]))
+        w1 = builder.addInitializedInputTensor(w1_data)
+        w2 = builder.addInitializedInputTensor(w2_data)
+        h = builder.aiOnnx.matmul([ip, w1])
+        out = builder.aiOnnx.matmul([h, w2])
+        builder.addOutputTensor(out)
+
+        with tu.create_test_device(1) as device:
+            opts = popart.SessionOptions()
+            opts.batchSerializationSettings.factor = factor
+            opts.batchSerializationSettings.memoryBudget = memoryBudget
+
+            session = popart.InferenceSession(
+                fnModel=builder.getModelProto(),
+                dataFlow=popart.DataFlow(1, {out: popart.AnchorReturnType("All")}),
+                userOptions=opts,
+                deviceInfo=device,
+            )
+
+            ir = json.loads(session._serializeIr(popart.IrSerializationFormat.JSON))
+            types = [op["type"] for op in ir["maingraph"]]
+
+            session.prepareDevice()
+            session.weightsFromHost()
+            anchors = session.initAnchorArrays()
+            stepio = popart.PyStepIO({ip: ip_data}, anchors)
+            session.run(stepio)
+            return types, anchors[out]
+
+    types, reference = run(0, 0)
+    assert types.count("MatMul") == 2
+
+    # The unserialized model fits in a large budget.
+    types, result = run(0, 1 << 30)
+    assert types.count("MatMul") == 2
+    assert np.allclose(reference, result)
+
+    # The hidden layer alone is bsize * dsize * hsize * 4 = 128KB.
+    types, result = run(0, 64 * 1024)
+    assert types.count("MatMul") > 2 or "Loop" in types
+    assert np.allclose(reference, result)
+
+    with pytest.raises(popart.popart_exception) as e_info:
+        run(4, 64 * 1024)
+    assert "Both BatchSerializationSettings::factor" in e_info.value.args[0]
+
+
+def test_memory_budget_set_lowering_options():
+    """
+    The batch serialization settings chosen for a memory budget do not stop
+    the lowering options of the prepared session from being changed.
+    """
+    bsize = 8
+    dsize = 16
+    hsize = 256
+    np.random.seed(0)
+    w1_data = np.random.rand(dsize, hsize).astype(np.float32)
+    w2_data = np.random.rand(hsize, dsize).astype(np.float32)
+    ip_data = np.random.rand(bsize, dsize, dsize).astype(np.float32)
+
+    builder = popart.Builder()
+    ip = builder.addInputTensor(popart.TensorInfo("FLOAT", [bsize, dsize, dsize]))
+    w1 = builder.addInitializedInputTensor(w1_data)
+    w2 = builder.addInitializedInputTensor(w2_data)
+    h = builder.aiOnnx.matmul([ip, w1])
+    out = builder.aiOnnx.matmul([h, w2])
+    builder.addOutputTensor(out)
+
+    def createOptions(enableInlining):
+        opts = popart.SessionOptions()
+        opts.batchSerializationSettings.memoryBudget = 64 * 1024
+        opts.engineOptions["opt.enableInlining"] = enableInlining
+        return opts
+
+    with tu.create_test_device(1) as device:
+        session = popart.InferenceSession(
+            fnModel=builder.getModelProto(),
+            dataFlow=popart.DataFlow(1, {out: popart.AnchorReturnType("All")}),
+            userOptions=createOptions("false"),
+            deviceInfo=device,
+        )
+
+        ir = json.loads(session._serializeIr(popart.IrSerializationFormat.JSON))
+        types = [op["type"] for op in ir["maingraph"]]
+        assert types.count("MatMul") > 2 or "Loop" in types
+
+        session.setLoweringOptions(createOptions("true"))
+
+        session.prepareDevice()
+        session.weightsFromHost()
+        anchors = session.initAnchorArrays()
+        stepio = popart.PyStepIO({ip: ip_data}, anchors)
+        session.run(stepio)
+
+    reference = np.matmul(np.matmul(ip_data, w1_data), w2_data)
+    assert np.allclose(reference, anchors[out], rtol=1e-4)
@@ -0,0 +1,94 @@
+# Copyright (c) 2022 Graphcore Ltd. All rights reserved.
+import json
+import numpy as np
+import popart
+import test_util as tu
+
+
+def _count_ops(session, opType):
+    ir = json.loads(session._serializeIr(popart.IrSerializationFormat.JSON))
+    return len([op for op in ir["maingraph"] if op["type"] == opType])
+
+
+def _run(build, inputs, enableTransposeSinking):
+    builder = popart.Builder()
+    ids, out = build(builder)
+
+    opts = popart.SessionOptions()
+    opts.enableTransposeSinking = enableTransposeSinking
+    opts.reportOptions = {"showExecutionSteps": "true"}
+    opts.engineOptions["debug.retainDebugInformation"] = "true"
+
+    with tu.create_test_device() as device:
+        session = popart.InferenceSession(
+            fnModel=builder.getModelProto(),
+            dataFlow=popart.DataFlow(1, {out: popart.AnchorReturnType("All")}),
+            userOptions=opts,
+            deviceInfo=device,
+        )
+        session.prepareDevice()
+        anchors = session.initAnchorArrays()
+        stepio = popart.PyStepIO(dict(zip(ids, inputs)), anchors)
+        session.run(stepio)
+
+        numTransposes = _count_ops(session, "Transpose") + _count_ops(
+            session, "TransposeInplace"
+        )
+        computeSets = tu.get_compute_sets_from_report(session.getSummaryReport())
+
+    print(
+        f"enableTransposeSinking={enableTransposeSinking}: "
+        f"{numTransposes} transposes, {len(computeSets)} compute sets"
+    )
+    return anchors[out], numTransposes, len(computeSets)
+
+
+def test_transposes_cancel_across_chain():
+    x = np.random.rand(2, 8, 4).astype(np.float32) - 0.5
+    w = np.random.rand(2, 8, 4).astype(np.float32)
+
+    def build(builder):
+        xId = builder.addInputTensor(popart.TensorInfo("FLOAT", x.shape))
+        wId = builder.addInputTensor(popart.TensorInfo("FLOAT", w.shape))
+        a = builder.aiOnnx.transpose([xId], perm=[0, 2, 1])
+        a = builder.aiOnnx.relu([a])
+        a = builder.aiOnnx.mul([a, builder.aiOnnx.transpose([wId], perm=[0, 2, 1])])
+        a = builder.aiOnnx.exp([a])
+        out = builder.aiOnnx.transpose([a], perm=[0, 2, 1])
+        builder.addOutputTensor(out)
+        return [xId, wId], out
+
+    reference, transposes, computeSets = _run(build, [x, w], False)
+    result, sunkTransposes, sunkComputeSets = _run(build, [x, w], True)
+
+    assert transposes == 3
+    assert sunkTransposes == 0
+    assert sunkComputeSets <= computeSets
+
+    assert np.allclose(reference, np.exp(np.maximum(x, 0) * w), rtol=1e-5)
+    assert np.allclose(result, reference, rtol=1e-5, atol=1e-6)
+
+
+def test_transposed_matmul_reduce():
+    a = np.random.rand(2, 4, 3).astype(np.float32)
+    b = np.random.rand(2, 5, 4).astype(np.float32)
+
+    def build(builder):
+        aId = builder.addInputTensor(popart.TensorInfo("FLOAT", a.shape))
+        bId = builder.addInputTensor(popart.TensorInfo("FLOAT", b.shape))
+        ta = builder.aiOnnx.transpose([aId], perm=[0, 2, 1])
+        tb = builder.aiOnnx.transpose([bId], perm=[0, 2, 1])
+        m = builder.aiOnnx.matmul([ta, tb])
+        out = builder.aiOnnx.reducesum([m], axes=[1], keepdims=0)
+        builder.addOutputTensor(out)
+        return [aId, bId], out
+
+    reference, transposes, _ = _run(build, [a, b], False)
+    result, sunkTransposes, _ = _run(build, [a, b], True)
+
+    assert transposes == 2
+    assert sunkTransposes == 0
+
+    expected = np.sum(np.transpose(a, (0, 2, 1)) @ np.transpose(b, (0, 2, 1)), axis=1)
+    assert np.allclose(reference, expected, rtol=1e-5)
+    assert np.allclose(result, reference, rtol=1e-5, atol=1e-6)
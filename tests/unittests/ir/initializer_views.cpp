@@ -0,0 +1,82 @@
+// Copyright (c) 2022 Graphcore Ltd. All rights reserved.
+#define BOOST_TEST_MODULE Test_Ir_InitializerViews
+#include <boost/test/unit_test.hpp>
+#include <cstring>
+#include <memory>
+#include <onnx/onnx_pb.h>
+#include <string>
+#include <vector>
+#include <popart/graph.hpp>
+#include <popart/ir.hpp>
+
+#include "popart/names.hpp"
+#include "popart/tensor.hpp"
+#include "popart/tensordata.hpp"
+#include "popart/tensors.hpp"
+#include "popart/variablesettings.hpp"
+
+using namespace popart;
+
+namespace {
+
+ONNX_NAMESPACE::TensorProto *addInitializer(ONNX_NAMESPACE::ModelProto &model,
+                                            const TensorId &id,
+                                            const std::vector<float> &values,
+                                            bool raw) {
+  auto *init = model.mutable_graph()->add_initializer();
+  init->set_name(id);
+  init->set_data_type(ONNX_NAMESPACE::TensorProto::FLOAT);
+  init->add_dims(values.size());
+  if (raw) {
+    init->set_raw_data(values.data(), values.size() * sizeof(float));
+  } else {
+    for (auto v : values) {
+      init->add_float_data(v);
+    }
+  }
+  return init;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(TestVarInitViewsRawData) {
+  Ir ir;
+  Tensors &tensors = ir.getMainGraph().getTensors();
+
+  const std::vector<float> values{1.0f, 2.0f, 3.0f, 4.0f};
+  auto model   = std::make_shared<ONNX_NAMESPACE::ModelProto>();
+  auto *weight = addInitializer(*model, "weight", values, true);
+
+  tensors.addVarInitFromViewOf("weight", weight, model, VariableSettings());
+  auto *data = tensors.get("weight")->tensorData();
+
+  // The tensor data is the initializer's bytes, not a copy of them.
+  BOOST_CHECK_EQUAL(data->data(), weight->raw_data().data());
+  BOOST_CHECK(data->copyDataAs<float>(4) == values);
+
+  // Writing the weights writes them to the initializer.
+  static_cast<float *>(data->data())[0] = 5.0f;
+  float first;
+  std::memcpy(&first, weight->raw_data().data(), sizeof(float));
+  BOOST_CHECK_EQUAL(first, 5.0f);
+
+  // The tensor data keeps the model alive.
+  model.reset();
+  BOOST_CHECK_EQUAL(data->copyDataAs<float>(4)[3], 4.0f);
+}
+
+BOOST_AUTO_TEST_CASE(TestConstInitCopiesTypedData) {
+  Ir ir;
+  Tensors &tensors = ir.getMainGraph().getTensors();
+
+  const std::vector<float> values{1.0f, 2.0f};
+  auto model = std::make_shared<ONNX_NAMESPACE::ModelProto>();
+  auto *bias = addInitializer(*model, "bias", values, false);
+
+  // Without raw data there are no bytes to view, so the data is copied.
+  tensors.addConstInitFromViewOf("bias", bias, model);
+  auto *tensor = tensors.get("bias");
+  BOOST_CHECK(tensor->tensorType() == TensorType::Const);
+  BOOST_CHECK(tensors.getConstIds().contains("bias"));
+  BOOST_CHECK(tensor->tensorData()->copyDataAs<float>(2) == values);
+}
@@ -0,0 +1,143 @@
+// Copyright (c) 2022 Graphcore Ltd. All rights reserved.
+#define BOOST_TEST_MODULE FusedAttentionTests
+#include <boost/test/unit_test.hpp>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <popart/graph.hpp>
+#include <popart/ir.hpp>
+#include <popart/op/add.hpp>
+#include <popart/op/attention.hpp>
+#include <popart/op/identity.hpp>
+#include <popart/op/matmul.hpp>
+#include <popart/op/scale.hpp>
+#include <popart/op/softmax.hpp>
+#include <popart/patterns/fusedattentionpattern.hpp>
+#include <popart/patterns/patterns.hpp>
+#include <popart/tensors.hpp>
+
+#include "popart/datatype.hpp"
+#include "popart/names.hpp"
+#include "popart/op.hpp"
+#include "popart/operators.hpp"
+#include "popart/tensor.hpp"
+#include "popart/tensorinfo.hpp"
+#include "popart/vendored/optional.hpp"
+
+using namespace popart;
+
+namespace {
+
+// query [2, 4, 64, 8], keyTransposed [2, 4, 8, 64], value [2, 4, 64, 8] and a
+// mask [2, 1, 1, 64] over the keys.
+void addInputs(Graph &g) {
+  g.getTensors().addStream("q", {DataType::FLOAT, Shape{2, 4, 64, 8}});
+  g.getTensors().addStream("kT", {DataType::FLOAT, Shape{2, 4, 8, 64}});
+  g.getTensors().addStream("v", {DataType::FLOAT, Shape{2, 4, 64, 8}});
+  g.getTensors().addStream("mask", {DataType::FLOAT, Shape{2, 1, 1, 64}});
+}
+
+Op *matmul(Graph &g, TensorId lhs, TensorId rhs, TensorId out) {
+  return g.createConnectedOp<MatMulOp>({{MatMulOp::getLhsInIndex(), lhs},
+                                        {MatMulOp::getRhsInIndex(), rhs}},
+                                       {{MatMulOp::getOutIndex(), out}},
+                                       Onnx::AiOnnx::OpSet9::MatMul,
+                                       Op::Settings(g, "matmul"),
+                                       nonstd::nullopt,
+                                       MatMulOp::SerialiseSettings(),
+                                       OptionalDataType());
+}
+
+/*
+  q, kT -- MatMul -- s -- Scale -- ss -- Add -- sm -- Softmax -- p -- MatMul
+                                 mask -'                        v ----'
+ */
+Op *addAttention(Graph &g) {
+  matmul(g, "q", "kT", "s");
+  g.createConnectedOp<ScaleOp>({{ScaleOp::getInIndex(), "s"}},
+                               {{ScaleOp::getOutIndex(), "ss"}},
+                               Onnx::CustomOperators::Scale_1,
+                               0.125f,
+                               Op::Settings(g, "scale"));
+  g.createConnectedOp<AddOp>(
+      {{AddOp::getArg0InIndex(), "ss"}, {AddOp::getArg1InIndex(), "mask"}},
+      {{AddOp::getOutIndex(), "sm"}},
+      Onnx::Operators::Add_7,
+      Op::Settings(g, "mask"));
+  g.createConnectedOp<SoftmaxOp>({{SoftmaxOp::getInIndex(), "sm"}},
+                                 {{SoftmaxOp::getOutIndex(), "p"}},
+                                 Onnx::Operators::Softmax_11,
+                                 -1,
+                                 Op::Settings(g, "softmax"));
+  return matmul(g, "p", "v", "out");
+}
+
+int64_t getTotalBytes(Graph &g) {
+  int64_t bytes = 0;
+  for (const auto &id : g.getTensors().getAllTensorIds()) {
+    bytes += g.getTensors().get(id)->info.nbytes();
+  }
+  return bytes;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(TestPatternNamesContainsFusedAttention) {
+  BOOST_REQUIRE_NO_THROW(PatternNames::getName<FusedAttentionPattern>());
+
+  // Off by default.
+  Patterns ps;
+  BOOST_REQUIRE(!ps.isPatternEnabled("FusedAttention"));
+}
+
+BOOST_AUTO_TEST_CASE(TestFusesMaskedAttention) {
+  Ir ir;
+  ir.setExecutionMode(Ir::ExecutionMode::Inference);
+  Graph &g = ir.getMainGraph();
+  addInputs(g);
+  auto out = addAttention(g);
+
+  const auto bytesBefore = getTotalBytes(g);
+
+  FusedAttentionPattern pattern;
+  BOOST_REQUIRE(pattern.matches(out));
+  pattern.apply(out);
+
+  BOOST_REQUIRE_EQUAL(g.getOps().size(), 1);
+  auto attention =
+      dynamic_cast<AttentionOp *>(g.getOps().begin()->second.get());
+  BOOST_REQUIRE(attention);
+  BOOST_CHECK_EQUAL(attention->getScale(), 0.125f);
+  BOOST_CHECK(attention->hasMask());
+  BOOST_CHECK_EQUAL(attention->inId(AttentionOp::getQueryInIndex()), "q");
+  BOOST_CHECK_EQUAL(attention->inId(AttentionOp::getKeyTransposedInIndex()),
+                    "kT");
+  BOOST_CHECK_EQUAL(attention->inId(AttentionOp::getValueInIndex()), "v");
+  BOOST_CHECK_EQUAL(attention->inId(AttentionOp::getMaskInIndex()), "mask");
+  BOOST_CHECK_EQUAL(attention->outId(AttentionOp::getOutIndex()), "out");
+  BOOST_CHECK(attention->outShape(AttentionOp::getOutIndex()) ==
+              Shape({2, 4, 64, 8}));
+  BOOST_CHECK(attention->outShape(AttentionOp::getLogSumExpOutIndex()) ==
+              Shape({2, 4, 64}));
+
+  // None of the [2, 4, 64, 64] scores remain.
+  for (auto id : {"s", "ss", "sm", "p"}) {
+    BOOST_CHECK(!g.getTensors().contains(id));
+  }
+  BOOST_CHECK_LT(getTotalBytes(g), bytesBefore);
+}
+
+BOOST_AUTO_TEST_CASE(TestDoesNotFuseProbabilitiesUsedElsewhere) {
+  Ir ir;
+  ir.setExecutionMode(Ir::ExecutionMode::Inference);
+  Graph &g = ir.getMainGraph();
+  addInputs(g);
+  auto out = addAttention(g);
+  g.createConnectedOp<IdentityOp>({{IdentityOp::getInIndex(), "p"}},
+                                  {{IdentityOp::getOutIndex(), "pCopy"}},
+                                  Onnx::Operators::Identity_1,
+                                  Op::Settings(g, "identity"));
+
+  FusedAttentionPattern pattern;
+  BOOST_CHECK(!pattern.matches(out));
+}
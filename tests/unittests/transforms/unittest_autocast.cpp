@@ -0,0 +1,134 @@
+// Copyright (c) 2022 Graphcore Ltd. All rights reserved.
+#define BOOST_TEST_MODULE TestAutocastTransform
+#include <algorithm>
+#include <boost/test/unit_test.hpp>
+#include <string>
+#include <vector>
+#include <popart/graph.hpp>
+#include <popart/ir.hpp>
+#include <popart/op/add.hpp>
+#include <popart/op/cast.hpp>
+#include <popart/op/matmul.hpp>
+#include <popart/op/softmax.hpp>
+#include <popart/tensorinfo.hpp>
+#include <popart/tensors.hpp>
+#include <popart/transforms/autocast.hpp>
+
+#include "popart/datatype.hpp"
+#include "popart/names.hpp"
+#include "popart/op.hpp"
+#include "popart/operators.hpp"
+#include "popart/sessionoptions.hpp"
+#include "popart/tensor.hpp"
+#include "popart/vendored/optional.hpp"
+
+using namespace popart;
+
+namespace {
+
+std::vector<float> wData(16 * 8, 0.5f);
+
+void enableAutocast(Ir &ir) {
+  SessionOptions opts;
+  opts.autocastSettings.enabled = true;
+  ir.setUserOptions(opts);
+}
+
+Op *matmul(Graph &g, TensorId lhs, TensorId rhs, TensorId out) {
+  return g.createConnectedOp<MatMulOp>({{MatMulOp::getLhsInIndex(), lhs},
+                                        {MatMulOp::getRhsInIndex(), rhs}},
+                                       {{MatMulOp::getOutIndex(), out}},
+                                       Onnx::Operators::MatMul_9,
+                                       Op::Settings(g, "matmul"),
+                                       nonstd::nullopt,
+                                       MatMulOp::SerialiseSettings(),
+                                       OptionalDataType());
+}
+
+bool contains(const std::vector<std::string> &types, const std::string &type) {
+  return std::find(types.begin(), types.end(), type) != types.end();
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(TestAutocastSessionOption) {
+  auto opts = SessionOptions();
+  BOOST_CHECK(opts.autocastSettings.enabled == false);
+  BOOST_CHECK(contains(opts.autocastSettings.allowOpTypes, "MatMul"));
+  BOOST_CHECK(contains(opts.autocastSettings.denyOpTypes, "Softmax"));
+  BOOST_CHECK(contains(opts.autocastSettings.promoteOpTypes, "Add"));
+}
+
+/*
+  x -- MatMul -- m -- Add -- a -- Softmax -- y
+  w ----'        b ----'
+
+  The MatMul and Add run in FLOAT16, the Softmax and the variable w in FLOAT.
+ */
+BOOST_AUTO_TEST_CASE(TestCastsMatMulToHalfAndSoftmaxToFloat) {
+  Ir ir;
+  enableAutocast(ir);
+  Graph &g = ir.getMainGraph();
+  g.getTensors().addStream("x", {DataType::FLOAT, Shape{4, 16}});
+  g.getTensors().addStream("b", {DataType::FLOAT, Shape{8}});
+  g.getTensors().addVarInit("w", {DataType::FLOAT, Shape{16, 8}}, wData.data());
+
+  auto mm      = matmul(g, "x", "w", "m");
+  auto add     = g.createConnectedOp<AddOp>(
+      {{AddOp::getArg0InIndex(), "m"}, {AddOp::getArg1InIndex(), "b"}},
+      {{AddOp::getOutIndex(), "a"}},
+      Onnx::Operators::Add_7,
+      Op::Settings(g, "add"));
+  auto softmax = g.createConnectedOp<SoftmaxOp>(
+      {{SoftmaxOp::getInIndex(), "a"}},
+      {{SoftmaxOp::getOutIndex(), "y"}},
+      Onnx::Operators::Softmax_11,
+      -1,
+      Op::Settings(g, "softmax"));
+
+  Autocast autocast;
+  autocast.apply(g);
+
+  for (auto index : {MatMulOp::getLhsInIndex(), MatMulOp::getRhsInIndex()}) {
+    BOOST_CHECK(mm->inInfo(index).dataType() == DataType::FLOAT16);
+    BOOST_CHECK(mm->inTensor(index)->getProducer()->isConvertibleTo<CastOp>());
+  }
+  BOOST_CHECK(g.getTensors().get("w")->info.dataType() == DataType::FLOAT);
+  BOOST_CHECK(g.getTensors().get("m")->info.dataType() == DataType::FLOAT16);
+
+  // The Add follows its FLOAT16 input.
+  BOOST_CHECK(add->inInfo(AddOp::getArg1InIndex()).dataType() ==
+              DataType::FLOAT16);
+  BOOST_CHECK(g.getTensors().get("a")->info.dataType() == DataType::FLOAT16);
+
+  BOOST_CHECK(softmax->inInfo(SoftmaxOp::getInIndex()).dataType() ==
+              DataType::FLOAT);
+  BOOST_CHECK(g.getTensors().get("y")->info.dataType() == DataType::FLOAT);
+}
+
+/*
+  x -- Cast(FLOAT) -- c -- MatMul -- m
+                     w -----'
+
+  The FLOAT16 x is used by the MatMul, rather than c cast back to FLOAT16.
+ */
+BOOST_AUTO_TEST_CASE(TestDoesNotCastBackToHalf) {
+  Ir ir;
+  enableAutocast(ir);
+  Graph &g = ir.getMainGraph();
+  g.getTensors().addStream("x", {DataType::FLOAT16, Shape{4, 16}});
+  g.getTensors().addVarInit("w", {DataType::FLOAT, Shape{16, 8}}, wData.data());
+
+  g.createConnectedOp<CastOp>({{CastOp::getInIndex(), "x"}},
+                              {{CastOp::getOutIndex(), "c"}},
+                              Onnx::Operators::Cast_9,
+                              DataType::FLOAT,
+                              Op::Settings(g, "cast"));
+  auto mm = matmul(g, "c", "w", "m");
+
+  Autocast autocast;
+  autocast.apply(g);
+
+  BOOST_CHECK_EQUAL(mm->inId(MatMulOp::getLhsInIndex()), "x");
+  BOOST_CHECK(g.getTensors().get("m")->info.dataType() == DataType::FLOAT16);
+}
@@ -0,0 +1,186 @@
+// Copyright (c) 2022 Graphcore Ltd. All rights reserved.
+#define BOOST_TEST_MODULE TestElementwiseFusionTransform
+#include <boost/test/unit_test.hpp>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+#include <popart/graph.hpp>
+#include <popart/ir.hpp>
+#include <popart/op/add.hpp>
+#include <popart/op/exp.hpp>
+#include <popart/op/fusedelementwise.hpp>
+#include <popart/op/relu.hpp>
+#include <popart/op/scale.hpp>
+#include <popart/op/sigmoid.hpp>
+#include <popart/op/tanh.hpp>
+#include <popart/tensorinfo.hpp>
+#include <popart/tensors.hpp>
+#include <popart/transforms/elementwisefusion.hpp>
+
+#include "popart/datatype.hpp"
+#include "popart/names.hpp"
+#include "popart/op.hpp"
+#include "popart/operators.hpp"
+#include "popart/sessionoptions.hpp"
+#include "popart/tensor.hpp"
+#include "popart/tensorindex.hpp"
+
+using namespace popart;
+
+namespace {
+
+const TensorInfo xInfo{DataType::FLOAT, Shape{4, 16}};
+const TensorInfo bInfo{DataType::FLOAT, Shape{16}};
+std::vector<float> bData(16, 1.0f);
+
+// Add the input x of shape (4, 16) and the weight b of shape (16) to g.
+void addInputs(Graph &g) {
+  g.getTensors().addStream("x", xInfo);
+  g.getTensors().addVarInit("b", bInfo, static_cast<void *>(bData.data()));
+}
+
+std::vector<Op *> getOps(Graph &g) {
+  std::vector<Op *> ops;
+  for (auto &id_op : g.getOps()) {
+    ops.push_back(id_op.second.get());
+  }
+  return ops;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(TestElementwiseFusionSessionOption) {
+  auto opts = SessionOptions();
+  BOOST_CHECK(opts.enableElementwiseFusion == false);
+}
+
+/*
+  x --- Add -- a -- Relu -- r -- Scale -- s -- Sigmoid -- y
+  b ----'
+ */
+BOOST_AUTO_TEST_CASE(TestFusesChain) {
+  Ir ir;
+  Graph &g = ir.getMainGraph();
+  addInputs(g);
+
+  g.createConnectedOp<AddOp>(
+      {{AddOp::getArg0InIndex(), "x"}, {AddOp::getArg1InIndex(), "b"}},
+      {{AddOp::getOutIndex(), "a"}},
+      Onnx::Operators::Add_7,
+      Op::Settings(g, ""));
+  g.createConnectedOp<ReluOp>({{ReluOp::getInIndex(), "a"}},
+                              {{ReluOp::getOutIndex(), "r"}},
+                              Onnx::Operators::Relu_6,
+                              Op::Settings(g, ""));
+  g.createConnectedOp<ScaleOp>({{ScaleOp::getInIndex(), "r"}},
+                               {{ScaleOp::getOutIndex(), "s"}},
+                               Onnx::CustomOperators::Scale_1,
+                               0.5f,
+                               Op::Settings(g, ""));
+  g.createConnectedOp<SigmoidOp>({{SigmoidOp::getInIndex(), "s"}},
+                                 {{SigmoidOp::getOutIndex(), "y"}},
+                                 Onnx::Operators::Sigmoid_6,
+                                 Op::Settings(g, ""));
+
+  ir.applyTransform(ElementwiseFusion::id(), g);
+
+  auto ops = getOps(g);
+  BOOST_REQUIRE_EQUAL(ops.size(), 1);
+  auto fused = dynamic_cast<FusedElementwiseOp *>(ops.front());
+  BOOST_REQUIRE(fused);
+
+  BOOST_CHECK_EQUAL(fused->input->n(), 2);
+  BOOST_CHECK_EQUAL(fused->inId(0), "x");
+  BOOST_CHECK_EQUAL(fused->inId(1), "b");
+  BOOST_CHECK_EQUAL(fused->outId(FusedElementwiseOp::getOutIndex()), "y");
+  BOOST_CHECK(fused->outInfo(FusedElementwiseOp::getOutIndex()) == xInfo);
+  BOOST_CHECK_EQUAL(fused->getExprString(),
+                    "in0; in1; Add(%0, %1); 0; Max(%2, %3); 0.5; Mul(%4, %5); "
+                    "Sigmoid(%6)");
+
+  // The intermediate tensors are gone.
+  for (auto id : {"a", "r", "s"}) {
+    BOOST_CHECK(!g.getTensors().contains(id));
+  }
+}
+
+/*
+  x -- Exp -- e -- Relu -- r -- Add -- y
+              '--- Tanh -- t ----'
+ */
+BOOST_AUTO_TEST_CASE(TestDoesNotFuseTensorsWithManyConsumers) {
+  Ir ir;
+  Graph &g = ir.getMainGraph();
+  addInputs(g);
+
+  auto exp = g.createConnectedOp<ExpOp>({{ExpOp::getInIndex(), "x"}},
+                                        {{ExpOp::getOutIndex(), "e"}},
+                                        Onnx::Operators::Exp_6,
+                                        Op::Settings(g, ""));
+  g.createConnectedOp<ReluOp>({{ReluOp::getInIndex(), "e"}},
+                              {{ReluOp::getOutIndex(), "r"}},
+                              Onnx::Operators::Relu_6,
+                              Op::Settings(g, ""));
+  g.createConnectedOp<TanhOp>({{TanhOp::getInIndex(), "e"}},
+                              {{TanhOp::getOutIndex(), "t"}},
+                              Onnx::Operators::Tanh_6,
+                              Op::Settings(g, ""));
+  g.createConnectedOp<AddOp>(
+      {{AddOp::getArg0InIndex(), "r"}, {AddOp::getArg1InIndex(), "t"}},
+      {{AddOp::getOutIndex(), "y"}},
+      Onnx::Operators::Add_7,
+      Op::Settings(g, ""));
+
+  ir.applyTransform(ElementwiseFusion::id(), g);
+
+  // e has two consumers, so Exp stays, and the ops consuming e are fused into
+  // one op with e as its only input.
+  BOOST_REQUIRE_EQUAL(g.getOps().size(), 2);
+  auto consumers = g.getTensors().get("e")->consumers.getOps();
+  BOOST_REQUIRE_EQUAL(consumers.size(), 1);
+  auto fused = dynamic_cast<FusedElementwiseOp *>(consumers.front());
+  BOOST_REQUIRE(fused);
+  BOOST_CHECK_EQUAL(fused->input->n(), 1);
+  BOOST_CHECK_EQUAL(fused->outId(FusedElementwiseOp::getOutIndex()), "y");
+  BOOST_CHECK(g.getTensors().get("e")->getProducer() == exp);
+}
+
+/*
+  b -- Relu -- rb -- Add -- a -- Sigmoid -- y
+  x ----------------'
+ */
+BOOST_AUTO_TEST_CASE(TestDoesNotFuseBroadcastProducers) {
+  Ir ir;
+  Graph &g = ir.getMainGraph();
+  addInputs(g);
+
+  auto relu = g.createConnectedOp<ReluOp>({{ReluOp::getInIndex(), "b"}},
+                                          {{ReluOp::getOutIndex(), "rb"}},
+                                          Onnx::Operators::Relu_6,
+                                          Op::Settings(g, ""));
+  g.createConnectedOp<AddOp>(
+      {{AddOp::getArg0InIndex(), "x"}, {AddOp::getArg1InIndex(), "rb"}},
+      {{AddOp::getOutIndex(), "a"}},
+      Onnx::Operators::Add_7,
+      Op::Settings(g, ""));
+  g.createConnectedOp<SigmoidOp>({{SigmoidOp::getInIndex(), "a"}},
+                                 {{SigmoidOp::getOutIndex(), "y"}},
+                                 Onnx::Operators::Sigmoid_6,
+                                 Op::Settings(g, ""));
+
+  ir.applyTransform(ElementwiseFusion::id(), g);
+
+  // The output of Relu is broadcast by Add, so Relu is not in the group of
+  // Add, but is an input of it.
+  BOOST_REQUIRE_EQUAL(g.getOps().size(), 2);
+  auto consumers = g.getTensors().get("rb")->consumers.getOps();
+  BOOST_REQUIRE_EQUAL(consumers.size(), 1);
+  auto fused = dynamic_cast<FusedElementwiseOp *>(consumers.front());
+  BOOST_REQUIRE(fused);
+  BOOST_CHECK(g.getTensors().get("rb")->getProducer() == relu);
+  BOOST_CHECK_EQUAL(fused->getExprString(),
+                    "in0; in1; Add(%0, %1); Sigmoid(%2)");
+  BOOST_CHECK(fused->outInfo(FusedElementwiseOp::getOutIndex()) == xInfo);
+}
@@ -0,0 +1,139 @@
+// Copyright (c) 2022 Graphcore Ltd. All rights reserved.
+#define BOOST_TEST_MODULE TestGlobalValueNumberingTransform
+#include <boost/test/unit_test.hpp>
+#include <string>
+#include <vector>
+#include <popart/graph.hpp>
+#include <popart/ir.hpp>
+#include <popart/op/add.hpp>
+#include <popart/op/call.hpp>
+#include <popart/op/dropout.hpp>
+#include <popart/op/relu.hpp>
+#include <popart/tensorinfo.hpp>
+#include <popart/tensors.hpp>
+#include <popart/transforms/globalvaluenumbering.hpp>
+
+#include "popart/datatype.hpp"
+#include "popart/graphid.hpp"
+#include "popart/names.hpp"
+#include "popart/op.hpp"
+#include "popart/operators.hpp"
+#include "popart/sessionoptions.hpp"
+#include "popart/tensor.hpp"
+#include "popart/util.hpp"
+
+using namespace popart;
+
+namespace {
+
+const TensorInfo xInfo{DataType::FLOAT, Shape{4, 16}};
+std::vector<float> cData(64, 2.0f);
+
+Op *add(Graph &g, TensorId arg0, TensorId arg1, TensorId out) {
+  return g.createConnectedOp<AddOp>(
+      {{AddOp::getArg0InIndex(), arg0}, {AddOp::getArg1InIndex(), arg1}},
+      {{AddOp::getOutIndex(), out}},
+      Onnx::Operators::Add_7,
+      Op::Settings(g, "add"));
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(TestGlobalValueNumberingSessionOption) {
+  auto opts = SessionOptions();
+  BOOST_CHECK(opts.enableGlobalValueNumbering == false);
+}
+
+/*
+  x --- Add -- a0 -- Add -- y
+  c0 ----'           |
+  x --- Add -- a1 ---'
+  c1 ----'
+
+  c0 and c1 are constants with the same data, so a1 is a0.
+ */
+BOOST_AUTO_TEST_CASE(TestMergesThroughEqualConstants) {
+  Ir ir;
+  Graph &g = ir.getMainGraph();
+  g.getTensors().addStream("x", xInfo);
+  g.getTensors().addConstInit("c0", xInfo, cData.data());
+  g.getTensors().addConstInit("c1", xInfo, cData.data());
+
+  add(g, "x", "c0", "a0");
+  add(g, "x", "c1", "a1");
+  auto sum = add(g, "a0", "a1", "y");
+
+  GlobalValueNumbering gvn;
+  gvn.apply(g);
+
+  BOOST_CHECK_EQUAL(g.getOps().size(), 2);
+  BOOST_CHECK(g.getTensors().contains("a0") != g.getTensors().contains("a1"));
+  BOOST_CHECK_EQUAL(sum->inId(AddOp::getArg0InIndex()),
+                    sum->inId(AddOp::getArg1InIndex()));
+}
+
+/*
+  x -- Call(sg) -- r0 -- Add -- y
+  x -- Call(sg) -- r1 ----'
+
+  sg: x -- Relu -- r
+ */
+BOOST_AUTO_TEST_CASE(TestMergesCallsOfPureGraph) {
+  Ir ir;
+  Graph &mg = ir.getMainGraph();
+  mg.getTensors().addStream("x", xInfo);
+
+  Graph &sg  = ir.createGraph(GraphId{"sg"});
+  auto sgIn  = addScope(sg, "x");
+  auto sgOut = addScope(sg, "r");
+  sg.addInput(sgIn, xInfo);
+  sg.createConnectedOp<ReluOp>({{ReluOp::getInIndex(), sgIn}},
+                               {{ReluOp::getOutIndex(), sgOut}},
+                               Onnx::Operators::Relu_6,
+                               Op::Settings(sg, "relu"));
+  sg.markAsOutput(sgOut);
+
+  for (auto out : {"r0", "r1"}) {
+    mg.createConnectedOp<CallOp>({{sg.getInputIndex(sgIn), "x"}},
+                                 {{sg.getOutputIndex(sgOut), out}},
+                                 Onnx::CustomOperators::Call_1,
+                                 sg,
+                                 Op::Settings(mg, "call"));
+  }
+  auto sum = add(mg, "r0", "r1", "y");
+
+  GlobalValueNumbering gvn;
+  gvn.apply(mg);
+
+  BOOST_CHECK_EQUAL(mg.getOps().size(), 2);
+  BOOST_CHECK_EQUAL(sum->inId(AddOp::getArg0InIndex()),
+                    sum->inId(AddOp::getArg1InIndex()));
+}
+
+/*
+  x -- Dropout -- d0 -- Add -- y
+  x -- Dropout -- d1 ----'
+
+  The dropouts draw different masks, so are not merged.
+ */
+BOOST_AUTO_TEST_CASE(TestDoesNotMergeRandomOps) {
+  Ir ir;
+  Graph &g = ir.getMainGraph();
+  g.getTensors().addStream("x", xInfo);
+
+  for (auto out : {"d0", "d1"}) {
+    g.createConnectedOp<DropoutOp>({{DropoutOp::getInIndex(), "x"}},
+                                   {{DropoutOp::getOutIndex(), out}},
+                                   Onnx::Operators::Dropout_10,
+                                   0.5f,
+                                   Op::Settings(g, "dropout"));
+  }
+  add(g, "d0", "d1", "y");
+
+  GlobalValueNumbering gvn;
+  gvn.apply(g);
+
+  BOOST_CHECK_EQUAL(g.getOps().size(), 3);
+  BOOST_CHECK(g.getTensors().contains("d0"));
+  BOOST_CHECK(g.getTensors().contains("d1"));
+}
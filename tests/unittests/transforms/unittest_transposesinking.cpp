@@ -0,0 +1,188 @@
+// Copyright (c) 2022 Graphcore Ltd. All rights reserved.
+#define BOOST_TEST_MODULE TestTransposeSinkingTransform
+#include <boost/test/unit_test.hpp>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <popart/graph.hpp>
+#include <popart/ir.hpp>
+#include <popart/op/add.hpp>
+#include <popart/op/identity.hpp>
+#include <popart/op/matmul.hpp>
+#include <popart/op/reducesum.hpp>
+#include <popart/op/relu.hpp>
+#include <popart/op/transpose.hpp>
+#include <popart/tensorinfo.hpp>
+#include <popart/tensors.hpp>
+#include <popart/transforms/transposesinking.hpp>
+
+#include "popart/datatype.hpp"
+#include "popart/names.hpp"
+#include "popart/op.hpp"
+#include "popart/operators.hpp"
+#include "popart/sessionoptions.hpp"
+#include "popart/tensor.hpp"
+#include "popart/vendored/optional.hpp"
+
+using namespace popart;
+
+namespace {
+
+Op *transpose(Graph &g, TensorId in, TensorId out, const Shape &perm) {
+  return g.createConnectedOp<TransposeOp>(
+      {{TransposeOp::getInIndex(), in}},
+      {{TransposeOp::getOutIndex(), out}},
+      Onnx::Operators::Transpose_1,
+      perm,
+      Op::Settings(g, "transpose"));
+}
+
+std::vector<TransposeOp *> getTransposes(Graph &g) {
+  std::vector<TransposeOp *> transposes;
+  for (auto &id_op : g.getOps()) {
+    if (auto t = dynamic_cast<TransposeOp *>(id_op.second.get())) {
+      transposes.push_back(t);
+    }
+  }
+  return transposes;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(TestTransposeSinkingSessionOption) {
+  auto opts = SessionOptions();
+  BOOST_CHECK(opts.enableTransposeSinking == false);
+}
+
+/*
+  x -- Transpose -- tx -- Relu -- r -- Add -- a -- Transpose -- y
+  w -- Transpose -- tw ----------------'
+
+  The transposes all meet after the Add, and cancel.
+ */
+BOOST_AUTO_TEST_CASE(TestCancelsTransposesAcrossChain) {
+  Ir ir;
+  Graph &g = ir.getMainGraph();
+  g.getTensors().addStream("x", {DataType::FLOAT, Shape{2, 3, 4}});
+  g.getTensors().addStream("w", {DataType::FLOAT, Shape{2, 3, 4}});
+
+  transpose(g, "x", "tx", {1, 2, 0});
+  transpose(g, "w", "tw", {1, 2, 0});
+  auto relu = g.createConnectedOp<ReluOp>({{ReluOp::getInIndex(), "tx"}},
+                                          {{ReluOp::getOutIndex(), "r"}},
+                                          Onnx::Operators::Relu_6,
+                                          Op::Settings(g, "relu"));
+  auto add  = g.createConnectedOp<AddOp>(
+      {{AddOp::getArg0InIndex(), "r"}, {AddOp::getArg1InIndex(), "tw"}},
+      {{AddOp::getOutIndex(), "a"}},
+      Onnx::Operators::Add_7,
+      Op::Settings(g, "add"));
+  transpose(g, "a", "y", {2, 0, 1});
+
+  TransposeSinking sinking;
+  sinking.apply(g);
+
+  BOOST_CHECK_EQUAL(relu->inId(ReluOp::getInIndex()), "x");
+  BOOST_CHECK_EQUAL(add->inId(AddOp::getArg1InIndex()), "w");
+
+  // One transpose remains, which does not change its input.
+  auto transposes = getTransposes(g);
+  BOOST_REQUIRE_EQUAL(transposes.size(), 1);
+  BOOST_CHECK(transposes.front()->canBeReplacedByIdentity());
+  BOOST_CHECK_EQUAL(transposes.front()->outId(TransposeOp::getOutIndex()),
+                    "y");
+  BOOST_CHECK(g.getTensors().get("y")->info.shape() == Shape({2, 3, 4}));
+}
+
+/*
+  x -- Transpose -- t -- ReduceSum -- y
+
+  The reduced axis of t is the last axis of x.
+ */
+BOOST_AUTO_TEST_CASE(TestMovesTransposePastReduce) {
+  Ir ir;
+  Graph &g = ir.getMainGraph();
+  g.getTensors().addStream("x", {DataType::FLOAT, Shape{2, 3, 4}});
+
+  transpose(g, "x", "t", {2, 0, 1});
+  auto reduce = g.createConnectedOp<ReduceSumOp>(
+      {{ReduceSumOp::getInIndex(), "t"}},
+      {{ReduceSumOp::getOutIndex(), "y"}},
+      Onnx::Operators::ReduceSum_11,
+      nonstd::optional<std::vector<int64_t>>{{0}},
+      0,
+      Op::Settings(g, "reduce"));
+
+  TransposeSinking sinking;
+  sinking.apply(g);
+
+  BOOST_CHECK_EQUAL(reduce->inId(ReduceSumOp::getInIndex()), "x");
+  BOOST_CHECK(reduce->getAxes() == std::vector<int64_t>({2}));
+  auto transposes = getTransposes(g);
+  BOOST_REQUIRE_EQUAL(transposes.size(), 1);
+  BOOST_CHECK(transposes.front()->getPerm() == Shape({0, 1}));
+  BOOST_CHECK(g.getTensors().get("y")->info.shape() == Shape({2, 3}));
+}
+
+/*
+  a -- Transpose -- ta -- MatMul -- y
+  b -- Transpose -- tb ----'
+
+  is replaced by b x a, transposed.
+ */
+BOOST_AUTO_TEST_CASE(TestCombinesMatMulOperandTransposes) {
+  Ir ir;
+  Graph &g = ir.getMainGraph();
+  g.getTensors().addStream("a", {DataType::FLOAT, Shape{2, 4, 3}});
+  g.getTensors().addStream("b", {DataType::FLOAT, Shape{2, 5, 4}});
+
+  transpose(g, "a", "ta", {0, 2, 1});
+  transpose(g, "b", "tb", {0, 2, 1});
+  auto matmul = g.createConnectedOp<MatMulOp>(
+      {{MatMulOp::getLhsInIndex(), "ta"}, {MatMulOp::getRhsInIndex(), "tb"}},
+      {{MatMulOp::getOutIndex(), "y"}},
+      Onnx::Operators::MatMul_9,
+      Op::Settings(g, "matmul"),
+      nonstd::nullopt,
+      MatMulOp::SerialiseSettings(),
+      OptionalDataType());
+
+  TransposeSinking sinking;
+  sinking.apply(g);
+
+  BOOST_CHECK_EQUAL(matmul->inId(MatMulOp::getLhsInIndex()), "b");
+  BOOST_CHECK_EQUAL(matmul->inId(MatMulOp::getRhsInIndex()), "a");
+  BOOST_CHECK(matmul->outShape(MatMulOp::getOutIndex()) == Shape({2, 5, 3}));
+  auto transposes = getTransposes(g);
+  BOOST_REQUIRE_EQUAL(transposes.size(), 1);
+  BOOST_CHECK(transposes.front()->getPerm() == Shape({0, 2, 1}));
+  BOOST_CHECK(g.getTensors().get("y")->info.shape() == Shape({2, 3, 5}));
+}
+
+/*
+  x -- Transpose -- t -- Relu -- y
+                    '-- Identity -- z
+
+  t is used twice, so the transpose is not moved.
+ */
+BOOST_AUTO_TEST_CASE(TestDoesNotMoveSharedTranspose) {
+  Ir ir;
+  Graph &g = ir.getMainGraph();
+  g.getTensors().addStream("x", {DataType::FLOAT, Shape{2, 3}});
+
+  transpose(g, "x", "t", {1, 0});
+  auto relu = g.createConnectedOp<ReluOp>({{ReluOp::getInIndex(), "t"}},
+                                          {{ReluOp::getOutIndex(), "y"}},
+                                          Onnx::Operators::Relu_6,
+                                          Op::Settings(g, "relu"));
+  g.createConnectedOp<IdentityOp>({{IdentityOp::getInIndex(), "t"}},
+                                  {{IdentityOp::getOutIndex(), "z"}},
+                                  Onnx::Operators::Identity_1,
+                                  Op::Settings(g, "identity"));
+
+  TransposeSinking sinking;
+  sinking.apply(g);
+
+  BOOST_CHECK_EQUAL(relu->inId(ReluOp::getInIndex()), "t");
+  BOOST_CHECK_EQUAL(getTransposes(g).size(), 1);
+}
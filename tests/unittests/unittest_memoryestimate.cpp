@@ -0,0 +1,109 @@
+// Copyright (c) 2022 Graphcore Ltd. All rights reserved.
+#define BOOST_TEST_MODULE TestMemoryEstimate
+#include <boost/test/unit_test.hpp>
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include <popart/graph.hpp>
+#include <popart/ir.hpp>
+#include <popart/memoryestimate.hpp>
+#include <popart/op/matmul.hpp>
+#include <popart/op/relu.hpp>
+#include <popart/op/reshape.hpp>
+#include <popart/sessionoptions.hpp>
+#include <popart/tensorinfo.hpp>
+#include <popart/tensors.hpp>
+
+#include "popart/datatype.hpp"
+#include "popart/names.hpp"
+#include "popart/op.hpp"
+#include "popart/operators.hpp"
+#include "popart/tensor.hpp"
+#include "popart/tensorlocation.hpp"
+#include "popart/vendored/optional.hpp"
+
+using namespace popart;
+
+namespace {
+
+std::vector<float> wData(16 * 8, 0.5f);
+
+/*
+  x -- MatMul -- m -- Relu -- r -- ReshapeInplace -- y
+  w ----'
+
+  x is 256 bytes, w 512, and m, r and y 128 each.
+ */
+void buildGraph(Graph &g) {
+  g.getTensors().addStream("x", {DataType::FLOAT, Shape{4, 16}});
+  g.getTensors().addVarInit("w", {DataType::FLOAT, Shape{16, 8}}, wData.data());
+
+  g.createConnectedOp<MatMulOp>(
+      {{MatMulOp::getLhsInIndex(), "x"}, {MatMulOp::getRhsInIndex(), "w"}},
+      {{MatMulOp::getOutIndex(), "m"}},
+      Onnx::Operators::MatMul_9,
+      Op::Settings(g, "matmul"),
+      nonstd::nullopt,
+      MatMulOp::SerialiseSettings(),
+      OptionalDataType());
+  g.createConnectedOp<ReluOp>({{ReluOp::getInIndex(), "m"}},
+                              {{ReluOp::getOutIndex(), "r"}},
+                              Onnx::Operators::Relu_6,
+                              Op::Settings(g, "relu"));
+  g.createConnectedOp<ReshapeInplaceOp>(
+      {{ReshapeInplaceOp::getInIndex(), "r"}},
+      {{ReshapeInplaceOp::getOutIndex(), "y"}},
+      Onnx::CustomOperators::ReshapeInplace,
+      Shape{32},
+      Op::Settings(g, "reshape"));
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(TestPeakAndTopContributors) {
+  Ir ir;
+  buildGraph(ir.getMainGraph());
+
+  auto estimate = estimateMemory(ir, 3);
+
+  // x and w are always live, and m and r are live while the Relu runs. y
+  // aliases r, so adds no bytes.
+  BOOST_REQUIRE_EQUAL(estimate.peakBytesPerVirtualGraph.size(), 1);
+  BOOST_CHECK_EQUAL(estimate.peakBytesPerVirtualGraph.at(0), 1024);
+
+  using Contributors = std::vector<MemoryEstimate::Contributor>;
+  BOOST_CHECK(estimate.topContributors.at(0) ==
+              Contributors({{"w", 512}, {"x", 256}, {"m", 128}}));
+
+  BOOST_CHECK(estimate.peakBytesPerPipelineStage.empty());
+  BOOST_CHECK(estimate.peakBytesPerExecutionPhase.empty());
+  BOOST_CHECK_EQUAL(estimate.bytesPerIpu, 0);
+  BOOST_CHECK(estimate.fits());
+}
+
+BOOST_AUTO_TEST_CASE(TestRemoteVariablesAreNotCounted) {
+  Ir ir;
+  buildGraph(ir.getMainGraph());
+  ir.getMainGraph().getTensors().get("w")->tensorLocationInfo.setRemote(true);
+
+  auto estimate = estimateMemory(ir);
+
+  BOOST_CHECK_EQUAL(estimate.peakBytesPerVirtualGraph.at(0), 512);
+  estimate.bytesPerIpu = 256;
+  BOOST_CHECK(!estimate.fits());
+}
+
+BOOST_AUTO_TEST_CASE(TestShardedVariablesCountOneShard) {
+  Ir ir;
+  SessionOptions opts;
+  opts.enableReplicatedGraphs = true;
+  opts.replicatedGraphCount   = 4;
+  ir.setUserOptions(opts);
+  buildGraph(ir.getMainGraph());
+  ir.getMainGraph().getTensors().get("w")->tensorLocationInfo.setSharded(true);
+
+  auto estimate = estimateMemory(ir);
+
+  // w is 512 bytes, so each of the 4 replicas holds 128.
+  BOOST_CHECK_EQUAL(estimate.peakBytesPerVirtualGraph.at(0), 640);
+}
@@ -0,0 +1,63 @@
+// Copyright (c) 2022 Graphcore Ltd. All rights reserved.
+#define BOOST_TEST_MODULE TestOpCost
+#include <boost/test/unit_test.hpp>
+#include <vector>
+#include <popart/graph.hpp>
+#include <popart/ir.hpp>
+#include <popart/op/matmul.hpp>
+#include <popart/op/relu.hpp>
+#include <popart/opcost.hpp>
+#include <popart/tensorinfo.hpp>
+#include <popart/tensors.hpp>
+
+#include "popart/datatype.hpp"
+#include "popart/names.hpp"
+#include "popart/op.hpp"
+#include "popart/operators.hpp"
+#include "popart/vendored/optional.hpp"
+
+using namespace popart;
+
+namespace {
+
+std::vector<float> wData(16 * 8, 0.5f);
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(TestMatMulAndElementwiseCost) {
+  Ir ir;
+  auto &g = ir.getMainGraph();
+
+  g.getTensors().addStream("x", {DataType::FLOAT, Shape{4, 16}});
+  g.getTensors().addVarInit("w", {DataType::FLOAT, Shape{16, 8}}, wData.data());
+
+  auto matmul = g.createConnectedOp<MatMulOp>(
+      {{MatMulOp::getLhsInIndex(), "x"}, {MatMulOp::getRhsInIndex(), "w"}},
+      {{MatMulOp::getOutIndex(), "m"}},
+      Onnx::Operators::MatMul_9,
+      Op::Settings(g, "matmul"),
+      nonstd::nullopt,
+      MatMulOp::SerialiseSettings(),
+      OptionalDataType());
+  auto relu = g.createConnectedOp<ReluOp>({{ReluOp::getInIndex(), "m"}},
+                                          {{ReluOp::getOutIndex(), "r"}},
+                                          Onnx::Operators::Relu_6,
+                                          Op::Settings(g, "relu"));
+
+  // A 4x16 by 16x8 matmul does 4 * 8 * 16 multiply-accumulates, and reads and
+  // writes 256 + 512 + 128 bytes.
+  auto matmulCost = estimateOpCost(matmul);
+  BOOST_CHECK_EQUAL(matmulCost.flops, 2 * 4 * 8 * 16);
+  BOOST_CHECK_EQUAL(matmulCost.bytes, 896);
+
+  // The relu does one operation per element, and is bound by its bytes.
+  auto reluCost = estimateOpCost(relu);
+  BOOST_CHECK_EQUAL(reluCost.flops, 32);
+  BOOST_CHECK_EQUAL(reluCost.bytes, 256);
+  BOOST_CHECK_GT(reluCost.getCost(), reluCost.flops);
+
+  auto total = matmulCost;
+  total += reluCost;
+  BOOST_CHECK_EQUAL(total.flops, matmulCost.flops + reluCost.flops);
+  BOOST_CHECK_EQUAL(total.bytes, 1152);
+}
@@ -0,0 +1,138 @@
+// Copyright (c) 2022 Graphcore Ltd. All rights reserved.
+#define BOOST_TEST_MODULE UnittestWillowPopxWeightTransferEngine
+#include <boost/test/unit_test.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <future>
+#include <stdexcept>
+#include <vector>
+
+#include <popx/weighttransferengine.hpp>
+
+using namespace popart::popx;
+
+namespace {
+
+std::vector<char> pattern(size_t n, char seed) {
+  std::vector<char> v(n);
+  for (size_t i = 0; i < n; ++i) {
+    v[i] = static_cast<char>(seed + i * 7);
+  }
+  return v;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(testCopyChunked) {
+  for (unsigned numThreads : {1u, 2u, 4u}) {
+    // Small chunks so that every job is split, with sizes that are not a
+    // multiple of the chunk size.
+    WeightTransferEngine engine(numThreads, 10);
+    BOOST_CHECK_EQUAL(engine.getNumThreads(), numThreads);
+
+    std::vector<std::vector<char>> srcs{
+        pattern(0, 1), pattern(1, 2), pattern(10, 3), pattern(1001, 4)};
+    std::vector<std::vector<char>> dsts;
+    std::vector<HostCopyJob> jobs;
+    for (const auto &src : srcs) {
+      dsts.emplace_back(src.size(), 0);
+      jobs.push_back({dsts.back().data(), src.data(), src.size()});
+    }
+    engine.copy(jobs);
+
+    for (size_t i = 0; i < srcs.size(); ++i) {
+      BOOST_CHECK(srcs[i] == dsts[i]);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(testAsyncInlineWithOneThread) {
+  WeightTransferEngine engine(1);
+  bool ran    = false;
+  auto future = engine.async([&ran]() { ran = true; });
+  // With no workers the task has already run on this thread.
+  BOOST_CHECK(ran);
+  future.get();
+}
+
+BOOST_AUTO_TEST_CASE(testWaitAllRethrows) {
+  WeightTransferEngine engine(4);
+  std::atomic<int> completed{0};
+  std::vector<std::future<void>> futures;
+  for (int i = 0; i < 16; ++i) {
+    futures.push_back(engine.async([i, &completed]() {
+      if (i == 3) {
+        throw std::runtime_error("task failed");
+      }
+      ++completed;
+    }));
+  }
+  BOOST_CHECK_THROW(WeightTransferEngine::waitAll(futures), std::runtime_error);
+  // All the other tasks were still waited for.
+  BOOST_CHECK_EQUAL(completed.load(), 15);
+  BOOST_CHECK(futures.empty());
+}
+
+BOOST_AUTO_TEST_CASE(testBufferPool) {
+  WeightTransferEngine engine(2);
+  BOOST_CHECK_EQUAL(engine.getMaxBuffers(), 3);
+  BOOST_CHECK_EQUAL(engine.getNumPooledBuffers(), 0);
+
+  const char *first = nullptr;
+  {
+    auto buffer = engine.acquireBuffer(100, false);
+    BOOST_CHECK_EQUAL(buffer->size(), 100);
+    first = buffer->data();
+    std::fill(buffer->begin(), buffer->end(), 1);
+  }
+  BOOST_CHECK_EQUAL(engine.getNumPooledBuffers(), 1);
+
+  // The released buffer is reused, and zeroed on request.
+  {
+    auto buffer = engine.acquireBuffer(50, true);
+    BOOST_CHECK_EQUAL(buffer->size(), 50);
+    BOOST_CHECK(buffer->data() == first);
+    for (char c : *buffer) {
+      BOOST_CHECK_EQUAL(c, 0);
+    }
+    BOOST_CHECK_EQUAL(engine.getNumPooledBuffers(), 0);
+  }
+
+  // Acquiring more than the maximum blocks until a buffer is released.
+  std::vector<WeightTransferEngine::Buffer> held;
+  for (unsigned i = 0; i < engine.getMaxBuffers(); ++i) {
+    held.push_back(engine.acquireBuffer(8, false));
+  }
+  auto blocked = std::async(std::launch::async,
+                            [&engine]() { engine.acquireBuffer(8, false); });
+  BOOST_CHECK(blocked.wait_for(std::chrono::milliseconds(50)) ==
+              std::future_status::timeout);
+  held.pop_back();
+  blocked.get();
+}
+
+BOOST_AUTO_TEST_CASE(testAsyncReleasesCapturedBuffers) {
+  // Like Devicex::remoteBufferWeightsToHost: acquire a staging buffer per
+  // group and hand it to a task, only waiting for the tasks at the end. This
+  // must not block on more groups than there are buffers.
+  for (unsigned numThreads : {1u, 2u}) {
+    WeightTransferEngine engine(numThreads);
+    const unsigned numGroups = engine.getMaxBuffers() * 4;
+
+    std::vector<char> out(numGroups, 0);
+    std::vector<std::future<void>> pending;
+    for (unsigned group = 0; group < numGroups; ++group) {
+      auto tmp       = engine.acquireBuffer(1, false);
+      (*tmp)[0]      = static_cast<char>(group + 1);
+      char *dst      = &out[group];
+      pending.push_back(engine.async([tmp, dst]() { *dst = (*tmp)[0]; }));
+    }
+    WeightTransferEngine::waitAll(pending);
+
+    for (unsigned group = 0; group < numGroups; ++group) {
+      BOOST_CHECK_EQUAL(out[group], static_cast<char>(group + 1));
+    }
+    BOOST_CHECK_LE(engine.getNumPooledBuffers(), engine.getMaxBuffers());
+  }
+}
@@ -0,0 +1,159 @@
+// Copyright (c) 2022 Graphcore Ltd. All rights reserved.
+#define BOOST_TEST_MODULE unittest_batchcompile
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "boost/test/unit_test.hpp"
+#include "popart/batchcompile.hpp"
+#include "popart/error.hpp"
+#include "popart/tensorinfo.hpp"
+
+using namespace popart;
+
+namespace {
+
+std::vector<batchcompile::Variant> read(const std::string &json) {
+  std::stringstream ss(json);
+  return batchcompile::readVariants(ss);
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(testReadVariants) {
+  const auto variants = read(R"({
+    "defaults": {
+      "sessionOptions": {
+        "enableOutlining": false,
+        "engineOptions": {"opt.enableInlining": "true"}
+      },
+      "device": {"numIPUs": "1", "ipuVersion": "ipu2"}
+    },
+    "variants": [
+      {
+        "name": "small",
+        "sessionOptions": {
+          "enableReplicatedGraphs": true,
+          "replicatedGraphCount": 2,
+          "virtualGraphMode": "Manual",
+          "engineOptions": {"debug.instrument": "false"}
+        },
+        "dataFlow": {
+          "batchesPerStep": 4,
+          "anchors": {
+            "out": "All",
+            "loss": {"type": "EveryN", "returnPeriod": 2}
+          }
+        },
+        "inputShapeInfo": {
+          "in.0": {"dataType": "FLOAT16", "shape": [16, 128]}
+        },
+        "patterns": "Minimal"
+      },
+      {
+        "sessionOptions": {"enableOutlining": true},
+        "device": {"numIPUs": "2"}
+      }
+    ]
+  })");
+  BOOST_REQUIRE_EQUAL(variants.size(), 2);
+
+  const auto &small = variants[0];
+  BOOST_CHECK_EQUAL(small.name, "small");
+  BOOST_CHECK(small.options.enableEngineCaching);
+  BOOST_CHECK(!small.options.enableOutlining);
+  BOOST_CHECK(small.options.enableReplicatedGraphs);
+  BOOST_CHECK_EQUAL(small.options.replicatedGraphCount, 2);
+  BOOST_CHECK(small.options.virtualGraphMode == VirtualGraphMode::Manual);
+  // Maps are merged with the defaults.
+  BOOST_CHECK_EQUAL(small.options.engineOptions.size(), 2);
+  BOOST_CHECK_EQUAL(small.options.engineOptions.at("opt.enableInlining"),
+                    "true");
+  BOOST_CHECK_EQUAL(small.options.engineOptions.at("debug.instrument"),
+                    "false");
+
+  BOOST_CHECK_EQUAL(small.dataFlow.batchesPerStep(), 4);
+  BOOST_CHECK(small.dataFlow.art("out").id() == AnchorReturnTypeId::All);
+  BOOST_CHECK(small.dataFlow.art("loss").id() == AnchorReturnTypeId::EveryN);
+  BOOST_CHECK_EQUAL(small.dataFlow.art("loss").rp(), 2);
+
+  BOOST_CHECK(small.inputShapeInfo.get("in.0") ==
+              TensorInfo(DataType::FLOAT16, {16, 128}));
+  BOOST_CHECK(small.patterns == Patterns(PatternsLevel::Minimal));
+  BOOST_CHECK_EQUAL(small.deviceOptions.at("numIPUs"), "1");
+  BOOST_CHECK_EQUAL(small.deviceOptions.at("ipuVersion"), "ipu2");
+
+  // Unnamed variants are named by their position.
+  const auto &other = variants[1];
+  BOOST_CHECK_EQUAL(other.name, "1");
+  BOOST_CHECK(other.options.enableOutlining);
+  BOOST_CHECK(other.patterns == Patterns(PatternsLevel::Default));
+  BOOST_CHECK_EQUAL(other.deviceOptions.at("numIPUs"), "2");
+}
+
+BOOST_AUTO_TEST_CASE(testReadNestedSettings) {
+  const auto variants = read(R"({
+    "defaults": {
+      "sessionOptions": {
+        "batchSerializationSettings": {"method": "Loop"},
+        "tensorLocationPlannerSettings": {"enabled": true}
+      }
+    },
+    "variants": [
+      {
+        "sessionOptions": {
+          "autoRecomputation": "MemoryBudget",
+          "autoRecomputationMemoryBudget": 1000000,
+          "autocastSettings": {"enabled": true, "allowOpTypes": ["MatMul"]},
+          "autoVirtualGraphSettings": {"balanceStages": true},
+          "batchSerializationSettings": {"memoryBudget": 2000000},
+          "tensorLocationPlannerSettings": {"memoryBudget": 3000000}
+        }
+      }
+    ]
+  })");
+  BOOST_REQUIRE_EQUAL(variants.size(), 1);
+
+  const auto &options = variants[0].options;
+  BOOST_CHECK(options.autoRecomputation == RecomputationType::MemoryBudget);
+  BOOST_CHECK_EQUAL(options.autoRecomputationMemoryBudget, 1000000);
+  BOOST_CHECK(options.autocastSettings.enabled);
+  BOOST_CHECK(options.autocastSettings.allowOpTypes ==
+              std::vector<std::string>{"MatMul"});
+  BOOST_CHECK(options.autoVirtualGraphSettings.balanceStages);
+  // Settings structs are merged with the defaults field by field.
+  BOOST_CHECK(options.batchSerializationSettings.method ==
+              BatchSerializationMethod::Loop);
+  BOOST_CHECK_EQUAL(options.batchSerializationSettings.memoryBudget, 2000000);
+  BOOST_CHECK(options.tensorLocationPlannerSettings.enabled);
+  BOOST_CHECK_EQUAL(options.tensorLocationPlannerSettings.memoryBudget,
+                    3000000);
+}
+
+BOOST_AUTO_TEST_CASE(testReadVariantsErrors) {
+  BOOST_CHECK_THROW(read("{"), popart::error);
+  BOOST_CHECK_THROW(read(R"({"variants": []})"), popart::error);
+  BOOST_CHECK_THROW(
+      read(R"({"variants": [{"name": "a"}, {"name": "a"}]})"), popart::error);
+  BOOST_CHECK_THROW(
+      read(R"({"variants": [{"sessionOptions": {"notAnOption": 1}}]})"),
+      popart::error);
+  BOOST_CHECK_THROW(
+      read(R"({"variants": [{"sessionOptions": {"enableOutlining": "x"}}]})"),
+      popart::error);
+  BOOST_CHECK_THROW(
+      read(R"({"variants": [{"sessionOptions": {"virtualGraphMode": "x"}}]})"),
+      popart::error);
+  BOOST_CHECK_THROW(read(R"({"variants": [{"sessionOptions": {
+                      "autocastSettings": {"notAField": true}}}]})"),
+                    popart::error);
+  BOOST_CHECK_THROW(read(R"({"variants": [{"sessionOptions": {
+                      "autocastSettings": {"enabled": "x"}}}]})"),
+                    popart::error);
+  BOOST_CHECK_THROW(read(R"({"variants": [{"patterns": "Some"}]})"),
+                    popart::error);
+  BOOST_CHECK_THROW(
+      read(R"({"variants": [{"inputShapeInfo": {"in": {"shape": [1]}}}]})"),
+      popart::error);
+}
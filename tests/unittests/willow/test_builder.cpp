@@ -293,3 +293,62 @@ BOOST_AUTO_TEST_CASE(Builder_UpdateAvailableMemoryProportion) {
       builder->getFloatNodeAttribute(sAvailMemAttribute, {output});
   BOOST_CHECK_EQUAL(actualMemoryProp, newValue);
 }
+
+BOOST_AUTO_TEST_CASE(Builder_LookupsFollowGraphChanges) {
+  // The builder indexes the inputs, value infos, initializers and nodes of its
+  // graph by name. Check that lookups stay correct when the graph is changed
+  // after earlier lookups, both by adding to it and by replacing it.
+  auto builder = Builder::create();
+  auto aiOnnx  = builder->aiOnnxOpset9();
+  auto a       = builder->addInputTensor("FLOAT", {2, 3}, "a");
+  auto b       = builder->addInputTensor("FLOAT", {2, 3}, "b");
+  auto c       = builder->addInputTensor("FLOAT", {2, 3}, "c");
+
+  // Reshape is shape inferred on a model of its own, which takes the shape
+  // from the initializer.
+  Shape shape0            = {3, 2};
+  ConstVoidData shapeData = {shape0.data(), {"INT64", Shape{2}}};
+  auto shapeId = builder->addInitializedInputTensor(shapeData, "shape");
+  auto r0      = aiOnnx.reshape({a, shapeId});
+  check_equal(builder->getTensorShape(r0), {3, 2});
+
+  // Then from a Constant node added after the first lookups.
+  Shape flat             = {6};
+  ConstVoidData flatData = {flat.data(), {"INT64", Shape{1}}};
+  auto flatId            = aiOnnx.constant(flatData, "flat");
+  auto r1                = aiOnnx.reshape({b, flatId});
+  check_equal(builder->getTensorShape(r1), {6});
+  check_equal(builder->getTensorShape(r0), {3, 2});
+  check_equal(builder->getTensorShape(c), {2, 3});
+  BOOST_CHECK(builder->isInitializer(shapeId));
+  BOOST_CHECK(!builder->isInitializer(flatId));
+
+  // Replace the graph with one that has as many inputs, with the same first
+  // and last names, but with a different input in between.
+  auto other     = Builder::create();
+  auto otherOnnx = other->aiOnnxOpset9();
+  auto otherA    = other->addInputTensor("FLOAT", {4}, "a");
+  auto x         = other->addInputTensor("FLOAT", {4}, "x");
+  auto otherC    = other->addInputTensor("FLOAT", {4}, "c");
+
+  Shape shape1                 = {2, 2};
+  ConstVoidData otherShapeData = {shape1.data(), {"INT64", Shape{2}}};
+  auto otherShapeId = other->addInitializedInputTensor(otherShapeData, "shape");
+  otherOnnx.add({otherA, x});
+  BOOST_REQUIRE_EQUAL(a, otherA);
+  BOOST_REQUIRE_EQUAL(c, otherC);
+  BOOST_REQUIRE_EQUAL(shapeId, otherShapeId);
+
+  builder->loadModelProto(other->getModelProto());
+  BOOST_CHECK(builder->hasValueInfo(x));
+  BOOST_CHECK(!builder->hasValueInfo(b));
+  BOOST_CHECK(!builder->hasValueInfo(r0));
+  BOOST_CHECK(!builder->hasValueInfo(r1));
+  check_equal(builder->getTensorShape(a), {4});
+  check_equal(builder->getTensorShape(x), {4});
+  BOOST_CHECK(builder->isInitializer(shapeId));
+
+  // Shape inference after the replacement uses the new initializer.
+  auto r2 = aiOnnx.reshape({x, shapeId});
+  check_equal(builder->getTensorShape(r2), {2, 2});
+}
@@ -0,0 +1,216 @@
+// Copyright (c) 2022 Graphcore Ltd. All rights reserved.
+#define BOOST_TEST_MODULE unittest_enginecache
+
+#include <boost/filesystem.hpp>
+#include <chrono>
+#include <cstddef>
+#include <fstream>
+#include <ostream>
+#include <string>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+
+#include "boost/test/unit_test.hpp"
+#include "popart/enginecache.hpp"
+
+using namespace popart;
+
+namespace {
+
+struct TmpDir {
+  TmpDir()
+      : path(boost::filesystem::temp_directory_path() /
+             boost::filesystem::unique_path("enginecache-%%%%-%%%%")) {}
+  ~TmpDir() { boost::filesystem::remove_all(path); }
+  std::string str() const { return path.string(); }
+  boost::filesystem::path path;
+};
+
+void publish(EngineCache &cache, size_t hash, size_t nbytes) {
+  cache.publish(hash, [nbytes](std::ostream &out) {
+    out << std::string(nbytes, 'x');
+  });
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(testPublishAndEntries) {
+  TmpDir dir;
+  EngineCache cache(dir.str(), 0);
+  BOOST_CHECK(cache.getEntries().empty());
+
+  publish(cache, 1, 100);
+  publish(cache, 2, 200);
+
+  const auto entries = cache.getEntries();
+  BOOST_REQUIRE_EQUAL(entries.size(), 2);
+  BOOST_CHECK_EQUAL(entries.at(1), cache.getEntryPath(1));
+  BOOST_CHECK_EQUAL(boost::filesystem::file_size(entries.at(2)), 200);
+
+  // Only the executables, the index and its lock are left in the directory.
+  for (auto &file : boost::filesystem::directory_iterator(dir.path)) {
+    BOOST_CHECK(file.path().string().find(".tmp") == std::string::npos);
+  }
+
+  // Entries whose file has been removed are skipped.
+  boost::filesystem::remove(entries.at(1));
+  BOOST_CHECK_EQUAL(cache.getEntries().count(1), 0);
+
+  // A failed write leaves nothing behind.
+  BOOST_CHECK_THROW(cache.publish(3,
+                                  [](std::ostream &) {
+                                    throw std::runtime_error("failed");
+                                  }),
+                    std::runtime_error);
+  BOOST_CHECK_EQUAL(cache.getEntries().count(3), 0);
+  BOOST_CHECK(!boost::filesystem::exists(cache.getEntryPath(3)));
+}
+
+BOOST_AUTO_TEST_CASE(testIndexBuiltFromExistingFiles) {
+  TmpDir dir;
+  boost::filesystem::create_directories(dir.path);
+  std::ofstream(dir.str() + "/1234.popef") << "executable";
+  std::ofstream(dir.str() + "/notes.txt") << "not an executable";
+
+  EngineCache cache(dir.str(), 0);
+  const auto entries = cache.getEntries();
+  BOOST_REQUIRE_EQUAL(entries.size(), 1);
+  BOOST_CHECK_EQUAL(entries.begin()->first, 1234);
+  BOOST_CHECK(
+      boost::filesystem::exists(dir.path / EngineCache::indexFileName));
+}
+
+BOOST_AUTO_TEST_CASE(testLruEviction) {
+  TmpDir dir;
+  EngineCache cache(dir.str(), 250);
+
+  publish(cache, 1, 100);
+  publish(cache, 2, 100);
+  // Using 1 makes 2 the least recently used.
+  cache.recordHit(1);
+  publish(cache, 3, 100);
+
+  auto entries = cache.getEntries();
+  BOOST_CHECK_EQUAL(entries.size(), 2);
+  BOOST_CHECK_EQUAL(entries.count(1), 1);
+  BOOST_CHECK_EQUAL(entries.count(2), 0);
+  BOOST_CHECK(!boost::filesystem::exists(cache.getEntryPath(2)));
+
+  // The executable just published is kept even if it is over budget alone.
+  publish(cache, 4, 1000);
+  entries = cache.getEntries();
+  BOOST_CHECK_EQUAL(entries.size(), 1);
+  BOOST_CHECK_EQUAL(entries.count(4), 1);
+
+  cache.recordMiss(5);
+  const auto statistics = cache.getStatistics();
+  BOOST_CHECK_EQUAL(statistics.hits, 1);
+  BOOST_CHECK_EQUAL(statistics.misses, 1);
+  BOOST_CHECK_EQUAL(statistics.evictions, 3);
+  BOOST_CHECK_EQUAL(statistics.numEntries, 1);
+  BOOST_CHECK_EQUAL(statistics.totalBytes, 1000);
+}
+
+BOOST_AUTO_TEST_CASE(testCompileLockAcrossProcesses) {
+  TmpDir dir;
+  EngineCache cache(dir.str(), 0);
+
+  auto lock = cache.lockForCompile(7);
+  BOOST_REQUIRE(lock.owns());
+  BOOST_CHECK(!lock.waited());
+
+  const pid_t child = fork();
+  BOOST_REQUIRE(child >= 0);
+  if (child == 0) {
+    // The child must wait for the parent to publish the executable.
+    EngineCache childCache(dir.str(), 0);
+    auto childLock = childCache.lockForCompile(7);
+    const bool ok  = childLock.owns() && childLock.waited() &&
+                    childCache.getEntries().count(7) == 1;
+    _exit(ok ? 0 : 1);
+  }
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(200));
+  publish(cache, 7, 10);
+  lock.release();
+  BOOST_CHECK(!lock.owns());
+
+  int status = 0;
+  BOOST_REQUIRE_EQUAL(waitpid(child, &status, 0), child);
+  BOOST_CHECK(WIFEXITED(status));
+  BOOST_CHECK_EQUAL(WEXITSTATUS(status), 0);
+
+  // Publishing removes the lock file, and a process taking the lock afresh is
+  // still told to look in the cache again.
+  BOOST_CHECK(!boost::filesystem::exists(dir.path / "7.compile.lock"));
+  auto laterLock = cache.lockForCompile(7);
+  BOOST_CHECK(laterLock.owns());
+  BOOST_CHECK(laterLock.waited());
+  laterLock.release();
+
+  // Evicting an executable removes its lock file.
+  EngineCache smallCache(dir.str(), 15);
+  smallCache.lockForCompile(7).release();
+  BOOST_CHECK(boost::filesystem::exists(dir.path / "7.compile.lock"));
+  publish(smallCache, 8, 10);
+  BOOST_CHECK_EQUAL(smallCache.getEntries().count(7), 0);
+  BOOST_CHECK(!boost::filesystem::exists(dir.path / "7.compile.lock"));
+}
+
+BOOST_AUTO_TEST_CASE(testFingerprintsExplainMisses) {
+  TmpDir dir;
+  EngineCache cache(dir.str(), 250);
+
+  const EngineCache::Fingerprint fingerprint1{{"dataFlow", 1},
+                                              {"graph(main)", 2},
+                                              {"graph(main).opNames", 3},
+                                              {"optimizer", 4}};
+  auto fingerprint2                                 = fingerprint1;
+  fingerprint2["graph(main)"]                       = 5;
+  fingerprint2["graph(main).ops(ai.onnx.MatMul:9)"] = 6;
+  fingerprint2["optimizer"]                         = 7;
+
+  const auto write = [](std::ostream &out) { out << std::string(100, 'x'); };
+
+  BOOST_CHECK(!cache.explainMiss(fingerprint1));
+  cache.publish(1, write, fingerprint1);
+  cache.publish(2, write, fingerprint2);
+  // Executables published without a fingerprint are not compared with.
+  publish(cache, 3, 10);
+
+  BOOST_REQUIRE(cache.getFingerprint(1));
+  BOOST_CHECK(*cache.getFingerprint(1) == fingerprint1);
+  BOOST_CHECK(!cache.getFingerprint(3));
+
+  // Only the op names differ from the first executable.
+  auto fingerprint                   = fingerprint1;
+  fingerprint["graph(main).opNames"] = 8;
+  auto explanation                   = cache.explainMiss(fingerprint);
+  BOOST_REQUIRE(explanation);
+  BOOST_CHECK_EQUAL(explanation->nearestHash, 1);
+  BOOST_REQUIRE_EQUAL(explanation->changed.size(), 1);
+  BOOST_CHECK_EQUAL(explanation->changed.front(), "graph(main).opNames");
+  BOOST_CHECK(explanation->added.empty());
+  BOOST_CHECK(explanation->removed.empty());
+
+  // Nearest to the second executable, without the op names.
+  fingerprint = fingerprint2;
+  fingerprint.erase("graph(main).opNames");
+  fingerprint["dataFlow"] = 9;
+  explanation             = cache.explainMiss(fingerprint);
+  BOOST_REQUIRE(explanation);
+  BOOST_CHECK_EQUAL(explanation->nearestHash, 2);
+  BOOST_CHECK(explanation->changed == std::vector<std::string>{"dataFlow"});
+  BOOST_CHECK(explanation->removed ==
+              std::vector<std::string>{"graph(main).opNames"});
+
+  // Evicting an executable removes its fingerprint.
+  cache.publish(4, write, fingerprint1);
+  BOOST_CHECK_EQUAL(cache.getEntries().count(1), 0);
+  BOOST_CHECK(!boost::filesystem::exists(cache.getFingerprintPath(1)));
+
+  // Fingerprints are not mistaken for executables when the index is rebuilt.
+  boost::filesystem::remove(dir.path / EngineCache::indexFileName);
+  BOOST_CHECK_EQUAL(cache.getEntries().size(), 3);
+}
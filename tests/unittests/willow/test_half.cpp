@@ -0,0 +1,153 @@
+// Copyright (c) 2022 Graphcore Ltd. All rights reserved.
+#define BOOST_TEST_MODULE unittest_half
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <halfconversion.hpp>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "boost/test/unit_test.hpp"
+#include "popart/half.hpp"
+
+using namespace popart;
+using halfconversion::Isa;
+
+namespace {
+
+const std::vector<Isa> allIsas{Isa::Scalar, Isa::F16C, Isa::Avx512};
+
+uint32_t bits(float f) {
+  uint32_t u;
+  std::memcpy(&u, &f, sizeof(u));
+  return u;
+}
+
+float fromBits(uint32_t u) {
+  float f;
+  std::memcpy(&f, &u, sizeof(f));
+  return f;
+}
+
+// Every half bit pattern, in an odd-sized buffer to exercise the tails of the
+// vectorised loops.
+std::vector<uint16_t> allHalfValues() {
+  std::vector<uint16_t> hs(65536 + 7);
+  for (size_t i = 0; i < hs.size(); ++i) {
+    hs[i] = static_cast<uint16_t>(i);
+  }
+  return hs;
+}
+
+// Floats covering the normal, subnormal, overflow and rounding boundary cases
+// of the half range, plus random bit patterns.
+std::vector<float> interestingFloats() {
+  std::vector<float> fs{0.0f,
+                        -0.0f,
+                        1.0f,
+                        65504.0f,
+                        65519.99f,
+                        65520.0f,
+                        1e-8f,
+                        5.96e-8f,
+                        2.98e-8f,
+                        6.1035156e-5f,
+                        std::numeric_limits<float>::infinity(),
+                        -std::numeric_limits<float>::infinity(),
+                        std::numeric_limits<float>::denorm_min()};
+  // Halfway points between consecutive halves round to even.
+  for (uint32_t u = 0x38000000; u < 0x47800000; u += 0x1000) {
+    fs.push_back(fromBits(u));
+    fs.push_back(-fromBits(u + 0x7ff));
+  }
+  std::mt19937 rng(1);
+  for (int i = 0; i < 100000; ++i) {
+    float f = fromBits(static_cast<uint32_t>(rng()));
+    if (!std::isnan(f)) {
+      fs.push_back(f);
+    }
+  }
+  return fs;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(testScalarKnownValues) {
+  BOOST_CHECK_EQUAL(floatToHalf(0.0f), 0x0000);
+  BOOST_CHECK_EQUAL(floatToHalf(-0.0f), 0x8000);
+  BOOST_CHECK_EQUAL(floatToHalf(1.0f), 0x3c00);
+  BOOST_CHECK_EQUAL(floatToHalf(-2.0f), 0xc000);
+  BOOST_CHECK_EQUAL(floatToHalf(65504.0f), 0x7bff);
+  BOOST_CHECK_EQUAL(floatToHalf(65520.0f), 0x7c00);
+  BOOST_CHECK_EQUAL(floatToHalf(1e6f), 0x7c00);
+  // Smallest subnormal half, and ties to even either side of it.
+  BOOST_CHECK_EQUAL(floatToHalf(std::ldexp(1.0f, -24)), 0x0001);
+  BOOST_CHECK_EQUAL(floatToHalf(std::ldexp(1.0f, -25)), 0x0000);
+  BOOST_CHECK_EQUAL(floatToHalf(std::ldexp(3.0f, -25)), 0x0002);
+  // 1 + 2^-11 is halfway between 1 and the next half, rounds to even (1).
+  BOOST_CHECK_EQUAL(floatToHalf(1.0f + std::ldexp(1.0f, -11)), 0x3c00);
+  BOOST_CHECK_EQUAL(floatToHalf(1.0f + 3 * std::ldexp(1.0f, -11)), 0x3c02);
+  BOOST_CHECK(std::isnan(halfToFloat(floatToHalf(std::nanf("")))));
+
+  BOOST_CHECK_EQUAL(halfToFloat(0x3c00), 1.0f);
+  BOOST_CHECK_EQUAL(halfToFloat(0x7bff), 65504.0f);
+  BOOST_CHECK_EQUAL(halfToFloat(0x0001), std::ldexp(1.0f, -24));
+  BOOST_CHECK_EQUAL(halfToFloat(0x7c00),
+                    std::numeric_limits<float>::infinity());
+}
+
+BOOST_AUTO_TEST_CASE(testScalarRoundTrip) {
+  for (uint32_t i = 0; i < 65536; ++i) {
+    const auto h  = static_cast<uint16_t>(i);
+    const float f = halfToFloat(h);
+    if (std::isnan(f)) {
+      BOOST_CHECK_EQUAL(floatToHalf(f) & 0x7c00, 0x7c00);
+    } else {
+      BOOST_CHECK_EQUAL(floatToHalf(f), h);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(testBulkHalfToFloatMatchesScalar) {
+  const auto hs = allHalfValues();
+  for (auto isa : allIsas) {
+    if (!halfconversion::isSupported(isa)) {
+      BOOST_TEST_MESSAGE("Skipping unsupported "
+                         << halfconversion::toString(isa));
+      continue;
+    }
+    std::vector<float> fs(hs.size());
+    halfconversion::halfToFloat(isa, hs.data(), fs.data(), hs.size());
+    for (size_t i = 0; i < hs.size(); ++i) {
+      BOOST_REQUIRE_EQUAL(bits(fs[i]), bits(halfToFloat(hs[i])));
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(testBulkFloatToHalfMatchesScalar) {
+  const auto fs = interestingFloats();
+  for (auto isa : allIsas) {
+    if (!halfconversion::isSupported(isa)) {
+      BOOST_TEST_MESSAGE("Skipping unsupported "
+                         << halfconversion::toString(isa));
+      continue;
+    }
+    std::vector<uint16_t> hs(fs.size());
+    halfconversion::floatToHalf(isa, fs.data(), hs.data(), fs.size());
+    for (size_t i = 0; i < fs.size(); ++i) {
+      BOOST_REQUIRE_EQUAL(hs[i], floatToHalf(fs[i]));
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(testBulkHostIsa) {
+  const std::vector<float> fs{0.5f, -3.25f, 1024.0f};
+  std::vector<uint16_t> hs(fs.size());
+  std::vector<float> back(fs.size());
+  floatToHalf(fs.data(), hs.data(), fs.size());
+  halfToFloat(hs.data(), back.data(), hs.size());
+  BOOST_CHECK_EQUAL_COLLECTIONS(fs.begin(), fs.end(), back.begin(), back.end());
+  BOOST_CHECK(halfconversion::isSupported(halfconversion::getHostIsa()));
+}
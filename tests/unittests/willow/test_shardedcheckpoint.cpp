@@ -0,0 +1,167 @@
+// Copyright (c) 2022 Graphcore Ltd. All rights reserved.
+#define BOOST_TEST_MODULE unittest_shardedcheckpoint
+
+#include <boost/filesystem.hpp>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "boost/test/unit_test.hpp"
+#include "popart/error.hpp"
+#include "popart/shardedcheckpoint.hpp"
+#include "popart/tensorinfo.hpp"
+
+using namespace popart;
+
+namespace {
+
+struct TmpDir {
+  TmpDir()
+      : path(boost::filesystem::temp_directory_path() /
+             boost::filesystem::unique_path("shardedcheckpoint-%%%%-%%%%")) {}
+  ~TmpDir() { boost::filesystem::remove_all(path); }
+  std::string str() const { return path.string(); }
+  boost::filesystem::path path;
+};
+
+std::vector<float> iota(size_t n, float start) {
+  std::vector<float> v(n);
+  for (size_t i = 0; i < n; ++i) {
+    v[i] = start + static_cast<float>(i);
+  }
+  return v;
+}
+
+// Builds sources for `data`, optionally splitting each tensor into two
+// segments to mimic grouped weights.
+std::vector<shardedcheckpoint::Source>
+makeSources(const std::map<TensorId, std::vector<float>> &data, bool split) {
+  std::vector<shardedcheckpoint::Source> sources;
+  for (const auto &tensor : data) {
+    const auto n     = static_cast<int64_t>(tensor.second.size());
+    const auto bytes = reinterpret_cast<const char *>(tensor.second.data());
+    shardedcheckpoint::Source source;
+    source.id   = tensor.first;
+    source.info = TensorInfo(DataType::FLOAT, {n});
+    if (split && n > 1) {
+      const size_t half = n / 2 * sizeof(float);
+      const size_t rest = n * sizeof(float) - half;
+
+      source.segments = {{bytes, half}, {bytes + half, rest}};
+    } else {
+      source.segments = {{bytes, n * sizeof(float)}};
+    }
+    sources.push_back(source);
+  }
+  return sources;
+}
+
+void checkReader(const shardedcheckpoint::Reader &reader,
+                 const std::map<TensorId, std::vector<float>> &data) {
+  BOOST_CHECK_EQUAL(reader.getEntries().size(), data.size());
+  for (const auto &tensor : data) {
+    BOOST_REQUIRE(reader.contains(tensor.first));
+    auto mvd = reader.weight(tensor.first);
+    BOOST_CHECK_EQUAL(mvd.info.nelms(), tensor.second.size());
+    BOOST_CHECK_EQUAL(reinterpret_cast<uintptr_t>(mvd.data) %
+                          shardedcheckpoint::tensorAlignment,
+                      0);
+    const auto *values = static_cast<const float *>(mvd.data);
+    BOOST_CHECK_EQUAL_COLLECTIONS(values,
+                                  values + tensor.second.size(),
+                                  tensor.second.begin(),
+                                  tensor.second.end());
+  }
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(testRoundTrip) {
+  const std::map<TensorId, std::vector<float>> data{
+      {"w0", iota(1000, 0.0f)},
+      {"w1", iota(3, 10.0f)},
+      {"w2", iota(17, -5.0f)},
+      {"w3", iota(4096, 1.0f)},
+      {"a/b:c \"quoted\"", iota(1, 42.0f)}};
+
+  for (unsigned numShards : {0u, 1u, 2u, 5u}) {
+    for (bool split : {false, true}) {
+      TmpDir dir;
+      const auto entries = shardedcheckpoint::write(
+          dir.str(), makeSources(data, split), numShards, 2);
+      BOOST_CHECK_EQUAL(entries.size(), data.size());
+      BOOST_CHECK(shardedcheckpoint::isShardedCheckpoint(dir.str()));
+
+      shardedcheckpoint::Reader reader(dir.str());
+      if (numShards != 0) {
+        BOOST_CHECK_EQUAL(reader.getNumShards(), numShards);
+      }
+      checkReader(reader, data);
+      BOOST_CHECK(!reader.contains("missing"));
+      BOOST_CHECK_THROW(reader.weight("missing"), popart::error);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(testShardsBalanced) {
+  std::map<TensorId, std::vector<float>> data;
+  for (int i = 0; i < 8; ++i) {
+    data["w" + std::to_string(i)] = iota(1024, i);
+  }
+  TmpDir dir;
+  shardedcheckpoint::write(dir.str(), makeSources(data, false), 4, 4);
+
+  shardedcheckpoint::Reader reader(dir.str());
+  std::vector<int> perShard(4, 0);
+  for (const auto &entry : reader.getEntries()) {
+    perShard.at(entry.shard)++;
+  }
+  for (auto n : perShard) {
+    BOOST_CHECK_EQUAL(n, 2);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(testOverwriteAndErrors) {
+  TmpDir dir;
+  BOOST_CHECK(!shardedcheckpoint::isShardedCheckpoint(dir.str()));
+  BOOST_CHECK_THROW(shardedcheckpoint::Reader reader(dir.str()),
+                    popart::error);
+
+  std::map<TensorId, std::vector<float>> data{{"w", iota(100, 0.0f)}};
+  shardedcheckpoint::write(dir.str(), makeSources(data, false), 1, 1);
+  data["w"] = iota(100, 7.0f);
+  shardedcheckpoint::write(dir.str(), makeSources(data, false), 1, 1);
+  checkReader(shardedcheckpoint::Reader(dir.str()), data);
+
+  // Overwriting with fewer shards removes the shards no longer used.
+  std::map<TensorId, std::vector<float>> many{{"a", iota(10, 0.0f)},
+                                              {"b", iota(10, 1.0f)},
+                                              {"c", iota(10, 2.0f)},
+                                              {"d", iota(10, 3.0f)}};
+  shardedcheckpoint::write(dir.str(), makeSources(many, false), 4, 1);
+  shardedcheckpoint::write(dir.str(), makeSources(data, false), 1, 1);
+  unsigned numShardFiles = 0;
+  for (auto &file : boost::filesystem::directory_iterator(dir.path)) {
+    if (file.path().extension() == ".bin") {
+      ++numShardFiles;
+    }
+  }
+  BOOST_CHECK_EQUAL(numShardFiles, 1);
+  checkReader(shardedcheckpoint::Reader(dir.str()), data);
+
+  // Truncated shards are reported when the tensor is read.
+  for (auto &file : boost::filesystem::directory_iterator(dir.path)) {
+    if (file.path().extension() == ".bin") {
+      boost::filesystem::resize_file(file.path(), 16);
+    }
+  }
+  shardedcheckpoint::Reader truncated(dir.str());
+  BOOST_CHECK_THROW(truncated.weight("w"), popart::error);
+
+  // Sources must match their info.
+  auto sources = makeSources(data, false);
+  sources.front().segments.front().second -= 4;
+  BOOST_CHECK_THROW(
+      shardedcheckpoint::write(dir.str(), sources, 1, 1), popart::error);
+}
@@ -0,0 +1,269 @@
+// Copyright (c) 2022 Graphcore Ltd. All rights reserved.
+//
+// popart-compile: compile configurations of an ONNX model ahead of time and
+// publish the executables to the engine cache, where sessions with the same
+// options find them.
+//
+//   popart-compile [--jobs N] [--cache-path DIR] MODEL VARIANTS
+//
+// VARIANTS is a JSON file describing the configurations, see
+// popart/batchcompile.hpp. Each configuration is compiled for an offline IPU
+// by a worker process, which runs this program again with --worker, so that
+// compilations run in parallel and one failing does not affect the others.
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+#include <popart/batchcompile.hpp>
+
+namespace {
+
+using namespace popart;
+using Clock = std::chrono::steady_clock;
+
+// Exit codes of the worker processes. Anything else is a failure.
+constexpr int exitCompiled = 0;
+constexpr int exitCached   = 10;
+
+struct Args {
+  std::string model;
+  std::string variants;
+  std::string cachePath;
+  unsigned jobs = 0;
+  int worker    = -1;
+};
+
+const char *const usage =
+    "usage: popart-compile [--jobs N] [--cache-path DIR] MODEL VARIANTS\n"
+    "\n"
+    "Compile the configurations of the ONNX model MODEL listed in the JSON\n"
+    "file VARIANTS for offline IPUs, and add the executables to the engine\n"
+    "cache.\n"
+    "\n"
+    "  --jobs N          Compile up to N configurations at once.\n"
+    "  --cache-path DIR  Use the engine cache in DIR for all configurations,\n"
+    "                    instead of their cachePath session option.\n";
+
+Args parseArgs(int argc, char **argv) {
+  Args args;
+  std::vector<std::string> positional;
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    auto value            = [&]() -> std::string {
+      if (i + 1 >= argc) {
+        throw std::runtime_error("missing value for " + arg);
+      }
+      return argv[++i];
+    };
+    if (arg == "--jobs" || arg == "-j") {
+      args.jobs = static_cast<unsigned>(std::stoul(value()));
+    } else if (arg == "--cache-path") {
+      args.cachePath = value();
+    } else if (arg == "--worker") {
+      args.worker = std::stoi(value());
+    } else if (arg == "--help" || arg == "-h") {
+      std::cout << usage;
+      std::exit(0);
+    } else if (!arg.empty() && arg[0] == '-') {
+      throw std::runtime_error("unknown option " + arg);
+    } else {
+      positional.push_back(arg);
+    }
+  }
+  if (positional.size() != 2) {
+    throw std::runtime_error("expected a model and a variants file");
+  }
+  args.model    = positional[0];
+  args.variants = positional[1];
+  return args;
+}
+
+int runWorker(const Args &args, const batchcompile::Variant &variant) {
+  const auto result = batchcompile::compileVariant(args.model, variant);
+  const bool cached = result.status == batchcompile::Status::Cached;
+  std::cout << "popart-compile: variant '" << variant.name << "' "
+            << (cached ? "was already cached" : "compiled") << " with hash "
+            << result.hash << std::endl;
+  return cached ? exitCached : exitCompiled;
+}
+
+// Run this program again to compile one variant. Only exec is called in the
+// child, so nothing the parent has initialised is used after the fork.
+pid_t spawnWorker(const Args &args, size_t index) {
+  std::vector<std::string> workerArgs{
+      "popart-compile", "--worker", std::to_string(index)};
+  if (!args.cachePath.empty()) {
+    workerArgs.push_back("--cache-path");
+    workerArgs.push_back(args.cachePath);
+  }
+  workerArgs.push_back(args.model);
+  workerArgs.push_back(args.variants);
+
+  std::vector<char *> argv;
+  for (auto &arg : workerArgs) {
+    argv.push_back(&arg[0]);
+  }
+  argv.push_back(nullptr);
+
+  const pid_t pid = fork();
+  if (pid < 0) {
+    throw std::runtime_error(std::string("fork failed: ") +
+                             std::strerror(errno));
+  }
+  if (pid == 0) {
+    execv("/proc/self/exe", argv.data());
+    std::perror("popart-compile: exec failed");
+    _exit(127);
+  }
+  return pid;
+}
+
+struct Outcome {
+  Clock::time_point start;
+  double seconds = 0.0;
+  std::string result;
+  bool failed = false;
+};
+
+void finish(Outcome &outcome, int status) {
+  outcome.seconds = std::chrono::duration<double>(Clock::now() - outcome.start)
+                        .count();
+  if (WIFEXITED(status) && WEXITSTATUS(status) == exitCompiled) {
+    outcome.result = "compiled";
+  } else if (WIFEXITED(status) && WEXITSTATUS(status) == exitCached) {
+    outcome.result = "cached";
+  } else {
+    outcome.failed = true;
+    outcome.result =
+        WIFSIGNALED(status)
+            ? "failed (signal " + std::to_string(WTERMSIG(status)) + ")"
+            : "failed (exit code " + std::to_string(WEXITSTATUS(status)) + ")";
+  }
+}
+
+void report(const std::vector<batchcompile::Variant> &variants,
+            const std::vector<Outcome> &outcomes,
+            unsigned jobs,
+            double wallSeconds) {
+  size_t nameWidth = std::string("variant").size();
+  for (const auto &variant : variants) {
+    nameWidth = std::max(nameWidth, variant.name.size());
+  }
+
+  std::cout << '\n'
+            << std::left << std::setw(nameWidth + 2) << "variant"
+            << std::setw(24) << "result"
+            << "seconds\n";
+  size_t numCompiled  = 0;
+  size_t numFailed    = 0;
+  double totalSeconds = 0.0;
+  for (size_t i = 0; i < variants.size(); ++i) {
+    const auto &outcome = outcomes[i];
+    std::cout << std::left << std::setw(nameWidth + 2) << variants[i].name
+              << std::setw(24) << outcome.result << std::fixed
+              << std::setprecision(1) << outcome.seconds << '\n';
+    numCompiled += outcome.result == "compiled";
+    numFailed += outcome.failed;
+    totalSeconds += outcome.seconds;
+  }
+
+  std::cout << '\n'
+            << variants.size() << " variant(s): " << numCompiled
+            << " compiled, " << variants.size() - numCompiled - numFailed
+            << " already cached, " << numFailed << " failed, in "
+            << wallSeconds << " s with " << jobs << " worker(s)\n";
+  if (wallSeconds > 0.0) {
+    std::cout << "Throughput: " << variants.size() * 3600.0 / wallSeconds
+              << " variants per hour, " << totalSeconds / wallSeconds
+              << " times compiling them one at a time\n";
+  }
+}
+
+int runAll(const Args &args, const std::vector<batchcompile::Variant> &vs) {
+  // Each compilation is itself multi-threaded, so by default only run a few
+  // at once.
+  unsigned jobs = args.jobs;
+  if (jobs == 0) {
+    jobs = std::max(1u, std::thread::hardware_concurrency() / 4);
+  }
+  jobs = std::min<unsigned>(jobs, vs.size());
+
+  std::vector<Outcome> outcomes(vs.size());
+  std::map<pid_t, size_t> running;
+  size_t next      = 0;
+  const auto start = Clock::now();
+  while (next < vs.size() || !running.empty()) {
+    while (next < vs.size() && running.size() < jobs) {
+      outcomes[next].start = Clock::now();
+      running.emplace(spawnWorker(args, next), next);
+      ++next;
+    }
+
+    int status      = 0;
+    const pid_t pid = waitpid(-1, &status, 0);
+    if (pid < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      throw std::runtime_error(std::string("waitpid failed: ") +
+                               std::strerror(errno));
+    }
+    const auto found = running.find(pid);
+    if (found == running.end()) {
+      continue;
+    }
+    auto &outcome = outcomes[found->second];
+    finish(outcome, status);
+    std::cout << "popart-compile: variant '" << vs[found->second].name
+              << "' " << outcome.result << " after " << std::fixed
+              << std::setprecision(1) << outcome.seconds << " s" << std::endl;
+    running.erase(found);
+  }
+
+  const double wallSeconds =
+      std::chrono::duration<double>(Clock::now() - start).count();
+  report(vs, outcomes, jobs, wallSeconds);
+
+  const bool anyFailed = std::any_of(outcomes.begin(),
+                                     outcomes.end(),
+                                     [](const Outcome &o) { return o.failed; });
+  return anyFailed ? 1 : 0;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  try {
+    const auto args = parseArgs(argc, argv);
+
+    auto variants = batchcompile::readVariants(args.variants);
+    if (!args.cachePath.empty()) {
+      for (auto &variant : variants) {
+        variant.options.cachePath = args.cachePath;
+      }
+    }
+
+    if (args.worker >= 0) {
+      return runWorker(args, variants.at(args.worker));
+    }
+    return runAll(args, variants);
+  } catch (const std::exception &e) {
+    std::cerr << "popart-compile: " << e.what() << '\n';
+    if (argc == 1) {
+      std::cerr << usage;
+    }
+    return 1;
+  }
+}
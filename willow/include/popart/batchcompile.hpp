@@ -0,0 +1,97 @@
+// Copyright (c) 2022 Graphcore Ltd. All rights reserved.
+#ifndef POPART_WILLOW_INCLUDE_POPART_BATCHCOMPILE_HPP_
+#define POPART_WILLOW_INCLUDE_POPART_BATCHCOMPILE_HPP_
+
+#include <cstddef>
+#include <iosfwd>
+#include <map>
+#include <string>
+#include <vector>
+#include <popart/dataflow.hpp>
+#include <popart/inputshapeinfo.hpp>
+#include <popart/patterns/patterns.hpp>
+#include <popart/sessionoptions.hpp>
+
+namespace popart {
+namespace batchcompile {
+
+/**
+ * Compiling many configurations of one model ahead of time, to populate the
+ * engine cache before serving starts. This is what the `popart-compile` tool
+ * is built on.
+ *
+ * The configurations are read from a JSON file of the form:
+ *
+ * <code>
+ * {
+ *   "defaults": {
+ *     "sessionOptions": {"enableOutlining": true},
+ *     "device": {"numIPUs": "1", "ipuVersion": "ipu2"}
+ *   },
+ *   "variants": [
+ *     {
+ *       "name": "batch16",
+ *       "sessionOptions": {"engineOptions": {"opt.enableInlining": "true"}},
+ *       "dataFlow": {"batchesPerStep": 4, "anchors": {"logits": "All"}},
+ *       "inputShapeInfo": {"input": {"dataType": "FLOAT", "shape": [16, 128]}},
+ *       "patterns": "Default"
+ *     }
+ *   ]
+ * }
+ * </code>
+ *
+ * Each variant is merged over `defaults`, key by key. The sections are:
+ * - `sessionOptions`: SessionOptions fields by name. Booleans, numbers,
+ *   strings, the string maps such as `engineOptions`, the enums
+ *   `autoRecomputation`, `virtualGraphMode` and `syntheticDataMode`, and the
+ *   fields of `autocastSettings`, `autoVirtualGraphSettings`,
+ *   `batchSerializationSettings` and `tensorLocationPlannerSettings` are
+ *   supported. Engine caching is always enabled.
+ * - `dataFlow`: `batchesPerStep` and `anchors`, each either an anchor return
+ *   type such as "All" or an object with `type` and `returnPeriod`.
+ * - `inputShapeInfo`: the data type and shape of the model inputs.
+ * - `device`: the options passed to DeviceManager::createOfflineIPUDevice().
+ * - `patterns`: one of "NoPatterns", "Minimal", "Default" or "All".
+ */
+
+/// One configuration of a model to compile.
+struct Variant {
+  std::string name;
+  SessionOptions options;
+  DataFlow dataFlow;
+  InputShapeInfo inputShapeInfo;
+  Patterns patterns;
+  std::map<std::string, std::string> deviceOptions;
+};
+
+/// Read the variants from a JSON stream, see above.
+std::vector<Variant> readVariants(std::istream &in);
+
+/// Read the variants from a JSON file, see above.
+std::vector<Variant> readVariants(const std::string &path);
+
+/// What compileVariant() did.
+enum class Status {
+  /// The executable was compiled and published to the engine cache.
+  Compiled = 0,
+  /// The engine cache already had the executable.
+  Cached,
+};
+
+struct Result {
+  Status status;
+  /// The hash the executable is cached under.
+  size_t hash;
+};
+
+/**
+ * Compile \p variant of the ONNX model \p model for an offline IPU and publish
+ * it to the engine cache at `variant.options.cachePath`, with the hash that an
+ * inference session with the same options on a matching IPU looks up.
+ */
+Result compileVariant(const std::string &model, const Variant &variant);
+
+} // namespace batchcompile
+} // namespace popart
+
+#endif // POPART_WILLOW_INCLUDE_POPART_BATCHCOMPILE_HPP_
@@ -2057,6 +2057,126 @@ static const char *__doc_popart_AnchorReturnType_tileSet_2 = R"doc()doc";
 static const char *__singlelinedoc_popart_AnchorReturnType_tileSet_2 =
     R"doc()doc";
 
+static const char *__doc_popart_AutoVirtualGraphSettings =
+    R"doc(The settings for placing ops on virtual graphs when the virtual graph mode
+is VirtualGraphMode::Auto.)doc";
+
+static const char *__singlelinedoc_popart_AutoVirtualGraphSettings =
+    R"doc(The settings for placing ops on virtual graphs when the virtual graph mode is VirtualGraphMode::Auto.)doc";
+
+static const char
+    *__doc_popart_AutoVirtualGraphSettings_AutoVirtualGraphSettings =
+        R"doc(Default constructor for the AutoVirtualGraphSettings struct.)doc";
+
+static const char
+    *__singlelinedoc_popart_AutoVirtualGraphSettings_AutoVirtualGraphSettings =
+        R"doc(Default constructor for the AutoVirtualGraphSettings struct.)doc";
+
+static const char
+    *__doc_popart_AutoVirtualGraphSettings_AutoVirtualGraphSettings_2 =
+        R"doc(Constructor for the AutoVirtualGraphSettings struct.
+
+Args:
+ balanceStages_: Place ops with the PipelineStageBalancer transform
+        (`true`) or the AutoVirtualGraph transform (`false`). Default:
+        `false`.
+ maxMemoryProportion_: The proportion of the tile memory of an IPU
+        that the weights and stashed activations of a stage may use.)doc";
+
+static const char
+    *__singlelinedoc_popart_AutoVirtualGraphSettings_AutoVirtualGraphSettings_2 =
+        R"doc(Constructor for the AutoVirtualGraphSettings struct. Args: balanceStages_: Place ops with the PipelineStageBalancer transform (`true`) or the AutoVirtualGraph transform (`false`). Default: `false`. maxMemoryProportion_: The proportion of the tile memory of an IPU that the weights and stashed activations of a stage may use.)doc";
+
+static const char *__doc_popart_AutoVirtualGraphSettings_balanceStages =
+    R"doc(Place ops with the PipelineStageBalancer transform, which splits the
+schedule into one stage per IPU so that the estimated cost of the most
+expensive stage is as small as possible, within the memory of each IPU.
+Otherwise, ops are placed by the AutoVirtualGraph transform. Enabled when
+`true`. Default: `false`.)doc";
+
+static const char
+    *__singlelinedoc_popart_AutoVirtualGraphSettings_balanceStages =
+        R"doc(Place ops with the PipelineStageBalancer transform, which splits the schedule into one stage per IPU so that the estimated cost of the most expensive stage is as small as possible, within the memory of each IPU. Otherwise, ops are placed by the AutoVirtualGraph transform. Enabled when `true`. Default: `false`.)doc";
+
+static const char *__doc_popart_AutoVirtualGraphSettings_hash = R"doc()doc";
+
+static const char *__singlelinedoc_popart_AutoVirtualGraphSettings_hash =
+    R"doc()doc";
+
+static const char *__doc_popart_AutoVirtualGraphSettings_maxMemoryProportion =
+    R"doc(The proportion of the tile memory of an IPU that the weights and stashed
+activations of a stage may use, leaving the rest for temporary memory,
+code and exchange. Default: 0.6.)doc";
+
+static const char
+    *__singlelinedoc_popart_AutoVirtualGraphSettings_maxMemoryProportion =
+        R"doc(The proportion of the tile memory of an IPU that the weights and stashed activations of a stage may use, leaving the rest for temporary memory, code and exchange. Default: 0.6.)doc";
+
+static const char *__doc_popart_AutocastSettings =
+    R"doc(The settings for the Autocast transform, which inserts casts so that the
+ops of a model run in mixed precision.
+
+Ops are identified by their type, for example `"MatMul"`. The ops of types
+in none of the lists consume their inputs in their original data types.)doc";
+
+static const char *__singlelinedoc_popart_AutocastSettings =
+    R"doc(The settings for the Autocast transform, which inserts casts so that the ops of a model run in mixed precision. Ops are identified by their type, for example `"MatMul"`. The ops of types in none of the lists consume their inputs in their original data types.)doc";
+
+static const char *__doc_popart_AutocastSettings_AutocastSettings =
+    R"doc(Default constructor for the AutocastSettings struct.)doc";
+
+static const char *__singlelinedoc_popart_AutocastSettings_AutocastSettings =
+    R"doc(Default constructor for the AutocastSettings struct.)doc";
+
+static const char *__doc_popart_AutocastSettings_AutocastSettings_2 =
+    R"doc(Constructor for the AutocastSettings struct.
+
+Args:
+ enabled_: Run the ops of the model in mixed precision (`true`) or
+        not (`false`). Default: `false`.
+ allowOpTypes_: The types of the ops to run in FLOAT16.
+ denyOpTypes_: The types of the ops to run in FLOAT.
+ promoteOpTypes_: The types of the ops to run in FLOAT16 if any of
+        their floating point inputs is FLOAT16.)doc";
+
+static const char *__singlelinedoc_popart_AutocastSettings_AutocastSettings_2 =
+    R"doc(Constructor for the AutocastSettings struct. Args: enabled_: Run the ops of the model in mixed precision (`true`) or not (`false`). Default: `false`. allowOpTypes_: The types of the ops to run in FLOAT16. denyOpTypes_: The types of the ops to run in FLOAT. promoteOpTypes_: The types of the ops to run in FLOAT16 if any of their floating point inputs is FLOAT16.)doc";
+
+static const char *__doc_popart_AutocastSettings_allowOpTypes =
+    R"doc(The types of the ops to run in FLOAT16. Their floating point inputs are
+cast to FLOAT16.)doc";
+
+static const char *__singlelinedoc_popart_AutocastSettings_allowOpTypes =
+    R"doc(The types of the ops to run in FLOAT16. Their floating point inputs are cast to FLOAT16.)doc";
+
+static const char *__doc_popart_AutocastSettings_denyOpTypes =
+    R"doc(The types of the ops to run in FLOAT, such as reductions, softmax and
+losses. Their floating point inputs are cast to FLOAT.)doc";
+
+static const char *__singlelinedoc_popart_AutocastSettings_denyOpTypes =
+    R"doc(The types of the ops to run in FLOAT, such as reductions, softmax and losses. Their floating point inputs are cast to FLOAT.)doc";
+
+static const char *__doc_popart_AutocastSettings_enabled =
+    R"doc(Run the ops of the model in mixed precision. The variables remain FLOAT,
+and are cast to FLOAT16 where they are consumed, so that the optimizer
+updates FLOAT master weights with FLOAT gradients.
+Enabled when `true`. Default: `false`.)doc";
+
+static const char *__singlelinedoc_popart_AutocastSettings_enabled =
+    R"doc(Run the ops of the model in mixed precision. The variables remain FLOAT, and are cast to FLOAT16 where they are consumed, so that the optimizer updates FLOAT master weights with FLOAT gradients. Enabled when `true`. Default: `false`.)doc";
+
+static const char *__doc_popart_AutocastSettings_hash = R"doc()doc";
+
+static const char *__singlelinedoc_popart_AutocastSettings_hash =
+    R"doc()doc";
+
+static const char *__doc_popart_AutocastSettings_promoteOpTypes =
+    R"doc(The types of the ops to run in FLOAT16 if any of their floating point
+inputs is FLOAT16, in which case the others are cast to FLOAT16.)doc";
+
+static const char *__singlelinedoc_popart_AutocastSettings_promoteOpTypes =
+    R"doc(The types of the ops to run in FLOAT16 if any of their floating point inputs is FLOAT16, in which case the others are cast to FLOAT16.)doc";
+
 static const char *__doc_popart_AutodiffSettings =
     R"doc(The settings for the Autodiff transform.)doc";
 
@@ -2363,11 +2483,13 @@ Args:
  method_: An experimental value to control how batch serialization is
         applied. Default: BatchSerializationMethod::UnrollDynamic.
  batchSchedule_: An experimental value that changes how operations are
-        scheduled. Default: BatchSerializationBatchSchedule::Isomorphic.)doc";
+        scheduled. Default: BatchSerializationBatchSchedule::Isomorphic.
+ memoryBudget_: The bytes of live activations per IPU to choose the
+        factor and method for. Default: 0 (not used).)doc";
 
 static const char *
     __singlelinedoc_popart_BatchSerializationSettings_BatchSerializationSettings_2 =
-        R"doc(Constructor for BatchSerializationSettings. Args: factor_: The number of compute batches to split operations into. Default: 0. concatOnVirtualGraphChange_: Indicate to break batch serialization chains (:code:`true`) when the virtual graph changes (by concatenating the compute batches to the local batch). Default: :code:`true`. concatOnExecutionPhaseChange_: Indicate to break batch serialization chains (:code:`true`) when the execution phase changes (by concatenating the compute batches to the local batch). Default: :code:`true`. concatOnPipelineStageChange_: Indicate to break batch serialization chains (:code:`true`) when the pipeline stage changes (by concatenating the compute batches to the local batch). Default: :code:`true`. transformContext_: An experimental value to control when batch serialization is applied. Default: ::Fwd. method_: An experimental value to control how batch serialization is applied. Default: BatchSerializationMethod::UnrollDynamic. batchSchedule_: An experimental value that changes how operations are scheduled. Default: BatchSerializationBatchSchedule::Isomorphic.)doc";
+        R"doc(Constructor for BatchSerializationSettings. Args: factor_: The number of compute batches to split operations into. Default: 0. concatOnVirtualGraphChange_: Indicate to break batch serialization chains (:code:`true`) when the virtual graph changes (by concatenating the compute batches to the local batch). Default: :code:`true`. concatOnExecutionPhaseChange_: Indicate to break batch serialization chains (:code:`true`) when the execution phase changes (by concatenating the compute batches to the local batch). Default: :code:`true`. concatOnPipelineStageChange_: Indicate to break batch serialization chains (:code:`true`) when the pipeline stage changes (by concatenating the compute batches to the local batch). Default: :code:`true`. transformContext_: An experimental value to control when batch serialization is applied. Default: ::Fwd. method_: An experimental value to control how batch serialization is applied. Default: BatchSerializationMethod::UnrollDynamic. batchSchedule_: An experimental value that changes how operations are scheduled. Default: BatchSerializationBatchSchedule::Isomorphic. memoryBudget_: The bytes of live activations per IPU to choose the factor and method for. Default: 0 (not used).)doc";
 
 static const char *__doc_popart_BatchSerializationSettings_batchSchedule =
     R"doc(Experimental value that changes how operations are scheduled.)doc";
@@ -2409,6 +2531,20 @@ static const char *__doc_popart_BatchSerializationSettings_factor =
 static const char *__singlelinedoc_popart_BatchSerializationSettings_factor =
     R"doc(The number of compute batches to split operations into.)doc";
 
+static const char *__doc_popart_BatchSerializationSettings_memoryBudget =
+    R"doc(The bytes of live activations per IPU to serialize the batch for. If
+greater than 0, the factor and method are chosen automatically: the
+smallest factor, and the method for it, with which the predicted peak
+bytes of the live activations of each IPU fit in this budget. The
+prediction includes the buffers the slices are copied to and from. Among
+the methods that fit, the one that copies the fewest bytes is chosen. The
+choice is logged. Can not be used together with :code:`factor`.
+Default: 0 (not used).)doc";
+
+static const char
+    *__singlelinedoc_popart_BatchSerializationSettings_memoryBudget =
+        R"doc(The bytes of live activations per IPU to serialize the batch for. If greater than 0, the factor and method are chosen automatically: the smallest factor, and the method for it, with which the predicted peak bytes of the live activations of each IPU fit in this budget. The prediction includes the buffers the slices are copied to and from. Among the methods that fit, the one that copies the fewest bytes is chosen. The choice is logged. Can not be used together with :code:`factor`. Default: 0 (not used).)doc";
+
 static const char *__doc_popart_BatchSerializationSettings_method =
     R"doc(Experimental value to control how batch serialization is applied.)doc";
 
@@ -7367,6 +7503,11 @@ static const char *__doc_popart_Ir_getOrSetRandomReferenceTensor = R"doc()doc";
 static const char *__singlelinedoc_popart_Ir_getOrSetRandomReferenceTensor =
     R"doc()doc";
 
+static const char *__doc_popart_Ir_getPassedSessionOptions = R"doc()doc";
+
+static const char *__singlelinedoc_popart_Ir_getPassedSessionOptions =
+    R"doc()doc";
+
 static const char *__doc_popart_Ir_getPatternLevelStr = R"doc()doc";
 
 static const char *__singlelinedoc_popart_Ir_getPatternLevelStr = R"doc()doc";
@@ -8160,6 +8301,76 @@ than MeanReductionStrategy::Post.)doc";
 static const char *__singlelinedoc_popart_MeanReductionStrategy_Running =
     R"doc(Keep the reduction buffer as the mean of the tensors accumulated so far. If :math:`t_1, ..., t_f` has just been processed, the current accumulator :math:`s` is the mean of these values, and the next accumulator update is :math:`s = \frac{f}{f+1} * s + \frac{1}{f+1} * t_{f+1}` to keep :math:`s` a running mean. This strategy guarantees :math:`s \le \max(a_1, ..., a_k)` throughout the accumulation, therefore it will not overflow, but it is generally slower than MeanReductionStrategy::Post.)doc";
 
+static const char *__doc_popart_MemoryEstimate =
+    R"doc(A static estimate of the peak device memory used by an IR, computed from the
+IR alone, without compiling it.
+
+The estimate is first order. It counts the bytes of every tensor that is
+live at each position of the global schedule of the LivenessAnalyzer,
+where:
+ - variables, constants and stream tensors are always live, unless their
+   TensorLocation is off chip,
+ - pipeline stashes are always live,
+ - other tensors are live from their first to their last use in each call
+   of their graph,
+ - tensors that alias another tensor, such as the outputs of view changing
+   and inplace ops, add no bytes, but keep the tensor they alias live.
+Poplar's own temporary memory, code, exchange buffers and tile imbalance are
+not included, so the estimate is a lower bound on the memory required.)doc";
+
+static const char *__singlelinedoc_popart_MemoryEstimate =
+    R"doc(A static estimate of the peak device memory used by an IR, computed from the IR alone, without compiling it. The estimate is first order. It counts the bytes of every tensor that is live at each position of the global schedule of the LivenessAnalyzer, where: - variables, constants and stream tensors are always live, unless their TensorLocation is off chip, - pipeline stashes are always live, - other tensors are live from their first to their last use in each call of their graph, - tensors that alias another tensor, such as the outputs of view changing and inplace ops, add no bytes, but keep the tensor they alias live. Poplar's own temporary memory, code, exchange buffers and tile imbalance are not included, so the estimate is a lower bound on the memory required.)doc";
+
+static const char *__doc_popart_MemoryEstimate_bytesPerIpu =
+    R"doc(The number of bytes of tile memory of one IPU of the device, or 0 if the
+IR has no device.)doc";
+
+static const char *__singlelinedoc_popart_MemoryEstimate_bytesPerIpu =
+    R"doc(The number of bytes of tile memory of one IPU of the device, or 0 if the IR has no device.)doc";
+
+static const char *__doc_popart_MemoryEstimate_fits =
+    R"doc(Check whether the peak of every virtual graph fits in the tile memory of
+one IPU.
+
+
+Returns:
+ `true` if no peak exceeds bytesPerIpu, or if bytesPerIpu is
+      unknown.)doc";
+
+static const char *__singlelinedoc_popart_MemoryEstimate_fits =
+    R"doc(Check whether the peak of every virtual graph fits in the tile memory of one IPU. Returns: `true` if no peak exceeds bytesPerIpu, or if bytesPerIpu is unknown.)doc";
+
+static const char *__doc_popart_MemoryEstimate_peakBytesPerExecutionPhase =
+    R"doc(The peak number of live bytes on the virtual graph of the ops of each
+execution phase, while they run.)doc";
+
+static const char
+    *__singlelinedoc_popart_MemoryEstimate_peakBytesPerExecutionPhase =
+        R"doc(The peak number of live bytes on the virtual graph of the ops of each execution phase, while they run.)doc";
+
+static const char *__doc_popart_MemoryEstimate_peakBytesPerPipelineStage =
+    R"doc(The peak number of live bytes on the virtual graph of the ops of each
+pipeline stage, while they run.)doc";
+
+static const char
+    *__singlelinedoc_popart_MemoryEstimate_peakBytesPerPipelineStage =
+        R"doc(The peak number of live bytes on the virtual graph of the ops of each pipeline stage, while they run.)doc";
+
+static const char *__doc_popart_MemoryEstimate_peakBytesPerVirtualGraph =
+    R"doc(The peak number of live bytes on each virtual graph. Tensors without a
+virtual graph are counted on virtual graph 0.)doc";
+
+static const char
+    *__singlelinedoc_popart_MemoryEstimate_peakBytesPerVirtualGraph =
+        R"doc(The peak number of live bytes on each virtual graph. Tensors without a virtual graph are counted on virtual graph 0.)doc";
+
+static const char *__doc_popart_MemoryEstimate_topContributors =
+    R"doc(The largest tensors live at the peak of each virtual graph, largest
+first.)doc";
+
+static const char *__singlelinedoc_popart_MemoryEstimate_topContributors =
+    R"doc(The largest tensors live at the peak of each virtual graph, largest first.)doc";
+
 static const char *__doc_popart_MergeVarUpdateType =
     R"doc(Enum type used to specify which VarUpdateOp ops to merge.)doc";
 
@@ -8912,6 +9123,11 @@ static const char *__doc_popart_OpManager_findOpInfo = R"doc()doc";
 
 static const char *__singlelinedoc_popart_OpManager_findOpInfo = R"doc()doc";
 
+static const char *__doc_popart_OpManager_findOpVersions = R"doc()doc";
+
+static const char *__singlelinedoc_popart_OpManager_findOpVersions =
+    R"doc()doc";
+
 static const char *__doc_popart_OpManager_getAttributesFromAnyMap = R"doc()doc";
 
 static const char *__singlelinedoc_popart_OpManager_getAttributesFromAnyMap =
@@ -8944,9 +9160,13 @@ static const char *__doc_popart_OpManager_getUnsupportedOperations =
 static const char *__singlelinedoc_popart_OpManager_getUnsupportedOperations =
     R"doc()doc";
 
-static const char *__doc_popart_OpManager_opMap = R"doc()doc";
+static const char *__doc_popart_OpManager_opTypeIds = R"doc()doc";
+
+static const char *__singlelinedoc_popart_OpManager_opTypeIds = R"doc()doc";
+
+static const char *__doc_popart_OpManager_opVersions = R"doc()doc";
 
-static const char *__singlelinedoc_popart_OpManager_opMap = R"doc()doc";
+static const char *__singlelinedoc_popart_OpManager_opVersions = R"doc()doc";
 
 static const char *__doc_popart_OpManager_registerOp = R"doc()doc";
 
@@ -9226,10 +9446,11 @@ static const char *__doc_popart_Op_append =
     R"doc(Append this op to a stream.
 
 Args:
- ss: The stream to append the op to.)doc";
+ ss: The stream to append the op to.
+ withName: If :code:`false`, leave out the name of the op.)doc";
 
 static const char *__singlelinedoc_popart_Op_append =
-    R"doc(Append this op to a stream. Args: ss: The stream to append the op to.)doc";
+    R"doc(Append this op to a stream. Args: ss: The stream to append the op to. withName: If :code:`false`, leave out the name of the op.)doc";
 
 static const char *__doc_popart_Op_appendAttributes =
     R"doc(Append attributes when serialising the op to a stream.
@@ -11640,6 +11861,10 @@ static const char *__doc_popart_PatternNames_names = R"doc()doc";
 
 static const char *__singlelinedoc_popart_PatternNames_names = R"doc()doc";
 
+static const char *__doc_popart_PatternNames_types = R"doc()doc";
+
+static const char *__singlelinedoc_popart_PatternNames_types = R"doc()doc";
+
 static const char *__doc_popart_Patterns =
     R"doc(A class to hold which patterns are enabled and disabled.)doc";
 
@@ -12860,6 +13085,12 @@ static const char *__doc_popart_PreAliasPatternManager_tryGetTypeIndex =
 static const char *
     __singlelinedoc_popart_PreAliasPatternManager_tryGetTypeIndex = R"doc()doc";
 
+static const char *__doc_popart_PreAliasPatternManager_typeIndices =
+    R"doc()doc";
+
+static const char *__singlelinedoc_popart_PreAliasPatternManager_typeIndices =
+    R"doc()doc";
+
 static const char *__doc_popart_RecomputationType =
     R"doc(Enum type to specify which ops to recompute in the backward pass when doing
 auto-recomputation.)doc";
@@ -12867,6 +13098,14 @@ auto-recomputation.)doc";
 static const char *__singlelinedoc_popart_RecomputationType =
     R"doc(Enum type to specify which ops to recompute in the backward pass when doing auto-recomputation.)doc";
 
+static const char *__doc_popart_RecomputationType_MemoryBudget =
+    R"doc(Recompute the ops that save the most activation memory for the fewest
+floating point operations, until the activations of each IPU fit in
+``SessionOptions::autoRecomputationMemoryBudget``.)doc";
+
+static const char *__singlelinedoc_popart_RecomputationType_MemoryBudget =
+    R"doc(Recompute the ops that save the most activation memory for the fewest floating point operations, until the activations of each IPU fit in ``SessionOptions::autoRecomputationMemoryBudget``.)doc";
+
 static const char *__doc_popart_RecomputationType_N =
     R"doc(The number of ``RecomputationTypes`` values.)doc";
 
@@ -13861,6 +14100,37 @@ static const char *__doc_popart_SessionOptions_autoRecomputationEnabled =
 static const char *__singlelinedoc_popart_SessionOptions_autoRecomputationEnabled =
     R"doc(Returns :code:`true` if auto-recomputation is enabled, :code:`false` otherwise.)doc";
 
+static const char *__doc_popart_SessionOptions_autoRecomputationMemoryBudget =
+    R"doc(The bytes of forward pass activations that each IPU may keep for the
+backward pass, when ``autoRecomputation`` is
+RecomputationType::MemoryBudget. Ops are recomputed, in order of the bytes
+they save per floating point operation recomputed, until the activations
+kept, and those recomputed at once, fit in the budget.
+
+With pipelining, each stage keeps the activations of several batches, so
+the budget is for the activations of one batch. With implicit pipelining,
+the ops to recompute are chosen by the pipeline transform instead.
+
+Default: 0 (must be set for RecomputationType::MemoryBudget).)doc";
+
+static const char
+    *__singlelinedoc_popart_SessionOptions_autoRecomputationMemoryBudget =
+        R"doc(The bytes of forward pass activations that each IPU may keep for the backward pass, when ``autoRecomputation`` is RecomputationType::MemoryBudget. Ops are recomputed, in order of the bytes they save per floating point operation recomputed, until the activations kept, and those recomputed at once, fit in the budget. With pipelining, each stage keeps the activations of several batches, so the budget is for the activations of one batch. With implicit pipelining, the ops to recompute are chosen by the pipeline transform instead. Default: 0 (must be set for RecomputationType::MemoryBudget).)doc";
+
+static const char *__doc_popart_SessionOptions_autoVirtualGraphSettings =
+    R"doc(Configuration settings for placing ops on virtual graphs, when
+``virtualGraphMode`` is VirtualGraphMode::Auto.)doc";
+
+static const char
+    *__singlelinedoc_popart_SessionOptions_autoVirtualGraphSettings =
+        R"doc(Configuration settings for placing ops on virtual graphs, when ``virtualGraphMode`` is VirtualGraphMode::Auto.)doc";
+
+static const char *__doc_popart_SessionOptions_autocastSettings =
+    R"doc(Configuration settings for the autocast transform.)doc";
+
+static const char *__singlelinedoc_popart_SessionOptions_autocastSettings =
+    R"doc(Configuration settings for the autocast transform.)doc";
+
 static const char *__doc_popart_SessionOptions_autodiffSettings =
     R"doc(Configuration settings for the autodiff transform.)doc";
 
@@ -14086,6 +14356,16 @@ static const char
     *__singlelinedoc_popart_SessionOptions_enableDistributedReplicatedGraphs =
         R"doc(Enable training with Poplar replicated graphs across multiple PopART instances. Default: :code:`false` (not enabled).)doc";
 
+static const char *__doc_popart_SessionOptions_enableElementwiseFusion =
+    R"doc(Enable fusing connected elementwise ops into single ops.
+Each group of fused ops is computed by one expression, in one compute set,
+instead of one compute set and intermediate tensor for each op.
+Enabled when :code:`true`. Default: :code:`false`.)doc";
+
+static const char
+    *__singlelinedoc_popart_SessionOptions_enableElementwiseFusion =
+        R"doc(Enable fusing connected elementwise ops into single ops. Each group of fused ops is computed by one expression, in one compute set, instead of one compute set and intermediate tensor for each op. Enabled when :code:`true`. Default: :code:`false`.)doc";
+
 static const char *__doc_popart_SessionOptions_enableEngineCaching =
     R"doc(Enable Poplar executable caching.
 The file is saved to the location defined with ``cachePath.`:code:`
@@ -14135,6 +14415,16 @@ poplar::OptionFlags, matmul::PlanningCache).)doc";
 static const char *__singlelinedoc_popart_SessionOptions_enableFullyConnectedPass =
     R"doc(Enable the global :code:`fullyConnectedPass` option for matmuls. See Also: poplin::matMul(poplar::Graph, poplar::Tensor, poplar::Tensor, poplar::program::Sequence, poplar::Type, poplar::DebugContext, poplar::OptionFlags, matmul::PlanningCache).)doc";
 
+static const char *__doc_popart_SessionOptions_enableGlobalValueNumbering =
+    R"doc(Enable common subexpression elimination by global value numbering.
+Ops computing the same values as earlier ops, including calls of the same
+pure subgraphs, are removed before autodiff.
+Enabled when `true`. Default: `false`.)doc";
+
+static const char
+    *__singlelinedoc_popart_SessionOptions_enableGlobalValueNumbering =
+        R"doc(Enable common subexpression elimination by global value numbering. Ops computing the same values as earlier ops, including calls of the same pure subgraphs, are removed before autodiff. Enabled when `true`. Default: `false`.)doc";
+
 static const char *__doc_popart_SessionOptions_enableGradientAccumulation =
     R"doc(Enable gradient accumulation. Default: :code:`false` (not enabled).)doc";
 
@@ -14216,6 +14506,22 @@ static const char *__doc_popart_SessionOptions_enablePipelining =
 static const char *__singlelinedoc_popart_SessionOptions_enablePipelining =
     R"doc(Enable pipelining of virtual graphs. Default: :code:`false` (not enabled).)doc";
 
+static const char *__doc_popart_SessionOptions_enablePlanningCacheReuse =
+    R"doc(If set to :code:`true`, sessions in the same process share their
+convolution and matmul planning caches when they are lowered for the same
+target, so that plans made by one session are reused by the next.
+
+Sessions that only differ slightly, for example in batch size or
+replication factor, reuse the plans of all the convolutions and matmuls
+that are unchanged. The shared caches are kept until the process exits,
+and sessions using the same caches are lowered one at a time.
+
+Default: :code:`false` (each session plans from scratch).)doc";
+
+static const char
+    *__singlelinedoc_popart_SessionOptions_enablePlanningCacheReuse =
+        R"doc(If set to :code:`true`, sessions in the same process share their convolution and matmul planning caches when they are lowered for the same target, so that plans made by one session are reused by the next. Sessions that only differ slightly, for example in batch size or replication factor, reuse the plans of all the convolutions and matmuls that are unchanged. The shared caches are kept until the process exits, and sessions using the same caches are lowered one at a time. Default: :code:`false` (each session plans from scratch).)doc";
+
 static const char *__doc_popart_SessionOptions_enablePrefetchDatastreams =
     R"doc(Enable prefetching for input data streams.
 
@@ -14286,6 +14592,15 @@ static const char
     *__singlelinedoc_popart_SessionOptions_enableSupportedDataTypeCasting =
         R"doc(Enable casting to supported data types. If enabled (:code:`true`), casts any tensor of unsupported data types to supported data types when lowering to Poplar. Currently, this implies casting: - INT64 -> INT32 - UINT64 -> UINT32 The cast will throw an error for incompatible data types and over/underflows, and will warn about narrowing casts. Default: :code:`true` (enabled).)doc";
 
+static const char *__doc_popart_SessionOptions_enableTransposeSinking =
+    R"doc(Enable moving transposes and reshapes past the ops that do not depend on the
+layout of their inputs, so that inverse pairs cancel.
+Enabled when `true`. Default: `false`.)doc";
+
+static const char
+    *__singlelinedoc_popart_SessionOptions_enableTransposeSinking =
+        R"doc(Enable moving transposes and reshapes past the ops that do not depend on the layout of their inputs, so that inverse pairs cancel. Enabled when `true`. Default: `false`.)doc";
+
 static const char *__doc_popart_SessionOptions_enableVariablesCaching =
     R"doc(Enable variable caching.
 
@@ -14300,6 +14615,36 @@ Default: `true` (enabled).)doc";
 static const char *__singlelinedoc_popart_SessionOptions_enableVariablesCaching =
     R"doc(Enable variable caching. This means that the caching process will save variables as additional `PopEF <https://docs.graphcore.ai/projects/popef/>`_ blobs to the file location defined with ``cachePath``. If PopART will require data for variables (during cache reading process), they will be automatically read from the cache file. Default: `true` (enabled).)doc";
 
+static const char *__doc_popart_SessionOptions_engineCacheIgnoreOpNames =
+    R"doc(Leave op names out of the IR hash used to look up executables in the
+engine cache at ``cachePath``.
+
+Op names only label the compiled program, they don't change the code
+generated for it, but by default renaming an op causes a cache miss and
+a recompile. If enabled, an executable compiled for a graph that differs
+only in op names is loaded instead, and profiles and debug information
+use the op names from when it was compiled.
+
+Default: :code:`false` (not enabled).)doc";
+
+static const char
+    *__singlelinedoc_popart_SessionOptions_engineCacheIgnoreOpNames =
+        R"doc(Leave op names out of the IR hash used to look up executables in the engine cache at ``cachePath``. Op names only label the compiled program, they don't change the code generated for it, but by default renaming an op causes a cache miss and a recompile. If enabled, an executable compiled for a graph that differs only in op names is loaded instead, and profiles and debug information use the op names from when it was compiled. Default: :code:`false` (not enabled).)doc";
+
+static const char *__doc_popart_SessionOptions_engineCacheMaxBytes =
+    R"doc(The maximum total size, in bytes, of the executables in the engine cache
+at ``cachePath``.
+
+When a new executable is added to the cache, the least recently used
+executables are deleted until the cache fits within this size. The cache
+directory may be shared between processes, which record the use of each
+executable in an index in the directory.
+
+Default: 0 (no limit).)doc";
+
+static const char *__singlelinedoc_popart_SessionOptions_engineCacheMaxBytes =
+    R"doc(The maximum total size, in bytes, of the executables in the engine cache at ``cachePath``. When a new executable is added to the cache, the least recently used executables are deleted until the cache fits within this size. The cache directory may be shared between processes, which record the use of each executable in an index in the directory. Default: 0 (no limit).)doc";
+
 static const char *__doc_popart_SessionOptions_engineOptions =
     R"doc(Poplar engine options.)doc";
 
@@ -14413,6 +14758,21 @@ Returns:
 static const char *__singlelinedoc_popart_SessionOptions_getGlobalReplicationFactor =
     R"doc(Get the global replication factor. Returns: s - If :code:`enableDistributedReplicatedGraphs` is :code:`true`, then return :code:`globalReplicationFactor`. - If :code:`enableReplicatedGraphs` is :code:`true`, then return :code:`replicatedGraphCount`. - otherwise return 1.)doc";
 
+static const char *__doc_popart_SessionOptions_getHashComponents =
+    R"doc(Get the hashes that make up std::hash<SessionOptions>, by option name.
+
+Options that are grouped in a settings struct, such as
+:code:`batchSerializationSettings`, are hashed together under the name of
+the struct. Comparing the components of two sets of options shows which
+options differ.
+
+
+Returns:
+ A map from the name of each hashed option to its hash.)doc";
+
+static const char *__singlelinedoc_popart_SessionOptions_getHashComponents =
+    R"doc(Get the hashes that make up std::hash<SessionOptions>, by option name. Options that are grouped in a settings struct, such as :code:`batchSerializationSettings`, are hashed together under the name of the struct. Comparing the components of two sets of options shows which options differ. Returns: A map from the name of each hashed option to its hash.)doc";
+
 static const char *__doc_popart_SessionOptions_globalReplicaOffset =
     R"doc(The first replica index that this PopART instance is running.)doc";
 
@@ -14521,6 +14881,22 @@ static const char *__doc_popart_SessionOptions_lstmOptions =
 static const char *__singlelinedoc_popart_SessionOptions_lstmOptions =
     R"doc(Poplar LSTM options.)doc";
 
+static const char *__doc_popart_SessionOptions_mapExternalTensorData =
+    R"doc(If set to :code:`true`, initializers of the ONNX model whose data is stored in
+external files are memory mapped rather than read into memory when the
+model is loaded.
+
+The mappings are private, so changes to the weights are never written back
+to the files, and pages are only read from disk when the data is first
+accessed, for example by constant folding or Session::weightsFromHost().
+This reduces start-up time and host memory use for large models.
+
+The external data files must not be truncated or modified by other
+processes while the session exists.)doc";
+
+static const char *__singlelinedoc_popart_SessionOptions_mapExternalTensorData =
+    R"doc(If set to :code:`true`, initializers of the ONNX model whose data is stored in external files are memory mapped rather than read into memory when the model is loaded. The mappings are private, so changes to the weights are never written back to the files, and pages are only read from disk when the data is first accessed, for example by constant folding or Session::weightsFromHost(). This reduces start-up time and host memory use for large models. The external data files must not be truncated or modified by other processes while the session exists.)doc";
+
 static const char *__doc_popart_SessionOptions_matmulOptions =
     R"doc(Poplar matmul options.)doc";
 
@@ -14775,6 +15151,15 @@ Default: SyntheticDataMode::Off.)doc";
 static const char *__singlelinedoc_popart_SessionOptions_syntheticDataMode =
     R"doc(Specify whether to use real or synthetic data to initialize input tensors. Streaming to/from the host is only enabled for SyntheticDataMode::Off which indicates that real data is being used. Default: SyntheticDataMode::Off.)doc";
 
+static const char *__doc_popart_SessionOptions_tensorLocationPlannerSettings =
+    R"doc(Settings to choose the tensor locations of the weights, optimizer state,
+accumulators and activations automatically, to fit a memory budget. The
+chosen locations are added to tensorLocationSettingsOverride.)doc";
+
+static const char
+    *__singlelinedoc_popart_SessionOptions_tensorLocationPlannerSettings =
+        R"doc(Settings to choose the tensor locations of the weights, optimizer state, accumulators and activations automatically, to fit a memory budget. The chosen locations are added to tensorLocationSettingsOverride.)doc";
+
 static const char *__doc_popart_SessionOptions_tensorLocationSettingsOverride =
     R"doc(Override tensor location for specific tensors by setting tensor locations
 for specific tensor ID values.)doc";
@@ -14834,6 +15219,21 @@ static const char
     *__singlelinedoc_popart_SessionOptions_weightTensorLocationSettings =
         R"doc(Tensor location for weight tensors.)doc";
 
+static const char *__doc_popart_SessionOptions_weightTransferThreads =
+    R"doc(Number of host threads used to copy weights between the host and the
+device in Session::weightsFromHost(), Session::weightsToHost() and
+Session::readWeights().
+
+Host side copies are split into chunks and spread over these threads, and
+rearrangements for replicated tensor sharding overlap with the remote
+buffer transfers. A value of 1 copies all weights serially on the calling
+thread.
+
+Default: 0 (choose based on the number of hardware threads).)doc";
+
+static const char *__singlelinedoc_popart_SessionOptions_weightTransferThreads =
+    R"doc(Number of host threads used to copy weights between the host and the device in Session::weightsFromHost(), Session::weightsToHost() and Session::readWeights(). Host side copies are split into chunks and spread over these threads, and rearrangements for replicated tensor sharding overlap with the remote buffer transfers. A value of 1 copies all weights serially on the calling thread. Default: 0 (choose based on the number of hardware threads).)doc";
+
 static const char *__doc_popart_Session_Session = R"doc()doc";
 
 static const char *__singlelinedoc_popart_Session_Session = R"doc()doc";
@@ -15075,6 +15475,29 @@ static const char *__doc_popart_Session_getIrLowering =
 static const char *__singlelinedoc_popart_Session_getIrLowering =
     R"doc(Get the IR lowering associated with the Session.)doc";
 
+static const char *__doc_popart_Session_getMemoryEstimate =
+    R"doc(Estimate the peak device memory used by the session's IR, without
+compiling it.
+
+The estimate reports the peak live bytes per virtual graph, pipeline
+stage and execution phase, and the largest tensors live at each peak.
+See MemoryEstimate for what is counted.
+
+This method may be called before prepareDevice(), but not when the
+executable is loaded from the cache.
+
+
+Args:
+ numTopContributors: The number of tensors to report for the peak of
+      each virtual graph. Default = 10.
+
+
+Returns:
+ The memory estimate.)doc";
+
+static const char *__singlelinedoc_popart_Session_getMemoryEstimate =
+    R"doc(Estimate the peak device memory used by the session's IR, without compiling it. The estimate reports the peak live bytes per virtual graph, pipeline stage and execution phase, and the largest tensors live at each peak. See MemoryEstimate for what is counted. This method may be called before prepareDevice(), but not when the executable is loaded from the cache. Args: numTopContributors: The number of tensors to report for the peak of each virtual graph. Default = 10. Returns: The memory estimate.)doc";
+
 static const char *__doc_popart_Session_getRNGState =
     R"doc(Get state of the random number generator.)doc";
 
@@ -15197,6 +15620,8 @@ static const char *__doc_popart_Session_loadExecutableFromFile =
     R"doc(Load the compiled executable and metadata from a file.
 
 The file must have been created with compileAndExport(const std::string).
+It is memory mapped rather than read through a stream, which makes this
+the fastest way to load a large executable.
 
 
 Args:
@@ -15204,7 +15629,7 @@ Args:
       from.)doc";
 
 static const char *__singlelinedoc_popart_Session_loadExecutableFromFile =
-    R"doc(Load the compiled executable and metadata from a file. The file must have been created with compileAndExport(const std::string). Args: filename: The name of the file to load the executable and metadata from.)doc";
+    R"doc(Load the compiled executable and metadata from a file. The file must have been created with compileAndExport(const std::string). It is memory mapped rather than read through a stream, which makes this the fastest way to load a large executable. Args: filename: The name of the file to load the executable and metadata from.)doc";
 
 static const char *__doc_popart_Session_loadExecutableFromStream =
     R"doc(Load the compiled executable and from a stream.
@@ -15278,16 +15703,19 @@ must be the weights. No other differences are allowed.
 This method only updates the weights on the host. weightsFromHost() must
 be called after this method to update the weights on the device.
 
+Weights that are not in the ONNX model are left unchanged.
+
 
 Args:
- model: An ONNX model protobuf, or the name of a file containing an
-      ONNX model protobuf.
+ model: An ONNX model protobuf, the name of a file containing an
+      ONNX model protobuf, or a sharded checkpoint directory written by
+      weightsToCheckpoint().
  ignoreWeightsInModelWithoutCorrespondingHostWeight: If :code:`true`, do not
       throw an error if there are initializers in the ONNX model without
       corresponding initializer tensor(s) in the session's IR.)doc";
 
 static const char *__singlelinedoc_popart_Session_resetHostWeights =
-    R"doc(Reset weights with weights in an ONNX model. Note that the only differences between the ONNX model and the current model must be the weights. No other differences are allowed. This method only updates the weights on the host. weightsFromHost() must be called after this method to update the weights on the device. Args: model: An ONNX model protobuf, or the name of a file containing an ONNX model protobuf. ignoreWeightsInModelWithoutCorrespondingHostWeight: If :code:`true`, do not throw an error if there are initializers in the ONNX model without corresponding initializer tensor(s) in the session's IR.)doc";
+    R"doc(Reset weights with weights in an ONNX model. Note that the only differences between the ONNX model and the current model must be the weights. No other differences are allowed. This method only updates the weights on the host. weightsFromHost() must be called after this method to update the weights on the device. Weights that are not in the ONNX model are left unchanged. Args: model: An ONNX model protobuf, the name of a file containing an ONNX model protobuf, or a sharded checkpoint directory written by weightsToCheckpoint(). ignoreWeightsInModelWithoutCorrespondingHostWeight: If :code:`true`, do not throw an error if there are initializers in the ONNX model without corresponding initializer tensor(s) in the session's IR.)doc";
 
 static const char *__doc_popart_Session_broadcastWeights =
     R"doc(Broadcasts the weight from the PopRun instance with index `rootRank` to all other instances.
@@ -15465,6 +15893,23 @@ static const char *__doc_popart_Session_setDeviceInfo =
 static const char *__singlelinedoc_popart_Session_setDeviceInfo =
     R"doc(Set the DeviceInfo of the Session.)doc";
 
+static const char *__doc_popart_Session_setLoweringOptions =
+    R"doc(Change the options used to lower the prepared IR and compile it, and set
+the session up to do so again, without preparing the IR again.
+
+Only SessionOptions::engineOptions, :code:`convolutionOptions`,
+:code:`matmulOptions`, :code:`gclOptions` and :code:`reportOptions` are
+changed. Use this to try different Poplar options, or to retry after
+compiling failed. The engine cache is looked up again with the new options.
+Call prepareDevice() afterwards.
+
+Args:
+ userOptions: The new options. The options that the IR depends on
+     must be the same as those the session was created with.)doc";
+
+static const char *__singlelinedoc_popart_Session_setLoweringOptions =
+    R"doc(Change the options used to lower the prepared IR and compile it, and set the session up to do so again, without preparing the IR again. Only SessionOptions::engineOptions, :code:`convolutionOptions`, :code:`matmulOptions`, :code:`gclOptions` and :code:`reportOptions` are changed. Use this to try different Poplar options, or to retry after compiling failed. The engine cache is looked up again with the new options. Call prepareDevice() afterwards. Args: userOptions: The new options. The options that the IR depends on must be the same as those the session was created with.)doc";
+
 static const char *__doc_popart_Session_setRNGState =
     R"doc(Set state of the random number generator.)doc";
 
@@ -15542,6 +15987,28 @@ static const char
     *__singlelinedoc_popart_Session_updateExternallySavedTensorLocations =
         R"doc(Update the tensor locations of tensors in the session's ONNX model. A new file will be created at this point, and written to when the ONNX model is saved with a subsequent call to modelToHost(). Args: fromLocation: All externally saved tensors with location \p fromLocation will have their location updated to \p toLocation. toLocation: The updated tensor locations. This must not already exist.)doc";
 
+static const char *__doc_popart_Session_weightsToCheckpoint =
+    R"doc(Write the current weights to a sharded checkpoint.
+
+The checkpoint is a directory holding a small index and a number of data
+shards, see shardedcheckpoint.hpp. The shards are written in parallel
+directly from the host weight buffers, so no additional copy of the
+weights is made and, unlike modelToHost(), there is no 2 GB limit on the
+size of the model.
+
+The checkpoint can be loaded with resetHostWeights(), or, partially and
+lazily, by passing a shardedcheckpoint::Reader to writeWeights().
+
+
+Args:
+ dir: The checkpoint directory. It is created if it does not exist,
+      and an existing checkpoint in it is overwritten.
+ numShards: The number of data shards. 0 picks a number based on the
+      size of the model and SessionOptions::weightTransferThreads.)doc";
+
+static const char *__singlelinedoc_popart_Session_weightsToCheckpoint =
+    R"doc(Write the current weights to a sharded checkpoint. The checkpoint is a directory holding a small index and a number of data shards, see shardedcheckpoint.hpp. The shards are written in parallel directly from the host weight buffers, so no additional copy of the weights is made and, unlike modelToHost(), there is no 2 GB limit on the size of the model. The checkpoint can be loaded with resetHostWeights(), or, partially and lazily, by passing a shardedcheckpoint::Reader to writeWeights(). Args: dir: The checkpoint directory. It is created if it does not exist, and an existing checkpoint in it is overwritten. numShards: The number of data shards. 0 picks a number based on the size of the model and SessionOptions::weightTransferThreads.)doc";
+
 static const char *__doc_popart_Session_weightsFromHost =
     R"doc(Copy weights from the host to the device.)doc";
 
@@ -15947,6 +16414,80 @@ static const char *__doc_popart_TensorLocationInfo_sharded = R"doc()doc";
 static const char *__singlelinedoc_popart_TensorLocationInfo_sharded =
     R"doc()doc";
 
+static const char *__doc_popart_TensorLocationPlannerSettings =
+    R"doc(A structure containing settings for the TensorLocationPlanner transform,
+which chooses the TensorLocation of each tensor to fit a memory budget.)doc";
+
+static const char *__singlelinedoc_popart_TensorLocationPlannerSettings =
+    R"doc(A structure containing settings for the TensorLocationPlanner transform, which chooses the TensorLocation of each tensor to fit a memory budget.)doc";
+
+static const char
+    *__doc_popart_TensorLocationPlannerSettings_TensorLocationPlannerSettings =
+        R"doc(Default constructor for the TensorLocationPlannerSettings struct.)doc";
+
+static const char
+    *__singlelinedoc_popart_TensorLocationPlannerSettings_TensorLocationPlannerSettings =
+        R"doc(Default constructor for the TensorLocationPlannerSettings struct.)doc";
+
+static const char
+    *__doc_popart_TensorLocationPlannerSettings_TensorLocationPlannerSettings_2 =
+        R"doc(Constructor for the TensorLocationPlannerSettings struct.
+
+Args:
+ enabled_: Plan the tensor locations (`true`) or not (`false`).
+ memoryBudget_: The bytes of tile memory per IPU that the tensors
+        may use, or 0 for the tile memory of an IPU.
+ remoteBandwidth_: The bytes per second streamed between remote
+        buffers and an IPU.
+ replicatedBandwidth_: The bytes per second gathered from the other
+        replicas by an IPU.)doc";
+
+static const char
+    *__singlelinedoc_popart_TensorLocationPlannerSettings_TensorLocationPlannerSettings_2 =
+        R"doc(Constructor for the TensorLocationPlannerSettings struct. Args: enabled_: Plan the tensor locations (`true`) or not (`false`). memoryBudget_: The bytes of tile memory per IPU that the tensors may use, or 0 for the tile memory of an IPU. remoteBandwidth_: The bytes per second streamed between remote buffers and an IPU. replicatedBandwidth_: The bytes per second gathered from the other replicas by an IPU.)doc";
+
+static const char *__doc_popart_TensorLocationPlannerSettings_enabled =
+    R"doc(Choose the TensorLocation of the weights, optimizer state, accumulators
+and, with execution phases, activations that are not set by the user,
+with the TensorLocationPlanner transform. The thresholds of the
+TensorLocationSettings of each type of tensor are not used for them.
+Enabled when `true`. Default: `false`.)doc";
+
+static const char
+    *__singlelinedoc_popart_TensorLocationPlannerSettings_enabled =
+        R"doc(Choose the TensorLocation of the weights, optimizer state, accumulators and, with execution phases, activations that are not set by the user, with the TensorLocationPlanner transform. The thresholds of the TensorLocationSettings of each type of tensor are not used for them. Enabled when `true`. Default: `false`.)doc";
+
+static const char *__doc_popart_TensorLocationPlannerSettings_hash =
+    R"doc()doc";
+
+static const char
+    *__singlelinedoc_popart_TensorLocationPlannerSettings_hash = R"doc()doc";
+
+static const char *__doc_popart_TensorLocationPlannerSettings_memoryBudget =
+    R"doc(The bytes of tile memory per IPU that the predicted peak of live
+tensors may use, or 0 for the tile memory of an IPU. Default: 0.)doc";
+
+static const char
+    *__singlelinedoc_popart_TensorLocationPlannerSettings_memoryBudget =
+        R"doc(The bytes of tile memory per IPU that the predicted peak of live tensors may use, or 0 for the tile memory of an IPU. Default: 0.)doc";
+
+static const char *__doc_popart_TensorLocationPlannerSettings_remoteBandwidth =
+    R"doc(The bytes per second streamed between remote buffers and an IPU, to
+predict the time added by off-chip tensors. Default: 16e9.)doc";
+
+static const char
+    *__singlelinedoc_popart_TensorLocationPlannerSettings_remoteBandwidth =
+        R"doc(The bytes per second streamed between remote buffers and an IPU, to predict the time added by off-chip tensors. Default: 16e9.)doc";
+
+static const char
+    *__doc_popart_TensorLocationPlannerSettings_replicatedBandwidth =
+        R"doc(The bytes per second gathered from the other replicas by an IPU, to
+predict the time added by replicated tensor sharding. Default: 64e9.)doc";
+
+static const char
+    *__singlelinedoc_popart_TensorLocationPlannerSettings_replicatedBandwidth =
+        R"doc(The bytes per second gathered from the other replicas by an IPU, to predict the time added by replicated tensor sharding. Default: 64e9.)doc";
+
 static const char *__doc_popart_TensorLocationSettings =
     R"doc(A structure containing user configuration for cache/offloading settings.)doc";
 
@@ -19360,6 +19901,25 @@ NOTE: This is different from a C++ runtime error.)doc";
 static const char *__singlelinedoc_popart_runtime_error =
     R"doc(Exception class specific to errors that occur when running a model. For example, this error could be thrown when a user-implemented IStepIO callback doesn't return any data. NOTE: This is different from a C++ runtime error.)doc";
 
+static const char *__doc_popart_shardedcheckpoint_Reader =
+    R"doc(Reads a checkpoint written by write().
+
+Only the index is read on construction. Shards are memory mapped on first
+use, so tensor data is only paged in from disk when it is accessed. Mapped
+pages are private, writes through weight() never reach the files.
+
+This implements IWeightsIO, so a checkpoint, or any subset of it, can be
+passed straight to Session::writeWeights.)doc";
+
+static const char *__singlelinedoc_popart_shardedcheckpoint_Reader =
+    R"doc(Reads a checkpoint written by write(). Only the index is read on construction. Shards are memory mapped on first use, so tensor data is only paged in from disk when it is accessed. Mapped pages are private, writes through weight() never reach the files. This implements IWeightsIO, so a checkpoint, or any subset of it, can be passed straight to Session::writeWeights.)doc";
+
+static const char *__doc_popart_shardedcheckpoint_Reader_getEntries =
+    R"doc(The entries of the index, in the order they were written.)doc";
+
+static const char *__singlelinedoc_popart_shardedcheckpoint_Reader_getEntries =
+    R"doc(The entries of the index, in the order they were written.)doc";
+
 static const char *__doc_popart_stripAllReservedPrefixes =
     R"doc(Creates a new TensorId where all prefixes are removed
 
@@ -0,0 +1,179 @@
+// Copyright (c) 2022 Graphcore Ltd. All rights reserved.
+#ifndef POPART_WILLOW_INCLUDE_POPART_ENGINECACHE_HPP_
+#define POPART_WILLOW_INCLUDE_POPART_ENGINECACHE_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iosfwd>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "popart/vendored/optional.hpp"
+
+namespace popart {
+
+struct SessionOptions;
+
+/**
+ * The store behind SessionOptions::enableEngineCaching.
+ *
+ * Executables are kept in the cache directory as `<hash>.popef` files, next
+ * to a JSON index, `popart_engine_cache.json`, which records the size and
+ * last use of every file along with hit, miss and eviction counts. Sessions
+ * read the index rather than listing and parsing the directory.
+ *
+ * Several processes may share one cache directory:
+ * - The index is only updated while holding an advisory lock on
+ *   `popart_engine_cache.lock`.
+ * - Executables are written to a temporary file and renamed into place, so a
+ *   partially written file is never visible.
+ * - lockForCompile() lets one process compile a graph while the others wait
+ *   for it to be published and then load it.
+ *
+ * Each executable may be published with a fingerprint, the hashes of the parts
+ * of the IR that make up its hash, which is kept in
+ * `<hash>.fingerprint.json`. On a miss, explainMiss() compares the fingerprint
+ * of the IR with those in the cache to find out what changed.
+ *
+ * File locks exclude other processes, not other threads of the same process.
+ *
+ * An EngineCache object only holds the directory and byte budget, all other
+ * state lives on disk, so it is cheap to construct one wherever it is needed.
+ */
+class EngineCache {
+public:
+  /// Counters kept in the index and shared by all users of the directory.
+  struct Statistics {
+    uint64_t hits       = 0;
+    uint64_t misses     = 0;
+    uint64_t evictions  = 0;
+    uint64_t numEntries = 0;
+    uint64_t totalBytes = 0;
+  };
+
+  /// Hashes of the parts of an IR, by name. See Ir::getFingerprint().
+  using Fingerprint = std::map<std::string, size_t>;
+
+  /// How a fingerprint differs from the nearest one in the cache.
+  struct MissExplanation {
+    /// The hash of the executable with the nearest fingerprint.
+    size_t nearestHash = 0;
+    /// Components whose hash differs.
+    std::vector<std::string> changed;
+    /// Components that are only in the fingerprint being explained.
+    std::vector<std::string> added;
+    /// Components that are only in the fingerprint of the nearest executable.
+    std::vector<std::string> removed;
+  };
+
+  /**
+   * Exclusive right to compile the graph with a given hash. Released on
+   * destruction or by release().
+   */
+  class CompileLock {
+  public:
+    CompileLock();
+    CompileLock(CompileLock &&);
+    CompileLock &operator=(CompileLock &&);
+    ~CompileLock();
+
+    /// True if the lock is held.
+    bool owns() const;
+
+    /// True if another process held the lock when it was requested, or has
+    /// published the executable since. That process has either published the
+    /// executable or given up, so the cache should be checked again before
+    /// compiling.
+    bool waited() const { return waited_; }
+
+    void release();
+
+  private:
+    friend class EngineCache;
+    class Impl;
+    std::unique_ptr<Impl> impl;
+    bool waited_ = false;
+  };
+
+  /// The name of the index file within the cache directory.
+  static const char *const indexFileName;
+
+  /**
+   * \param dir The cache directory, SessionOptions::cachePath.
+   * \param maxBytes Once the executables in the cache add up to more than
+   *      this, the least recently used ones are deleted. 0 means no limit.
+   */
+  EngineCache(const std::string &dir, uint64_t maxBytes);
+
+  /// The cache at SessionOptions::cachePath, with a budget of
+  /// SessionOptions::engineCacheMaxBytes.
+  explicit EngineCache(const SessionOptions &opts);
+
+  /**
+   * The executables in the cache, by hash.
+   *
+   * If there is no index yet, the directory is scanned once, as in earlier
+   * releases, and the index is built from the `.popef` files found there.
+   * Entries whose file has been removed are skipped.
+   */
+  std::map<size_t, std::string> getEntries() const;
+
+  /// The path the executable with \p hash is published to.
+  std::string getEntryPath(size_t hash) const;
+
+  /// The path the fingerprint of the executable with \p hash is written to.
+  std::string getFingerprintPath(size_t hash) const;
+
+  /// Record that the executable with \p hash was loaded from the cache.
+  void recordHit(size_t hash);
+
+  /// Record that the executable with \p hash was not in the cache.
+  void recordMiss(size_t hash);
+
+  /**
+   * Atomically add the executable with \p hash to the cache, then evict the
+   * least recently used executables until the cache fits in the budget. The
+   * executable just published is never evicted. The compile lock file of
+   * \p hash is removed, as are those of the evicted executables.
+   *
+   * \param write Called with a stream to a temporary file, which is renamed
+   *      to getEntryPath() once \p write returns.
+   * \param fingerprint If not empty, written to getFingerprintPath().
+   */
+  void publish(size_t hash,
+               const std::function<void(std::ostream &)> &write,
+               const Fingerprint &fingerprint = {});
+
+  /// The fingerprint published with the executable with \p hash, if any.
+  nonstd::optional<Fingerprint> getFingerprint(size_t hash) const;
+
+  /**
+   * Compare \p fingerprint with the fingerprints of the executables in the
+   * cache, and return how it differs from the nearest one, which has the
+   * fewest differing components. Returns nothing if no executable in the
+   * cache has a fingerprint.
+   */
+  nonstd::optional<MissExplanation>
+  explainMiss(const Fingerprint &fingerprint) const;
+
+  /**
+   * Take the compile lock for \p hash, waiting for any other process that
+   * holds it. Returns a lock that owns nothing if the lock file cannot be
+   * created, for example because the cache directory is read only.
+   */
+  CompileLock lockForCompile(size_t hash);
+
+  /// The statistics recorded in the index.
+  Statistics getStatistics() const;
+
+private:
+  std::string dir;
+  uint64_t maxBytes;
+};
+
+} // namespace popart
+
+#endif // POPART_WILLOW_INCLUDE_POPART_ENGINECACHE_HPP_
@@ -32,6 +32,7 @@ const static AiGraphcoreOpIdV1 AsinGrad("AsinGrad");
 const static AiGraphcoreOpIdV1 Atan2Arg0Grad("Atan2Arg0Grad");
 const static AiGraphcoreOpIdV1 Atan2Arg1Grad("Atan2Arg1Grad");
 const static AiGraphcoreOpIdV1 AtanGrad("AtanGrad");
+const static AiGraphcoreOpIdV1 AttentionGrad("AttentionGrad");
 const static AiGraphcoreOpIdV1 AutoLossScaleProxyGrad("AutoLossScaleProxyGrad");
 const static AiGraphcoreOpIdV1 AveragePoolGrad("AveragePoolGrad");
 const static AiGraphcoreOpIdV1 BatchNormalizationGrad("BatchNormalizationGrad");
@@ -149,6 +150,7 @@ const static AiGraphcoreOpIdV1 AsinInplace("AsinInplace");
 const static AiGraphcoreOpIdV1 Atan2_1("Atan2", 2, 1);
 const static AiGraphcoreOpIdV1 Atan2Inplace("Atan2Inplace");
 const static AiGraphcoreOpIdV1 AtanInplace("AtanInplace");
+const static AiGraphcoreOpIdV1 Attention("Attention");
 const static AiGraphcoreOpIdV1 AutoLossScaleProxy("AutoLossScaleProxy", 1, 1);
 const static AiGraphcoreOpIdV1 BatchNormalization_1("BatchNormalization", 5, 5);
 const static AiGraphcoreOpIdV1 Call_1("Call");
@@ -187,6 +189,7 @@ const static AiGraphcoreOpIdV1 Expm1Inplace("Expm1Inplace");
 const static AiGraphcoreOpIdV1 FlattenInplace("FlattenInplace");
 const static AiGraphcoreOpIdV1 FloorInplace("FloorInplace");
 const static AiGraphcoreOpIdV1 Fmod("Fmod", 2, 1);
+const static AiGraphcoreOpIdV1 FusedElementwise("FusedElementwise");
 const static AiGraphcoreOpIdV1 Gelu_1("Gelu", 1, 1);
 const static AiGraphcoreOpIdV1 GeluInplace("GeluInplace");
 const static AiGraphcoreOpIdV1 GetRandomSeed("GetRandomSeed");
@@ -1,6 +1,7 @@
 // Copyright (c) 2019 Graphcore Ltd. All rights reserved.
 #ifndef POPART_WILLOW_INCLUDE_POPART_HALF_HPP_
 #define POPART_WILLOW_INCLUDE_POPART_HALF_HPP_
+#include <cstddef>
 #include <cstdint>
 #include <iosfwd>
 #include <type_traits>
@@ -14,6 +15,14 @@ namespace popart {
 extern float halfToFloat(uint16_t f16);
 extern uint16_t floatToHalf(float f);
 
+// Bulk conversions of `n` contiguous values from `src` to `dst`. The buffers
+// must not overlap. These use F16C or AVX-512 instructions when the host
+// supports them and fall back to a scalar loop otherwise. Floats are rounded
+// to the nearest half, ties to even. Prefer these over converting element by
+// element when converting tensor data.
+void halfToFloat(const uint16_t *src, float *dst, size_t n);
+void floatToHalf(const float *src, uint16_t *dst, size_t n);
+
 class Half {
 
 public:
@@ -103,6 +103,10 @@ public:
 
 using HashesMap = std::map<size_t, std::string>;
 
+// Hashes of the parts of an Ir that make up its hash, by name. These are
+// kept next to executables in the engine cache to explain cache misses.
+using IrFingerprint = std::map<std::string, size_t>;
+
 class Ir {
 
 public:
@@ -167,6 +171,8 @@ public:
   // Weights for training should always therefore rather appear in the ONNX
   // initializer list, and in the ONNX input list.
   void setOnnxModel(const ONNX_NAMESPACE::ModelProto &model);
+  // As above, but without copying the model.
+  void setOnnxModel(ONNX_NAMESPACE::ModelProto &&model);
 
   /**
    * Check if there's an ONNX model in the IR. This is true if the IR has been
@@ -260,6 +266,19 @@ public:
   bool isPrepared() const { return isPrepared_; }
   bool hashMatched() const { return hashMatched_; }
 
+  /**
+   * Replace the options that are only used when lowering the prepared IR:
+   * SessionOptions::engineOptions, \c convolutionOptions, \c matmulOptions,
+   * \c gclOptions and \c reportOptions. The graphs are left as they are, so
+   * the IR can be lowered again without being prepared again. Call
+   * updateHash() afterwards, with the hash seed of the new engine options.
+   *
+   * \param opts The new options. All options that are part of the hash of the
+   *      SessionOptions, other than those above, must be the same as the
+   *      current ones, as the graphs depend on them.
+   */
+  void setLoweringOptions(const SessionOptions &opts);
+
   void updateOptimizer(const Optimizer &);
 
   // take training steps
@@ -427,6 +446,12 @@ public:
   const SessionOptions &getSessionOptions() const { return userOptions; }
   SessionOptions &getSessionOptions() { return userOptions; }
 
+  // The options as they were passed to prepare(), before preparation changed
+  // any of them.
+  const SessionOptions &getPassedSessionOptions() const {
+    return passedUserOptions;
+  }
+
   void setSessionName(const std::string name) { sessionName = name; }
   const std::string getSessionName() const { return sessionName; }
 
@@ -702,7 +727,9 @@ private:
 
   std::unique_ptr<poprithms::logging::TimePartitionLogger> timePartitionLogger_;
 
-  std::unique_ptr<ONNX_NAMESPACE::ModelProto> onnxModel;
+  // Shared with the data of the tensors created from its initializers, which
+  // are views of the initializers' bytes.
+  std::shared_ptr<ONNX_NAMESPACE::ModelProto> onnxModel;
   // Additional tensors that we want to add to the model proto when saving to a
   // .onnx file
   std::set<Tensor *, PTensorCmp> additionalModelProtoTensors;
@@ -716,6 +743,11 @@ private:
   std::unique_ptr<Optimizer> optimizer;
   DeviceInfo *deviceInfo = nullptr;
   SessionOptions userOptions;
+  // The options as they were passed to prepare(). Preparation changes some of
+  // userOptions, such as the batch serialization settings chosen for a memory
+  // budget and the tensor locations chosen by the TensorLocationPlanner, and
+  // the hash of the IR is of the options before those changes.
+  SessionOptions passedUserOptions;
   std::string sessionName;
   InputShapeInfo inputShapeInfo;
 
@@ -773,6 +805,14 @@ private:
 
   size_t irBundleHash = 0;
 
+  IrFingerprint irBundleFingerprint;
+  IrFingerprint graphFingerprint;
+  IrFingerprint fingerprint;
+
+  // True if prepare() stopped after constructing the forward graph, because
+  // the executable was in the engine cache.
+  bool preparationSkipped = false;
+
 public:
   // A "dummy" Op used to ensure that anchor tensors
   // will be copied out of sub-graphs, even if they
@@ -800,6 +840,23 @@ public:
 
   size_t getHash() const;
   void computeHash(size_t hashSeed);
+
+  // Set the hash from \p hashSeed and the components of the hash that were
+  // stored by the last computeHash(), without scheduling the graphs again.
+  void updateHash(size_t hashSeed);
+
+  /**
+   * The components of the hash set by computeHash(): the session, data flow,
+   * optimizer and other parts of the IrBundle, the engine options in the hash
+   * seed, and each graph. Each graph contributes a hash of the whole graph,
+   * one per op type and one of the op names, unless
+   * SessionOptions::engineCacheIgnoreOpNames is set.
+   */
+  const IrFingerprint &getFingerprint() const { return fingerprint; }
+
+  // The graph components of getFingerprint(), computed from the current
+  // state of the graphs.
+  IrFingerprint getGraphFingerprint() const;
   size_t getIrBundleHash() const;
   void setIrBundleHash(size_t);
 
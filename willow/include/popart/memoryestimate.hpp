@@ -0,0 +1,83 @@
+// Copyright (c) 2022 Graphcore Ltd. All rights reserved.
+#ifndef POPART_WILLOW_INCLUDE_POPART_MEMORYESTIMATE_HPP_
+#define POPART_WILLOW_INCLUDE_POPART_MEMORYESTIMATE_HPP_
+
+#include <cstdint>
+#include <iosfwd>
+#include <map>
+#include <utility>
+#include <vector>
+
+#include "popart/names.hpp"
+
+namespace popart {
+
+class Ir;
+
+/**
+ * A static estimate of the peak device memory used by an IR, computed from the
+ * IR alone, without compiling it.
+ *
+ * The estimate is first order. It counts the bytes of every tensor that is
+ * live at each position of the global schedule of the LivenessAnalyzer,
+ * where:
+ *  - variables, constants and stream tensors are always live, unless their
+ *    TensorLocation is off chip,
+ *  - tensors sharded across the replicas count the bytes of one shard,
+ *  - pipeline stashes are always live,
+ *  - other tensors are live from their first to their last use in each call
+ *    of their graph,
+ *  - tensors that alias another tensor, such as the outputs of view changing
+ *    and inplace ops, add no bytes, but keep the tensor they alias live.
+ * Poplar's own temporary memory, code, exchange buffers and tile imbalance are
+ * not included, so the estimate is a lower bound on the memory required.
+ */
+struct MemoryEstimate {
+  /// A tensor and the number of bytes it adds to a peak.
+  using Contributor = std::pair<TensorId, int64_t>;
+
+  /// The peak number of live bytes on each virtual graph. Tensors without a
+  /// virtual graph are counted on virtual graph 0.
+  std::map<VGraphId, int64_t> peakBytesPerVirtualGraph;
+
+  /// The peak number of live bytes on the virtual graph of the ops of each
+  /// pipeline stage, while they run.
+  std::map<PipelineStage, int64_t> peakBytesPerPipelineStage;
+
+  /// The peak number of live bytes on the virtual graph of the ops of each
+  /// execution phase, while they run.
+  std::map<ExecutionPhase, int64_t> peakBytesPerExecutionPhase;
+
+  /// The largest tensors live at the peak of each virtual graph, largest
+  /// first.
+  std::map<VGraphId, std::vector<Contributor>> topContributors;
+
+  /// The number of bytes of tile memory of one IPU of the device, or 0 if the
+  /// IR has no device.
+  int64_t bytesPerIpu = 0;
+
+  /**
+   * Check whether the peak of every virtual graph fits in the tile memory of
+   * one IPU.
+   *
+   * \returns `true` if no peak exceeds bytesPerIpu, or if bytesPerIpu is
+   *      unknown.
+   */
+  bool fits() const;
+};
+
+std::ostream &operator<<(std::ostream &os, const MemoryEstimate &estimate);
+
+/**
+ * Estimate the peak device memory used by an IR.
+ *
+ * \param ir The IR to estimate the memory of.
+ * \param numTopContributors The number of tensors to report for the peak of
+ *      each virtual graph.
+ * \returns The memory estimate.
+ */
+MemoryEstimate estimateMemory(const Ir &ir, unsigned numTopContributors = 10);
+
+} // namespace popart
+
+#endif // POPART_WILLOW_INCLUDE_POPART_MEMORYESTIMATE_HPP_
@@ -4,6 +4,7 @@
 
 #include <popart/debugcontext.hpp>
 #include <popart/names.hpp>
+#include <popart/vendored/optional.hpp>
 
 namespace onnx {
 class TensorProto;
@@ -13,15 +14,23 @@ class ValueInfoProto;
 namespace popart {
 class TensorInfo;
 
+// The values of the ONNX debug infos are only built from their protos when
+// they are destroyed, which is when Poplar writes them out. The protos must
+// outlive the debug infos.
 class OnnxOpDebugInfo : public DebugInfo {
+  const Node &node;
+
 public:
   OnnxOpDebugInfo(const DebugContext &debugContext, const Node &node);
   OnnxOpDebugInfo &operator=(const OnnxOpDebugInfo &) = delete;
   OnnxOpDebugInfo(const OnnxOpDebugInfo &)            = delete;
-  virtual ~OnnxOpDebugInfo()                          = default;
+  virtual ~OnnxOpDebugInfo();
 };
 
 class OnnxVariableDebugInfo : public DebugInfo {
+  const ONNX_NAMESPACE::TensorProto *tensorProto       = nullptr;
+  const ONNX_NAMESPACE::ValueInfoProto *valueInfoProto = nullptr;
+  nonstd::optional<Shape> shapeFromInput;
 
 public:
   OnnxVariableDebugInfo(const DebugContext &dc,
@@ -36,7 +45,7 @@ public:
 
   OnnxVariableDebugInfo &operator=(const OnnxVariableDebugInfo &) = delete;
   OnnxVariableDebugInfo(const OnnxVariableDebugInfo &)            = delete;
-  virtual ~OnnxVariableDebugInfo()                                = default;
+  virtual ~OnnxVariableDebugInfo();
 };
 
 } // namespace popart
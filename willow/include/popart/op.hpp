@@ -742,8 +742,9 @@ public:
   /**
    * Append this op to a stream.
    * \param ss The stream to append the op to.
+   * \param withName If \c false, leave out the name of the op.
    */
-  void append(std::stringstream &ss) const;
+  void append(std::stringstream &ss, bool withName = true) const;
 
   /**
    * Convert this op to JSON format and append it to a stream.
@@ -0,0 +1,110 @@
+// Copyright (c) 2022 Graphcore Ltd. All rights reserved.
+#ifndef POPART_WILLOW_INCLUDE_POPART_OP_ATTENTION_HPP_
+#define POPART_WILLOW_INCLUDE_POPART_OP_ATTENTION_HPP_
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <set>
+#include <vector>
+#include <popart/op.hpp>
+
+#include "popart/names.hpp"
+#include "popart/tensorinfo.hpp"
+
+namespace popart {
+
+class OpSerialiserBase;
+struct OperatorIdentifier;
+
+// out = softmax(scale * query x keyTransposed + mask) x value
+//
+// query is [..., queries, depth], keyTransposed is [..., depth, keys], value
+// is [..., keys, valueDepth] and the optional mask is broadcastable to
+// [..., queries, keys]. The leading dimensions of query, keyTransposed and
+// value are the same.
+//
+// The scores are computed for tileSize keys at a time and combined with an
+// online softmax, so the [..., queries, keys] scores never exist in full. The
+// second output is the log of the sum of the exponentiated scores of each
+// query, from which the grad op recomputes the scores a tile at a time.
+class AttentionOp : public Op {
+public:
+  AttentionOp(const OperatorIdentifier &_opid,
+              float scale_,
+              int64_t tileSize_,
+              const Op::Settings &settings_);
+
+  std::unique_ptr<Op> clone() const final;
+  std::vector<std::unique_ptr<Op>> getGradOps() final;
+  void setup() final;
+
+  float getScale() const { return scale; }
+  int64_t getTileSize() const { return tileSize; }
+  bool hasMask() const { return hasInput(getMaskInIndex()); }
+
+  std::set<InIndex> optionalInputs() const override {
+    return {getMaskInIndex()};
+  }
+
+  void appendOutlineAttributes(OpSerialiserBase &) const override;
+
+  float getSubgraphValue() const final { return getHighSubgraphValue(); }
+
+  static InIndex getQueryInIndex() { return 0; }
+  static InIndex getKeyTransposedInIndex() { return 1; }
+  static InIndex getValueInIndex() { return 2; }
+  static InIndex getMaskInIndex() { return 3; }
+  static OutIndex getOutIndex() { return 0; }
+  static OutIndex getLogSumExpOutIndex() { return 1; }
+
+private:
+  float scale;
+  int64_t tileSize;
+};
+
+class AttentionGradOp : public Op {
+public:
+  AttentionGradOp(const AttentionOp &fwdOp);
+
+  std::unique_ptr<Op> clone() const final;
+  void setup() final;
+
+  const std::vector<GradInOutMapper> &gradInputInfo() const final;
+  const std::map<int, int> &gradOutToNonGradIn() const final;
+
+  float getScale() const { return scale; }
+  int64_t getTileSize() const { return tileSize; }
+  bool hasMask() const { return hasInput(getMaskInIndex()); }
+
+  std::set<InIndex> optionalInputs() const override {
+    return {getMaskInIndex()};
+  }
+
+  void appendOutlineAttributes(OpSerialiserBase &) const override;
+
+  float getSubgraphValue() const final { return getHighSubgraphValue(); }
+
+  static InIndex getGradInIndex() { return 0; }
+  static InIndex getQueryInIndex() { return 1; }
+  static InIndex getKeyTransposedInIndex() { return 2; }
+  static InIndex getValueInIndex() { return 3; }
+  static InIndex getFwdOutInIndex() { return 4; }
+  static InIndex getLogSumExpInIndex() { return 5; }
+  static InIndex getMaskInIndex() { return 6; }
+  static OutIndex getQueryOutIndex() { return 0; }
+  static OutIndex getKeyTransposedOutIndex() { return 1; }
+  static OutIndex getValueOutIndex() { return 2; }
+
+private:
+  float scale;
+  int64_t tileSize;
+  std::vector<GradInOutMapper> gradInInfo;
+  TensorInfo queryInfo;
+  TensorInfo keyTransposedInfo;
+  TensorInfo valueInfo;
+};
+
+} // namespace popart
+
+#endif // POPART_WILLOW_INCLUDE_POPART_OP_ATTENTION_HPP_
@@ -31,6 +31,7 @@ public:
   std::vector<std::unique_ptr<Op>> getGradOps() final;
 
   int64_t getAxis() const;
+  void setAxis(int64_t value) { axis = value; }
 
   // note that this is not final, ConcatInplaceOp overrides it
   std::vector<std::tuple<OperatorIdentifier, float>>
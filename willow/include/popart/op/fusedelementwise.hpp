@@ -0,0 +1,94 @@
+// Copyright (c) 2022 Graphcore Ltd. All rights reserved.
+#ifndef POPART_WILLOW_INCLUDE_POPART_OP_FUSEDELEMENTWISE_HPP_
+#define POPART_WILLOW_INCLUDE_POPART_OP_FUSEDELEMENTWISE_HPP_
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <popart/op.hpp>
+
+#include "popart/datatype.hpp"
+#include "popart/names.hpp"
+
+namespace popart {
+
+class OpSerialiserBase;
+struct OperatorIdentifier;
+
+enum class FusedElementwiseExprType {
+  // Leaves.
+  Input,
+  Const,
+  // Unary expressions.
+  Abs,
+  Cast,
+  Exp,
+  Log,
+  Neg,
+  Reciprocal,
+  Sigmoid,
+  Sqrt,
+  Tanh,
+  // Binary expressions.
+  Add,
+  Div,
+  Max,
+  Mul,
+  Pow,
+  Sub
+};
+
+std::string toString(FusedElementwiseExprType);
+
+// A node of the expression computed by a FusedElementwiseOp.
+struct FusedElementwiseExpr {
+  FusedElementwiseExprType type;
+
+  // The indices of the arguments, which come earlier in the expression.
+  std::vector<int> args;
+
+  // The input of an Input node.
+  InIndex inIndex = -1;
+
+  // The value of a Const node.
+  float value = 0.0f;
+
+  // The type a Cast node casts to.
+  DataType dataType = DataType::UNDEFINED;
+};
+
+// Computes an expression of its inputs elementwise. The expression is a list
+// of nodes in topological order, and the last node is the output. Inputs are
+// numpy broadcast to the output shape.
+//
+// This op replaces groups of connected elementwise ops, see the
+// ElementwiseFusion transform, so that they are computed together in one
+// compute set and without intermediate tensors.
+class FusedElementwiseOp : public Op {
+public:
+  FusedElementwiseOp(const OperatorIdentifier &_opid,
+                     const std::vector<FusedElementwiseExpr> &exprs_,
+                     const Op::Settings &settings_);
+
+  std::unique_ptr<Op> clone() const final;
+  void setup() final;
+
+  const std::vector<FusedElementwiseExpr> &getExprs() const { return exprs; }
+
+  // The expression in a readable form, one node after another, e.g.
+  // "in0; in1; Add(%0, %1); 0.5; Mul(%2, %3)".
+  std::string getExprString() const;
+
+  void appendOutlineAttributes(OpSerialiserBase &) const override;
+
+  float getSubgraphValue() const final { return getLowSubgraphValue(); }
+
+  static OutIndex getOutIndex() { return 0; }
+
+private:
+  std::vector<FusedElementwiseExpr> exprs;
+};
+
+} // namespace popart
+
+#endif // POPART_WILLOW_INCLUDE_POPART_OP_FUSEDELEMENTWISE_HPP_
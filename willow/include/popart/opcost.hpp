@@ -0,0 +1,49 @@
+// Copyright (c) 2022 Graphcore Ltd. All rights reserved.
+#ifndef POPART_WILLOW_INCLUDE_POPART_OPCOST_HPP_
+#define POPART_WILLOW_INCLUDE_POPART_OPCOST_HPP_
+
+namespace popart {
+
+class Op;
+
+/**
+ * A first order estimate of the cost of running an op, computed from the
+ * shapes of its inputs and outputs.
+ *
+ * Matrix multiplications, convolutions and attention, and their gradients,
+ * count two floating point operations per multiply-accumulate. Other ops count
+ * one per element of their largest input or output. Ops that call subgraphs
+ * add the cost of the ops of the subgraphs, for each iteration of a loop.
+ */
+struct OpCost {
+  /// The number of floating point operations.
+  double flops = 0.0;
+
+  /// The number of bytes of the inputs read and the outputs written.
+  double bytes = 0.0;
+
+  /**
+   * Get the cost of the op, in floating point operations.
+   *
+   * An op is bound by either its floating point operations or the bytes it
+   * accesses, so this is the larger of the two, with each byte counted as
+   * the floating point operations an IPU tile can do in the same time.
+   *
+   * \returns The cost of the op.
+   */
+  double getCost() const;
+
+  OpCost &operator+=(const OpCost &other);
+};
+
+/**
+ * Estimate the cost of running an op.
+ *
+ * \param op The op to estimate the cost of.
+ * \returns The cost of the op.
+ */
+OpCost estimateOpCost(const Op *op);
+
+} // namespace popart
+
+#endif // POPART_WILLOW_INCLUDE_POPART_OPCOST_HPP_
@@ -2,14 +2,27 @@
 #ifndef POPART_WILLOW_INCLUDE_POPART_OPDEBUGINFO_HPP_
 #define POPART_WILLOW_INCLUDE_POPART_OPDEBUGINFO_HPP_
 
+#include <map>
+#include <string>
+#include <vector>
 #include <popart/debugcontext.hpp>
+#include <popart/names.hpp>
 
 namespace popart {
 class Op;
+
+// The values of the debug info of an op are only built when it is destroyed,
+// which is when Poplar writes it out. Until then, it keeps the provenance of
+// the op that finalize() records, as plain strings.
 class OpDebugInfo : public DebugInfo {
   const Op &op;
   bool finalizeCalled = false;
 
+  std::vector<TensorId> inputs;
+  std::vector<TensorId> outputs;
+  std::map<std::string, std::string> attributes;
+  std::string graphId;
+
 public:
   OpDebugInfo(const DebugContext &debugContext, const Op &_op);
   virtual ~OpDebugInfo();
@@ -17,8 +30,8 @@ public:
   OpDebugInfo &operator=(const OpDebugInfo &) = delete;
   OpDebugInfo(const OpDebugInfo &)            = delete;
 
-  // Called when the op is fully configured. Sets the debug info
-  // for this op.
+  // Called when the op is fully configured. Records the inputs, outputs and
+  // attributes of this op for its debug info.
   void finalize();
 };
 } // namespace popart
@@ -2,6 +2,7 @@
 #ifndef POPART_WILLOW_INCLUDE_POPART_OPMANAGER_HPP_
 #define POPART_WILLOW_INCLUDE_POPART_OPMANAGER_HPP_
 
+#include <cstddef>
 #include <cstdint>
 #include <functional>
 #include <iosfwd>
@@ -9,6 +10,7 @@
 #include <memory>
 #include <set>
 #include <string>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 #include <popart/attributes.hpp>
@@ -306,7 +308,25 @@ private:
   // Singleton
   static OpManager &getInstance();
 
-  // Search opMap for the OpInfo with the highest version that is less than or
+  // The registered versions of one domain and type.
+  struct OpVersions {
+    // Sorted. The OpInfo of each version is at the same index in infos.
+    std::vector<int> versions;
+    std::vector<std::unique_ptr<OpInfo>> infos;
+
+    // The OpInfo with the highest version that is less than or equal to
+    // maxVersion, or null if there is none.
+    OpInfo *findAtMost(int maxVersion) const;
+    // The OpInfo of exactly the version, or null if there is none.
+    OpInfo *find(int version) const;
+  };
+
+  // Find the versions registered for the domain and type, or null if there
+  // are none. An empty domain is the ai.onnx domain.
+  const OpVersions *findOpVersions(const OpDomain &domain,
+                                   const OpType &type) const;
+
+  // Search for the OpInfo with the highest version that is less than or
   // equal to the opsetVersion. This method will return null if a suitable op is
   // not found.
   OpInfo *
@@ -318,8 +338,13 @@ private:
                                   int opsetVersion,
                                   Graph &graph);
 
-  // Map of domain/type to the list of supported versions and the opInfo
-  std::map<std::pair<OpDomain, OpType>, std::map<int, OpInfo>> opMap;
+  // The index in opVersions of each registered domain and type. Domains and
+  // types are interned when they are first registered, so that finding the op
+  // of a node is two hash lookups and a binary search over its versions.
+  std::unordered_map<OpDomain, std::unordered_map<OpType, size_t>> opTypeIds;
+
+  // The versions of each registered domain and type, see opTypeIds.
+  std::vector<OpVersions> opVersions;
 };
 
 // This class registers a lambda function to create a op with the
@@ -68,7 +68,7 @@ private:
 
 class OpSerialiser : public OpSerialiserBase {
 public:
-  OpSerialiser(const Op *, std::stringstream &ss_);
+  OpSerialiser(const Op *, std::stringstream &ss_, bool withName = true);
 
   void appendAttribute(const std::string &, nonstd::optional<int64_t>) override;
   void appendAttribute(const std::string &, nonstd::optional<float>) override;
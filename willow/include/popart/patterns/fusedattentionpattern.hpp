@@ -0,0 +1,38 @@
+// Copyright (c) 2022 Graphcore Ltd. All rights reserved.
+#ifndef POPART_WILLOW_INCLUDE_POPART_PATTERNS_FUSEDATTENTIONPATTERN_HPP_
+#define POPART_WILLOW_INCLUDE_POPART_PATTERNS_FUSEDATTENTIONPATTERN_HPP_
+
+#include <cstdint>
+#include <vector>
+#include <popart/patterns/pattern.hpp>
+
+namespace popart {
+
+class Op;
+class Tensor;
+
+// Replace the attention subgraph
+//
+//   query, keyTransposed -> MatMul -> [Scale] -> [Add(mask)] -> Softmax
+//     -> [Dropout] -> MatMul(value)
+//
+// with an AttentionOp, whose lowering never holds the full scores. The scale
+// may be a Scale op, or a Mul or Div by a constant scalar, and the Dropout must
+// be an identity. The pattern is applied before the backwards pass is
+// constructed, so that the grad of the subgraph is an AttentionGradOp, which
+// recomputes the scores a tile at a time instead of stashing them.
+class FusedAttentionPattern : public PreAliasPattern {
+public:
+  bool matches(Op *) const override;
+
+  std::vector<const Tensor *> touches(Op *) const override;
+
+  bool apply(Op *) const override;
+
+  // The number of keys the scores are computed for at a time.
+  static int64_t getTileSize() { return 128; }
+};
+
+} // namespace popart
+
+#endif // POPART_WILLOW_INCLUDE_POPART_PATTERNS_FUSEDATTENTIONPATTERN_HPP_
@@ -51,6 +51,8 @@ public:
 
 private:
   std::unordered_map<std::type_index, std::string> names;
+  // The pattern classes of each name, for finding names in constant time.
+  std::unordered_map<std::string, std::type_index> types;
 
   static PatternNames &getInstance() {
     static PatternNames instance;
@@ -78,6 +80,9 @@ private:
   PreAliasPatternManager() = default;
 
   std::map<std::type_index, PreAliasPatternInfo> patternInfos;
+  // The pattern of each name, so that patterns are found by name in constant
+  // time.
+  std::unordered_map<std::string, std::type_index> typeIndices;
 
   // Singleton
   static PreAliasPatternManager &getInstance();
@@ -89,6 +94,7 @@ public:
                   bool enabled,
                   bool mandatory,
                   std::function<std::unique_ptr<PreAliasPattern>()> func) {
+    getInstance().typeIndices.insert({name, ti});
     getInstance().patternInfos.insert(
         {ti, PreAliasPatternInfo{enabled, mandatory, name, func}});
   }
@@ -118,13 +124,12 @@ public:
     return getInfo(ti).name;
   }
 
-  static nonstd::optional<std::type_index> tryGetTypeIndex(std::string s) {
-    for (auto &ti_info : getInstance().patternInfos) {
-      auto &ti   = ti_info.first;
-      auto &info = ti_info.second;
-      if (info.name == s) {
-        return ti;
-      }
+  static nonstd::optional<std::type_index>
+  tryGetTypeIndex(const std::string &s) {
+    const auto &typeIndices = getInstance().typeIndices;
+    auto found              = typeIndices.find(s);
+    if (found != typeIndices.end()) {
+      return found->second;
     }
     return nonstd::nullopt;
   }
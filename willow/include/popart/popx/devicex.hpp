@@ -8,9 +8,11 @@
 #include <iosfwd>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <set>
 #include <string>
 #include <tuple>
+#include <utility>
 #include <vector>
 #include <poplar/Engine.hpp> // IWYU pragma: keep
 #include <poplar/StreamCallback.hpp>
@@ -43,6 +45,9 @@ using PopStreamId = std::string;
 class IrLowering;
 class Executablex;
 class DevicexInfo;
+class WeightTransferEngine;
+struct HostCopyJob;
+struct PlanningCaches;
 
 poplar::Type popType(const TensorInfo &);
 poplar::Type popType(DataType);
@@ -65,6 +70,8 @@ private:
   int nCallsToRun{0};
   std::shared_ptr<DeviceInfo> deviceInfo;
   bool prepareHasBeenCalled_;
+  // Owns convCache and matmulCache, which may be shared with other sessions.
+  std::shared_ptr<PlanningCaches> planningCaches;
 
 public:
   const Ir &ir() const;
@@ -104,6 +111,12 @@ public:
   // (weightsToHost() + d2hWeightBuffersToTensorData)
   void weightsToHost(const std::map<TensorId, MutableVoidData> &);
 
+  // The host end of the d2h weight stream of tensor `id`, as the contiguous
+  // segments which, concatenated, hold the data that weightsToHost(map) would
+  // copy out. Only valid after weightsToHost(), until its next call.
+  std::vector<std::pair<const char *, size_t>>
+  getHostWeightSegments(const TensorId &id, DownsampleStream downsample);
+
 private:
   // host stream -> specified host addresses
   void d2hWeightBuffersToTensorData(
@@ -176,8 +189,13 @@ public:
 
   // Although these belong in IrLowering we keep these in devicex since
   // they may be used in custom ops
-  poplin::PlanningCache convCache;
-  poplin::matmul::PlanningCache matmulCache;
+  poplin::PlanningCache &convCache;
+  poplin::matmul::PlanningCache &matmulCache;
+
+  // Lock the planning caches while growing the graph, as they may be shared
+  // with sessions in other threads. See
+  // SessionOptions::enablePlanningCacheReuse.
+  std::unique_lock<std::mutex> lockPlanningCaches();
   // These are always expected to be true. They have only been exposed for
   // testing.
   bool prePlanConvolutions = true;
@@ -325,6 +343,11 @@ private:
   // Precondition: Tensor is in `executable_.getWeightTensors()`
   char *getD2hWeightData(Tensor *);
 
+  // Spreads the host side of weight transfers over several threads. Created
+  // on first use, with SessionOptions::weightTransferThreads threads.
+  std::unique_ptr<WeightTransferEngine> weightTransferEngine;
+  WeightTransferEngine &getWeightTransferEngine();
+
   // Buffers for storing the hardware cycle count
   std::map<std::string, std::vector<uint64_t>> cycleCount;
 
@@ -360,6 +383,13 @@ private:
                         TensorId id,
                         DownsampleStream downsample);
 
+  // As hostStreamToHost, but appends the copies to `jobs` instead of
+  // performing them, so that copies for many tensors can be done together.
+  void appendHostStreamToHostCopies(const MutableVoidData &mv_data,
+                                    TensorId id,
+                                    DownsampleStream downsample,
+                                    std::vector<HostCopyJob> &jobs);
+
   // Call hostToHostStream on all the Tensors in pir->dataStreamTensors()
   void anchorsHostToHostStreams(IStepIO &stepio);
 
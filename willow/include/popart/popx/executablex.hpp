@@ -24,6 +24,10 @@ namespace popart {
 class DataFlow;
 struct SessionOptions;
 
+namespace shardedcheckpoint {
+class Reader;
+}
+
 namespace popx {
 class IrLowering;
 
@@ -95,6 +99,9 @@ public:
   void resetWeights(
       const ONNX_NAMESPACE::ModelProto &modelProto,
       const bool ignoreWeightsInModelWithoutCorrespondingIrWeight = false);
+  void resetWeights(
+      const shardedcheckpoint::Reader &checkpoint,
+      const bool ignoreWeightsInModelWithoutCorrespondingIrWeight = false);
 
   const SessionOptions &getSessionOptions() const { return options; }
 
@@ -0,0 +1,90 @@
+// Copyright (c) 2022 Graphcore Ltd. All rights reserved.
+#ifndef POPART_WILLOW_INCLUDE_POPART_POPX_OP_ATTENTIONX_HPP_
+#define POPART_WILLOW_INCLUDE_POPART_POPX_OP_ATTENTIONX_HPP_
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <snap/Tensor.hpp>
+#include <popops/OperationDef.hpp>
+
+#include "popart/names.hpp"
+#include "popart/popx/popopx.hpp"
+
+namespace snap {
+namespace program {
+class Sequence;
+} // namespace program
+} // namespace snap
+
+namespace popart {
+class Op;
+
+namespace popx {
+class Devicex;
+
+// The attention ops work on tensors with their leading dimensions flattened
+// into one group dimension: the query is [groups, queries, depth], the
+// transposed key is [groups, depth, keys] and the value is
+// [groups, keys, valueDepth]. Both ops visit the keys tileSize at a time.
+class AttentionBaseOpx : public PopOpx {
+public:
+  AttentionBaseOpx(Op *, Devicex *);
+
+protected:
+  // Reshape t of shape [..., m, n] to [groups, m, n].
+  snap::Tensor flattenGroups(const snap::Tensor &t) const;
+
+  // The grouped matrix product of a [groups, m, k] and b [groups, k, n].
+  snap::Tensor matMul(const snap::Tensor &a,
+                      const snap::Tensor &b,
+                      snap::program::Sequence &,
+                      const std::string &debugName) const;
+
+  // Reduce the last dimension of t.
+  snap::Tensor reduceRows(const snap::Tensor &t,
+                          popops::Operation,
+                          snap::program::Sequence &,
+                          const std::string &debugName) const;
+
+  // Broadcast t of shape [..., m] to [..., m, n].
+  snap::Tensor broadcastRows(const snap::Tensor &t, std::size_t n) const;
+
+  // The mask input broadcast to the [groups, queries, keys] scores, or an
+  // invalid tensor if the op has no mask.
+  snap::Tensor getMask(InIndex maskIndex,
+                       InIndex queryIndex,
+                       InIndex keyTransposedIndex) const;
+
+  // The scaled and masked scores of the query and the keys [begin, end) of
+  // the transposed key. mask is as returned by getMask.
+  snap::Tensor scores(const snap::Tensor &query,
+                      const snap::Tensor &keyTransposed,
+                      const snap::Tensor &mask,
+                      std::size_t begin,
+                      std::size_t end,
+                      float scale,
+                      snap::program::Sequence &) const;
+};
+
+// Computes the attention a tile of keys at a time with an online softmax: the
+// running maximum and sum of each row are kept, and the partial output is
+// corrected each time the maximum grows.
+class AttentionOpx : public AttentionBaseOpx {
+public:
+  AttentionOpx(Op *, Devicex *);
+  void grow(snap::program::Sequence &) const final;
+};
+
+// Recomputes the probabilities a tile of keys at a time from the log-sum-exp
+// of the forward op.
+class AttentionGradOpx : public AttentionBaseOpx {
+public:
+  AttentionGradOpx(Op *, Devicex *);
+  void grow(snap::program::Sequence &) const final;
+};
+
+} // namespace popx
+} // namespace popart
+
+#endif // POPART_WILLOW_INCLUDE_POPART_POPX_OP_ATTENTIONX_HPP_
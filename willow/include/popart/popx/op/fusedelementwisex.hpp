@@ -0,0 +1,38 @@
+// Copyright (c) 2022 Graphcore Ltd. All rights reserved.
+#ifndef POPART_WILLOW_INCLUDE_POPART_POPX_OP_FUSEDELEMENTWISEX_HPP_
+#define POPART_WILLOW_INCLUDE_POPART_POPX_OP_FUSEDELEMENTWISEX_HPP_
+
+#include <snap/Tensor.hpp>
+#include <popart/names.hpp>
+
+#include "popart/popx/popopx.hpp"
+
+namespace snap {
+namespace program {
+class Sequence;
+} // namespace program
+} // namespace snap
+
+namespace popart {
+class Op;
+
+namespace popx {
+class Devicex;
+
+// Computes the expression of a FusedElementwiseOp with a single popops::map.
+class FusedElementwiseOpx : public PopOpx {
+public:
+  FusedElementwiseOpx(Op *, Devicex *);
+  void grow(snap::program::Sequence &) const final;
+
+  InputCreatorType getInputCreatorType(InIndex) const override;
+
+  snap::Tensor
+      unwindTensorLayout(snap::Tensor, InIndex, OutIndex) const override;
+  view::RegMap unwindRegion(InIndex, OutIndex) const override;
+};
+
+} // namespace popx
+} // namespace popart
+
+#endif // POPART_WILLOW_INCLUDE_POPART_POPX_OP_FUSEDELEMENTWISEX_HPP_
@@ -4,6 +4,7 @@
 
 #include <iostream>
 #include <memory>
+#include <string>
 #include <vector>
 
 #include "popart/vendored/optional.hpp"
@@ -113,6 +114,17 @@ public:
    */
   Reader(const std::vector<std::shared_ptr<std::istream>> &in_vec);
 
+  /**
+   * Constructs Reader class object from a PopEF file on disk.
+   *
+   * The file is memory mapped read only rather than read through a
+   * \c std::ifstream, so the executable and tensor data blobs are read
+   * straight from the page cache.
+   *
+   * \param filePath The path of the PopEF file.
+   */
+  explicit Reader(const std::string &filePath);
+
   /**
    * Move constructor.
    */
@@ -11,6 +11,7 @@
 #include <string>
 #include <vector>
 #include <popart/ir.hpp>
+#include <popart/memoryestimate.hpp>
 #include <popart/sessionoptions.hpp>
 
 #include "popart/dataflow.hpp"
@@ -30,6 +31,9 @@ namespace popx {
 class Devicex;
 class IrLowering;
 class Executablex;
+namespace serialization {
+class Reader;
+} // namespace serialization
 } // namespace popx
 
 const std::string DefaultInferenceSessionName = "inference";
@@ -284,6 +288,8 @@ public:
    * Load the compiled executable and metadata from a file.
    *
    * The file must have been created with compileAndExport(const std::string).
+   * It is memory mapped rather than read through a stream, which makes this
+   * the fastest way to load a large executable.
    *
    * \param filename The name of the file to load the executable and metadata
    *      from.
@@ -437,6 +443,25 @@ public:
    */
   void modelToHost(const std::string &fn);
 
+  /**
+   * Write the current weights to a sharded checkpoint.
+   *
+   * The checkpoint is a directory holding a small index and a number of data
+   * shards, see shardedcheckpoint.hpp. The shards are written in parallel
+   * directly from the host weight buffers, so no additional copy of the
+   * weights is made and, unlike modelToHost(), there is no 2 GB limit on the
+   * size of the model.
+   *
+   * The checkpoint can be loaded with resetHostWeights(), or, partially and
+   * lazily, by passing a shardedcheckpoint::Reader to writeWeights().
+   *
+   * \param dir The checkpoint directory. It is created if it does not exist,
+   *      and an existing checkpoint in it is overwritten.
+   * \param numShards The number of data shards. 0 picks a number based on the
+   *      size of the model and SessionOptions::weightTransferThreads.
+   */
+  void weightsToCheckpoint(const std::string &dir, unsigned numShards = 0);
+
   /**
    * Get the tensor information for a tensor.
    *
@@ -503,6 +528,24 @@ public:
    */
   pva::Report getReport() const;
 
+  /**
+   * Estimate the peak device memory used by the session's IR, without
+   * compiling it.
+   *
+   * The estimate reports the peak live bytes per virtual graph, pipeline
+   * stage and execution phase, and the largest tensors live at each peak.
+   * See MemoryEstimate for what is counted.
+   *
+   * This method may be called before prepareDevice(), but not when the
+   * executable is loaded from the cache.
+   *
+   * \param numTopContributors The number of tensors to report for the peak of
+   *      each virtual graph. Default = 10.
+   *
+   * \return The memory estimate.
+   */
+  MemoryEstimate getMemoryEstimate(unsigned numTopContributors = 10) const;
+
   /**
    * Reset weights with weights in an ONNX model.
    *
@@ -512,8 +555,11 @@ public:
    * This method only updates the weights on the host. weightsFromHost() must
    * be called after this method to update the weights on the device.
    *
-   * \param model An ONNX model protobuf, or the name of a file containing an
-   *      ONNX model protobuf.
+   * Weights that are not in the ONNX model are left unchanged.
+   *
+   * \param model An ONNX model protobuf, the name of a file containing an
+   *      ONNX model protobuf, or a sharded checkpoint directory written by
+   *      weightsToCheckpoint().
    * \param ignoreWeightsInModelWithoutCorrespondingHostWeight If `true`, do not
    *      throw an error if there are initializers in the ONNX model without
    *      corresponding initializer tensor(s) in the session's IR.
@@ -590,6 +636,21 @@ public:
    */
   void updateEngineCache();
 
+  /**
+   * Change the options used to lower the prepared IR and compile it, and set
+   * the session up to do so again, without preparing the IR again.
+   *
+   * Only SessionOptions::engineOptions, \c convolutionOptions,
+   * \c matmulOptions, \c gclOptions and \c reportOptions are changed. Use
+   * this to try different Poplar options, or to retry after compiling failed.
+   * The engine cache is looked up again with the new options. Call
+   * prepareDevice() afterwards.
+   *
+   * \param userOptions The new options. The options that the IR depends on
+   *      must be the same as those the session was created with.
+   */
+  void setLoweringOptions(const SessionOptions &userOptions);
+
   /**
    * Set the DeviceInfo of the Session.
    */
@@ -611,6 +672,11 @@ protected:
    */
   bool tryLoadExecutable();
 
+  /**
+   * Load the compiled executable and metadata from a PopEF reader.
+   */
+  void loadExecutableFromReader(popx::serialization::Reader &reader);
+
   /**
    * Throw an error if there is no executable.
    */
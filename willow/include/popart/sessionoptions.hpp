@@ -150,6 +150,12 @@ enum class RecomputationType {
   Pipeline,
   /// Recompute all ops.
   RecomputeAll,
+  /**
+   * Recompute the ops that save the most activation memory for the fewest
+   * floating point operations, until the activations of each IPU fit in
+   * \c SessionOptions::autoRecomputationMemoryBudget.
+   */
+  MemoryBudget,
   /// The number of \c RecomputationTypes values.
   N
 };
@@ -337,6 +343,53 @@ std::string toString(const TensorLocationSettings &);
 /// Stream the value for TensorLocationSettings.
 std::ostream &operator<<(std::ostream &, const TensorLocationSettings &);
 
+/**
+ * A structure containing settings for the TensorLocationPlanner transform,
+ * which chooses the TensorLocation of each tensor to fit a memory budget.
+ */
+struct TensorLocationPlannerSettings {
+  /// Default constructor for the TensorLocationPlannerSettings struct.
+  TensorLocationPlannerSettings() = default;
+
+  /**
+   * Constructor for the TensorLocationPlannerSettings struct.
+   * \param enabled_ Plan the tensor locations (`true`) or not (`false`).
+   * \param memoryBudget_ The bytes of tile memory per IPU that the tensors
+   *        may use, or 0 for the tile memory of an IPU.
+   * \param remoteBandwidth_ The bytes per second streamed between remote
+   *        buffers and an IPU.
+   * \param replicatedBandwidth_ The bytes per second gathered from the other
+   *        replicas by an IPU.
+   */
+  TensorLocationPlannerSettings(bool enabled_,
+                                int64_t memoryBudget_,
+                                double remoteBandwidth_,
+                                double replicatedBandwidth_);
+
+  std::size_t hash() const;
+
+  /**
+   * Choose the TensorLocation of the weights, optimizer state, accumulators
+   * and, with execution phases, activations that are not set by the user,
+   * with the TensorLocationPlanner transform. The thresholds of the
+   * TensorLocationSettings of each type of tensor are not used for them.
+   * Enabled when `true`. Default: `false`.
+   */
+  bool enabled = false;
+
+  /// The bytes of tile memory per IPU that the predicted peak of live
+  /// tensors may use, or 0 for the tile memory of an IPU. Default: 0.
+  int64_t memoryBudget = 0;
+
+  /// The bytes per second streamed between remote buffers and an IPU, to
+  /// predict the time added by off-chip tensors. Default: 16e9.
+  double remoteBandwidth = 16.0e9;
+
+  /// The bytes per second gathered from the other replicas by an IPU, to
+  /// predict the time added by replicated tensor sharding. Default: 64e9.
+  double replicatedBandwidth = 64.0e9;
+};
+
 /**
  * Enum type that describes how to change the batch serialisation subgraph
  * schedule before outlining.
@@ -423,6 +476,8 @@ struct BatchSerializationSettings {
    *        applied. Default: BatchSerializationMethod::UnrollDynamic.
    * \param batchSchedule_ An experimental value that changes how operations are
    *        scheduled. Default: BatchSerializationBatchSchedule::Isomorphic.
+   * \param memoryBudget_ The bytes of live activations per IPU to choose the
+   *        factor and method for. Default: 0 (not used).
    */
   BatchSerializationSettings(
       int factor_,
@@ -434,7 +489,8 @@ struct BatchSerializationSettings {
       BatchSerializationMethod method_ =
           BatchSerializationMethod::UnrollDynamic,
       BatchSerializationBatchSchedule batchSchedule_ =
-          BatchSerializationBatchSchedule::Isomorphic);
+          BatchSerializationBatchSchedule::Isomorphic,
+      int64_t memoryBudget_ = 0);
 
   /// The number of compute batches to split operations into.
   int factor = 0;
@@ -461,6 +517,17 @@ struct BatchSerializationSettings {
   /// Experimental value that changes how operations are scheduled.
   BatchSerializationBatchSchedule batchSchedule =
       BatchSerializationBatchSchedule::Isomorphic;
+  /**
+   * The bytes of live activations per IPU to serialize the batch for. If
+   * greater than 0, the factor and method are chosen automatically: the
+   * smallest factor, and the method for it, with which the predicted peak
+   * bytes of the live activations of each IPU fit in this budget. The
+   * prediction includes the buffers the slices are copied to and from. Among
+   * the methods that fit, the one that copies the fewest bytes is chosen. The
+   * choice is logged. Can not be used together with \c factor.
+   * Default: 0 (not used).
+   */
+  int64_t memoryBudget = 0;
 };
 
 /**
@@ -760,6 +827,129 @@ struct AutodiffSettings {
       AutodiffStitchStrategy::RecomputeAllNonInputs;
 };
 
+/**
+ * The settings for the Autocast transform, which inserts casts so that the
+ * ops of a model run in mixed precision.
+ *
+ * Ops are identified by their type, for example `"MatMul"`. The ops of types
+ * in none of the lists consume their inputs in their original data types.
+ */
+struct AutocastSettings {
+  /// Default constructor for the AutocastSettings struct.
+  AutocastSettings() = default;
+
+  /**
+   * Constructor for the AutocastSettings struct.
+   * \param enabled_ Run the ops of the model in mixed precision (`true`) or
+   *        not (`false`). Default: `false`.
+   * \param allowOpTypes_ The types of the ops to run in FLOAT16.
+   * \param denyOpTypes_ The types of the ops to run in FLOAT.
+   * \param promoteOpTypes_ The types of the ops to run in FLOAT16 if any of
+   *        their floating point inputs is FLOAT16.
+   */
+  AutocastSettings(bool enabled_,
+                   const std::vector<std::string> &allowOpTypes_,
+                   const std::vector<std::string> &denyOpTypes_,
+                   const std::vector<std::string> &promoteOpTypes_);
+
+  std::size_t hash() const;
+
+  /**
+   * Run the ops of the model in mixed precision. The variables remain FLOAT,
+   * and are cast to FLOAT16 where they are consumed, so that the optimizer
+   * updates FLOAT master weights with FLOAT gradients.
+   * Enabled when `true`. Default: `false`.
+   */
+  bool enabled = false;
+
+  /// The types of the ops to run in FLOAT16. Their floating point inputs are
+  /// cast to FLOAT16.
+  std::vector<std::string> allowOpTypes = {"Conv", "ConvTranspose", "MatMul"};
+
+  /// The types of the ops to run in FLOAT, such as reductions, softmax and
+  /// losses. Their floating point inputs are cast to FLOAT.
+  std::vector<std::string> denyOpTypes = {"Exp",
+                                          "IdentityLoss",
+                                          "L1",
+                                          "Log",
+                                          "LogSoftmax",
+                                          "Nll",
+                                          "Pow",
+                                          "ReduceL1",
+                                          "ReduceL2",
+                                          "ReduceLogSum",
+                                          "ReduceLogSumExp",
+                                          "ReduceMean",
+                                          "ReduceProd",
+                                          "ReduceSum",
+                                          "ReduceSumSquare",
+                                          "Softmax"};
+
+  /// The types of the ops to run in FLOAT16 if any of their floating point
+  /// inputs is FLOAT16, in which case the others are cast to FLOAT16.
+  std::vector<std::string> promoteOpTypes = {"Abs",
+                                             "Add",
+                                             "AutoLossScaleProxy",
+                                             "Concat",
+                                             "Div",
+                                             "Dropout",
+                                             "Flatten",
+                                             "Gelu",
+                                             "Identity",
+                                             "Max",
+                                             "Min",
+                                             "Mul",
+                                             "Neg",
+                                             "Relu",
+                                             "Reshape",
+                                             "Scale",
+                                             "Sigmoid",
+                                             "Slice",
+                                             "Sqrt",
+                                             "Squeeze",
+                                             "Sub",
+                                             "Sum",
+                                             "Tanh",
+                                             "Transpose",
+                                             "Unsqueeze",
+                                             "Where"};
+};
+
+/**
+ * The settings for placing ops on virtual graphs when the virtual graph mode
+ * is VirtualGraphMode::Auto.
+ */
+struct AutoVirtualGraphSettings {
+  /// Default constructor for the AutoVirtualGraphSettings struct.
+  AutoVirtualGraphSettings() = default;
+
+  /**
+   * Constructor for the AutoVirtualGraphSettings struct.
+   * \param balanceStages_ Place ops with the PipelineStageBalancer transform
+   *        (`true`) or the AutoVirtualGraph transform (`false`). Default:
+   *        `false`.
+   * \param maxMemoryProportion_ The proportion of the tile memory of an IPU
+   *        that the weights and stashed activations of a stage may use.
+   */
+  AutoVirtualGraphSettings(bool balanceStages_, float maxMemoryProportion_);
+
+  std::size_t hash() const;
+
+  /**
+   * Place ops with the PipelineStageBalancer transform, which splits the
+   * schedule into one stage per IPU so that the estimated cost of the most
+   * expensive stage is as small as possible, within the memory of each IPU.
+   * Otherwise, ops are placed by the AutoVirtualGraph transform. Enabled when
+   * `true`. Default: `false`.
+   */
+  bool balanceStages = false;
+
+  /// The proportion of the tile memory of an IPU that the weights and stashed
+  /// activations of a stage may use, leaving the rest for temporary memory,
+  /// code and exchange. Default: 0.6.
+  float maxMemoryProportion = 0.6f;
+};
+
 /// Struct for development-specific configuration intended to be used by
 /// PopART developers, as opposed to PopART users.
 ///
@@ -824,6 +1014,29 @@ struct SessionOptions {
    */
   bool enableOutlining = true;
 
+  /**
+   * Enable fusing connected elementwise ops into single ops.
+   * Each group of fused ops is computed by one expression, in one compute set,
+   * instead of one compute set and intermediate tensor for each op.
+   * Enabled when `true`. Default: `false`.
+   */
+  bool enableElementwiseFusion = false;
+
+  /**
+   * Enable common subexpression elimination by global value numbering.
+   * Ops computing the same values as earlier ops, including calls of the same
+   * pure subgraphs, are removed before autodiff.
+   * Enabled when `true`. Default: `false`.
+   */
+  bool enableGlobalValueNumbering = false;
+
+  /**
+   * Enable moving transposes and reshapes past the ops that do not depend on
+   * the layout of their inputs, so that inverse pairs cancel.
+   * Enabled when `true`. Default: `false`.
+   */
+  bool enableTransposeSinking = false;
+
   /**
    * Enable inclusion of the cost of copying of cached sections should be
    * in the outlining cost model.
@@ -881,6 +1094,21 @@ struct SessionOptions {
    */
   RecomputationType autoRecomputation = RecomputationType::None;
 
+  /**
+   * The bytes of forward pass activations that each IPU may keep for the
+   * backward pass, when \c autoRecomputation is
+   * RecomputationType::MemoryBudget. Ops are recomputed, in order of the bytes
+   * they save per floating point operation recomputed, until the activations
+   * kept, and those recomputed at once, fit in the budget.
+   *
+   * With pipelining, each stage keeps the activations of several batches, so
+   * the budget is for the activations of one batch. With implicit pipelining,
+   * the ops to recompute are chosen by the pipeline transform instead.
+   *
+   * Default: 0 (must be set for RecomputationType::MemoryBudget).
+   */
+  int64_t autoRecomputationMemoryBudget = 0;
+
   /**
    * Enable merging of VarUpdates into groups of VarUpdates, by flattening
    * and concatenating variable tensors and updating tensors.
@@ -1051,6 +1279,10 @@ struct SessionOptions {
    */
   VirtualGraphMode virtualGraphMode = VirtualGraphMode::Off;
 
+  /// Configuration settings for placing ops on virtual graphs, when \c
+  /// virtualGraphMode is VirtualGraphMode::Auto.
+  AutoVirtualGraphSettings autoVirtualGraphSettings;
+
   /// Enable pipelining of virtual graphs. Default: `false` (not enabled).
   bool enablePipelining = false;
 
@@ -1157,6 +1389,33 @@ struct SessionOptions {
   /// Folder to save the \c poplar::Executable to.
   std::string cachePath = "session_cache";
 
+  /**
+   * The maximum total size, in bytes, of the executables in the engine cache
+   * at <tt>cachePath</tt>.
+   *
+   * When a new executable is added to the cache, the least recently used
+   * executables are deleted until the cache fits within this size. The cache
+   * directory may be shared between processes, which record the use of each
+   * executable in an index in the directory.
+   *
+   * Default: 0 (no limit).
+   */
+  int64_t engineCacheMaxBytes = 0;
+
+  /**
+   * Leave op names out of the IR hash used to look up executables in the
+   * engine cache at <tt>cachePath</tt>.
+   *
+   * Op names only label the compiled program, they don't change the code
+   * generated for it, but by default renaming an op causes a cache miss and
+   * a recompile. If enabled, an executable compiled for a graph that differs
+   * only in op names is loaded instead, and profiles and debug information
+   * use the op names from when it was compiled.
+   *
+   * Default: <tt>false</tt> (not enabled).
+   */
+  bool engineCacheIgnoreOpNames = false;
+
   /**
    * Enable that exceptions are thrown when floating point errors occur.
    *
@@ -1263,6 +1522,9 @@ struct SessionOptions {
   /// Configuration settings for the autodiff transform.
   AutodiffSettings autodiffSettings;
 
+  /// Configuration settings for the autocast transform.
+  AutocastSettings autocastSettings;
+
   /// Options to delay variable updates as much as possible.
   // TODO: Remove with T19212
   bool delayVarUpdates = true;
@@ -1573,6 +1835,13 @@ struct SessionOptions {
    */
   std::map<TensorId, TensorLocation> tensorLocationSettingsOverride;
 
+  /**
+   * Settings to choose the tensor locations of the weights, optimizer state,
+   * accumulators and activations automatically, to fit a memory budget. The
+   * chosen locations are added to tensorLocationSettingsOverride.
+   */
+  TensorLocationPlannerSettings tensorLocationPlannerSettings;
+
   /**
    * Settings to enable and configure the automatic loss scaling behaviour when
    * training.
@@ -1649,6 +1918,18 @@ struct SessionOptions {
   /// Returns `true` if auto-recomputation is enabled, `false` otherwise.
   bool autoRecomputationEnabled() const;
 
+  /**
+   * Get the hashes that make up std::hash<SessionOptions>, by option name.
+   *
+   * Options that are grouped in a settings struct, such as
+   * `batchSerializationSettings`, are hashed together under the name of the
+   * struct. Comparing the components of two sets of options shows which
+   * options differ.
+   *
+   * \returns A map from the name of each hashed option to its hash.
+   */
+  std::map<std::string, std::size_t> getHashComponents() const;
+
   /**
    * Enable merging remote and host IO operations to facilitate IO overlap.
    * `true` to enable, otherwise `false`.
@@ -1699,6 +1980,49 @@ struct SessionOptions {
    */
   bool throwIfLog2ScaleTensorNotInRange = true;
 
+  /**
+   * Number of host threads used to copy weights between the host and the
+   * device in Session::weightsFromHost(), Session::weightsToHost() and
+   * Session::readWeights().
+   *
+   * Host side copies are split into chunks and spread over these threads, and
+   * rearrangements for replicated tensor sharding overlap with the remote
+   * buffer transfers. A value of 1 copies all weights serially on the calling
+   * thread.
+   *
+   * Default: 0 (choose based on the number of hardware threads).
+   */
+  unsigned weightTransferThreads = 0;
+
+  /**
+   * If set to `true`, sessions in the same process share their convolution
+   * and matmul planning caches when they are lowered for the same target, so
+   * that plans made by one session are reused by the next.
+   *
+   * Sessions that only differ slightly, for example in batch size or
+   * replication factor, reuse the plans of all the convolutions and matmuls
+   * that are unchanged. The shared caches are kept until the process exits,
+   * and sessions using the same caches are lowered one at a time.
+   *
+   * Default: `false` (each session plans from scratch).
+   */
+  bool enablePlanningCacheReuse = false;
+
+  /**
+   * If set to `true`, initializers of the ONNX model whose data is stored in
+   * external files are memory mapped rather than read into memory when the
+   * model is loaded.
+   *
+   * The mappings are private, so changes to the weights are never written back
+   * to the files, and pages are only read from disk when the data is first
+   * accessed, for example by constant folding or Session::weightsFromHost().
+   * This reduces start-up time and host memory use for large models.
+   *
+   * The external data files must not be truncated or modified by other
+   * processes while the session exists.
+   */
+  bool mapExternalTensorData = false;
+
   /// Constructor for SessionOptions.
   SessionOptions() {
     // Automatically set `enableEngineCaching` and `cachePath` if the
@@ -0,0 +1,116 @@
+// Copyright (c) 2022 Graphcore Ltd. All rights reserved.
+#ifndef POPART_WILLOW_INCLUDE_POPART_SHARDEDCHECKPOINT_HPP_
+#define POPART_WILLOW_INCLUDE_POPART_SHARDEDCHECKPOINT_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+#include <popart/stepio.hpp>
+#include <popart/tensorinfo.hpp>
+#include <popart/voiddata.hpp>
+
+#include "popart/tensordebuginfo.hpp"
+
+namespace popart {
+namespace shardedcheckpoint {
+
+/**
+ * A sharded checkpoint is a directory holding a small JSON index,
+ * `popart_checkpoint.json`, and a number of binary data shards. Each tensor is
+ * stored as raw bytes, contiguously, in exactly one shard at a 64 byte aligned
+ * offset. The index records the data type, shape, shard and offset of every
+ * tensor.
+ *
+ * Unlike an ONNX model, a checkpoint has no 2 GB size limit, the shards are
+ * written in parallel straight from the host weight buffers, and tensors can
+ * be read back individually without loading whole shards into memory.
+ */
+
+/// The name of the index file within a checkpoint directory.
+extern const char *const indexFileName;
+
+/// The alignment, in bytes, of each tensor within a shard.
+constexpr uint64_t tensorAlignment = 64;
+
+/// Returns true if \p path is a directory containing a checkpoint index.
+bool isShardedCheckpoint(const std::string &path);
+
+/// Where a tensor is stored in a checkpoint.
+struct Entry {
+  TensorId id;
+  TensorInfo info;
+  unsigned shard;
+  uint64_t offset;
+};
+
+/// A tensor to write to a checkpoint. Its data is the concatenation of
+/// `segments`, each a pointer and size in bytes, which must add up to
+/// `info.nbytes()`.
+struct Source {
+  TensorId id;
+  TensorInfo info;
+  std::vector<std::pair<const char *, size_t>> segments;
+};
+
+/**
+ * Write a checkpoint to directory \p dir, creating it if needed.
+ *
+ * The tensors are balanced across the shards by size. Each shard is written
+ * directly from the source segments by one thread, and the index is written
+ * last, so an interrupted write never leaves a readable checkpoint behind.
+ * Shards of an earlier checkpoint in \p dir that are not overwritten, for
+ * example because it had more shards, are removed.
+ *
+ * \param dir The directory to write to.
+ * \param sources The tensors to write.
+ * \param numShards The number of data shards. 0 picks a number based on the
+ *      total size and the number of threads.
+ * \param numThreads The maximum number of shards written at once. 0 picks a
+ *      value based on the hardware concurrency.
+ * \returns The entries written to the index.
+ */
+std::vector<Entry> write(const std::string &dir,
+                         const std::vector<Source> &sources,
+                         unsigned numShards,
+                         unsigned numThreads);
+
+/**
+ * Reads a checkpoint written by write().
+ *
+ * Only the index is read on construction. Shards are memory mapped on first
+ * use, so tensor data is only paged in from disk when it is accessed. Mapped
+ * pages are private, writes through weight() never reach the files.
+ *
+ * This implements IWeightsIO, so a checkpoint, or any subset of it, can be
+ * passed straight to Session::writeWeights.
+ */
+class Reader : public IWeightsIO {
+public:
+  /// \param dir A directory containing a checkpoint.
+  explicit Reader(const std::string &dir);
+  ~Reader() override;
+
+  Reader(const Reader &) = delete;
+  Reader &operator=(const Reader &) = delete;
+
+  bool contains(TensorId) const override;
+  MutableVoidData weight(TensorId) const override;
+
+  /// The entries of the index, in the order they were written.
+  const std::vector<Entry> &getEntries() const;
+
+  /// The number of data shards.
+  unsigned getNumShards() const;
+
+private:
+  class Impl;
+  std::unique_ptr<Impl> impl;
+};
+
+} // namespace shardedcheckpoint
+} // namespace popart
+
+#endif // POPART_WILLOW_INCLUDE_POPART_SHARDEDCHECKPOINT_HPP_
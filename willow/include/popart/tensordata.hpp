@@ -49,6 +49,22 @@ public:
    */
   static TensorData fromViewOf(void *src, std::size_t size);
 
+  /**
+   * \brief Factory to create a TensorData that contains a non-owning pointer to
+   * a buffer kept alive by \p owner.
+   *
+   * As fromViewOf(), but the TensorData holds a reference to \p owner, for
+   * example a memory mapping, for as long as it exists.
+   *
+   * \param src Pointer to buffer that will be aliased.
+   * \param size Size in bytes of \p src buffer.
+   * \param owner Object that keeps the buffer alive.
+   * \return TensorData object that aliases the buffer you passed.
+   */
+  static TensorData fromSharedViewOf(void *src,
+                                     std::size_t size,
+                                     std::shared_ptr<void> owner);
+
   /**
    * \brief Factory to create a TensorData by emplacement of a
    * `std::vector<char> &&`.
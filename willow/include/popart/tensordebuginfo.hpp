@@ -2,8 +2,12 @@
 #ifndef POPART_WILLOW_INCLUDE_POPART_TENSORDEBUGINFO_HPP_
 #define POPART_WILLOW_INCLUDE_POPART_TENSORDEBUGINFO_HPP_
 
+#include <cstdint>
 #include <string>
+#include <vector>
+#include <popart/datatype.hpp>
 #include <popart/debugcontext.hpp>
+#include <popart/vendored/optional.hpp>
 
 namespace popart {
 
@@ -12,7 +16,14 @@ class TensorInfo;
 
 enum class TensorType;
 
+// The values of the debug info of a tensor are only built when it is
+// destroyed, which is when Poplar writes it out.
 class TensorDebugInfo : public DebugInfo {
+  TensorId tensorId;
+  nonstd::optional<std::vector<int64_t>> shape;
+  nonstd::optional<DataType> elementType;
+  TensorType type;
+
 public:
   TensorDebugInfo(const DebugContext &debugContext,
                   const TensorId &tenid,
@@ -25,7 +36,7 @@ public:
 
   TensorDebugInfo &operator=(const TensorDebugInfo &) = delete;
   TensorDebugInfo(const TensorDebugInfo &)            = delete;
-  virtual ~TensorDebugInfo()                          = default;
+  virtual ~TensorDebugInfo();
 };
 
 } // namespace popart
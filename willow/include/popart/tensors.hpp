@@ -66,6 +66,14 @@ public:
                             void *,
                             const VariableSettings &,
                             const DebugContext &dc = {});
+  // create a Variable Tensor whose data is a view of the raw data of the
+  // TensorProto, rather than a copy of it. The data holds a reference to
+  // owner, which must keep the TensorProto alive.
+  void addVarInitFromViewOf(const TensorId &,
+                            ONNX_NAMESPACE::TensorProto *,
+                            std::shared_ptr<void> owner,
+                            const VariableSettings &,
+                            const DebugContext &dc = {});
 
   // create a Constant Tensor
   void addConstInit(const TensorId &,
@@ -76,6 +84,13 @@ public:
                     const void *,
                     const DebugContext &dc = {});
 
+  // create a Constant Tensor whose data is a view of the raw data of the
+  // TensorProto, as addVarInitFromViewOf
+  void addConstInitFromViewOf(const TensorId &,
+                              ONNX_NAMESPACE::TensorProto *,
+                              std::shared_ptr<void> owner,
+                              const DebugContext &dc = {});
+
   // make an existing tensor a const init tensor
   void makeConstInit(const TensorId &, const void *);
 
@@ -127,6 +142,13 @@ private:
                const VariableSettings &,
                const DebugInfo &di);
 
+  // Create the Tensor of an initializer, without its data.
+  Tensor *addInitTensor(const TensorId &,
+                        const ONNX_NAMESPACE::TensorProto &,
+                        TensorType,
+                        const VariableSettings &,
+                        const DebugInfo &di);
+
   std::tuple<Tensor *, unsigned> addVarInitCore(const TensorId &name,
                                                 const TensorInfo &info,
                                                 const VariableSettings &vs,
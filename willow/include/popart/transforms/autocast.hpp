@@ -0,0 +1,46 @@
+// Copyright (c) 2022 Graphcore Ltd. All rights reserved.
+#ifndef POPART_WILLOW_INCLUDE_POPART_TRANSFORMS_AUTOCAST_HPP_
+#define POPART_WILLOW_INCLUDE_POPART_TRANSFORMS_AUTOCAST_HPP_
+
+#include <cstddef>
+#include <string>
+#include <popart/transforms/transform.hpp>
+
+namespace popart {
+class Graph;
+
+// Insert casts so that the ops of the graph run in mixed precision, as set by
+// SessionOptions::autocastSettings.
+//
+// Going through the ops in schedule order, the floating point inputs of each
+// op are cast to:
+//  - FLOAT16, if the type of the op is in the allow list,
+//  - FLOAT, if it is in the deny list,
+//  - FLOAT16, if it is in the promote list and any of them is FLOAT16,
+//  - their original data types otherwise,
+// after which the op is set up again, so that its outputs take the new data
+// types. Ops that produce graph outputs, anchors, the loss or tensors that are
+// modified, ops with side effects and ops that call subgraphs keep their
+// original data types, so the model's inputs, outputs and subgraph signatures
+// are unchanged. Casts are shared by the consumers of a tensor, and a FLOAT16
+// tensor cast to FLOAT is not cast back to FLOAT16, but used directly.
+//
+// Variables are not changed, so running before autodiff, the gradients of the
+// casts of the variables are FLOAT, and the optimizer updates FLOAT weights.
+class Autocast : public Transform {
+public:
+  static std::size_t id();
+
+  Autocast() : Transform() {}
+  ~Autocast() override {}
+
+  virtual bool apply(Graph &graph) const final;
+
+  virtual std::size_t getId() const final { return id(); }
+
+  virtual std::string getName() const final { return "Autocast"; }
+};
+
+} // namespace popart
+
+#endif // POPART_WILLOW_INCLUDE_POPART_TRANSFORMS_AUTOCAST_HPP_
@@ -78,6 +78,7 @@
 
 namespace popart {
 class Graph;
+struct BatchSerializationSettings;
 
 class BatchSerializedTensorInfo {
 public:
@@ -109,6 +110,27 @@ public:
 
   std::string getName() const final { return "BatchSerialize"; }
 
+  // The batch serialization settings of the IR, with the factor and method
+  // chosen for BatchSerializationSettings::memoryBudget, before serializing
+  // the forward pass of graph.
+  //
+  // The peak bytes of the live activations of each virtual graph are
+  // predicted from the schedule of graph, for each factor that divides the
+  // batch size and each method. An activation with a batch axis is:
+  //  - serialized, if its producer and consumers can shard: one slice of it
+  //    is live at a time, or all slices when it is kept for the backward pass.
+  //  - sliced, if its producer can not shard but a consumer can: with
+  //    UnrollDynamic and Loop, it is live along with the buffer of a slice,
+  //    with UnrollStatic, the slices alias it.
+  //  - concatenated, if its producer can shard but a consumer can not: with
+  //    UnrollDynamic and Loop, the slices are copied to a buffer, with
+  //    UnrollStatic, the slices are live along with their concatenation.
+  // The smallest factor with which a method fits in the budget is chosen.
+  // Among the methods that fit, the one that copies the fewest bytes to and
+  // from slices is chosen, then the one with the fewest ops. If no factor
+  // fits, the largest one is chosen, with the method of the smallest peak.
+  static BatchSerializationSettings chooseSettings(const Graph &graph);
+
 private:
   OpId reshapeForSlice(Graph &graph,
                        Op::Settings settings,
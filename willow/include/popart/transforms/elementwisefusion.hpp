@@ -0,0 +1,37 @@
+// Copyright (c) 2022 Graphcore Ltd. All rights reserved.
+#ifndef POPART_WILLOW_INCLUDE_POPART_TRANSFORMS_ELEMENTWISEFUSION_HPP_
+#define POPART_WILLOW_INCLUDE_POPART_TRANSFORMS_ELEMENTWISEFUSION_HPP_
+
+#include <cstddef>
+#include <string>
+#include <popart/transforms/transform.hpp>
+
+namespace popart {
+class Graph;
+
+// Replace groups of connected elementwise ops with single FusedElementwiseOps.
+// Each op is computed in a compute set of its own, and writes its output to a
+// tensor the next op reads. A FusedElementwiseOp computes the expression of
+// the whole group in one compute set, without the intermediate tensors.
+//
+// A group is a tree of ops with one output: every tensor the ops of a group
+// produce, except the output, is consumed by exactly one op of the group, and
+// is not an anchor or a graph output. The ops of a group have the same
+// placement and output shape, and have no topological constraints.
+class ElementwiseFusion : public Transform {
+public:
+  static std::size_t id();
+
+  ElementwiseFusion() : Transform() {}
+  ~ElementwiseFusion() override {}
+
+  virtual bool apply(Graph &graph) const final;
+
+  virtual std::size_t getId() const final { return id(); }
+
+  virtual std::string getName() const final { return "ElementwiseFusion"; }
+};
+
+} // namespace popart
+
+#endif // POPART_WILLOW_INCLUDE_POPART_TRANSFORMS_ELEMENTWISEFUSION_HPP_
@@ -0,0 +1,43 @@
+// Copyright (c) 2022 Graphcore Ltd. All rights reserved.
+#ifndef POPART_WILLOW_INCLUDE_POPART_TRANSFORMS_GLOBALVALUENUMBERING_HPP_
+#define POPART_WILLOW_INCLUDE_POPART_TRANSFORMS_GLOBALVALUENUMBERING_HPP_
+
+#include <cstddef>
+#include <string>
+#include <popart/transforms/transform.hpp>
+
+namespace popart {
+class Graph;
+
+// Common subexpression elimination by global value numbering.
+//
+// Every tensor of the graph is given a value number, such that tensors with
+// the same number hold the same value. Tensors without a producer get a number
+// of their own, except constants with the same info and data, which share one.
+// Op outputs get the numbers of the outputs of the first op in the schedule
+// with the same type, attributes, placement and input value numbers, and new
+// numbers otherwise. An op found to compute the same values as an earlier op
+// is removed, and its consumers consume the outputs of the earlier op.
+//
+// Ops are not numbered, so never merged, if they have side effects, are
+// random, modify or alias their inputs, or read or write tensors that any op
+// modifies or aliases. Ops that call graphs are numbered only if the called
+// graphs are pure, and the outputs of a CallOp which are inputs of the called
+// graph are numbered as those inputs.
+class GlobalValueNumbering : public Transform {
+public:
+  static std::size_t id();
+
+  GlobalValueNumbering() : Transform() {}
+  ~GlobalValueNumbering() override {}
+
+  virtual bool apply(Graph &graph) const final;
+
+  virtual std::size_t getId() const final { return id(); }
+
+  virtual std::string getName() const final { return "GlobalValueNumbering"; }
+};
+
+} // namespace popart
+
+#endif // POPART_WILLOW_INCLUDE_POPART_TRANSFORMS_GLOBALVALUENUMBERING_HPP_
@@ -0,0 +1,69 @@
+// Copyright (c) 2022 Graphcore Ltd. All rights reserved.
+#ifndef POPART_WILLOW_INCLUDE_POPART_TRANSFORMS_PIPELINESTAGEBALANCER_HPP_
+#define POPART_WILLOW_INCLUDE_POPART_TRANSFORMS_PIPELINESTAGEBALANCER_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <popart/optimizer.hpp>
+#include <popart/transforms/transform.hpp>
+#include <popart/vendored/optional.hpp>
+
+namespace popart {
+class Graph;
+
+// Place the ops of the main graph on one virtual graph per IPU, so that the
+// estimated cost of the most expensive stage is as small as possible. This is
+// used instead of AutoVirtualGraph, when
+// SessionOptions::autoVirtualGraphSettings.balanceStages is set.
+//
+// The schedule is split into contiguous stages, in order, so every tensor is
+// consumed on the virtual graph it is produced on or a later one. The cost of
+// a stage is:
+//  - the estimated cost of its ops (see OpCost), three times over when
+//    training, for the backward pass,
+//  - plus the cost of copying the tensors that cross to the next stage, and
+//    their gradients back when training.
+// The memory of a stage is the bytes of its weights, with their gradients and
+// optimizer state when training, plus the bytes of the activations it stashes
+// for the backward pass: once without pipelining, and once per batch in
+// flight in the stage with pipelining.
+//
+// The optimizer of the Ir is only set after the backward pass is constructed,
+// after this transform, so the optimizer type is passed to the constructor.
+// Without one, the memory of two optimizer state tensors per weight is counted
+// when training.
+//
+// The split points are found with dynamic programming, so that no stage uses
+// more than SessionOptions::autoVirtualGraphSettings.maxMemoryProportion of
+// the tile memory of an IPU. If no split fits, the memory limit is ignored.
+// Stages other than the first have at most maxStageOps ops more or fewer than
+// the stages of an even split, which bounds the search to
+// O(numStages * maxStageOps) per op.
+// When pipelining, the pipeline stage of each op is set to its virtual graph.
+// The predicted cost and memory of each stage are logged.
+class PipelineStageBalancer : public Transform {
+public:
+  static std::size_t id();
+
+  PipelineStageBalancer() : Transform() {}
+  explicit PipelineStageBalancer(OptimizerType optimizerType_)
+      : Transform(), optimizerType(optimizerType_) {}
+  ~PipelineStageBalancer() override {}
+
+  virtual bool apply(Graph &graph) const final;
+
+  virtual std::size_t getId() const final { return id(); }
+
+  virtual std::string getName() const final { return "PipelineStageBalancer"; }
+
+  // The most ops a stage has over or under the stages of an even split.
+  static constexpr int64_t maxStageOps = 4096;
+
+private:
+  nonstd::optional<OptimizerType> optimizerType;
+};
+
+} // namespace popart
+
+#endif // POPART_WILLOW_INCLUDE_POPART_TRANSFORMS_PIPELINESTAGEBALANCER_HPP_
@@ -0,0 +1,64 @@
+// Copyright (c) 2022 Graphcore Ltd. All rights reserved.
+#ifndef POPART_WILLOW_INCLUDE_POPART_TRANSFORMS_TENSORLOCATIONPLANNER_HPP_
+#define POPART_WILLOW_INCLUDE_POPART_TRANSFORMS_TENSORLOCATIONPLANNER_HPP_
+
+#include <cstddef>
+#include <string>
+#include <popart/transforms/transform.hpp>
+
+namespace popart {
+class Graph;
+
+// Choose the TensorLocation of the tensors of the main graph, so that the
+// predicted peak memory of each virtual graph fits in
+// SessionOptions::tensorLocationPlannerSettings.memoryBudget. This is applied
+// before StreamingMemory::id(2), when the planner is enabled, and adds the
+// locations of the tensors it moves to
+// SessionOptions::tensorLocationSettingsOverride, which StreamingMemory
+// applies. Tensors it keeps on chip get no override. Tensors with a location
+// set by the user are not planned. That is a location in the overrides, the
+// builder attribute of their producer, or a location other than the default
+// TensorLocation() in the TensorLocationSettings of their category, such as
+// SessionOptions::weightTensorLocationSettings.
+//
+// The tensors planned are the weights, optimizer state and accumulators, and
+// with execution phases, the activations consumed more than one phase after
+// they are produced. Each tensor can be:
+//  - kept on chip,
+//  - sharded across the replicas, when training with replication, which keeps
+//    one shard on chip, and adds gathering the other shards,
+//  - moved off chip, which adds loading it, and storing it when it is
+//    updated or is an activation,
+//  - moved off chip and sharded, which loads and stores one shard, and adds
+//    gathering the other shards.
+// The peak of each virtual graph is predicted with estimateMemory, with all
+// planned tensors on chip. A tensor only saves memory if it is live at the
+// peak of its virtual graph. The loaded or gathered copy of a tensor is on
+// chip while the tensor is used, so it is charged against the saving if an
+// op using the tensor runs at the peak, which is approximated by an output of
+// the op being live at the peak. The streaming time added is predicted from
+// the bandwidths of the settings, once per weight update, or once per micro
+// batch for accumulators and activations.
+//
+// While a virtual graph exceeds the budget, the placement that adds the least
+// streaming time per byte saved on it is chosen, replacing a placement of the
+// same tensor that saves less. The predicted memory saved and streaming time
+// added for each virtual graph are logged, and a warning is logged for each
+// virtual graph that does not fit.
+class TensorLocationPlanner : public Transform {
+public:
+  static std::size_t id();
+
+  TensorLocationPlanner() : Transform() {}
+  ~TensorLocationPlanner() override {}
+
+  virtual bool apply(Graph &graph) const final;
+
+  virtual std::size_t getId() const final { return id(); }
+
+  virtual std::string getName() const final { return "TensorLocationPlanner"; }
+};
+
+} // namespace popart
+
+#endif // POPART_WILLOW_INCLUDE_POPART_TRANSFORMS_TENSORLOCATIONPLANNER_HPP_
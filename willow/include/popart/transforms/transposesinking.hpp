@@ -0,0 +1,42 @@
+// Copyright (c) 2022 Graphcore Ltd. All rights reserved.
+#ifndef POPART_WILLOW_INCLUDE_POPART_TRANSFORMS_TRANSPOSESINKING_HPP_
+#define POPART_WILLOW_INCLUDE_POPART_TRANSFORMS_TRANSPOSESINKING_HPP_
+
+#include <cstddef>
+#include <string>
+#include <popart/transforms/transform.hpp>
+
+namespace popart {
+class Graph;
+
+// Push transposes and reshapes down through the ops that do not depend on the
+// layout of their inputs, so that they meet and cancel.
+//
+// A transpose (reshape) whose only consumer is:
+//  - an elementwise unary op,
+//  - an elementwise binary op whose other input is transposed (reshaped) the
+//    same way, or has only singleton dimensions,
+//  - a reduce op (transposes only) or
+//  - a concat whose inputs are all transposed the same way (transposes only)
+// is moved to the output of the consumer, adjusting the axes of the consumer.
+// A matmul of two operands with their last two dimensions transposed is
+// replaced by the transpose of the matmul of the operands in reverse order.
+// Adjacent transposes (reshapes) are combined into one, which is replaced by
+// an identity by the OpToIdentity pattern if it does not change its input.
+class TransposeSinking : public Transform {
+public:
+  static std::size_t id();
+
+  TransposeSinking() : Transform() {}
+  ~TransposeSinking() override {}
+
+  virtual bool apply(Graph &graph) const final;
+
+  virtual std::size_t getId() const final { return id(); }
+
+  virtual std::string getName() const final { return "TransposeSinking"; }
+};
+
+} // namespace popart
+
+#endif // POPART_WILLOW_INCLUDE_POPART_TRANSFORMS_TRANSPOSESINKING_HPP_
@@ -0,0 +1,412 @@
+// Copyright (c) 2022 Graphcore Ltd. All rights reserved.
+#include <boost/property_tree/json_parser.hpp>
+#include <boost/property_tree/ptree.hpp>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <set>
+#include <utility>
+#include <vector>
+#include <popart/batchcompile.hpp>
+#include <popart/devicemanager.hpp>
+#include <popart/error.hpp>
+#include <popart/ir.hpp>
+#include <popart/logging.hpp>
+#include <popart/session.hpp>
+#include <popart/tensorinfo.hpp>
+
+namespace popart {
+namespace batchcompile {
+
+namespace {
+
+namespace pt = boost::property_tree;
+
+using StringMap = std::map<std::string, std::string>;
+template <typename C>
+using FieldSetter  = std::function<void(C &, const pt::ptree &)>;
+using OptionSetter = FieldSetter<SessionOptions>;
+
+template <typename C, typename T> FieldSetter<C> setter(T C::*field) {
+  return [field](C &opts, const pt::ptree &value) {
+    opts.*field = value.get_value<T>();
+  };
+}
+
+template <typename C> FieldSetter<C> setter(StringMap C::*field) {
+  return [field](C &opts, const pt::ptree &value) {
+    for (const auto &option : value) {
+      (opts.*field)[option.first] = option.second.data();
+    }
+  };
+}
+
+// JSON arrays replace the whole list.
+template <typename C>
+FieldSetter<C> setter(std::vector<std::string> C::*field) {
+  return [field](C &opts, const pt::ptree &value) {
+    (opts.*field).clear();
+    for (const auto &element : value) {
+      (opts.*field).push_back(element.second.data());
+    }
+  };
+}
+
+template <typename C, typename T>
+FieldSetter<C> enumSetter(T C::*field, const std::map<std::string, T> &values) {
+  return [field, values](C &opts, const pt::ptree &value) {
+    const auto found = values.find(value.data());
+    if (found == values.end()) {
+      throw error("'{}' is not a valid value", value.data());
+    }
+    opts.*field = found->second;
+  };
+}
+
+// Settings structs are read field by field, so that a variant only needs to
+// give the fields it changes.
+template <typename C, typename S>
+FieldSetter<C>
+structSetter(S C::*field, const std::map<std::string, FieldSetter<S>> &fields) {
+  return [field, fields](C &opts, const pt::ptree &value) {
+    for (const auto &child : value) {
+      const auto found = fields.find(child.first);
+      if (found == fields.end()) {
+        throw error("'{}' is not a supported field", child.first);
+      }
+      try {
+        found->second(opts.*field, child.second);
+      } catch (const pt::ptree_error &) {
+        throw error("'{}' is not a valid value for '{}'",
+                    child.second.data(),
+                    child.first);
+      }
+    }
+  };
+}
+
+const std::map<std::string, OptionSetter> &optionSetters() {
+  using O = SessionOptions;
+  static const std::map<std::string, OptionSetter> setters{
+      {"accumulationFactor", setter(&O::accumulationFactor)},
+      {"aliasZeroCopy", setter(&O::aliasZeroCopy)},
+      {"autocastSettings",
+       structSetter(
+           &O::autocastSettings,
+           std::map<std::string, FieldSetter<AutocastSettings>>{
+               {"enabled", setter(&AutocastSettings::enabled)},
+               {"allowOpTypes", setter(&AutocastSettings::allowOpTypes)},
+               {"denyOpTypes", setter(&AutocastSettings::denyOpTypes)},
+               {"promoteOpTypes", setter(&AutocastSettings::promoteOpTypes)}})},
+      {"autoRecomputation",
+       enumSetter(&O::autoRecomputation,
+                  std::map<std::string, RecomputationType>{
+                      {"None", RecomputationType::None},
+                      {"Standard", RecomputationType::Standard},
+                      {"NormOnly", RecomputationType::NormOnly},
+                      {"Pipeline", RecomputationType::Pipeline},
+                      {"RecomputeAll", RecomputationType::RecomputeAll},
+                      {"MemoryBudget", RecomputationType::MemoryBudget}})},
+      {"autoRecomputationMemoryBudget",
+       setter(&O::autoRecomputationMemoryBudget)},
+      {"autoVirtualGraphSettings",
+       structSetter(
+           &O::autoVirtualGraphSettings,
+           std::map<std::string, FieldSetter<AutoVirtualGraphSettings>>{
+               {"balanceStages",
+                setter(&AutoVirtualGraphSettings::balanceStages)},
+               {"maxMemoryProportion",
+                setter(&AutoVirtualGraphSettings::maxMemoryProportion)}})},
+      {"batchSerializationSettings",
+       structSetter(
+           &O::batchSerializationSettings,
+           std::map<std::string, FieldSetter<BatchSerializationSettings>>{
+               {"factor", setter(&BatchSerializationSettings::factor)},
+               {"concatOnVirtualGraphChange",
+                setter(
+                    &BatchSerializationSettings::concatOnVirtualGraphChange)},
+               {"concatOnExecutionPhaseChange",
+                setter(
+                    &BatchSerializationSettings::concatOnExecutionPhaseChange)},
+               {"concatOnPipelineStageChange",
+                setter(
+                    &BatchSerializationSettings::concatOnPipelineStageChange)},
+               {"method",
+                enumSetter(&BatchSerializationSettings::method,
+                           std::map<std::string, BatchSerializationMethod>{
+                               {"UnrollDynamic",
+                                BatchSerializationMethod::UnrollDynamic},
+                               {"UnrollStatic",
+                                BatchSerializationMethod::UnrollStatic},
+                               {"Loop", BatchSerializationMethod::Loop}})},
+               {"memoryBudget",
+                setter(&BatchSerializationSettings::memoryBudget)}})},
+      {"cachePath", setter(&O::cachePath)},
+      {"constantWeights", setter(&O::constantWeights)},
+      {"convolutionOptions", setter(&O::convolutionOptions)},
+      {"customCodeletCompileFlags", setter(&O::customCodeletCompileFlags)},
+      {"decomposeGradSum", setter(&O::decomposeGradSum)},
+      {"defaultBufferingDepth", setter(&O::defaultBufferingDepth)},
+      {"defaultPrefetchBufferingDepth",
+       setter(&O::defaultPrefetchBufferingDepth)},
+      {"delayVarUpdates", setter(&O::delayVarUpdates)},
+      {"enableDistributedReplicatedGraphs",
+       setter(&O::enableDistributedReplicatedGraphs)},
+      {"enableElementwiseFusion", setter(&O::enableElementwiseFusion)},
+      {"enableExplicitMainLoops", setter(&O::enableExplicitMainLoops)},
+      {"enableFloatingPointChecks", setter(&O::enableFloatingPointChecks)},
+      {"enableFullyConnectedPass", setter(&O::enableFullyConnectedPass)},
+      {"enableGlobalValueNumbering", setter(&O::enableGlobalValueNumbering)},
+      {"enableGradientAccumulation", setter(&O::enableGradientAccumulation)},
+      {"enableMergeExchange", setter(&O::enableMergeExchange)},
+      {"enableNonStableSoftmax", setter(&O::enableNonStableSoftmax)},
+      {"enableOutlining", setter(&O::enableOutlining)},
+      {"enablePipelining", setter(&O::enablePipelining)},
+      {"enablePrefetchDatastreams", setter(&O::enablePrefetchDatastreams)},
+      {"enableReplicatedGraphs", setter(&O::enableReplicatedGraphs)},
+      {"enableSerializedMatmuls", setter(&O::enableSerializedMatmuls)},
+      {"enableStableNorm", setter(&O::enableStableNorm)},
+      {"enableStochasticRounding", setter(&O::enableStochasticRounding)},
+      {"enableTransposeSinking", setter(&O::enableTransposeSinking)},
+      {"enableVariablesCaching", setter(&O::enableVariablesCaching)},
+      {"engineCacheIgnoreOpNames", setter(&O::engineCacheIgnoreOpNames)},
+      {"engineOptions", setter(&O::engineOptions)},
+      {"explicitRecomputation", setter(&O::explicitRecomputation)},
+      {"gclOptions", setter(&O::gclOptions)},
+      {"globalReplicaOffset", setter(&O::globalReplicaOffset)},
+      {"globalReplicationFactor", setter(&O::globalReplicationFactor)},
+      {"groupHostSync", setter(&O::groupHostSync)},
+      {"kahnTieBreaker", setter(&O::kahnTieBreaker)},
+      {"lstmOptions", setter(&O::lstmOptions)},
+      {"matmulOptions", setter(&O::matmulOptions)},
+      {"mergeVarUpdateMemThreshold", setter(&O::mergeVarUpdateMemThreshold)},
+      {"outlineThreshold", setter(&O::outlineThreshold)},
+      {"partialsTypeMatMuls", setter(&O::partialsTypeMatMuls)},
+      {"rearrangeAnchorsOnHost", setter(&O::rearrangeAnchorsOnHost)},
+      {"rearrangeStreamsOnHost", setter(&O::rearrangeStreamsOnHost)},
+      {"replicatedGraphCount", setter(&O::replicatedGraphCount)},
+      {"reportOptions", setter(&O::reportOptions)},
+      {"syntheticDataMode",
+       enumSetter(&O::syntheticDataMode,
+                  std::map<std::string, SyntheticDataMode>{
+                      {"Off", SyntheticDataMode::Off},
+                      {"Zeros", SyntheticDataMode::Zeros},
+                      {"RandomNormal", SyntheticDataMode::RandomNormal},
+                      {"RandomUniform", SyntheticDataMode::RandomUniform}})},
+      {"tensorLocationPlannerSettings",
+       structSetter(
+           &O::tensorLocationPlannerSettings,
+           std::map<std::string, FieldSetter<TensorLocationPlannerSettings>>{
+               {"enabled", setter(&TensorLocationPlannerSettings::enabled)},
+               {"memoryBudget",
+                setter(&TensorLocationPlannerSettings::memoryBudget)},
+               {"remoteBandwidth",
+                setter(&TensorLocationPlannerSettings::remoteBandwidth)},
+               {"replicatedBandwidth",
+                setter(&TensorLocationPlannerSettings::replicatedBandwidth)}})},
+      {"useHostCopyOps", setter(&O::useHostCopyOps)},
+      {"virtualGraphMode",
+       enumSetter(&O::virtualGraphMode,
+                  std::map<std::string, VirtualGraphMode>{
+                      {"Off", VirtualGraphMode::Off},
+                      {"Manual", VirtualGraphMode::Manual},
+                      {"Auto", VirtualGraphMode::Auto},
+                      {"ExecutionPhases", VirtualGraphMode::ExecutionPhases}})},
+  };
+  return setters;
+}
+
+// JSON arrays are read as children with empty keys.
+bool isObject(const pt::ptree &tree) {
+  return !tree.empty() && !tree.front().first.empty();
+}
+
+// Merge overrides into base, objects key by key. Anything else is replaced.
+void merge(pt::ptree &base, const pt::ptree &overrides) {
+  for (const auto &child : overrides) {
+    // Keys such as engine option names may contain '.', which is the default
+    // path separator.
+    const pt::ptree::path_type key(child.first, '\0');
+    auto existing = base.get_child_optional(key);
+    if (existing && isObject(*existing) && isObject(child.second)) {
+      merge(*existing, child.second);
+    } else {
+      base.put_child(key, child.second);
+    }
+  }
+}
+
+void readSessionOptions(const pt::ptree &tree, SessionOptions &options) {
+  for (const auto &option : tree) {
+    const auto found = optionSetters().find(option.first);
+    if (found == optionSetters().end()) {
+      throw error("Unsupported session option '{}'", option.first);
+    }
+    try {
+      found->second(options, option.second);
+    } catch (const pt::ptree_error &) {
+      throw error("Invalid value '{}' for session option '{}'",
+                  option.second.data(),
+                  option.first);
+    } catch (const error &e) {
+      throw error("Invalid session option '{}': {}", option.first, e.what());
+    }
+  }
+}
+
+DataFlow readDataFlow(const pt::ptree &tree) {
+  AnchorReturnTypeMap anchors;
+  if (const auto anchorTree = tree.get_child_optional("anchors")) {
+    for (const auto &anchor : *anchorTree) {
+      const auto &art = anchor.second;
+      if (!isObject(art)) {
+        anchors.emplace(anchor.first, AnchorReturnType(art.data()));
+      } else if (art.count("returnPeriod") != 0) {
+        anchors.emplace(anchor.first,
+                        AnchorReturnType(art.get<std::string>("type"),
+                                         art.get<int>("returnPeriod")));
+      } else {
+        anchors.emplace(anchor.first,
+                        AnchorReturnType(art.get<std::string>("type")));
+      }
+    }
+  }
+  return DataFlow(tree.get<int>("batchesPerStep", 1), anchors);
+}
+
+InputShapeInfo readInputShapeInfo(const pt::ptree &tree) {
+  InputShapeInfo inputShapeInfo;
+  for (const auto &input : tree) {
+    Shape shape;
+    for (const auto &dim : input.second.get_child("shape")) {
+      shape.push_back(dim.second.get_value<int64_t>());
+    }
+    inputShapeInfo.add(
+        input.first,
+        TensorInfo(input.second.get<std::string>("dataType"), shape));
+  }
+  return inputShapeInfo;
+}
+
+PatternsLevel readPatternsLevel(const std::string &level) {
+  static const std::map<std::string, PatternsLevel> levels{
+      {"NoPatterns", PatternsLevel::NoPatterns},
+      {"Minimal", PatternsLevel::Minimal},
+      {"Default", PatternsLevel::Default},
+      {"All", PatternsLevel::All}};
+  const auto found = levels.find(level);
+  if (found == levels.end()) {
+    throw error("Unknown patterns level '{}'", level);
+  }
+  return found->second;
+}
+
+Variant readVariant(const pt::ptree &tree, const std::string &name) {
+  Variant variant;
+  variant.name = name;
+  // The runtime only looks executables up with engine caching enabled, and
+  // the options are part of the hash.
+  variant.options.enableEngineCaching = true;
+
+  if (const auto options = tree.get_child_optional("sessionOptions")) {
+    readSessionOptions(*options, variant.options);
+  }
+  if (const auto dataFlow = tree.get_child_optional("dataFlow")) {
+    variant.dataFlow = readDataFlow(*dataFlow);
+  }
+  if (const auto inputs = tree.get_child_optional("inputShapeInfo")) {
+    variant.inputShapeInfo = readInputShapeInfo(*inputs);
+  }
+  if (const auto device = tree.get_child_optional("device")) {
+    for (const auto &option : *device) {
+      variant.deviceOptions[option.first] = option.second.data();
+    }
+  }
+  if (const auto patterns = tree.get_optional<std::string>("patterns")) {
+    variant.patterns = Patterns(readPatternsLevel(*patterns));
+  }
+  return variant;
+}
+
+} // namespace
+
+std::vector<Variant> readVariants(std::istream &in) {
+  pt::ptree root;
+  try {
+    pt::read_json(in, root);
+  } catch (const pt::json_parser_error &e) {
+    throw error("Could not parse the compile variants: {}", e.what());
+  }
+
+  const auto variantTrees = root.get_child_optional("variants");
+  if (!variantTrees || variantTrees->empty()) {
+    throw error("The compile variants have no 'variants' list");
+  }
+  const auto defaults = root.get_child("defaults", pt::ptree());
+
+  std::vector<Variant> variants;
+  std::set<std::string> names;
+  for (const auto &variantTree : *variantTrees) {
+    const auto name = variantTree.second.get<std::string>(
+        "name", std::to_string(variants.size()));
+    if (!names.insert(name).second) {
+      throw error("There is more than one compile variant named '{}'", name);
+    }
+
+    auto tree = defaults;
+    merge(tree, variantTree.second);
+    try {
+      variants.push_back(readVariant(tree, name));
+    } catch (const pt::ptree_error &e) {
+      throw error("Invalid compile variant '{}': {}", name, e.what());
+    } catch (const error &e) {
+      throw error("Invalid compile variant '{}': {}", name, e.what());
+    }
+  }
+  return variants;
+}
+
+std::vector<Variant> readVariants(const std::string &path) {
+  std::ifstream ifs(path);
+  if (!ifs.is_open()) {
+    throw error("Could not open compile variants file {}", path);
+  }
+  return readVariants(ifs);
+}
+
+Result compileVariant(const std::string &model, const Variant &variant) {
+  auto device = DeviceManager::createDeviceManager().createOfflineIPUDevice(
+      variant.deviceOptions);
+  if (!device) {
+    throw error("Could not create an offline IPU for compile variant '{}'",
+                variant.name);
+  }
+
+  auto session = InferenceSession::createFromOnnxModel(model,
+                                                       variant.dataFlow,
+                                                       device,
+                                                       variant.inputShapeInfo,
+                                                       variant.options,
+                                                       variant.patterns);
+  const auto &ir = session->getIr();
+  if (ir.hashMatched()) {
+    logging::session::info("Compile variant '{}': executable {} is already in "
+                           "the engine cache",
+                           variant.name,
+                           ir.getHash());
+    return {Status::Cached, ir.getHash()};
+  }
+
+  // Preparing the device publishes the executable to the engine cache.
+  session->prepareDevice(/*loadEngine=*/false);
+  logging::session::info("Compile variant '{}': published executable {} to "
+                         "the engine cache {}",
+                         variant.name,
+                         ir.getHash(),
+                         variant.options.cachePath);
+  return {Status::Compiled, ir.getHash()};
+}
+
+} // namespace batchcompile
+} // namespace popart
@@ -59,6 +59,10 @@ const static int64_t maxOnnxOperatorSetVersion = 11;
 const static int64_t minGraphcoreOperatorSetVersion = 1;
 const static int64_t maxGraphcoreOperatorSetVersion = 1;
 
+// The largest initializer copied into the model that the outputs of a node are
+// inferred from.
+const static int64_t maxInitializerElementsForShapeInference = 1024;
+
 const BuilderImpl *BuilderImpl::getParent() const {
   if (!hasParent()) {
     throw internal_error("No Parent Builder");
@@ -182,8 +186,10 @@ void BuilderImpl::runShapeInference(ONNX_NAMESPACE::NodeProto *node,
       // Set the data type.
       tt->set_elem_type(onnxutil::getTPDataType(info.dataType()));
     }
-  } else {
+  } else if (!inferNodeShapes(*node)) {
     ONNX_NAMESPACE::shape_inference::InferShapes(model_);
+    // Shape inference of the whole model may rewrite its value infos.
+    clearGraphIndexes();
   }
 
   // Check shape inference worked.
@@ -205,6 +211,65 @@ void BuilderImpl::runShapeInference(ONNX_NAMESPACE::NodeProto *node,
   }
 }
 
+bool BuilderImpl::inferNodeShapes(const ONNX_NAMESPACE::NodeProto &node) {
+  // Subgraphs may use any tensor of the enclosing graphs.
+  for (const auto &attribute : node.attribute()) {
+    if (attribute.type() == ONNX_NAMESPACE::AttributeProto::GRAPH ||
+        attribute.type() == ONNX_NAMESPACE::AttributeProto::GRAPHS) {
+      return false;
+    }
+  }
+
+  ONNX_NAMESPACE::ModelProto model;
+  model.set_ir_version(model_.ir_version());
+  *model.mutable_opset_import() = model_.opset_import();
+  auto *graph = model.mutable_graph();
+
+  const auto &fullGraph = model_.graph();
+  std::set<TensorId> added;
+  for (const auto &input : node.input()) {
+    if (input.empty() || !added.insert(input).second) {
+      continue;
+    }
+    if (!hasValueInfo(input)) {
+      // For example, a tensor of a parent graph.
+      return false;
+    }
+    *graph->add_input() = getValueInfoProto(input);
+
+    // ONNX shape inference reads the values of initializers and constants,
+    // for example the shape input of Reshape. Only small tensors are copied,
+    // as weights are never used that way.
+    const int initializer =
+        initializerIndex.find(fullGraph.initializer(), input);
+    if (initializer >= 0) {
+      const auto &tensor = fullGraph.initializer(initializer);
+      int64_t nelms      = 1;
+      for (auto dim : tensor.dims()) {
+        nelms *= dim;
+      }
+      if (nelms <= maxInitializerElementsForShapeInference) {
+        *graph->add_initializer() = tensor;
+      }
+    }
+    const int producer = nodeIndex.find(fullGraph.node(), input);
+    if (producer >= 0 && fullGraph.node(producer).op_type() == "Constant") {
+      *graph->add_node() = fullGraph.node(producer);
+    }
+  }
+  *graph->add_node() = node;
+
+  ONNX_NAMESPACE::shape_inference::InferShapes(model);
+
+  const std::set<TensorId> outputs(node.output().begin(), node.output().end());
+  for (const auto &valueInfo : model.graph().value_info()) {
+    if (outputs.count(valueInfo.name()) != 0) {
+      *model_.mutable_graph()->add_value_info() = valueInfo;
+    }
+  }
+  return true;
+}
+
 bool BuilderImpl::inHigherScope(const TensorId &id) const {
 
   if (hasParent()) {
@@ -641,9 +706,6 @@ void BuilderImpl::op(
     }
   }
 
-  // Get valid tensors of mutable graph.
-  auto validTensors = getValidInputTensorIds();
-
   for (size_t i = 0; i < inputs.size(); ++i) {
     auto &input     = inputs[i];
     auto isOptional = (i >= opid.numInputs.min);
@@ -664,7 +726,8 @@ void BuilderImpl::op(
     } else {
       // Throw an exception if an tensor id is given as an input but it does not
       // exist.
-      if (validTensors.find(input) == validTensors.end()) {
+      if (!isValidInputTensorId(input)) {
+        const auto validTensors = getValidInputTensorIds();
         std::stringstream ss;
         ss << "Unknown tensor '" << input << "' (";
 
@@ -744,29 +807,32 @@ void BuilderImpl::op(
 bool BuilderImpl::findNodeProtoByOutputNamesImpl(
     ONNX_NAMESPACE::NodeProto *&out,
     const std::set<TensorId> &nodeOutputNames) {
+  if (nodeOutputNames.empty()) {
+    return false;
+  }
+
+  // Output names are unique, so only the node with the first output can match.
   ONNX_NAMESPACE::GraphProto *graph = model_.mutable_graph();
-  for (ONNX_NAMESPACE::NodeProto &node : *graph->mutable_node()) {
-    // Don't check nodes which don't have the same number of outputs.
-    if (node.output_size() != nodeOutputNames.size()) {
-      continue;
-    }
+  const int index = nodeIndex.find(graph->node(), *nodeOutputNames.begin());
+  if (index < 0) {
+    return false;
+  }
+  ONNX_NAMESPACE::NodeProto &node = *graph->mutable_node(index);
 
-    // Match up all the outputs - note that output names are always unique so we
-    // don't need to worry about the order.
-    std::set<TensorId> unfoundNodeOutputNames = nodeOutputNames;
-    for (const std::string &output : node.output()) {
-      if (unfoundNodeOutputNames.count(output)) {
-        unfoundNodeOutputNames.erase(output);
-      }
-    }
+  // Don't match nodes which don't have the same number of outputs.
+  if (node.output_size() != nodeOutputNames.size()) {
+    return false;
+  }
 
-    // Return the node if we matched.
-    if (unfoundNodeOutputNames.size() == 0) {
-      out = &node;
-      return true;
+  // Match up all the outputs - note that output names are always unique so we
+  // don't need to worry about the order.
+  for (const std::string &output : node.output()) {
+    if (nodeOutputNames.count(output) == 0) {
+      return false;
     }
   }
-  return false;
+  out = &node;
+  return true;
 }
 
 ONNX_NAMESPACE::NodeProto &BuilderImpl::findNodeProtoByOutputNames(
@@ -1134,6 +1200,7 @@ std::vector<std::string> BuilderImpl::getAllNodeAttributeNames(
 
 void BuilderImpl::loadModelProto(const std::string &modelProtoOrFilename) {
   model_ = onnxutil::getModelProto(modelProtoOrFilename);
+  clearGraphIndexes();
 
   // Check imported model is valid.
   ONNX_NAMESPACE::checker::check_model(model_);
@@ -1255,19 +1322,34 @@ std::set<TensorId> BuilderImpl::getValidInputTensorIds() const {
   return ids;
 }
 
+void BuilderImpl::clearGraphIndexes() {
+  inputIndex.clear();
+  outputIndex.clear();
+  valueInfoIndex.clear();
+  initializerIndex.clear();
+  nodeIndex.clear();
+}
+
+bool BuilderImpl::isValidInputTensorId(const TensorId &id) const {
+  const auto &graph = model_.graph();
+  if (isInputTensor(id) || isOutputTensor(id) || isValueTensor(id) ||
+      nodeIndex.find(graph.node(), id) >= 0) {
+    return true;
+  }
+  // Tensor IDs of parent graphs can be used in the child graph.
+  return nullptr != parent && parent->isValidInputTensorId(id);
+}
+
 bool BuilderImpl::isInputTensor(const TensorId &id) const {
-  std::vector<TensorId> inIds = getInputTensorIds();
-  return std::find(inIds.begin(), inIds.end(), id) != inIds.end();
+  return inputIndex.find(model_.graph().input(), id) >= 0;
 }
 
 bool BuilderImpl::isOutputTensor(const TensorId &id) const {
-  std::vector<TensorId> outIds = getOutputTensorIds();
-  return std::find(outIds.begin(), outIds.end(), id) != outIds.end();
+  return outputIndex.find(model_.graph().output(), id) >= 0;
 }
 
 bool BuilderImpl::isValueTensor(const TensorId &id) const {
-  std::vector<TensorId> valueIds = getValueTensorIds();
-  return std::find(valueIds.begin(), valueIds.end(), id) != valueIds.end();
+  return valueInfoIndex.find(model_.graph().value_info(), id) >= 0;
 }
 
 bool BuilderImpl::hasValueInfo(const TensorId &id) const {
@@ -1285,16 +1367,8 @@ std::string BuilderImpl::getStrFromTensorIdVec(std::vector<TensorId> v) const {
 }
 
 int BuilderImpl::getInputTensorIndex(TensorId id) const {
-  if (isInputTensor(id)) {
-    int index = -1;
-    for (int i = 0; i < model_.graph().input_size(); i++) {
-      if (model_.graph().input(i).name() == id) {
-        index = i;
-      }
-    }
-    if (index == -1) {
-      throw error("{} index not found", id);
-    }
+  const int index = inputIndex.find(model_.graph().input(), id);
+  if (index >= 0) {
     return index;
   } else {
     throw error("{} is not an input tensor. Must be {}",
@@ -1304,16 +1378,8 @@ int BuilderImpl::getInputTensorIndex(TensorId id) const {
 }
 
 int BuilderImpl::getOutputTensorIndex(TensorId id) const {
-  if (isOutputTensor(id)) {
-    int index = -1;
-    for (int i = 0; i < model_.graph().output_size(); i++) {
-      if (model_.graph().output(i).name() == id) {
-        index = i;
-      }
-    }
-    if (index == -1) {
-      throw error("{} index not found", id);
-    }
+  const int index = outputIndex.find(model_.graph().output(), id);
+  if (index >= 0) {
     return index;
   } else {
     throw error("{} is not an output tensor. Must be {}",
@@ -1323,16 +1389,8 @@ int BuilderImpl::getOutputTensorIndex(TensorId id) const {
 }
 
 int BuilderImpl::getValueTensorIndex(TensorId id) const {
-  if (isValueTensor(id)) {
-    int index = -1;
-    for (int i = 0; i < model_.graph().value_info_size(); i++) {
-      if (model_.graph().value_info(i).name() == id) {
-        index = i;
-      }
-    }
-    if (index == -1) {
-      throw error("{} index not found", id);
-    }
+  const int index = valueInfoIndex.find(model_.graph().value_info(), id);
+  if (index >= 0) {
     return index;
   } else {
     throw error("{} is not an value tensor. Must be {}",
@@ -1399,12 +1457,7 @@ std::string BuilderImpl::getTensorDtypeString(const TensorId &id) {
 }
 
 bool BuilderImpl::isInitializer(const TensorId &id) const {
-  for (const auto &initializer : model_.graph().initializer()) {
-    if (initializer.name() == id) {
-      return true;
-    }
-  }
-  return false;
+  return initializerIndex.find(model_.graph().initializer(), id) >= 0;
 }
 
 std::vector<TensorId> BuilderImpl::getTrainableTensorIds() const {
@@ -15,6 +15,7 @@
 #include <map>
 #include <set>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "popart/datatype.hpp"
@@ -27,6 +28,99 @@ namespace popart {
 class ConstVoidData;
 class TensorInfo;
 
+/**
+ * The positions of the elements of a repeated field of a GraphProto, by name:
+ * the names of inputs, outputs, value infos and initializers, and the output
+ * names of nodes. If there is more than one element with a name, the last one
+ * is found, as when searching the field.
+ *
+ * The index is brought up to date on each lookup. Elements appended since the
+ * last lookup, by the builder or by ONNX shape inference, are added to it, and
+ * it is rebuilt if elements were removed or replaced. As a replaced element
+ * cannot always be detected, the index is cleared whenever the whole model
+ * may have been rewritten, for example when a model is loaded.
+ */
+class GraphFieldIndex {
+public:
+  // The position of the last element of \p field named \p name, or -1.
+  template <typename Field>
+  int find(const Field &field, const std::string &name) const {
+    update(field);
+    auto found = positions.find(name);
+    if (found != positions.end() && !hasName(field.Get(found->second), name)) {
+      // An element was renamed.
+      numIndexed = 0;
+      positions.clear();
+      update(field);
+      found = positions.find(name);
+    }
+    return found == positions.end() ? -1 : found->second;
+  }
+
+  // Forget all positions, so that the next lookup rebuilds the index.
+  void clear() {
+    positions.clear();
+    numIndexed = 0;
+    lastName.clear();
+  }
+
+private:
+  static const std::string &
+  firstName(const ONNX_NAMESPACE::ValueInfoProto &element) {
+    return element.name();
+  }
+  static const std::string &
+  firstName(const ONNX_NAMESPACE::TensorProto &element) {
+    return element.name();
+  }
+  static const std::string &firstName(const ONNX_NAMESPACE::NodeProto &node) {
+    static const std::string none;
+    return node.output_size() > 0 ? node.output(0) : none;
+  }
+
+  template <typename Element>
+  static bool hasName(const Element &element, const std::string &name) {
+    return element.name() == name;
+  }
+  static bool hasName(const ONNX_NAMESPACE::NodeProto &node,
+                      const std::string &name) {
+    return std::find(node.output().begin(), node.output().end(), name) !=
+           node.output().end();
+  }
+
+  void add(const ONNX_NAMESPACE::ValueInfoProto &element, int position) const {
+    positions[element.name()] = position;
+  }
+  void add(const ONNX_NAMESPACE::TensorProto &element, int position) const {
+    positions[element.name()] = position;
+  }
+  void add(const ONNX_NAMESPACE::NodeProto &node, int position) const {
+    for (const auto &output : node.output()) {
+      positions[output] = position;
+    }
+  }
+
+  template <typename Field> void update(const Field &field) const {
+    // The field was changed other than by appending to it if it shrank, or
+    // the last element indexed is not the same.
+    if (field.size() < numIndexed ||
+        (numIndexed > 0 && firstName(field.Get(numIndexed - 1)) != lastName)) {
+      positions.clear();
+      numIndexed = 0;
+    }
+    for (; numIndexed < field.size(); ++numIndexed) {
+      add(field.Get(numIndexed), numIndexed);
+    }
+    if (numIndexed > 0) {
+      lastName = firstName(field.Get(numIndexed - 1));
+    }
+  }
+
+  mutable std::unordered_map<std::string, int> positions;
+  mutable int numIndexed = 0;
+  mutable std::string lastName;
+};
+
 /**
  * An implementation of a Builder
  */
@@ -264,6 +358,9 @@ public:
 
   std::set<TensorId> getValidInputTensorIds() const;
 
+  // True if \p id is in getValidInputTensorIds().
+  bool isValidInputTensorId(const TensorId &id) const;
+
   bool isInputTensor(const TensorId &id) const;
 
   bool isOutputTensor(const TensorId &id) const;
@@ -334,6 +431,12 @@ private:
   void runShapeInference(ONNX_NAMESPACE::NodeProto *node,
                          const OperatorIdentifier &);
 
+  // Run ONNX shape inference on a model with only \p node and the tensors it
+  // reads, rather than on the whole model, which would make building a model
+  // quadratic in its number of nodes. Returns false if the node cannot be
+  // inferred on its own, for example because it has a subgraph.
+  bool inferNodeShapes(const ONNX_NAMESPACE::NodeProto &node);
+
   void addOpsetRequirement(const std::string &domain, int version);
 
   TensorId getNextId(const std::string &name, int n = -1);
@@ -389,6 +492,18 @@ private:
 
   ONNX_NAMESPACE::ModelProto model_;
 
+  // Indexes of the fields of the graph of model_, so that tensors and nodes
+  // are found without searching the whole graph.
+  GraphFieldIndex inputIndex;
+  GraphFieldIndex outputIndex;
+  GraphFieldIndex valueInfoIndex;
+  GraphFieldIndex initializerIndex;
+  GraphFieldIndex nodeIndex;
+
+  // Clear the indexes, after the graph may have been changed other than by
+  // appending to its fields.
+  void clearGraphIndexes();
+
   std::map<std::string, popart::any> attributes;
 
   // Record which opset version we are using for each domain
@@ -21,178 +21,175 @@ namespace popart {
 
 BuilderDebugInfo::BuilderDebugInfo(
     const DebugContext &debugContext,
-    const std::string &api,
-    const std::vector<TensorId> &inputs,
-    const std::map<std::string, popart::any> &attributes,
-    const std::vector<TensorId> &outputs)
-    : DebugInfo(debugContext, "popartbuilder") {
+    const std::string &api_,
+    const std::vector<TensorId> &inputs_,
+    const std::map<std::string, popart::any> &attributes_,
+    const std::vector<TensorId> &outputs_)
+    : DebugInfo(debugContext, "popartbuilder"), api(api_), inputs(inputs_),
+      outputs(outputs_) {
 
-  setValue("category", ProfileValue{"api"});
-  setValue("api", ProfileValue{api});
-
-  if (inputs.size() > 0) {
-    ProfileValue::Vector inputsPV;
-    for (auto input : inputs) {
-      inputsPV.push_back(ProfileValue{input});
-    }
-    setValue("inputs", inputsPV);
-  }
-
-  if (outputs.size() > 0) {
-    ProfileValue::Vector outputsPV;
-    for (auto output : outputs) {
-      outputsPV.push_back(ProfileValue{output});
-    }
-    setValue("outputs", outputsPV);
-  }
-
-  ProfileValue::Map args;
-  for (auto p : attributes) {
+  for (auto p : attributes_) {
 
     if (p.second.type() == typeid(int64_t)) {
       int64_t v = popart::any_cast<int64_t>(p.second);
-      args.insert({p.first, ProfileValue{std::to_string(v)}});
+      attributes.insert({p.first, std::to_string(v)});
     } else if (p.second.type() == typeid(uint64_t)) {
       uint64_t v = popart::any_cast<uint64_t>(p.second);
-      args.insert({p.first, ProfileValue{std::to_string(v)}});
+      attributes.insert({p.first, std::to_string(v)});
     } else if (p.second.type() == typeid(float)) {
       float v = popart::any_cast<float>(p.second);
-      args.insert({p.first, ProfileValue{std::to_string(v)}});
+      attributes.insert({p.first, std::to_string(v)});
     } else if (p.second.type() == typeid(unsigned)) {
       unsigned v = popart::any_cast<unsigned>(p.second);
-      args.insert({p.first, ProfileValue{std::to_string(v)}});
+      attributes.insert({p.first, std::to_string(v)});
     } else if (p.second.type() == typeid(std::string)) {
       std::string v = popart::any_cast<std::string>(p.second);
-      args.insert({p.first, ProfileValue{v}});
+      attributes.insert({p.first, v});
     } else if (p.second.type() == typeid(const std::vector<std::string> &)) {
       auto v = popart::any_cast<const std::vector<std::string>>(p.second);
       std::stringstream ss;
       ss << v;
-      args.insert({p.first, ProfileValue{ss.str()}});
+      attributes.insert({p.first, ss.str()});
     } else if (p.second.type() == typeid(const std::vector<int64_t> &)) {
       auto v = popart::any_cast<const std::vector<int64_t>>(p.second);
       std::stringstream ss;
       ss << v;
-      args.insert({p.first, ProfileValue{ss.str()}});
+      attributes.insert({p.first, ss.str()});
     } else if (p.second.type() == typeid(const std::vector<float> &)) {
       auto v = popart::any_cast<const std::vector<float>>(p.second);
       std::stringstream ss;
       ss << v;
-      args.insert({p.first, ProfileValue{ss.str()}});
+      attributes.insert({p.first, ss.str()});
     } else if (p.second.type() == typeid(nonstd::optional<int64_t>)) {
       auto v = popart::any_cast<nonstd::optional<int64_t>>(p.second);
       if (v) {
         std::stringstream ss;
         ss << *v;
-        args.insert({p.first, ProfileValue{ss.str()}});
+        attributes.insert({p.first, ss.str()});
       }
     } else if (p.second.type() == typeid(nonstd::optional<float>)) {
       auto v = popart::any_cast<nonstd::optional<float>>(p.second);
       if (v) {
         std::stringstream ss;
         ss << *v;
-        args.insert({p.first, ProfileValue{ss.str()}});
+        attributes.insert({p.first, ss.str()});
       }
     } else {
-      args.insert({p.first, ProfileValue{"<UNKNOWN>"}});
+      attributes.insert({p.first, "<UNKNOWN>"});
     }
   }
-  setValue("attributes", args);
 }
 
-void BuilderDebugInfo::setOutputs(const std::vector<TensorId> &outputs) {
+void BuilderDebugInfo::setOutputs(const std::vector<TensorId> &outputs_) {
+  if (outputs_.size() > 0) {
+    outputs = outputs_;
+  }
+}
+
+BuilderDebugInfo::~BuilderDebugInfo() {
+  setValue("category", ProfileValue{"api"});
+  setValue("api", ProfileValue{api});
+
+  if (inputs.size() > 0) {
+    ProfileValue::Vector inputsPV(inputs.begin(), inputs.end());
+    setValue("inputs", inputsPV);
+  }
+
   if (outputs.size() > 0) {
-    ProfileValue::Vector outputsPV;
-    for (auto output : outputs) {
-      outputsPV.push_back(ProfileValue{output});
-    }
+    ProfileValue::Vector outputsPV(outputs.begin(), outputs.end());
     setValue("outputs", outputsPV);
   }
+
+  ProfileValue::Map args(attributes.begin(), attributes.end());
+  setValue("attributes", args);
 }
 
 BuilderVarDebugInfo::BuilderVarDebugInfo(const DebugContext &debugContext,
-                                         const std::string &api,
+                                         const std::string &api_,
                                          const TensorId &id,
                                          const TensorInfo &ti)
-    : DebugInfo(debugContext, "popartbuilder") {
+    : DebugInfo(debugContext, "popartbuilder"), api(api_), tensorId(id),
+      shape(ti.shape()), dataType(ti.dataType()) {}
+
+BuilderVarDebugInfo::BuilderVarDebugInfo(const DebugContext &debugContext,
+                                         const std::string &api_,
+                                         const TensorId &id)
+    : DebugInfo(debugContext, "popartbuilder"), api(api_), tensorId(id) {}
+
+BuilderVarDebugInfo::~BuilderVarDebugInfo() {
   setValue("category", ProfileValue{"variable"});
   setValue("api", ProfileValue{api});
+  setValue("tensorId", tensorId);
 
-  setValue("tensorId", id);
+  if (!shape) {
+    return;
+  }
 
   std::stringstream ss;
-  ss << ti.shape();
+  ss << *shape;
   setValue("shape", ss.str());
 
-  std::string dataType = "<UNKNOWN>";
-  switch (ti.dataType()) {
+  std::string type = "<UNKNOWN>";
+  switch (dataType) {
   case popart::DataType::UINT8:
-    dataType = "UINT8";
+    type = "UINT8";
     break;
   case popart::DataType::INT8:
-    dataType = "INT8";
+    type = "INT8";
     break;
   case popart::DataType::UINT16:
-    dataType = "UINT16";
+    type = "UINT16";
     break;
   case popart::DataType::INT16:
-    dataType = "INT16";
+    type = "INT16";
     break;
   case popart::DataType::INT32:
-    dataType = "INT32";
+    type = "INT32";
     break;
   case popart::DataType::INT64:
-    dataType = "INT64";
+    type = "INT64";
     break;
   case popart::DataType::UINT32:
-    dataType = "UINT32";
+    type = "UINT32";
     break;
   case popart::DataType::UINT64:
-    dataType = "UINT64";
+    type = "UINT64";
     break;
   case popart::DataType::BOOL:
-    dataType = "BOOL";
+    type = "BOOL";
     break;
   case popart::DataType::FLOAT:
-    dataType = "FLOAT";
+    type = "FLOAT";
     break;
   case popart::DataType::FLOAT16:
-    dataType = "FLOAT16";
+    type = "FLOAT16";
     break;
   case popart::DataType::BFLOAT16:
-    dataType = "BFLOAT16";
+    type = "BFLOAT16";
     break;
   case popart::DataType::FLOAT8_143:
-    dataType = "FLOAT8_143";
+    type = "FLOAT8_143";
     break;
   case popart::DataType::FLOAT8_152:
-    dataType = "FLOAT8_152";
+    type = "FLOAT8_152";
     break;
   case popart::DataType::DOUBLE:
-    dataType = "DOUBLE";
+    type = "DOUBLE";
     break;
   case popart::DataType::COMPLEX64:
-    dataType = "COMPLEX64";
+    type = "COMPLEX64";
     break;
   case popart::DataType::COMPLEX128:
-    dataType = "COMPLEX128";
+    type = "COMPLEX128";
     break;
   case popart::DataType::STRING:
-    dataType = "STRING";
+    type = "STRING";
     break;
   case popart::DataType::UNDEFINED:
-    dataType = "UNDEFINED";
+    type = "UNDEFINED";
     break;
   }
-  setValue("type", dataType);
-}
-BuilderVarDebugInfo::BuilderVarDebugInfo(const DebugContext &debugContext,
-                                         const std::string &api,
-                                         const TensorId &id)
-    : DebugInfo(debugContext, "popartbuilder") {
-  setValue("category", ProfileValue{"variable"});
-  setValue("api", ProfileValue{api});
-  setValue("tensorId", id);
+  setValue("type", type);
 }
 
 } // namespace popart
@@ -2,19 +2,30 @@
 #ifndef POPART_WILLOW_SRC_BUILDERDEBUGINFO_HPP_
 #define POPART_WILLOW_SRC_BUILDERDEBUGINFO_HPP_
 
+#include <cstdint>
 #include <map>
 #include <string>
 #include <vector>
 #include <popart/debugcontext.hpp>
 #include <poparttracepoint.hpp>
 
+#include "popart/datatype.hpp"
 #include "popart/tensordebuginfo.hpp"
+#include "popart/vendored/optional.hpp"
 
 namespace popart {
 class TensorInfo;
 class any;
 
+// The values of the builder debug infos are only built when they are
+// destroyed, which is when Poplar writes them out. Until then, they keep the
+// arguments of the builder call as plain strings.
 class BuilderDebugInfo : public DebugInfo {
+  std::string api;
+  std::vector<TensorId> inputs;
+  std::vector<TensorId> outputs;
+  std::map<std::string, std::string> attributes;
+
 public:
   // BuilderDebugInfo(const DebugContext &debugContext);
 
@@ -44,10 +55,15 @@ public:
 
   BuilderDebugInfo &operator=(const BuilderDebugInfo &) = delete;
   BuilderDebugInfo(const BuilderDebugInfo &)            = delete;
-  virtual ~BuilderDebugInfo()                           = default;
+  virtual ~BuilderDebugInfo();
 };
 
 class BuilderVarDebugInfo : public DebugInfo {
+  std::string api;
+  TensorId tensorId;
+  nonstd::optional<std::vector<int64_t>> shape;
+  DataType dataType = DataType::UNDEFINED;
+
 public:
   BuilderVarDebugInfo(const DebugContext &dc,
                       const std::string &api,
@@ -60,7 +76,7 @@ public:
 
   BuilderVarDebugInfo &operator=(const BuilderVarDebugInfo &) = delete;
   BuilderVarDebugInfo(const BuilderVarDebugInfo &)            = delete;
-  virtual ~BuilderVarDebugInfo()                              = default;
+  virtual ~BuilderVarDebugInfo();
 };
 
 } // namespace popart
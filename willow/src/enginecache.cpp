@@ -0,0 +1,610 @@
+// Copyright (c) 2022 Graphcore Ltd. All rights reserved.
+#include <algorithm>
+#include <boost/filesystem.hpp>
+#include <boost/interprocess/sync/file_lock.hpp>
+#include <boost/property_tree/json_parser.hpp>
+#include <boost/property_tree/ptree.hpp>
+#include <cctype>
+#include <exception>
+#include <fstream>
+#include <mutex>
+#include <sstream>
+#include <utility>
+#include <popart/enginecache.hpp>
+#include <popart/error.hpp>
+#include <popart/logging.hpp>
+#include <popart/popx/popefserializer.hpp>
+#include <popart/sessionoptions.hpp>
+
+#include "popart/vendored/optional.hpp"
+
+namespace popart {
+
+const char *const EngineCache::indexFileName = "popart_engine_cache.json";
+
+namespace {
+
+namespace bfs = boost::filesystem;
+namespace bip = boost::interprocess;
+namespace pt  = boost::property_tree;
+
+const char *const lockFileName          = "popart_engine_cache.lock";
+const char *const formatName            = "popart-engine-cache";
+const char *const fingerprintFormatName = "popart-engine-cache-fingerprint";
+const int formatVersion                 = 1;
+
+struct IndexEntry {
+  std::string file;
+  uint64_t bytes;
+  uint64_t lastUsed;
+};
+
+struct Index {
+  std::map<size_t, IndexEntry> entries;
+  EngineCache::Statistics statistics;
+  // Logical clock used to order uses of the entries, which unlike wall clock
+  // time is consistent across machines sharing the directory.
+  uint64_t clock = 0;
+};
+
+// Serialises index updates between threads of this process. The file lock
+// only excludes other processes.
+std::mutex &indexMutex() {
+  static std::mutex mutex;
+  return mutex;
+}
+
+bfs::path indexPath(const std::string &dir) {
+  return bfs::path(dir) / EngineCache::indexFileName;
+}
+
+bfs::path compileLockPath(const std::string &dir, size_t hash) {
+  return bfs::path(dir) / logging::format("{}.compile.lock", hash);
+}
+
+bool isCacheFile(const bfs::path &path) {
+  const auto name = path.filename().string();
+  return name == EngineCache::indexFileName || name == lockFileName ||
+         path.extension() == ".lock" || path.extension() == ".json" ||
+         name.find(".tmp") != std::string::npos;
+}
+
+// Creates the file at path if it does not exist, returns false if it can't.
+// Existing files are left alone, as closing any descriptor of a file drops
+// all the locks this process holds on it.
+bool touch(const bfs::path &path) {
+  if (bfs::exists(path)) {
+    return true;
+  }
+  std::ofstream ofs(path.string(), std::ofstream::app);
+  return ofs.is_open();
+}
+
+nonstd::optional<size_t> inferCacheEntryFromPath(const bfs::path &entry) {
+  const std::string &filePath = entry.string();
+  if (entry.extension().string().compare(".popef") != 0) {
+    logging::session::trace(
+        "File in cache path does not have extension '.popef': {}", filePath);
+    return {};
+  }
+
+  auto maybeStrHash = entry.stem().string();
+  auto isHash =
+      std::all_of(maybeStrHash.begin(), maybeStrHash.end(), ::isdigit);
+  if (!isHash) {
+    logging::session::trace("Cannot infer IR hash from PopEF file name: {}",
+                            maybeStrHash);
+    return {};
+  }
+
+  size_t hash;
+  std::stringstream sstream(maybeStrHash);
+  sstream >> hash;
+  logging::session::info(
+      "PopEF file inferred to have hash '{}' has been found: {}",
+      hash,
+      filePath);
+  return hash;
+}
+
+// Build an index from the files in the directory, for caches written before
+// there was an index.
+Index scanDirectory(const std::string &dir) {
+  Index index;
+  if (!bfs::is_directory(dir)) {
+    return index;
+  }
+  for (auto &entry : bfs::directory_iterator(dir)) {
+    if (!bfs::is_regular_file(entry) || isCacheFile(entry.path())) {
+      continue;
+    }
+    auto possibleHash = inferCacheEntryFromPath(entry.path());
+    if (!possibleHash) {
+      possibleHash =
+          popx::serialization::Reader::checkFileForValidPoplarExecutable(
+              entry.path().string());
+    }
+    if (possibleHash) {
+      index.entries.emplace(*possibleHash,
+                            IndexEntry{entry.path().filename().string(),
+                                       bfs::file_size(entry.path()),
+                                       0});
+    }
+  }
+  logging::session::debug(
+      "Indexed {} executable(s) in engine cache {}", index.entries.size(), dir);
+  return index;
+}
+
+// Write to a temporary file and rename it to path, so that readers, which
+// don't take any lock, never see a partially written file.
+void writeJsonAtomically(const bfs::path &path, const pt::ptree &root) {
+  const auto tmpPath = bfs::path(
+      path.string() + bfs::unique_path(".tmp-%%%%-%%%%-%%%%").string());
+  try {
+    std::ofstream ofs(tmpPath.string());
+    if (!ofs.is_open()) {
+      throw error("Failed to open {} for writing", tmpPath.string());
+    }
+    pt::write_json(ofs, root);
+    ofs.close();
+    if (ofs.fail()) {
+      throw error("Failed to write {}", tmpPath.string());
+    }
+    bfs::rename(tmpPath, path);
+  } catch (...) {
+    boost::system::error_code ec;
+    bfs::remove(tmpPath, ec);
+    throw;
+  }
+}
+
+// Returns false if there is no usable index.
+bool readIndex(const std::string &dir, Index &index) {
+  const auto path = indexPath(dir);
+  if (!bfs::is_regular_file(path)) {
+    return false;
+  }
+
+  pt::ptree root;
+  try {
+    pt::read_json(path.string(), root);
+  } catch (const pt::json_parser_error &e) {
+    logging::session::warn("Ignoring unreadable engine cache index {}: {}",
+                           path.string(),
+                           e.what());
+    return false;
+  }
+  if (root.get<std::string>("format", "") != formatName ||
+      root.get<int>("version", 0) != formatVersion) {
+    logging::session::warn("Ignoring engine cache index {} with unsupported "
+                           "format {} version {}",
+                           path.string(),
+                           root.get<std::string>("format", ""),
+                           root.get<int>("version", 0));
+    return false;
+  }
+
+  index.clock                = root.get<uint64_t>("clock", 0);
+  index.statistics.hits      = root.get<uint64_t>("statistics.hits", 0);
+  index.statistics.misses    = root.get<uint64_t>("statistics.misses", 0);
+  index.statistics.evictions = root.get<uint64_t>("statistics.evictions", 0);
+  for (const auto &entry : root.get_child("entries")) {
+    const auto &e = entry.second;
+    index.entries.emplace(e.get<size_t>("hash"),
+                          IndexEntry{e.get<std::string>("file"),
+                                     e.get<uint64_t>("bytes"),
+                                     e.get<uint64_t>("lastUsed")});
+  }
+  return true;
+}
+
+void writeIndex(const std::string &dir, const Index &index) {
+  pt::ptree root;
+  root.put("format", formatName);
+  root.put("version", formatVersion);
+  root.put("clock", index.clock);
+  root.put("statistics.hits", index.statistics.hits);
+  root.put("statistics.misses", index.statistics.misses);
+  root.put("statistics.evictions", index.statistics.evictions);
+
+  pt::ptree entries;
+  for (const auto &entry : index.entries) {
+    pt::ptree e;
+    e.put("hash", entry.first);
+    e.put("file", entry.second.file);
+    e.put("bytes", entry.second.bytes);
+    e.put("lastUsed", entry.second.lastUsed);
+    entries.push_back({"", e});
+  }
+  root.add_child("entries", entries);
+
+  writeJsonAtomically(indexPath(dir), root);
+}
+
+void writeFingerprint(const bfs::path &path,
+                      size_t hash,
+                      const EngineCache::Fingerprint &fingerprint) {
+  pt::ptree root;
+  root.put("format", fingerprintFormatName);
+  root.put("version", formatVersion);
+  root.put("hash", hash);
+
+  // Component names may contain '.', which ptree uses as a path separator, so
+  // they are stored as values rather than keys.
+  pt::ptree components;
+  for (const auto &component : fingerprint) {
+    pt::ptree c;
+    c.put("name", component.first);
+    c.put("hash", component.second);
+    components.push_back({"", c});
+  }
+  root.add_child("components", components);
+  writeJsonAtomically(path, root);
+}
+
+nonstd::optional<EngineCache::Fingerprint>
+readFingerprint(const bfs::path &path) {
+  if (!bfs::is_regular_file(path)) {
+    return {};
+  }
+  try {
+    pt::ptree root;
+    pt::read_json(path.string(), root);
+    if (root.get<std::string>("format", "") != fingerprintFormatName ||
+        root.get<int>("version", 0) != formatVersion) {
+      logging::session::debug("Ignoring engine cache fingerprint {} with "
+                              "unsupported format",
+                              path.string());
+      return {};
+    }
+    EngineCache::Fingerprint fingerprint;
+    for (const auto &component : root.get_child("components")) {
+      fingerprint.emplace(component.second.get<std::string>("name"),
+                          component.second.get<size_t>("hash"));
+    }
+    return fingerprint;
+  } catch (const pt::ptree_error &e) {
+    logging::session::debug("Ignoring unreadable engine cache fingerprint "
+                            "{}: {}",
+                            path.string(),
+                            e.what());
+    return {};
+  }
+}
+
+EngineCache::MissExplanation diff(size_t nearestHash,
+                                  const EngineCache::Fingerprint &fingerprint,
+                                  const EngineCache::Fingerprint &nearest) {
+  EngineCache::MissExplanation explanation;
+  explanation.nearestHash = nearestHash;
+  for (const auto &component : fingerprint) {
+    auto found = nearest.find(component.first);
+    if (found == nearest.end()) {
+      explanation.added.push_back(component.first);
+    } else if (found->second != component.second) {
+      explanation.changed.push_back(component.first);
+    }
+  }
+  for (const auto &component : nearest) {
+    if (fingerprint.count(component.first) == 0) {
+      explanation.removed.push_back(component.first);
+    }
+  }
+  return explanation;
+}
+
+size_t numDifferences(const EngineCache::MissExplanation &explanation) {
+  return explanation.changed.size() + explanation.added.size() +
+         explanation.removed.size();
+}
+
+EngineCache::Statistics computeStatistics(const Index &index) {
+  auto statistics       = index.statistics;
+  statistics.numEntries = index.entries.size();
+  statistics.totalBytes = 0;
+  for (const auto &entry : index.entries) {
+    statistics.totalBytes += entry.second.bytes;
+  }
+  return statistics;
+}
+
+void logStatistics(const std::string &dir, const Index &index) {
+  const auto statistics = computeStatistics(index);
+  logging::session::info("Engine cache {}: {} hit(s), {} miss(es), {} "
+                         "eviction(s), {} executable(s) using {} bytes",
+                         dir,
+                         statistics.hits,
+                         statistics.misses,
+                         statistics.evictions,
+                         statistics.numEntries,
+                         statistics.totalBytes);
+}
+
+// Holds the index lock, if it can be taken, while in scope.
+class IndexLock {
+public:
+  explicit IndexLock(const std::string &dir) : guard(indexMutex()) {
+    const auto path = bfs::path(dir) / lockFileName;
+    try {
+      if (touch(path)) {
+        bip::file_lock(path.string().c_str()).swap(lock);
+        lock.lock();
+        locked = true;
+      }
+    } catch (const bip::interprocess_exception &e) {
+      logging::session::debug(
+          "Could not lock engine cache index {}: {}", path.string(), e.what());
+    }
+    if (!locked) {
+      logging::session::debug("Updating engine cache index in {} without a "
+                              "lock",
+                              dir);
+    }
+  }
+
+  ~IndexLock() {
+    if (locked) {
+      lock.unlock();
+    }
+  }
+
+private:
+  std::lock_guard<std::mutex> guard;
+  bip::file_lock lock;
+  bool locked = false;
+};
+
+// Read, modify and write back the index while holding the index lock.
+template <typename Fn> void updateIndex(const std::string &dir, Fn &&fn) {
+  IndexLock lock(dir);
+  Index index;
+  if (!readIndex(dir, index)) {
+    index = scanDirectory(dir);
+  }
+  fn(index);
+  writeIndex(dir, index);
+  logStatistics(dir, index);
+}
+
+// As updateIndex, but failing to update the index is not an error. The cache
+// still works without statistics.
+template <typename Fn>
+void tryUpdateIndex(const std::string &dir, Fn &&fn) noexcept {
+  try {
+    updateIndex(dir, std::forward<Fn>(fn));
+  } catch (const std::exception &e) {
+    logging::session::warn(
+        "Failed to update the engine cache index in {}: {}", dir, e.what());
+  }
+}
+
+} // namespace
+
+class EngineCache::CompileLock::Impl {
+public:
+  explicit Impl(const std::string &path) : lock(path.c_str()) {}
+  bip::file_lock lock;
+};
+
+EngineCache::CompileLock::CompileLock()               = default;
+EngineCache::CompileLock::CompileLock(CompileLock &&) = default;
+EngineCache::CompileLock &
+EngineCache::CompileLock::operator=(CompileLock &&) = default;
+EngineCache::CompileLock::~CompileLock() { release(); }
+
+bool EngineCache::CompileLock::owns() const { return impl != nullptr; }
+
+void EngineCache::CompileLock::release() {
+  if (impl) {
+    impl->lock.unlock();
+    impl.reset();
+  }
+}
+
+EngineCache::EngineCache(const std::string &dir_, uint64_t maxBytes_)
+    : dir(dir_), maxBytes(maxBytes_) {}
+
+EngineCache::EngineCache(const SessionOptions &opts)
+    : EngineCache(opts.cachePath,
+                  static_cast<uint64_t>(
+                      std::max<int64_t>(opts.engineCacheMaxBytes, 0))) {}
+
+std::map<size_t, std::string> EngineCache::getEntries() const {
+  std::map<size_t, std::string> cacheEntries;
+  if (!bfs::is_directory(dir)) {
+    return cacheEntries;
+  }
+
+  Index index;
+  if (!readIndex(dir, index)) {
+    IndexLock lock(dir);
+    // Another process may have built the index while we waited for the lock.
+    if (!readIndex(dir, index)) {
+      index = scanDirectory(dir);
+      try {
+        writeIndex(dir, index);
+      } catch (const std::exception &e) {
+        logging::session::debug(
+            "Could not write engine cache index in {}: {}", dir, e.what());
+      }
+    }
+  }
+
+  for (const auto &entry : index.entries) {
+    const auto path = bfs::path(dir) / entry.second.file;
+    if (bfs::is_regular_file(path)) {
+      cacheEntries.emplace(entry.first, path.string());
+    } else {
+      logging::session::debug("Skipping engine cache entry {} for missing "
+                              "file {}",
+                              entry.first,
+                              path.string());
+    }
+  }
+  return cacheEntries;
+}
+
+std::string EngineCache::getEntryPath(size_t hash) const {
+  return logging::format("{}/{}.popef", dir, hash);
+}
+
+std::string EngineCache::getFingerprintPath(size_t hash) const {
+  return logging::format("{}/{}.fingerprint.json", dir, hash);
+}
+
+void EngineCache::recordHit(size_t hash) {
+  tryUpdateIndex(dir, [hash](Index &index) {
+    ++index.statistics.hits;
+    auto found = index.entries.find(hash);
+    if (found != index.entries.end()) {
+      found->second.lastUsed = ++index.clock;
+    }
+  });
+}
+
+void EngineCache::recordMiss(size_t hash) {
+  logging::session::debug("Engine cache miss for hash {}", hash);
+  tryUpdateIndex(dir, [](Index &index) { ++index.statistics.misses; });
+}
+
+void EngineCache::publish(size_t hash,
+                          const std::function<void(std::ostream &)> &write,
+                          const Fingerprint &fingerprint) {
+  bfs::create_directories(dir);
+
+  const bfs::path path(getEntryPath(hash));
+  const auto tmpPath = bfs::path(
+      path.string() + bfs::unique_path(".tmp-%%%%-%%%%-%%%%").string());
+  try {
+    std::ofstream ofs(tmpPath.string(), std::ofstream::binary);
+    if (!ofs.is_open()) {
+      throw error("Failed to open {} for writing", tmpPath.string());
+    }
+    write(ofs);
+    ofs.close();
+    if (ofs.fail()) {
+      throw error("Failed to write {}", tmpPath.string());
+    }
+    bfs::rename(tmpPath, path);
+  } catch (...) {
+    boost::system::error_code ec;
+    bfs::remove(tmpPath, ec);
+    throw;
+  }
+  logging::session::info("Published executable to engine cache {}",
+                         path.string());
+
+  // The compile lock is no longer needed once the executable is in the cache.
+  // Processes already waiting on the unlinked file still get the lock, and
+  // any process taking it afresh finds the executable, see lockForCompile().
+  {
+    boost::system::error_code ec;
+    bfs::remove(compileLockPath(dir, hash), ec);
+  }
+
+  // The fingerprint is only used to explain misses, so failing to write it is
+  // not an error.
+  if (!fingerprint.empty()) {
+    try {
+      writeFingerprint(getFingerprintPath(hash), hash, fingerprint);
+    } catch (const std::exception &e) {
+      logging::session::warn("Failed to write the fingerprint of {}: {}",
+                             path.string(),
+                             e.what());
+    }
+  }
+
+  const uint64_t budget = maxBytes;
+  tryUpdateIndex(dir, [&](Index &index) {
+    index.entries[hash] = IndexEntry{
+        path.filename().string(), bfs::file_size(path), ++index.clock};
+
+    uint64_t totalBytes = computeStatistics(index).totalBytes;
+    while (budget != 0 && totalBytes > budget) {
+      auto lru = index.entries.end();
+      for (auto it = index.entries.begin(); it != index.entries.end(); ++it) {
+        if (it->first != hash && (lru == index.entries.end() ||
+                                  it->second.lastUsed < lru->second.lastUsed)) {
+          lru = it;
+        }
+      }
+      if (lru == index.entries.end()) {
+        break;
+      }
+      // Processes that already opened the file keep their copy, as removing
+      // it only unlinks the name.
+      const auto evicted = bfs::path(dir) / lru->second.file;
+      boost::system::error_code ec;
+      bfs::remove(evicted, ec);
+      bfs::remove(getFingerprintPath(lru->first), ec);
+      bfs::remove(compileLockPath(dir, lru->first), ec);
+      logging::session::info("Evicted {} ({} bytes) from the engine cache",
+                             evicted.string(),
+                             lru->second.bytes);
+      totalBytes -= lru->second.bytes;
+      ++index.statistics.evictions;
+      index.entries.erase(lru);
+    }
+  });
+}
+
+nonstd::optional<EngineCache::Fingerprint>
+EngineCache::getFingerprint(size_t hash) const {
+  return readFingerprint(getFingerprintPath(hash));
+}
+
+nonstd::optional<EngineCache::MissExplanation>
+EngineCache::explainMiss(const Fingerprint &fingerprint) const {
+  nonstd::optional<MissExplanation> nearest;
+  for (const auto &entry : getEntries()) {
+    const auto cached = getFingerprint(entry.first);
+    if (!cached) {
+      continue;
+    }
+    auto explanation = diff(entry.first, fingerprint, *cached);
+    if (!nearest || numDifferences(explanation) < numDifferences(*nearest)) {
+      nearest = std::move(explanation);
+    }
+  }
+  return nearest;
+}
+
+EngineCache::CompileLock EngineCache::lockForCompile(size_t hash) {
+  CompileLock compileLock;
+  const auto path = compileLockPath(dir, hash);
+  try {
+    bfs::create_directories(dir);
+    if (!touch(path)) {
+      logging::session::debug("Could not create engine cache compile lock {}",
+                              path.string());
+      return compileLock;
+    }
+    auto impl = std::make_unique<CompileLock::Impl>(path.string());
+    if (!impl->lock.try_lock()) {
+      logging::session::info("Waiting for another process to compile the "
+                             "executable with hash {}",
+                             hash);
+      impl->lock.lock();
+      compileLock.waited_ = true;
+    } else if (bfs::exists(getEntryPath(hash))) {
+      // The lock file was removed by a process that published the executable
+      // after it was last looked for.
+      compileLock.waited_ = true;
+    }
+    compileLock.impl = std::move(impl);
+  } catch (const std::exception &e) {
+    logging::session::debug("Could not take engine cache compile lock {}: {}",
+                            path.string(),
+                            e.what());
+  }
+  return compileLock;
+}
+
+EngineCache::Statistics EngineCache::getStatistics() const {
+  Index index;
+  readIndex(dir, index);
+  return computeStatistics(index);
+}
+
+} // namespace popart
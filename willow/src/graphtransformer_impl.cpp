@@ -17,6 +17,7 @@
 
 #include "popart/datatype.hpp"
 #include "popart/error.hpp"
+#include "popart/half.hpp"
 #include "popart/names.hpp"
 #include "popart/operatoridentifier.hpp"
 #include "popart/operators.hpp"
@@ -593,16 +594,12 @@ void GraphTransformerImpl::convertFloatTensorToHalf(
   auto floatData   = reinterpret_cast<const float *>(mutableData.data);
 
   auto n_elms = mutableData.info.nelms();
-  std::vector<char> hValData(2 * n_elms);
-  // poplar::copyFloatToDeviceHalf takes a Target as an argument, but doesn't
-  // use it, so a dummy target can be used here.
-  auto dummyTarget = poplar::Target();
-  poplar::copyFloatToDeviceHalf(
-      dummyTarget, floatData, hValData.data(), n_elms);
+  std::vector<uint16_t> hValData(n_elms);
+  floatToHalf(floatData, hValData.data(), n_elms);
 
   tp.clear_float_data();
   tp.clear_raw_data();
-  tp.set_raw_data(hValData.data(), hValData.size());
+  tp.set_raw_data(hValData.data(), hValData.size() * sizeof(uint16_t));
   tp.set_data_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT16);
 }
 
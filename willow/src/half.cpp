@@ -1,25 +1,270 @@
 // Copyright (c) 2019 Graphcore Ltd. All rights reserved.
 #include <cstdint>
-#include <iosfwd>
-#include <poplar/Target.hpp>
+#include <cstring>
+#include <halfconversion.hpp>
+#include <ostream>
+#include <string>
+#include <popart/error.hpp>
 #include <popart/half.hpp>
 
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define POPART_HALF_X86_SIMD 1
+#include <cpuid.h>
+#include <immintrin.h>
+#endif
+
 namespace popart {
 
-float halfToFloat(uint16_t f16) {
-  // poplar::Target is not used in this function
-  static auto dummyTarget = poplar::Target();
+namespace {
+
+uint32_t floatBits(float f) {
+  uint32_t u;
+  std::memcpy(&u, &f, sizeof(u));
+  return u;
+}
+
+float bitsFloat(uint32_t u) {
   float f;
-  poplar::copyDeviceHalfToFloat(dummyTarget, &f16, &f, 1);
+  std::memcpy(&f, &u, sizeof(f));
   return f;
 }
 
-uint16_t floatToHalf(float f) {
-  // poplar::Target is not used in this function
-  static auto dummyTarget = poplar::Target();
-  uint16_t f16;
-  poplar::copyFloatToDeviceHalf(dummyTarget, &f, &f16, 1);
-  return f16;
+// IEEE binary16 -> binary32. Exact for all inputs, NaNs are quietened to
+// match the behaviour of vcvtph2ps.
+float halfToFloatScalar(uint16_t h) {
+  const uint32_t sign = static_cast<uint32_t>(h & 0x8000u) << 16;
+  uint32_t exponent   = (h >> 10) & 0x1fu;
+  uint32_t mantissa   = h & 0x3ffu;
+
+  if (exponent == 0x1fu) {
+    // Inf or NaN.
+    uint32_t bits = sign | 0x7f800000u | (mantissa << 13);
+    if (mantissa != 0) {
+      bits |= 0x00400000u;
+    }
+    return bitsFloat(bits);
+  }
+
+  if (exponent == 0) {
+    if (mantissa == 0) {
+      return bitsFloat(sign);
+    }
+    // Subnormal half, normalise it.
+    exponent = 127 - 15 + 1;
+    while ((mantissa & 0x400u) == 0) {
+      mantissa <<= 1;
+      --exponent;
+    }
+    mantissa &= 0x3ffu;
+    return bitsFloat(sign | (exponent << 23) | (mantissa << 13));
+  }
+
+  return bitsFloat(sign | ((exponent + 127 - 15) << 23) | (mantissa << 13));
+}
+
+// IEEE binary32 -> binary16 with round to nearest, ties to even. NaNs are
+// quietened and keep the top bits of their payload, like vcvtps2ph.
+uint16_t floatToHalfScalar(float f) {
+  uint32_t x          = floatBits(f);
+  const uint32_t sign = (x >> 16) & 0x8000u;
+  x &= 0x7fffffffu;
+
+  uint32_t h;
+  if (x >= 0x7f800000u) {
+    // Inf or NaN.
+    h = x > 0x7f800000u ? 0x7e00u | ((x >> 13) & 0x3ffu) : 0x7c00u;
+  } else if (x >= 0x477ff000u) {
+    // At least 65520.0f, which rounds to infinity.
+    h = 0x7c00u;
+  } else if (x < 0x38800000u) {
+    // Below the smallest normal half (2^-14): the result is subnormal or zero.
+    // Adding 0.5f aligns the mantissa so that the FPU does the rounding.
+    const uint32_t magic = 126u << 23;
+
+    h = floatBits(bitsFloat(x) + bitsFloat(magic)) - magic;
+  } else {
+    // Normal half. Rebias the exponent and round the dropped 13 bits.
+    const uint32_t mantissaOdd = (x >> 13) & 1u;
+
+    x += (static_cast<uint32_t>(15 - 127) << 23) + 0xfffu + mantissaOdd;
+    h = x >> 13;
+  }
+  return static_cast<uint16_t>(h | sign);
+}
+
+void halfToFloatScalarLoop(const uint16_t *src, float *dst, size_t n) {
+  for (size_t i = 0; i < n; ++i) {
+    dst[i] = halfToFloatScalar(src[i]);
+  }
+}
+
+void floatToHalfScalarLoop(const float *src, uint16_t *dst, size_t n) {
+  for (size_t i = 0; i < n; ++i) {
+    dst[i] = floatToHalfScalar(src[i]);
+  }
+}
+
+#ifdef POPART_HALF_X86_SIMD
+
+__attribute__((target("avx,f16c"))) void
+halfToFloatF16C(const uint16_t *src, float *dst, size_t n) {
+  size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    const __m128i h =
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+    _mm256_storeu_ps(dst + i, _mm256_cvtph_ps(h));
+  }
+  halfToFloatScalarLoop(src + i, dst + i, n - i);
+}
+
+__attribute__((target("avx,f16c"))) void
+floatToHalfF16C(const float *src, uint16_t *dst, size_t n) {
+  size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    const __m256 f = _mm256_loadu_ps(src + i);
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i),
+                     _mm256_cvtps_ph(f, _MM_FROUND_TO_NEAREST_INT));
+  }
+  floatToHalfScalarLoop(src + i, dst + i, n - i);
+}
+
+__attribute__((target("avx512f"))) void
+halfToFloatAvx512(const uint16_t *src, float *dst, size_t n) {
+  size_t i = 0;
+  for (; i + 16 <= n; i += 16) {
+    const __m256i h =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + i));
+    _mm512_storeu_ps(dst + i, _mm512_cvtph_ps(h));
+  }
+  halfToFloatF16C(src + i, dst + i, n - i);
+}
+
+__attribute__((target("avx512f"))) void
+floatToHalfAvx512(const float *src, uint16_t *dst, size_t n) {
+  size_t i = 0;
+  for (; i + 16 <= n; i += 16) {
+    const __m512 f = _mm512_loadu_ps(src + i);
+    _mm256_storeu_si256(
+        reinterpret_cast<__m256i *>(dst + i),
+        _mm512_cvtps_ph(f, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC));
+  }
+  floatToHalfF16C(src + i, dst + i, n - i);
+}
+
+uint64_t readXcr0() {
+  uint32_t eax, edx;
+  __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+  return (static_cast<uint64_t>(edx) << 32) | eax;
+}
+
+halfconversion::Isa detectHostIsa() {
+  unsigned eax, ebx, ecx, edx;
+  if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx)) {
+    return halfconversion::Isa::Scalar;
+  }
+  const bool osxsave = (ecx & (1u << 27)) != 0;
+  const bool avx     = (ecx & (1u << 28)) != 0;
+  const bool f16c    = (ecx & (1u << 29)) != 0;
+  if (!osxsave || !avx || !f16c) {
+    return halfconversion::Isa::Scalar;
+  }
+
+  // The OS must save the YMM (and for AVX-512 the ZMM and opmask) state.
+  const uint64_t xcr0 = readXcr0();
+  if ((xcr0 & 0x6u) != 0x6u) {
+    return halfconversion::Isa::Scalar;
+  }
+
+  if (__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx)) {
+    const bool avx512f = (ebx & (1u << 16)) != 0;
+    if (avx512f && (xcr0 & 0xe6u) == 0xe6u) {
+      return halfconversion::Isa::Avx512;
+    }
+  }
+  return halfconversion::Isa::F16C;
+}
+
+#else
+
+halfconversion::Isa detectHostIsa() { return halfconversion::Isa::Scalar; }
+
+#endif
+
+} // namespace
+
+namespace halfconversion {
+
+std::string toString(Isa isa) {
+  switch (isa) {
+  case Isa::Scalar:
+    return "Scalar";
+  case Isa::F16C:
+    return "F16C";
+  case Isa::Avx512:
+    return "Avx512";
+  }
+  throw error("Unknown halfconversion::Isa {}", static_cast<int>(isa));
+}
+
+Isa getHostIsa() {
+  static const Isa hostIsa = detectHostIsa();
+  return hostIsa;
+}
+
+bool isSupported(Isa isa) {
+  return static_cast<int>(isa) <= static_cast<int>(getHostIsa());
+}
+
+void halfToFloat(Isa isa, const uint16_t *src, float *dst, size_t n) {
+  if (!isSupported(isa)) {
+    throw error("Half conversion ISA {} is not supported by this host",
+                toString(isa));
+  }
+  switch (isa) {
+#ifdef POPART_HALF_X86_SIMD
+  case Isa::Avx512:
+    halfToFloatAvx512(src, dst, n);
+    return;
+  case Isa::F16C:
+    halfToFloatF16C(src, dst, n);
+    return;
+#endif
+  default:
+    halfToFloatScalarLoop(src, dst, n);
+  }
+}
+
+void floatToHalf(Isa isa, const float *src, uint16_t *dst, size_t n) {
+  if (!isSupported(isa)) {
+    throw error("Half conversion ISA {} is not supported by this host",
+                toString(isa));
+  }
+  switch (isa) {
+#ifdef POPART_HALF_X86_SIMD
+  case Isa::Avx512:
+    floatToHalfAvx512(src, dst, n);
+    return;
+  case Isa::F16C:
+    floatToHalfF16C(src, dst, n);
+    return;
+#endif
+  default:
+    floatToHalfScalarLoop(src, dst, n);
+  }
+}
+
+} // namespace halfconversion
+
+float halfToFloat(uint16_t f16) { return halfToFloatScalar(f16); }
+
+uint16_t floatToHalf(float f) { return floatToHalfScalar(f); }
+
+void halfToFloat(const uint16_t *src, float *dst, size_t n) {
+  halfconversion::halfToFloat(halfconversion::getHostIsa(), src, dst, n);
+}
+
+void floatToHalf(const float *src, uint16_t *dst, size_t n) {
+  halfconversion::floatToHalf(halfconversion::getHostIsa(), src, dst, n);
 }
 
 std::ostream &operator<<(std::ostream &ss, const Half &v) {
@@ -0,0 +1,39 @@
+// Copyright (c) 2022 Graphcore Ltd. All rights reserved.
+#ifndef POPART_WILLOW_SRC_HALFCONVERSION_HPP_
+#define POPART_WILLOW_SRC_HALFCONVERSION_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace popart {
+namespace halfconversion {
+
+/// Instruction set used by the bulk half <-> float conversions in half.hpp.
+enum class Isa {
+  // Portable bit manipulation, one element at a time.
+  Scalar = 0,
+  // 8 elements per instruction using the F16C extension (requires AVX).
+  F16C,
+  // 16 elements per instruction using AVX-512F.
+  Avx512
+};
+
+std::string toString(Isa isa);
+
+/// The fastest instruction set supported by the host. Detected once.
+Isa getHostIsa();
+
+/// Returns true if conversions using `isa` can run on this host.
+bool isSupported(Isa isa);
+
+/// Convert using a specific instruction set. Throws if `isa` is not supported
+/// by the host. Mostly useful for testing and benchmarking; other code should
+/// use popart::halfToFloat / popart::floatToHalf which pick getHostIsa().
+void halfToFloat(Isa isa, const uint16_t *src, float *dst, size_t n);
+void floatToHalf(Isa isa, const float *src, uint16_t *dst, size_t n);
+
+} // namespace halfconversion
+} // namespace popart
+
+#endif // POPART_WILLOW_SRC_HALFCONVERSION_HPP_
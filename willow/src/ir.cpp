@@ -64,6 +64,7 @@
 #include <popart/recompute.hpp>
 #include <popart/transforms/accumulateouterfragmentparallelizer.hpp>
 #include <popart/transforms/auto_virtual_graph.hpp>
+#include <popart/transforms/autocast.hpp>
 #include <popart/transforms/autodiff.hpp>
 #include <popart/transforms/automaticlossscaling.hpp>
 #include <popart/transforms/batchserialize.hpp>
@@ -71,8 +72,10 @@
 #include <popart/transforms/contiguatecollectivesformerging.hpp>
 #include <popart/transforms/decomposegradsum.hpp>
 #include <popart/transforms/dynamicoptransform.hpp>
+#include <popart/transforms/elementwisefusion.hpp>
 #include <popart/transforms/ensurefp32lossscale.hpp>
 #include <popart/transforms/explicitrecompute.hpp>
+#include <popart/transforms/globalvaluenumbering.hpp>
 #include <popart/transforms/hostiosetup.hpp>
 #include <popart/transforms/inferpipelinestages.hpp>
 #include <popart/transforms/inplaceaccumulategradpartialsintooptimizeraccumtensor.hpp>
@@ -86,6 +89,7 @@
 #include <popart/transforms/mergevarupdates.hpp>
 #include <popart/transforms/overlapio.hpp>
 #include <popart/transforms/pipeline.hpp>
+#include <popart/transforms/pipelinestagebalancer.hpp>
 #include <popart/transforms/preautomaticlossscaling.hpp>
 #include <popart/transforms/prune.hpp>
 #include <popart/transforms/randomsetup.hpp>
@@ -94,6 +98,8 @@
 #include <popart/transforms/stochasticrounding.hpp>
 #include <popart/transforms/streamingmemory.hpp>
 #include <popart/transforms/subgraphoutline.hpp>
+#include <popart/transforms/tensorlocationplanner.hpp>
+#include <popart/transforms/transposesinking.hpp>
 // used to get the packageHash()
 #include <algorithm>
 #include <cstddef>
@@ -362,6 +368,10 @@ void Ir::setOnnxModel(const ONNX_NAMESPACE::ModelProto &model) {
   onnxModel.reset(new ONNX_NAMESPACE::ModelProto(model));
 }
 
+void Ir::setOnnxModel(ONNX_NAMESPACE::ModelProto &&model) {
+  onnxModel = std::make_shared<ONNX_NAMESPACE::ModelProto>(std::move(model));
+}
+
 void Ir::setDataFlow(const DataFlow &df) {
   // Inference  mode require an anchor
   if (!canTrain() && df.nAnchors() == 0) {
@@ -393,7 +403,10 @@ bool Ir::usingEngineCache(const SessionOptions &opts, const DeviceInfo *di) {
          di->isHwCompatible();
 }
 
-void Ir::setUserOptions(const SessionOptions &flags) { userOptions = flags; }
+void Ir::setUserOptions(const SessionOptions &flags) {
+  userOptions       = flags;
+  passedUserOptions = flags;
+}
 
 void Ir::setInputShapeInfo(const InputShapeInfo &info) {
   inputShapeInfo = info;
@@ -485,6 +498,45 @@ void Ir::logIr() const {
   logging::ir::debug("End IR");
 }
 
+namespace {
+
+// Each session option is a component of its own, so that a miss can be traced
+// to the option that changed.
+void setSessionOptionsFingerprint(IrFingerprint &fingerprint,
+                                  const SessionOptions &opts) {
+  for (const auto &component : opts.getHashComponents()) {
+    fingerprint["sessionOptions." + component.first] = component.second;
+  }
+}
+
+// The components of std::hash<IrBundle>.
+IrFingerprint getIrBundleFingerprint(const IrBundle &bundle) {
+  IrFingerprint fingerprint;
+  fingerprint["inputShapeInfo"] =
+      std::hash<InputShapeInfo>()(bundle.inputShapeInfo);
+  fingerprint["dataFlow"] = std::hash<DataFlow>{}(bundle.dataFlow);
+  fingerprint["loss"]     = boost::hash<TensorId>{}(bundle.loss);
+  if (bundle.optimizer) {
+    fingerprint["optimizer"] = std::hash<Optimizer *>()(bundle.optimizer);
+  }
+  fingerprint["deviceInfo"] = std::hash<DeviceInfo>()(bundle.deviceInfo);
+  setSessionOptionsFingerprint(fingerprint, bundle.userOptions);
+  fingerprint["patterns"] = std::hash<Patterns>()(bundle.patterns);
+  fingerprint["poplar"]   = boost::hash<std::string>{}(poplar::packageHash());
+  return fingerprint;
+}
+
+size_t hashFingerprint(const IrFingerprint &fingerprint) {
+  size_t seed = 0;
+  for (const auto &component : fingerprint) {
+    boost::hash_combine(seed, component.first);
+    boost::hash_combine(seed, component.second);
+  }
+  return seed;
+}
+
+} // namespace
+
 void Ir::compareWithSavedHash(const HashesMap &cacheEntries) {
   if (false == Ir::usingEngineCache(userOptions, deviceInfo)) {
     logging::ir::info("Engine caching disabled. Skipping Ir hashing.");
@@ -512,8 +564,106 @@ void Ir::compareWithSavedHash(const HashesMap &cacheEntries) {
 }
 
 void Ir::computeHash(size_t hashSeed) {
+  graphFingerprint = getGraphFingerprint();
+  updateHash(hashSeed);
+}
+
+void Ir::updateHash(size_t hashSeed) {
+  // As std::hash<Ir>, without scheduling the graphs again.
+  size_t irHash = hashFingerprint(graphFingerprint);
+  boost::hash_combine(irHash, getIrBundleHash());
   hash_ = hashSeed;
-  boost::hash_combine(*hash_, *this);
+  boost::hash_combine(*hash_, irHash);
+
+  fingerprint = irBundleFingerprint;
+  if (fingerprint.empty()) {
+    fingerprint["irBundle"] = getIrBundleHash();
+  }
+  fingerprint["engineOptions"] = hashSeed;
+  fingerprint.insert(graphFingerprint.begin(), graphFingerprint.end());
+}
+
+void Ir::setLoweringOptions(const SessionOptions &opts) {
+  if (!isPrepared()) {
+    throw error("The IR must be prepared before its lowering options are set");
+  }
+  if (preparationSkipped) {
+    throw error("The lowering options of this IR cannot be set, as its "
+                "preparation was skipped when its executable was found in the "
+                "engine cache");
+  }
+
+  // Compare with the options as they were passed, as preparation may have
+  // changed some of the others.
+  auto newOptions               = passedUserOptions;
+  newOptions.engineOptions      = opts.engineOptions;
+  newOptions.convolutionOptions = opts.convolutionOptions;
+  newOptions.matmulOptions      = opts.matmulOptions;
+  newOptions.gclOptions         = opts.gclOptions;
+  newOptions.reportOptions      = opts.reportOptions;
+
+  // The prepared graphs can only be reused for options with the same hash,
+  // the key the engine cache uses for the options.
+  const std::hash<SessionOptions> hashOptions;
+  if (hashOptions(newOptions) != hashOptions(opts)) {
+    throw error("Only the engineOptions, convolutionOptions, matmulOptions, "
+                "gclOptions and reportOptions session options can be changed "
+                "without preparing the IR again");
+  }
+  passedUserOptions = newOptions;
+
+  // Keep the values that preparation chose for the other options.
+  userOptions.engineOptions      = opts.engineOptions;
+  userOptions.convolutionOptions = opts.convolutionOptions;
+  userOptions.matmulOptions      = opts.matmulOptions;
+  userOptions.gclOptions         = opts.gclOptions;
+  userOptions.reportOptions      = opts.reportOptions;
+
+  if (!irBundleFingerprint.empty()) {
+    setSessionOptionsFingerprint(irBundleFingerprint, passedUserOptions);
+    setIrBundleHash(hashFingerprint(irBundleFingerprint));
+  }
+  // The executable for the new options has to be looked up again.
+  hashMatched_ = false;
+}
+
+IrFingerprint Ir::getGraphFingerprint() const {
+  const bool withOpNames = !getSessionOptions().engineCacheIgnoreOpNames;
+  const boost::hash<std::string> hashString;
+
+  IrFingerprint graphFingerprint;
+  for (auto graph : getAllGraphs()) {
+    const auto name = logging::format(
+        "graph({})", graph->id.str().empty() ? "main" : graph->id.str());
+
+    // The ops are serialised without their names, which only contribute to
+    // the opNames component, so that renaming ops can be told apart from
+    // other changes.
+    std::stringstream graphSs;
+    std::stringstream namesSs;
+    std::map<std::string, std::string> opTypes;
+    for (auto &op : graph->getOpSchedule({}, RequireOptimalSchedule::Yes)) {
+      std::stringstream opSs;
+      op->append(opSs, false);
+      graphSs << opSs.str();
+
+      std::ostringstream opid;
+      opid << op->opid;
+      opTypes[opid.str()] += opSs.str();
+
+      namesSs << op->id << ' ' << op->getName() << '\n';
+    }
+
+    graphFingerprint[name] = hashString(graphSs.str());
+    for (const auto &opType : opTypes) {
+      graphFingerprint[logging::format("{}.ops({})", name, opType.first)] =
+          hashString(opType.second);
+    }
+    if (withOpNames) {
+      graphFingerprint[name + ".opNames"] = hashString(namesSs.str());
+    }
+  }
+  return graphFingerprint;
 }
 
 void Ir::verifyPipelineSettings() const {
@@ -1251,7 +1401,11 @@ void Ir::prepareImpl(const IrBundle &gb,
   setInputShapeInfo(gb.inputShapeInfo);
   setUserOptions(gb.userOptions);
   setPatterns(gb.patterns);
-  setOnnxModel(gb.modelProto);
+  // The model may already have been moved into the Ir, see
+  // Session::configureFromOnnx.
+  if (&gb.modelProto != onnxModel.get()) {
+    setOnnxModel(gb.modelProto);
+  }
   setSessionName(gb.sessionName);
 
   if (graphs.size() == 1) {
@@ -1281,12 +1435,14 @@ void Ir::prepareImpl(const IrBundle &gb,
 
   // Check if cached Ir hash matches the current one and skip
   // the rest of the Ir preparation if true.
+  irBundleFingerprint = getIrBundleFingerprint(gb);
   setIrBundleHash(std::hash<popart::IrBundle>()(gb));
 
   computeHash(hashSeed);
   compareWithSavedHash(cacheEntries);
   if (hashMatched()) {
     logging::ir::info("Ir hash matched cached value. Skipping Ir preparation");
+    preparationSkipped = true;
     if (gb.optimizer) {
       optimizer = gb.optimizer->clone();
       optimizer->setFactorsFromOptions(getSessionOptions());
@@ -1333,9 +1489,21 @@ void Ir::prepareImpl(const IrBundle &gb,
 
   applyTransform(RandomSetup::id(), getMainGraph());
 
+  const bool balanceStages =
+      userOptions.virtualGraphMode == VirtualGraphMode::Auto &&
+      userOptions.autoVirtualGraphSettings.balanceStages;
   enableTransform(AutoVirtualGraph::id(),
-                  userOptions.virtualGraphMode == VirtualGraphMode::Auto);
+                  userOptions.virtualGraphMode == VirtualGraphMode::Auto &&
+                      !balanceStages);
   applyTransform(AutoVirtualGraph::id(), getMainGraph());
+  if (balanceStages && gb.optimizer) {
+    // The optimizer is only set after the backward pass is constructed.
+    const auto scopedStopwatch =
+        timePartitionLogger().scopedStopwatch("PipelineStageBalancer");
+    PipelineStageBalancer(gb.optimizer->type()).apply(getMainGraph());
+  } else if (balanceStages) {
+    applyTransform(PipelineStageBalancer::id(), getMainGraph());
+  }
 
   // Required transform order for StreamingMemory is:
   // FWD -> StreamingMemory1 -> BWD -> IpuCopy -> StreamingMemory2 ->
@@ -1350,6 +1518,27 @@ void Ir::prepareImpl(const IrBundle &gb,
     updateVertices();
   }
 
+  if (getSessionOptions().enableGlobalValueNumbering) {
+    for (auto &id_graph : graphs) {
+      applyTransform(GlobalValueNumbering::id(), getGraph(id_graph.first));
+    }
+    updateVertices();
+  }
+
+  if (getSessionOptions().enableTransposeSinking) {
+    for (auto &id_graph : graphs) {
+      applyTransform(TransposeSinking::id(), getGraph(id_graph.first));
+    }
+    updateVertices();
+  }
+
+  if (getSessionOptions().autocastSettings.enabled) {
+    for (auto &id_graph : graphs) {
+      applyTransform(Autocast::id(), getGraph(id_graph.first));
+    }
+    updateVertices();
+  }
+
   // First streaming memory transformation pass (fwd)
   applyTransform(StreamingMemory::id(1), getMainGraph());
   if (userOptions.virtualGraphMode == VirtualGraphMode::ExecutionPhases &&
@@ -1357,6 +1546,12 @@ void Ir::prepareImpl(const IrBundle &gb,
     verifyVirtualGraphIds(true);
   }
 
+  // Choose the batch serialisation factor and method for the memory budget
+  if (userOptions.batchSerializationSettings.memoryBudget > 0) {
+    userOptions.batchSerializationSettings =
+        BatchSerialize::chooseSettings(getMainGraph());
+  }
+
   // Batch serialisation, step 1
   // (has to occur after setFinalLoss)
   if (userOptions.batchSerializationSettings.factor > 1 &&
@@ -1545,6 +1740,11 @@ void Ir::prepareImpl(const IrBundle &gb,
     updateVertices();
   }
 
+  // Choose the tensor locations that StreamingMemory::id(2) applies
+  if (userOptions.tensorLocationPlannerSettings.enabled) {
+    applyTransform(TensorLocationPlanner::id(), getMainGraph());
+  }
+
   // Second streaming memory transformation pass (cut)
   // Streaming memory transformation 2 needs up-to-date aliasing information
   applyTransform(StreamingMemory::id(2), getMainGraph());
@@ -1678,6 +1878,15 @@ void Ir::prepareImpl(const IrBundle &gb,
     }
   }
 
+  // Fuse elementwise ops before outlining, so that the fused ops are outlined
+  // rather than the groups of ops they replace.
+  if (getSessionOptions().enableElementwiseFusion) {
+    for (auto &id_graph : graphs) {
+      applyTransform(ElementwiseFusion::id(), *id_graph.second);
+    }
+    updateVertices();
+  }
+
   if (getSessionOptions().enableOutlining) {
     if (getSessionOptions().batchSerializationSettings.factor <= 1) {
       // This pattern attempts to remove aliasing chains that outlining
@@ -2219,7 +2428,9 @@ void Ir::registerInputTensors() {
 
   std::set<TensorId> onnxInitializers, unusedInitializers;
 
-  for (const auto &initializer : onnxGraph.initializer()) {
+  // The data of the tensors are views of the initializers' bytes, which the
+  // Ir's model keeps, so there is only one copy of the weights on the host.
+  for (auto &initializer : *onnxModel->mutable_graph()->mutable_initializer()) {
     TensorId tenId = initializer.name();
     if (consumerTypes.find(tenId) == consumerTypes.end()) {
       logging::info("Not creating Tensor for unused initializer, {}", tenId);
@@ -2283,7 +2494,8 @@ void Ir::registerInputTensors() {
       if (inference_constants && vs.numReplicasReturningVariable(
                                      userOptions.replicatedGraphCount) == 1) {
         logCreationInfo("Constant", tenId);
-        getTensors().addConstInit(tenId, &initializer, DebugContext(onnxDi));
+        getTensors().addConstInitFromViewOf(
+            tenId, &initializer, onnxModel, DebugContext(onnxDi));
       } else {
         logCreationInfo("Variable", tenId);
         if (inference_constants) {
@@ -2295,7 +2507,8 @@ void Ir::registerInputTensors() {
                         tenId,
                         vs);
         }
-        getTensors().addVarInit(tenId, &initializer, vs, DebugContext(onnxDi));
+        getTensors().addVarInitFromViewOf(
+            tenId, &initializer, onnxModel, vs, DebugContext(onnxDi));
       }
       onnxInitializers.emplace(tenId);
     }
@@ -3272,8 +3485,8 @@ int Ir::getOpSetVersionFromModel(const std::string &node_domain) const {
 
   // Get the version of the opset from the model based on the domain
   int version    = 0;
-  auto opsetList = getModel().opset_import();
-  for (auto &opset : opsetList) {
+  const auto &opsetList = getModel().opset_import();
+  for (const auto &opset : opsetList) {
 
     std::string opset_domain;
     if (opset.has_domain() == false || opset.domain() == "") {
@@ -4368,12 +4581,7 @@ namespace std {
 std::size_t std::hash<popart::Ir>::operator()(const popart::Ir &ir) const {
   // Hash based on all the IR attributes that
   // can affect compiled program
-  size_t seed = 0;
-
-  std::stringstream ss;
-  ir.append(ss);
-
-  boost::hash_combine(seed, ss.str());
+  size_t seed = popart::hashFingerprint(ir.getGraphFingerprint());
   boost::hash_combine(seed, ir.getIrBundleHash());
 
   return seed;
@@ -4381,25 +4589,7 @@ std::size_t std::hash<popart::Ir>::operator()(const popart::Ir &ir) const {
 
 std::size_t
 std::hash<popart::IrBundle>::operator()(const popart::IrBundle &bundle) const {
-  size_t seed = 0;
-
-  boost::hash_combine(
-      seed, std::hash<popart::InputShapeInfo>()(bundle.inputShapeInfo));
-  boost::hash_combine(seed, std::hash<popart::DataFlow>{}(bundle.dataFlow));
-  boost::hash_combine(seed, bundle.loss);
-
-  if (bundle.optimizer) {
-    boost::hash_combine(seed,
-                        std::hash<popart::Optimizer *>()(bundle.optimizer));
-  }
-  boost::hash_combine(seed, std::hash<popart::DeviceInfo>()(bundle.deviceInfo));
-  boost::hash_combine(seed,
-                      std::hash<popart::SessionOptions>{}(bundle.userOptions));
-  boost::hash_combine(seed, std::hash<popart::Patterns>()(bundle.patterns));
-  const std::string poplarHash = poplar::packageHash();
-  boost::hash_combine(seed, poplarHash);
-
-  return seed;
+  return popart::hashFingerprint(popart::getIrBundleFingerprint(bundle));
 }
 
 } // namespace std
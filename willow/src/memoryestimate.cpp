@@ -0,0 +1,302 @@
+// Copyright (c) 2022 Graphcore Ltd. All rights reserved.
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <ostream>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+#include <poplar/Target.hpp>
+#include <popart/devicemanager.hpp>
+#include <popart/graph.hpp>
+#include <popart/ir.hpp>
+#include <popart/liveness.hpp>
+#include <popart/memoryestimate.hpp>
+#include <popart/op.hpp>
+#include <popart/op/stash.hpp>
+#include <popart/sessionoptions.hpp>
+#include <popart/subgraphcopyingstrategy.hpp>
+#include <popart/tensor.hpp>
+#include <popart/tensors.hpp>
+
+#include "popart/graphid.hpp"
+#include "popart/logging.hpp"
+#include "popart/names.hpp"
+#include "popart/region.hpp"
+#include "popart/tensorinfo.hpp"
+#include "popart/tensorlocation.hpp"
+
+namespace popart {
+
+namespace {
+
+using liveness::CallStack;
+using liveness::LivenessAnalyzer;
+using liveness::LivenessNode;
+
+// The tensors that own the memory of the tensors of an IR, and how long they
+// are live.
+class MemoryModel {
+public:
+  explicit MemoryModel(const Ir &ir_) : ir(ir_) {
+    auto &opts = ir.getSessionOptions();
+    replicas   = opts.enableReplicatedGraphs ? opts.replicatedGraphCount : 1;
+    for (auto graph : ir.getAllGraphs()) {
+      for (auto &id_op : graph->getOps()) {
+        addAliases(id_op.second.get());
+      }
+    }
+  }
+
+  // The tensor that owns the memory of the tensor id.
+  Tensor *getRoot(TensorId id) const {
+    for (auto found = aliasOf.find(id); found != aliasOf.end();
+         found      = aliasOf.find(id)) {
+      id = found->second;
+    }
+    return ir.getTensor(id);
+  }
+
+  // Is the memory of root allocated for the whole program?
+  bool isAlwaysLive(Tensor *root) const {
+    if (root->tensorType() == TensorType::Variable ||
+        root->tensorType() == TensorType::Const ||
+        root->tensorType() == TensorType::Stream) {
+      return true;
+    }
+    return root->hasProducer() &&
+           root->getProducer()->isConvertibleTo<StashOp>();
+  }
+
+  // The number of bytes of device memory of root. Each replica only holds
+  // one shard of a tensor sharded across the replicas.
+  int64_t getBytes(Tensor *root) const {
+    if (root->tensorLocationInfo.isRemote()) {
+      return 0;
+    }
+    auto bytes = root->info.nbytes();
+    if (root->tensorLocationInfo.isSharded()) {
+      return (bytes + replicas - 1) / replicas;
+    }
+    return bytes;
+  }
+
+  VGraphId getVirtualGraphId(Tensor *root) {
+    auto found = vgraphIds.find(root);
+    if (found == vgraphIds.end()) {
+      auto vgid = root->getVirtualGraphIdUnsafe();
+      found     = vgraphIds.emplace(root, std::max<VGraphId>(vgid, 0)).first;
+    }
+    return found->second;
+  }
+
+private:
+  void addAliases(Op *op) {
+    for (auto &out : op->output->tensorMap()) {
+      for (auto &in : op->input->tensorMap()) {
+        auto regions = op->aliases(in.first, out.first);
+        if (std::any_of(regions.begin(), regions.end(), [](auto &region) {
+              return !region.isEmpty();
+            })) {
+          aliasOf[out.second->id] = in.second->id;
+          break;
+        }
+      }
+    }
+  }
+
+  const Ir &ir;
+  int64_t replicas;
+  std::map<TensorId, TensorId> aliasOf;
+  std::map<Tensor *, VGraphId> vgraphIds;
+};
+
+// The call of the graph of tensor in which node uses it.
+CallStack getCall(const LivenessNode &node, Tensor *tensor) {
+  auto callStack = node.getCallStack();
+  if (tensor->getGraph().id == node.getOp()->getGraph().id) {
+    callStack.pop_back();
+  }
+  return callStack;
+}
+
+struct Interval {
+  int64_t start;
+  int64_t end;
+};
+
+} // namespace
+
+bool MemoryEstimate::fits() const {
+  if (bytesPerIpu == 0) {
+    return true;
+  }
+  return std::all_of(peakBytesPerVirtualGraph.begin(),
+                     peakBytesPerVirtualGraph.end(),
+                     [this](auto &vgid_bytes) {
+                       return vgid_bytes.second <= bytesPerIpu;
+                     });
+}
+
+std::ostream &operator<<(std::ostream &os, const MemoryEstimate &estimate) {
+  for (auto &vgid_bytes : estimate.peakBytesPerVirtualGraph) {
+    os << "Virtual graph " << vgid_bytes.first << ": " << vgid_bytes.second
+       << " bytes";
+    if (estimate.bytesPerIpu > 0) {
+      os << " of " << estimate.bytesPerIpu;
+    }
+    os << std::endl;
+    auto found = estimate.topContributors.find(vgid_bytes.first);
+    if (found != estimate.topContributors.end()) {
+      for (auto &contributor : found->second) {
+        os << "  " << contributor.first << ": " << contributor.second
+           << " bytes" << std::endl;
+      }
+    }
+  }
+  for (auto &stage_bytes : estimate.peakBytesPerPipelineStage) {
+    os << "Pipeline stage " << stage_bytes.first << ": " << stage_bytes.second
+       << " bytes" << std::endl;
+  }
+  for (auto &phase_bytes : estimate.peakBytesPerExecutionPhase) {
+    os << "Execution phase " << phase_bytes.first << ": " << phase_bytes.second
+       << " bytes" << std::endl;
+  }
+  return os;
+}
+
+MemoryEstimate estimateMemory(const Ir &ir, unsigned numTopContributors) {
+  liveness::OnEnterAndExitSubgraphCopyingStrategy copyingStrategy;
+  LivenessAnalyzer analyzer(&ir, &copyingStrategy);
+  copyingStrategy.setIr(&ir);
+  copyingStrategy.setLivenessAnalyzer(&analyzer);
+  copyingStrategy.apply();
+  analyzer.apply();
+
+  MemoryModel model(ir);
+  const int64_t scheduleSize = analyzer.getOpScheduleSize();
+
+  // The bytes of each virtual graph that are live for the whole program, and
+  // the live intervals of the other tensors in each call of their graph.
+  std::map<VGraphId, int64_t> alwaysLive;
+  std::set<Tensor *> alwaysLiveRoots;
+  std::map<std::pair<Tensor *, CallStack>, Interval> intervals;
+
+  for (auto graph : ir.getAllGraphs()) {
+    for (auto &id : graph->getTensors().getAllTensorIds()) {
+      auto root = model.getRoot(id);
+      if (model.isAlwaysLive(root) && alwaysLiveRoots.insert(root).second) {
+        alwaysLive[model.getVirtualGraphId(root)] += model.getBytes(root);
+      }
+    }
+  }
+
+  for (int64_t i = 0; i < scheduleSize; ++i) {
+    auto &node = analyzer.getOpScheduleAt(i);
+    for (auto &id : node.usedTensorIds()) {
+      auto root = model.getRoot(id);
+      if (alwaysLiveRoots.count(root)) {
+        continue;
+      }
+      auto key   = std::make_pair(root, getCall(node, ir.getTensor(id)));
+      auto found = intervals.find(key);
+      if (found == intervals.end()) {
+        intervals.emplace(key, Interval{i, i});
+      } else {
+        found->second.end = i;
+      }
+    }
+  }
+
+  // Sweep the schedule, tracking the live bytes of each virtual graph.
+  std::vector<std::map<VGraphId, int64_t>> deltas(scheduleSize + 1);
+  for (auto &key_interval : intervals) {
+    auto root  = key_interval.first.first;
+    auto vgid  = model.getVirtualGraphId(root);
+    auto bytes = model.getBytes(root);
+    deltas.at(key_interval.second.start)[vgid] += bytes;
+    deltas.at(key_interval.second.end + 1)[vgid] -= bytes;
+  }
+
+  MemoryEstimate estimate;
+  std::map<VGraphId, int64_t> peakIndices;
+  std::map<VGraphId, int64_t> live  = alwaysLive;
+  estimate.peakBytesPerVirtualGraph = alwaysLive;
+
+  for (int64_t i = 0; i < scheduleSize; ++i) {
+    for (auto &vgid_delta : deltas.at(i)) {
+      live[vgid_delta.first] += vgid_delta.second;
+    }
+    for (auto &vgid_bytes : live) {
+      auto &peak = estimate.peakBytesPerVirtualGraph[vgid_bytes.first];
+      if (vgid_bytes.second > peak) {
+        peak                          = vgid_bytes.second;
+        peakIndices[vgid_bytes.first] = i;
+      }
+    }
+
+    // The ops of a stage or phase run on one virtual graph. Ops without a
+    // virtual graph, such as IPU copies, count on the largest.
+    auto op      = analyzer.getOpScheduleAt(i).getOp();
+    int64_t used = 0;
+    auto vgid    = op->getOptionalVGraphId();
+    if (vgid) {
+      used = live[std::max<VGraphId>(*vgid, 0)];
+    } else {
+      for (auto &vgid_bytes : live) {
+        used = std::max(used, vgid_bytes.second);
+      }
+    }
+    if (op->hasPipelineStage()) {
+      auto &peak = estimate.peakBytesPerPipelineStage[op->getPipelineStage()];
+      peak       = std::max(peak, used);
+    }
+    if (op->hasExecutionPhase()) {
+      auto &peak = estimate.peakBytesPerExecutionPhase[op->getExecutionPhase()];
+      peak       = std::max(peak, used);
+    }
+  }
+
+  // The tensors live at the peak of each virtual graph.
+  std::map<VGraphId, std::map<TensorId, int64_t>> peakTensors;
+  for (auto root : alwaysLiveRoots) {
+    peakTensors[model.getVirtualGraphId(root)][root->id] = model.getBytes(root);
+  }
+  for (auto &key_interval : intervals) {
+    auto root  = key_interval.first.first;
+    auto vgid  = model.getVirtualGraphId(root);
+    auto found = peakIndices.find(vgid);
+    if (found != peakIndices.end() &&
+        key_interval.second.start <= found->second &&
+        key_interval.second.end >= found->second) {
+      peakTensors[vgid][root->id] += model.getBytes(root);
+    }
+  }
+  for (auto &vgid_tensors : peakTensors) {
+    auto &contributors = estimate.topContributors[vgid_tensors.first];
+    for (auto &id_bytes : vgid_tensors.second) {
+      if (id_bytes.second > 0) {
+        contributors.push_back(id_bytes);
+      }
+    }
+    std::stable_sort(contributors.begin(),
+                     contributors.end(),
+                     [](auto &a, auto &b) { return a.second > b.second; });
+    if (contributors.size() > numTopContributors) {
+      contributors.resize(numTopContributors);
+    }
+  }
+
+  if (auto deviceInfo = ir.getDeviceInfo()) {
+    estimate.bytesPerIpu =
+        static_cast<int64_t>(deviceInfo->getTarget().getBytesPerTile()) *
+        deviceInfo->getTilesPerIPU();
+  }
+
+  logging::ir::debug("[estimateMemory] Estimated peak memory:\n{}", estimate);
+  return estimate;
+}
+
+} // namespace popart
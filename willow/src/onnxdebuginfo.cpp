@@ -17,9 +17,10 @@ ProfileValue toProfileValue(const ONNX_NAMESPACE::TensorProto &proto) {
   ProfileValue::Map tensorProto;
   tensorProto.insert({"name", proto.name()});
 
-  TensorInfo ti(proto);
+  // The shape is read from the proto directly, rather than through
+  // TensorInfo, as this runs in a destructor and must not throw.
   std::stringstream ss;
-  ss << ti.shape();
+  ss << Shape(proto.dims().begin(), proto.dims().end());
 
   tensorProto.insert({"dims", ss.str()});
 
@@ -39,9 +40,12 @@ ProfileValue toProfileValue(const ONNX_NAMESPACE::ValueInfoProto &proto) {
     ProfileValue::Map typeProto;
     if (proto.type().tensor_type().has_shape()) {
 
-      TensorInfo ti(proto.type());
+      Shape shape;
+      for (auto &dim : proto.type().tensor_type().shape().dim()) {
+        shape.push_back(dim.dim_value());
+      }
       std::stringstream ss;
-      ss << ti.shape();
+      ss << shape;
 
       typeProto.insert({"shape", ss.str()});
     }
@@ -54,9 +58,10 @@ ProfileValue toProfileValue(const ONNX_NAMESPACE::ValueInfoProto &proto) {
 namespace popart {
 
 OnnxOpDebugInfo::OnnxOpDebugInfo(const DebugContext &debugContext,
-                                 const Node &node)
-    : DebugInfo(debugContext, "onnx") {
+                                 const Node &node_)
+    : DebugInfo(debugContext, "onnx"), node(node_) {}
 
+OnnxOpDebugInfo::~OnnxOpDebugInfo() {
   setValue("category", ProfileValue{"op"});
 
   ProfileValue::Vector inputs;
@@ -127,35 +132,37 @@ OnnxOpDebugInfo::OnnxOpDebugInfo(const DebugContext &debugContext,
 OnnxVariableDebugInfo::OnnxVariableDebugInfo(
     const DebugContext &debugContext,
     const ONNX_NAMESPACE::TensorProto &proto)
-    : DebugInfo(debugContext, "onnx") {
-  setValue("category", ProfileValue{"variable"});
-  setValue("tensorProto", toProfileValue(proto));
-}
+    : DebugInfo(debugContext, "onnx"), tensorProto(&proto) {}
 
 OnnxVariableDebugInfo::OnnxVariableDebugInfo(
     const DebugContext &debugContext,
     const ONNX_NAMESPACE::ValueInfoProto &proto)
-    : DebugInfo(debugContext, "onnx") {
-  setValue("category", ProfileValue{"variable"});
-  setValue("valueInfoProto", toProfileValue(proto));
-}
+    : DebugInfo(debugContext, "onnx"), valueInfoProto(&proto) {}
 
 OnnxVariableDebugInfo::OnnxVariableDebugInfo(
     const DebugContext &debugContext,
     const ONNX_NAMESPACE::ValueInfoProto &proto,
     const TensorInfo &ti)
-    : DebugInfo(debugContext, "onnx") {
+    : DebugInfo(debugContext, "onnx"), valueInfoProto(&proto),
+      shapeFromInput(ti.shape()) {}
+
+OnnxVariableDebugInfo::~OnnxVariableDebugInfo() {
   setValue("category", ProfileValue{"variable"});
 
-  ProfileValue::Map valueInfoProto;
-  valueInfoProto.insert({"name", proto.name()});
+  if (tensorProto) {
+    setValue("tensorProto", toProfileValue(*tensorProto));
+  } else if (shapeFromInput) {
+    ProfileValue::Map valueInfo;
+    valueInfo.insert({"name", valueInfoProto->name()});
 
-  ProfileValue::Map typeProto;
-  std::stringstream ss;
-  ss << ti.shape();
-  valueInfoProto.insert({"shape_from_input", ss.str()});
+    std::stringstream ss;
+    ss << *shapeFromInput;
+    valueInfo.insert({"shape_from_input", ss.str()});
 
-  setValue("valueInfoProto", valueInfoProto);
+    setValue("valueInfoProto", valueInfo);
+  } else {
+    setValue("valueInfoProto", toProfileValue(*valueInfoProto));
+  }
 }
 
 } // namespace popart
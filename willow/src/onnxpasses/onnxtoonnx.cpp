@@ -75,8 +75,15 @@ void Canonnxalizer::canonnxalize(GraphProto &g) const {
 }
 
 GraphProto IOnnxToOnnx::getCanonnxalized(const GraphProto &inputGraph) const {
-  // Create a copy of the input Graph, and modify inplace.
-  auto g = inputGraph;
+  // Create a copy of the input Graph, and modify inplace. The initializers,
+  // which can be most of the size of the model, are not used by the patterns
+  // and are not copied.
+  GraphProto g;
+  g.set_name(inputGraph.name());
+  *g.mutable_node()       = inputGraph.node();
+  *g.mutable_input()      = inputGraph.input();
+  *g.mutable_output()     = inputGraph.output();
+  *g.mutable_value_info() = inputGraph.value_info();
   canonnxalize(g);
   return g;
 }
@@ -19,8 +19,8 @@ public:
   /** Inplace modification of a ONNX GraphProto. */
   virtual void canonnxalize(GraphProto &) const = 0;
 
-  /** Create a copy of \a gIn, modify it with canonnxalize, and return the
-   * modified GraphProto */
+  /** Create a copy of \a gIn without its initializers, modify it with
+   * canonnxalize, and return the modified GraphProto */
   GraphProto getCanonnxalized(const GraphProto &gIn) const;
 };
 
@@ -1,6 +1,8 @@
 // Copyright (c) 2018 Graphcore Ltd. All rights reserved.
 #include <algorithm>
 #include <boost/filesystem.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
 #include <filereader.hpp>
 #include <fstream>
 #include <google/protobuf/stubs/port.h>
@@ -12,6 +14,7 @@
 #include <poprithms/logging/timepartitionlogger.hpp>
 #include <popart/attributes.hpp>
 #include <popart/error.hpp>
+#include <popart/tensordata.hpp>
 #include <popart/tensorinfo.hpp>
 
 #include "popart/logging.hpp"
@@ -329,6 +332,54 @@ ConstVoidData getConstData(const ONNX_NAMESPACE::TensorProto &tp) {
   return cv_data;
 }
 
+bool hasExternalData(const ONNX_NAMESPACE::TensorProto &tp) {
+  return tp.has_data_location() &&
+         tp.data_location() == ONNX_NAMESPACE::TensorProto::EXTERNAL;
+}
+
+TensorData mapExternalTensorData(const ONNX_NAMESPACE::TensorProto &tp) {
+  namespace bip = boost::interprocess;
+
+  auto externalInfo = ExternalTensorProtoInfo(tp);
+  TensorInfo info(tp);
+
+  if (externalInfo.length != info.nbytes()) {
+    throw error("External data of tensor '{}' is {} bytes, but {} bytes are "
+                "required for tensor info {}",
+                tp.name(),
+                externalInfo.length,
+                info.nbytes(),
+                info);
+  }
+  const auto fileSize = boost::filesystem::file_size(externalInfo.location);
+  if (externalInfo.offset + externalInfo.length >
+      static_cast<int64_t>(fileSize)) {
+    throw error("External data of tensor '{}' is bytes [{}, {}) of file '{}', "
+                "but the file is only {} bytes",
+                tp.name(),
+                externalInfo.offset,
+                externalInfo.offset + externalInfo.length,
+                externalInfo.location,
+                fileSize);
+  }
+
+  logging::debug("Mapping {} bytes of '{}' at offset {} for tensor '{}'",
+                 externalInfo.length,
+                 externalInfo.location,
+                 externalInfo.offset,
+                 tp.name());
+
+  // Each tensor gets its own mapping, so that copy on write pages are never
+  // shared between tensors, or between sessions loading the same file.
+  bip::file_mapping file(externalInfo.location.c_str(), bip::read_only);
+  auto region = std::make_shared<bip::mapped_region>(file,
+                                                     bip::copy_on_write,
+                                                     externalInfo.offset,
+                                                     externalInfo.length);
+  return TensorData::fromSharedViewOf(
+      region->get_address(), externalInfo.length, region);
+}
+
 MutableVoidData getMutableData(ONNX_NAMESPACE::TensorProto &tp) {
   MutableVoidData mv_data;
   mv_data.info = TensorInfo(tp);
@@ -22,6 +22,8 @@ class TimePartitionLogger;
 } // namespace poprithms
 
 namespace popart {
+class TensorData;
+
 namespace onnxutil {
 
 class ExternalTensorProtoInfo {
@@ -47,6 +49,14 @@ getImplicitTensorIds(const ONNX_NAMESPACE::GraphProto &bodyProto,
 ConstVoidData getConstData(const ONNX_NAMESPACE::TensorProto &tp);
 MutableVoidData getMutableData(ONNX_NAMESPACE::TensorProto &tp);
 
+// Returns true if the data of `tp` is stored in an external file.
+bool hasExternalData(const ONNX_NAMESPACE::TensorProto &tp);
+
+// Memory map the external data of `tp`, without reading it. The mapping is
+// private: the data can be modified, but changes are not written to the file.
+// The returned TensorData keeps the mapping alive.
+TensorData mapExternalTensorData(const ONNX_NAMESPACE::TensorProto &tp);
+
 // Returns true if TensorProto with name `id` has an external data location
 bool isExternallySavedInitializer(ONNX_NAMESPACE::ModelProto &model,
                                   const TensorId &id);
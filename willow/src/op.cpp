@@ -437,8 +437,8 @@ std::string Op::getSubgraphEquivId(
   return ss.str();
 }
 
-void Op::append(std::stringstream &ss) const {
-  OpSerialiser os(this, ss);
+void Op::append(std::stringstream &ss, bool withName) const {
+  OpSerialiser os(this, ss, withName);
 
   appendAttributes(os);
   appendMore(os);
@@ -0,0 +1,151 @@
+// Copyright (c) 2022 Graphcore Ltd. All rights reserved.
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <vector>
+#include <popart/error.hpp>
+#include <popart/op/attention.hpp>
+#include <popart/opserialiser.hpp>
+#include <popart/tensorinfo.hpp>
+
+#include "popart/graphcoreoperators.hpp"
+#include "popart/names.hpp"
+#include "popart/op.hpp"
+#include "popart/operatoridentifier.hpp"
+
+namespace popart {
+
+AttentionOp::AttentionOp(const OperatorIdentifier &_opid,
+                         float scale_,
+                         int64_t tileSize_,
+                         const Op::Settings &settings_)
+    : Op(_opid, settings_), scale(scale_), tileSize(tileSize_) {}
+
+std::unique_ptr<Op> AttentionOp::clone() const {
+  return std::make_unique<AttentionOp>(*this);
+}
+
+std::vector<std::unique_ptr<Op>> AttentionOp::getGradOps() {
+  std::vector<std::unique_ptr<Op>> upops;
+  upops.emplace_back(std::make_unique<AttentionGradOp>(*this));
+  return upops;
+}
+
+void AttentionOp::setup() {
+  const auto &query         = inInfo(getQueryInIndex());
+  const auto &keyTransposed = inInfo(getKeyTransposedInIndex());
+  const auto &value         = inInfo(getValueInIndex());
+
+  const auto rank = query.rank();
+  if (rank < 2 || keyTransposed.rank() != rank || value.rank() != rank) {
+    throw error("The query, transposed key and value of {} must have the same "
+                "rank of at least 2, not {}, {} and {}",
+                debugName(),
+                rank,
+                keyTransposed.rank(),
+                value.rank());
+  }
+
+  Shape leading(query.shape().begin(), query.shape().end() - 2);
+  for (const auto *info : {&keyTransposed, &value}) {
+    if (Shape(info->shape().begin(), info->shape().end() - 2) != leading) {
+      throw error("The query {}, transposed key {} and value {} of {} must "
+                  "have the same leading dimensions",
+                  query.shape(),
+                  keyTransposed.shape(),
+                  value.shape(),
+                  debugName());
+    }
+  }
+
+  const int64_t queries = query.dim(rank - 2);
+  const int64_t depth   = query.dim(rank - 1);
+  const int64_t keys    = keyTransposed.dim(rank - 1);
+  if (keyTransposed.dim(rank - 2) != depth || value.dim(rank - 2) != keys) {
+    throw error("The query {}, transposed key {} and value {} of {} have "
+                "mismatched dimensions",
+                query.shape(),
+                keyTransposed.shape(),
+                value.shape(),
+                debugName());
+  }
+
+  if (hasMask()) {
+    Shape scores = leading;
+    scores.push_back(queries);
+    scores.push_back(keys);
+    if (npOut(scores, inShape(getMaskInIndex()), debugName()) != scores) {
+      throw error("The mask {} of {} cannot be broadcast to the scores {}",
+                  inShape(getMaskInIndex()),
+                  debugName(),
+                  scores);
+    }
+  }
+
+  Shape logSumExp = leading;
+  logSumExp.push_back(queries);
+  Shape out = logSumExp;
+  out.push_back(value.dim(rank - 1));
+  outInfo(getOutIndex())          = {query.dataType(), out};
+  outInfo(getLogSumExpOutIndex()) = {query.dataType(), logSumExp};
+}
+
+void AttentionOp::appendOutlineAttributes(OpSerialiserBase &os) const {
+  Op::appendOutlineAttributes(os);
+  os.appendAttribute("scale", scale);
+  os.appendAttribute("tileSize", tileSize);
+}
+
+AttentionGradOp::AttentionGradOp(const AttentionOp &fwdOp)
+    : Op(Onnx::GradOperators::AttentionGrad, fwdOp.getSettings()),
+      scale(fwdOp.getScale()), tileSize(fwdOp.getTileSize()),
+      queryInfo(fwdOp.inInfo(AttentionOp::getQueryInIndex())),
+      keyTransposedInfo(fwdOp.inInfo(AttentionOp::getKeyTransposedInIndex())),
+      valueInfo(fwdOp.inInfo(AttentionOp::getValueInIndex())) {
+  gradInInfo = {
+      {getGradInIndex(), AttentionOp::getOutIndex(), GradOpInType::GradOut},
+      {getQueryInIndex(), AttentionOp::getQueryInIndex(), GradOpInType::In},
+      {getKeyTransposedInIndex(),
+       AttentionOp::getKeyTransposedInIndex(),
+       GradOpInType::In},
+      {getValueInIndex(), AttentionOp::getValueInIndex(), GradOpInType::In},
+      {getFwdOutInIndex(), AttentionOp::getOutIndex(), GradOpInType::Out},
+      {getLogSumExpInIndex(),
+       AttentionOp::getLogSumExpOutIndex(),
+       GradOpInType::Out}};
+  if (fwdOp.hasMask()) {
+    gradInInfo.push_back(
+        {getMaskInIndex(), AttentionOp::getMaskInIndex(), GradOpInType::In});
+  }
+}
+
+std::unique_ptr<Op> AttentionGradOp::clone() const {
+  return std::make_unique<AttentionGradOp>(*this);
+}
+
+void AttentionGradOp::setup() {
+  outInfo(getQueryOutIndex())         = queryInfo;
+  outInfo(getKeyTransposedOutIndex()) = keyTransposedInfo;
+  outInfo(getValueOutIndex())         = valueInfo;
+}
+
+const std::vector<GradInOutMapper> &AttentionGradOp::gradInputInfo() const {
+  return gradInInfo;
+}
+
+// The mask has no gradient.
+const std::map<int, int> &AttentionGradOp::gradOutToNonGradIn() const {
+  static const std::map<int, int> outInfo = {
+      {getQueryOutIndex(), AttentionOp::getQueryInIndex()},
+      {getKeyTransposedOutIndex(), AttentionOp::getKeyTransposedInIndex()},
+      {getValueOutIndex(), AttentionOp::getValueInIndex()}};
+  return outInfo;
+}
+
+void AttentionGradOp::appendOutlineAttributes(OpSerialiserBase &os) const {
+  Op::appendOutlineAttributes(os);
+  os.appendAttribute("scale", scale);
+  os.appendAttribute("tileSize", tileSize);
+}
+
+} // namespace popart
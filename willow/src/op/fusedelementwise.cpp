@@ -0,0 +1,191 @@
+// Copyright (c) 2022 Graphcore Ltd. All rights reserved.
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <popart/error.hpp>
+#include <popart/op/fusedelementwise.hpp>
+#include <popart/opserialiser.hpp>
+#include <popart/tensorinfo.hpp>
+
+#include "popart/datatype.hpp"
+#include "popart/names.hpp"
+#include "popart/op.hpp"
+#include "popart/operatoridentifier.hpp"
+
+namespace popart {
+
+namespace {
+
+bool isLeaf(FusedElementwiseExprType type) {
+  return type == FusedElementwiseExprType::Input ||
+         type == FusedElementwiseExprType::Const;
+}
+
+bool isBinary(FusedElementwiseExprType type) {
+  switch (type) {
+  case FusedElementwiseExprType::Add:
+  case FusedElementwiseExprType::Div:
+  case FusedElementwiseExprType::Max:
+  case FusedElementwiseExprType::Mul:
+  case FusedElementwiseExprType::Pow:
+  case FusedElementwiseExprType::Sub:
+    return true;
+  default:
+    return false;
+  }
+}
+
+} // namespace
+
+std::string toString(FusedElementwiseExprType type) {
+  switch (type) {
+  case FusedElementwiseExprType::Input:
+    return "Input";
+  case FusedElementwiseExprType::Const:
+    return "Const";
+  case FusedElementwiseExprType::Abs:
+    return "Abs";
+  case FusedElementwiseExprType::Cast:
+    return "Cast";
+  case FusedElementwiseExprType::Exp:
+    return "Exp";
+  case FusedElementwiseExprType::Log:
+    return "Log";
+  case FusedElementwiseExprType::Neg:
+    return "Neg";
+  case FusedElementwiseExprType::Reciprocal:
+    return "Reciprocal";
+  case FusedElementwiseExprType::Sigmoid:
+    return "Sigmoid";
+  case FusedElementwiseExprType::Sqrt:
+    return "Sqrt";
+  case FusedElementwiseExprType::Tanh:
+    return "Tanh";
+  case FusedElementwiseExprType::Add:
+    return "Add";
+  case FusedElementwiseExprType::Div:
+    return "Div";
+  case FusedElementwiseExprType::Max:
+    return "Max";
+  case FusedElementwiseExprType::Mul:
+    return "Mul";
+  case FusedElementwiseExprType::Pow:
+    return "Pow";
+  case FusedElementwiseExprType::Sub:
+    return "Sub";
+  }
+  throw internal_error("Unknown FusedElementwiseExprType {}",
+                       static_cast<int>(type));
+}
+
+FusedElementwiseOp::FusedElementwiseOp(
+    const OperatorIdentifier &_opid,
+    const std::vector<FusedElementwiseExpr> &exprs_,
+    const Op::Settings &settings_)
+    : Op(_opid, settings_), exprs(exprs_) {}
+
+std::unique_ptr<Op> FusedElementwiseOp::clone() const {
+  return std::make_unique<FusedElementwiseOp>(*this);
+}
+
+void FusedElementwiseOp::setup() {
+  if (exprs.empty()) {
+    throw error("The expression of {} is empty", debugName());
+  }
+
+  // The data type of each node. Constants take the type of the other argument
+  // of the binary expression they are in.
+  std::vector<DataType> types(exprs.size(), DataType::UNDEFINED);
+  Shape shape;
+  const int numExprs = exprs.size();
+  for (int i = 0; i < numExprs; ++i) {
+    const auto &expr = exprs[i];
+    const size_t numArgs =
+        isLeaf(expr.type) ? 0 : (isBinary(expr.type) ? 2 : 1);
+    if (expr.args.size() != numArgs) {
+      throw error("Node {} ({}) of the expression of {} has {} arguments, "
+                  "expected {}",
+                  i,
+                  toString(expr.type),
+                  debugName(),
+                  expr.args.size(),
+                  numArgs);
+    }
+    for (int arg : expr.args) {
+      if (arg < 0 || arg >= i) {
+        throw error("Node {} of the expression of {} has argument {}, which "
+                    "is not an earlier node",
+                    i,
+                    debugName(),
+                    arg);
+      }
+    }
+
+    switch (expr.type) {
+    case FusedElementwiseExprType::Input:
+      if (!hasInput(expr.inIndex)) {
+        throw error("Node {} of the expression of {} is input {}, which is not "
+                    "connected",
+                    i,
+                    debugName(),
+                    expr.inIndex);
+      }
+      types[i] = inInfo(expr.inIndex).dataType();
+      shape    = npOut(shape, inShape(expr.inIndex), debugName());
+      break;
+    case FusedElementwiseExprType::Const:
+      break;
+    case FusedElementwiseExprType::Cast:
+      types[i] = expr.dataType;
+      break;
+    default:
+      types[i] = types[expr.args[0]];
+      if (types[i] == DataType::UNDEFINED && isBinary(expr.type)) {
+        types[i] = types[expr.args[1]];
+      }
+    }
+  }
+
+  if (types.back() == DataType::UNDEFINED) {
+    throw error("The expression of {} does not depend on any input",
+                debugName());
+  }
+  outInfo(getOutIndex()) = {types.back(), shape};
+}
+
+std::string FusedElementwiseOp::getExprString() const {
+  std::ostringstream ss;
+  for (size_t i = 0; i < exprs.size(); ++i) {
+    const auto &expr = exprs[i];
+    if (i != 0) {
+      ss << "; ";
+    }
+    switch (expr.type) {
+    case FusedElementwiseExprType::Input:
+      ss << "in" << expr.inIndex;
+      break;
+    case FusedElementwiseExprType::Const:
+      ss << expr.value;
+      break;
+    case FusedElementwiseExprType::Cast:
+      ss << "Cast(%" << expr.args[0] << ", "
+         << getDataTypeInfoMap().at(expr.dataType).name() << ")";
+      break;
+    default:
+      ss << toString(expr.type) << "(%" << expr.args[0];
+      if (expr.args.size() > 1) {
+        ss << ", %" << expr.args[1];
+      }
+      ss << ")";
+    }
+  }
+  return ss.str();
+}
+
+void FusedElementwiseOp::appendOutlineAttributes(OpSerialiserBase &os) const {
+  Op::appendOutlineAttributes(os);
+  os.appendAttribute("expr", getExprString());
+}
+
+} // namespace popart
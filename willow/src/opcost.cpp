@@ -0,0 +1,134 @@
+// Copyright (c) 2022 Graphcore Ltd. All rights reserved.
+#include <algorithm>
+#include <cstdint>
+#include <popart/graph.hpp>
+#include <popart/op.hpp>
+#include <popart/op/attention.hpp>
+#include <popart/op/convbase.hpp>
+#include <popart/op/loop.hpp>
+#include <popart/op/matmul.hpp>
+#include <popart/opcost.hpp>
+#include <popart/tensor.hpp>
+#include <popart/tensorindex.hpp>
+
+#include "popart/names.hpp"
+#include "popart/tensorinfo.hpp"
+
+namespace popart {
+
+namespace {
+
+// The floating point operations an IPU tile does in the time it takes to
+// access one byte of its memory.
+constexpr double flopsPerByte = 4.0;
+
+double macs(const TensorInfo &info, int64_t reduced) {
+  return 2.0 * static_cast<double>(info.nelms()) * static_cast<double>(reduced);
+}
+
+// The floating point operations of the multiply-accumulates of op, or 0 if it
+// is not a matrix multiplication, convolution or attention.
+double getMacFlops(const Op *op) {
+  if (op->isConvertibleTo<MatMulOp>()) {
+    return macs(op->outInfo(MatMulOp::getOutIndex()),
+                op->inInfo(MatMulOp::getLhsInIndex()).shape().back());
+  }
+  if (op->isConvertibleTo<MatMulLhsGradOp>()) {
+    return macs(op->inInfo(MatMulLhsGradOp::getGradInIndex()),
+                op->outInfo(MatMulLhsGradOp::getOutIndex()).shape().back());
+  }
+  if (op->isConvertibleTo<MatMulRhsGradOp>()) {
+    return macs(op->inInfo(MatMulRhsGradOp::getGradInIndex()),
+                op->inInfo(MatMulRhsGradOp::getLhsInIndex()).shape().back());
+  }
+  // Each output element of a convolution, and each element of the gradient of
+  // its output, takes a multiply-accumulate per weight of an output channel.
+  if (auto conv = dynamic_cast<const MultiConvBaseOp *>(op)) {
+    double flops = 0.0;
+    for (int i = 0; i < conv->numConvs(); i++) {
+      auto &weights = conv->inInfo(MultiConvBaseOp::getWeightsInIndex(i));
+      flops += macs(conv->outInfo(MultiConvBaseOp::getOutIndex(i)),
+                    weights.nelms() / weights.dim(0));
+    }
+    return flops;
+  }
+  if (auto conv = dynamic_cast<const MultiConvDataGradBaseOp *>(op)) {
+    double flops = 0.0;
+    for (int i = 0; i < conv->numConvs(); i++) {
+      auto &weights =
+          conv->inInfo(MultiConvDataGradBaseOp::getWeightsInIndex(i));
+      flops += macs(
+          conv->inInfo(MultiConvDataGradBaseOp::getGradConvolvedInIndex(i)),
+          weights.nelms() / weights.dim(0));
+    }
+    return flops;
+  }
+  if (auto conv = dynamic_cast<const MultiConvWeightsGradBaseOp *>(op)) {
+    double flops = 0.0;
+    for (int i = 0; i < conv->numConvs(); i++) {
+      auto &weights =
+          conv->outInfo(MultiConvWeightsGradBaseOp::getOutIndex(i));
+      flops += macs(
+          conv->inInfo(MultiConvWeightsGradBaseOp::getGradConvolvedInIndex(i)),
+          weights.nelms() / weights.dim(0));
+    }
+    return flops;
+  }
+  // Attention multiplies the queries by the keys, and the probabilities by the
+  // values. Its gradient does twice as much.
+  if (op->isConvertibleTo<AttentionOp>()) {
+    auto keys = op->inInfo(AttentionOp::getKeyTransposedInIndex()).shape();
+    return macs(op->inInfo(AttentionOp::getQueryInIndex()), keys.back()) +
+           macs(op->outInfo(AttentionOp::getOutIndex()), keys.back());
+  }
+  if (op->isConvertibleTo<AttentionGradOp>()) {
+    auto keys = op->inInfo(AttentionGradOp::getKeyTransposedInIndex()).shape();
+    return 2.0 *
+           (macs(op->inInfo(AttentionGradOp::getQueryInIndex()), keys.back()) +
+            macs(op->inInfo(AttentionGradOp::getFwdOutInIndex()), keys.back()));
+  }
+  return 0.0;
+}
+
+} // namespace
+
+double OpCost::getCost() const { return std::max(flops, bytes * flopsPerByte); }
+
+OpCost &OpCost::operator+=(const OpCost &other) {
+  flops += other.flops;
+  bytes += other.bytes;
+  return *this;
+}
+
+OpCost estimateOpCost(const Op *op) {
+  OpCost cost;
+  int64_t largest = 0;
+  for (auto tensor : op->input->tensors()) {
+    cost.bytes += static_cast<double>(tensor->info.nbytes());
+    largest = std::max(largest, tensor->info.nelms());
+  }
+  for (auto tensor : op->output->tensors()) {
+    cost.bytes += static_cast<double>(tensor->info.nbytes());
+    largest = std::max(largest, tensor->info.nelms());
+  }
+
+  cost.flops = getMacFlops(op);
+  if (cost.flops == 0.0) {
+    cost.flops = static_cast<double>(largest);
+  }
+
+  for (auto graph : op->getCalledGraphs()) {
+    OpCost called;
+    for (auto &id_op : graph->getOps()) {
+      called += estimateOpCost(id_op.second.get());
+    }
+    if (auto loop = dynamic_cast<const LoopOp *>(op)) {
+      called.flops *= loop->getTripCountValue();
+      called.bytes *= loop->getTripCountValue();
+    }
+    cost += called;
+  }
+  return cost;
+}
+
+} // namespace popart
@@ -24,12 +24,12 @@
 
 namespace {
 using namespace popart;
-class ProfileValueOpSerialiser : public OpSerialiserBase {
+class StringOpSerialiser : public OpSerialiserBase {
 public:
-  ProfileValue::Map map;
+  std::map<std::string, std::string> map;
 
-  ProfileValueOpSerialiser()          = default;
-  virtual ~ProfileValueOpSerialiser() = default;
+  StringOpSerialiser()          = default;
+  virtual ~StringOpSerialiser() = default;
 
   void appendAttribute(const std::string &name, float value) {
     map.insert({name, std::to_string(value)});
@@ -100,53 +100,61 @@ private:
 namespace popart {
 
 OpDebugInfo::OpDebugInfo(const DebugContext &debugContext, const Op &_op)
-    : DebugInfo(debugContext, "popart"), op(_op) {
+    : DebugInfo(debugContext, "popart"), op(_op) {}
+
+OpDebugInfo::~OpDebugInfo() {
+  // The id and opid of the op are declared before its debug info, so are
+  // still alive.
   setValue("category", ProfileValue{"op"});
   setValue("instanceId", std::to_string(op.id));
 
   std::stringstream ss;
   ss << op.opid;
   setValue("opid", ss.str());
-}
 
-OpDebugInfo::~OpDebugInfo() {
   if (finalizeCalled == false) {
     setValue("discard", 1);
-  } else {
-    setValue("discard", 0);
+    return;
   }
+
+  ProfileValue::Vector inputsPV(inputs.begin(), inputs.end());
+  setValue("inputs", inputsPV);
+
+  ProfileValue::Vector outputsPV(outputs.begin(), outputs.end());
+  setValue("outputs", outputsPV);
+
+  ProfileValue::Map attributesPV(attributes.begin(), attributes.end());
+  setValue("attributes", attributesPV);
+  setValue("graphId", graphId);
+  setValue("discard", 0);
 }
 
 void OpDebugInfo::finalize() {
 
   finalizeCalled = true;
 
-  ProfileValue::Vector inputs;
+  inputs.clear();
   if (op.input) {
     for (auto t : op.input->tensorMap()) {
       if (t.second) {
-        std::string n = t.second->str();
-        inputs.push_back(n);
+        inputs.push_back(t.second->str());
       }
     }
   }
-  setValue("inputs", inputs);
 
-  ProfileValue::Vector outputs;
+  outputs.clear();
   if (op.output) {
     for (auto t : op.output->tensorMap()) {
       if (t.second) {
-        std::string n = t.second->id;
-        outputs.push_back(n);
+        outputs.push_back(t.second->id);
       }
     }
   }
-  setValue("outputs", outputs);
 
-  ProfileValueOpSerialiser attributes;
-  op.appendAttributes(attributes);
-  setValue("attributes", attributes.map);
-  setValue("graphId", op.settings.graph.get().getGraphId());
+  StringOpSerialiser serialiser;
+  op.appendAttributes(serialiser);
+  attributes = std::move(serialiser.map);
+  graphId    = op.settings.graph.get().getGraphId();
 }
 
 } // namespace popart
@@ -41,14 +41,6 @@ class TensorData;
 
 namespace {
 
-OpDomain sanitizeDomain(const OpDomain &domain) {
-  if (domain == "") {
-    return Domain::ai_onnx;
-  } else {
-    return domain;
-  }
-}
-
 std::vector<TensorId> getInputIds(const Node &node, const Graph &graph) {
   std::vector<TensorId> inputIds;
   for (int i = 0; i < node.input_size(); i++) {
@@ -170,33 +162,76 @@ OpManager::ComplexOpFactoryFunc &OpManager::OpInfo::getComplexFactory() {
   return *complexFactory;
 }
 
+OpManager::OpInfo *OpManager::OpVersions::findAtMost(int maxVersion) const {
+  auto it = std::upper_bound(versions.begin(), versions.end(), maxVersion);
+  if (it == versions.begin()) {
+    return nullptr;
+  }
+  return infos.at(std::distance(versions.begin(), it) - 1).get();
+}
+
+OpManager::OpInfo *OpManager::OpVersions::find(int version) const {
+  auto it = std::lower_bound(versions.begin(), versions.end(), version);
+  if (it == versions.end() || *it != version) {
+    return nullptr;
+  }
+  return infos.at(std::distance(versions.begin(), it)).get();
+}
+
 void OpManager::registerOp(const OpInfo &opInfo) {
-  auto opid = opInfo.id;
-  auto it   = getInstance().opMap.find(std::make_pair(opid.domain, opid.type));
-  if (it != getInstance().opMap.end()) {
-    // Add to list
-    it->second.insert(std::make_pair(opid.version, opInfo));
-  } else {
-    // Add new entry for domain/type
-    std::map<int, OpInfo> map;
-    map.insert(std::make_pair(opid.version, opInfo));
-    getInstance().opMap.insert(
-        std::make_pair(std::make_pair(opid.domain, opid.type), map));
+  auto &self      = getInstance();
+  const auto opid = opInfo.id;
+
+  // Intern the domain and type.
+  auto &typeIds = self.opTypeIds[opid.domain];
+  const auto id = typeIds.emplace(opid.type, self.opVersions.size());
+  if (id.second) {
+    self.opVersions.emplace_back();
+  }
+
+  // Keep the versions sorted. The first op registered for a version is the
+  // one used.
+  auto &opVersions = self.opVersions.at(id.first->second);
+  auto &versions   = opVersions.versions;
+  auto it = std::lower_bound(versions.begin(), versions.end(), opid.version);
+  if (it != versions.end() && *it == opid.version) {
+    return;
   }
+  const auto index = std::distance(versions.begin(), it);
+  versions.insert(it, opid.version);
+  opVersions.infos.insert(opVersions.infos.begin() + index,
+                          std::make_unique<OpInfo>(opInfo));
+}
+
+const OpManager::OpVersions *
+OpManager::findOpVersions(const OpDomain &domain, const OpType &type) const {
+  static const OpDomain aiOnnx(Domain::ai_onnx);
+
+  auto foundDomain = opTypeIds.find(domain.empty() ? aiOnnx : domain);
+  if (foundDomain == opTypeIds.end()) {
+    return nullptr;
+  }
+  auto foundType = foundDomain->second.find(type);
+  if (foundType == foundDomain->second.end()) {
+    return nullptr;
+  }
+  return &opVersions.at(foundType->second);
 }
 
 const std::vector<OperatorIdentifier>
 OpManager::getSupportedOperations(bool includePrivate) {
   std::vector<OperatorIdentifier> list;
 
-  for (auto &op : OpManager::getInstance().opMap) {
-    for (auto &opVersion : op.second) {
-      if (opVersion.second.isPublic || includePrivate) {
-        list.push_back(opVersion.second.id);
+  for (const auto &opVersions : OpManager::getInstance().opVersions) {
+    for (const auto &opInfo : opVersions.infos) {
+      if (opInfo->isPublic || includePrivate) {
+        list.push_back(opInfo->id);
       }
     }
   }
 
+  // In the order of the domains, types and versions.
+  std::sort(list.begin(), list.end(), OperatorIdentifierLess());
   return list;
 }
 
@@ -205,16 +240,9 @@ OpManager::getUnsupportedOperations(int opsetVersion) {
   std::vector<OperatorIdentifier> result;
 
   for (auto &op : getOpset(opsetVersion)) {
-    bool foundOp = [&]() {
-      auto foundType = getInstance().opMap.find({Domain::ai_onnx, op.type});
-      if (foundType == getInstance().opMap.end()) {
-        return false;
-      }
-
-      auto &versions    = foundType->second;
-      auto foundVersion = versions.find(op.version);
-      return foundVersion != versions.end();
-    }();
+    const auto opVersions =
+        getInstance().findOpVersions(Domain::ai_onnx, op.type);
+    const bool foundOp = opVersions && opVersions->find(op.version);
 
     if (!foundOp) {
       result.push_back(op);
@@ -228,10 +256,10 @@ const OpDefinitions
 OpManager::getSupportedOperationsDefinition(bool includePrivate) {
   OpDefinitions list;
 
-  for (auto &op : OpManager::getInstance().opMap) {
-    for (auto &opVersion : op.second) {
-      if (opVersion.second.isPublic || includePrivate) {
-        list.insert({opVersion.second.id, opVersion.second.details});
+  for (const auto &opVersions : OpManager::getInstance().opVersions) {
+    for (const auto &opInfo : opVersions.infos) {
+      if (opInfo->isPublic || includePrivate) {
+        list.insert({opInfo->id, opInfo->details});
       }
     }
   }
@@ -263,25 +291,8 @@ Attributes OpManager::getAttributesFromAnyMap(
 OpManager::OpInfo *OpManager::findOpInfo(const OpDomain &opDomain,
                                          const OpType &type,
                                          int opsetVersion) {
-  OpDomain domain = sanitizeDomain(opDomain);
-  int version     = 0;
-  OpInfo *opInfo  = nullptr;
-
-  // First find the domain/type
-  auto it2 = opMap.find(std::make_pair(domain, type));
-  if (it2 != opMap.end()) {
-    for (auto &it3 : it2->second) {
-
-      // Then find the op with the largest version that is less than the opset
-      // version
-      if (it3.first >= version && it3.first <= opsetVersion) {
-        version = it3.first;
-        opInfo  = &it3.second;
-      }
-    }
-  }
-
-  return opInfo;
+  const auto opVersions = findOpVersions(opDomain, type);
+  return opVersions ? opVersions->findAtMost(opsetVersion) : nullptr;
 }
 
 void OpManager::checkOpVersionAgainstOpset(const OpInfo *opInfo,
@@ -370,23 +381,11 @@ OpManager::createOpWithInputs(const OperatorIdentifier &opid,
 
   OpManager &self = getInstance();
 
-  // First find the domain/type
-  const auto &it2 = self.opMap.find(std::make_pair(opid.domain, opid.type));
-
-  if (it2 != self.opMap.end()) {
-    // Then find the version
-    const auto &it3 = it2->second.find(opid.version);
-
-    if (it3 != it2->second.end()) {
-      return self.create(opid,
-                         graph,
-                         name,
-                         {},
-                         attr,
-                         inIds,
-                         {},
-                         it3->second.getSimpleFactory());
-    }
+  const auto opVersions = self.findOpVersions(opid.domain, opid.type);
+  OpInfo *opInfo        = opVersions ? opVersions->find(opid.version) : nullptr;
+  if (opInfo != nullptr) {
+    return self.create(
+        opid, graph, name, {}, attr, inIds, {}, opInfo->getSimpleFactory());
   }
   return nullptr;
 }
@@ -503,26 +502,10 @@ OpVersion OpManager::getOpVersionFromOpSet(const OpDomain &opDomain,
                                            const int opsetVersion) {
   OpManager &self = getInstance();
 
-  OpDomain domain = opDomain;
-  if (domain == "")
-    domain = Domain::ai_onnx;
-
-  int version = 0;
-
-  // First find the domain/type
-  auto it2 = self.opMap.find(std::make_pair(domain, type));
-  if (it2 != self.opMap.end()) {
-    for (auto &it3 : it2->second) {
-
-      // Then find the op with the largest version that is less than the opset
-      // version
-      if (it3.first > version && it3.first <= opsetVersion) {
-        version = it3.first;
-      }
-    }
-  }
-
-  return version;
+  // The op with the largest version that is less than or equal to the opset
+  // version.
+  const auto opInfo = self.findOpInfo(opDomain, type, opsetVersion);
+  return opInfo ? opInfo->id.version : 0;
 }
 
 std::ostream &operator<<(std::ostream &os,
@@ -23,10 +23,12 @@
 
 namespace popart {
 
-OpSerialiser::OpSerialiser(const Op *op, std::stringstream &ss_)
+OpSerialiser::OpSerialiser(const Op *op,
+                           std::stringstream &ss_,
+                           bool withName)
     : OpSerialiserBase(), ss(ss_) {
   ss << '\n' << "Op ";
-  if (!op->getName().empty()) {
+  if (withName && !op->getName().empty()) {
     ss << '"' << op->getName() << "\", ";
   }
   ss << op->id << " of type " << op->opid << '\n';
@@ -0,0 +1,352 @@
+// Copyright (c) 2022 Graphcore Ltd. All rights reserved.
+#include <cstddef>
+#include <set>
+#include <string>
+#include <vector>
+#include <popart/graph.hpp>
+#include <popart/ir.hpp>
+#include <popart/op.hpp>
+#include <popart/op/add.hpp>
+#include <popart/op/attention.hpp>
+#include <popart/op/div.hpp>
+#include <popart/op/dropout.hpp>
+#include <popart/op/matmul.hpp>
+#include <popart/op/mul.hpp>
+#include <popart/op/scale.hpp>
+#include <popart/op/softmax.hpp>
+#include <popart/patterns/fusedattentionpattern.hpp>
+#include <popart/patterns/patterns.hpp>
+#include <popart/tensorindex.hpp>
+#include <popart/topocons.hpp>
+
+#include "popart/datatype.hpp"
+#include "popart/error.hpp"
+#include "popart/graphcoreoperators.hpp"
+#include "popart/half.hpp"
+#include "popart/logging.hpp"
+#include "popart/names.hpp"
+#include "popart/tensor.hpp"
+#include "popart/tensordata.hpp"
+#include "popart/tensorinfo.hpp"
+#include "popart/tensors.hpp"
+
+namespace popart {
+
+namespace {
+
+// The ops of an attention subgraph, from its output back to its scores.
+struct Attention {
+  MatMulOp *out      = nullptr;
+  DropoutOp *dropout = nullptr;
+  SoftmaxOp *softmax = nullptr;
+  AddOp *add         = nullptr;
+  InIndex maskIndex  = -1;
+  Op *scaleOp        = nullptr;
+  float scale        = 1.0f;
+  MatMulOp *scores   = nullptr;
+
+  std::vector<Op *> ops() const {
+    std::vector<Op *> result;
+    for (Op *op : std::vector<Op *>{out, dropout, softmax, add, scaleOp}) {
+      if (op) {
+        result.push_back(op);
+      }
+    }
+    result.push_back(scores);
+    return result;
+  }
+};
+
+// The producer of tensor if tensor is an intermediate tensor of the subgraph:
+// it is consumed only by the next op of the subgraph and is not otherwise
+// needed. Otherwise nullptr.
+Op *getIntermediateProducer(Tensor *tensor) {
+  if (!tensor->hasProducer() || tensor->consumers.getTotal() != 1 ||
+      tensor->isAnchored() || tensor->isGraphOutput() ||
+      tensor->id == tensor->getIr().getFinalLossId()) {
+    return nullptr;
+  }
+  return tensor->getProducer();
+}
+
+// Set value to that of tensor if it is a constant float scalar.
+bool getConstScalar(const Tensor *tensor, float &value) {
+  if (tensor->tensorType() != TensorType::Const ||
+      tensor->info.nelms() != 1 || !tensor->hasTensorData()) {
+    return false;
+  }
+  if (tensor->info.dataType() == DataType::FLOAT) {
+    value = tensor->tensorData()->copyDataAs<float>(1)[0];
+    return true;
+  }
+  if (tensor->info.dataType() == DataType::FLOAT16) {
+    value = tensor->tensorData()->copyDataAs<float16_t>(1)[0];
+    return true;
+  }
+  return false;
+}
+
+// If op scales its input by a constant, set scale and return the scaled
+// input. Otherwise return nullptr.
+Tensor *getScaledInput(Op *op, float &scale) {
+  if (op->isConvertibleTo<ScaleOp>()) {
+    scale = static_cast<ScaleOp *>(op)->getScaleFactor();
+    return op->inTensor(ScaleOp::getInIndex());
+  }
+  const bool isMul = op->isConvertibleTo<MulOp>();
+  if (!isMul && !op->isConvertibleTo<DivOp>()) {
+    return nullptr;
+  }
+  const auto arg0 = op->inTensor(MulOp::getArg0InIndex());
+  const auto arg1 = op->inTensor(MulOp::getArg1InIndex());
+  float value;
+  if (getConstScalar(arg1, value)) {
+    scale = isMul ? value : 1.0f / value;
+    return arg0;
+  }
+  if (isMul && getConstScalar(arg0, value)) {
+    scale = value;
+    return arg1;
+  }
+  return nullptr;
+}
+
+// Does tensor depend on a variable, so that the mask would need a grad?
+bool dependsOnVariable(Tensor *tensor) {
+  std::set<Tensor *> visited;
+  std::vector<Tensor *> pending{tensor};
+  while (!pending.empty()) {
+    auto t = pending.back();
+    pending.pop_back();
+    if (!visited.insert(t).second) {
+      continue;
+    }
+    if (t->tensorType() == TensorType::Variable) {
+      return true;
+    }
+    if (t->hasProducer()) {
+      for (auto in : t->getProducer()->input->tensors()) {
+        pending.push_back(in);
+      }
+    }
+  }
+  return false;
+}
+
+bool isFloat(DataType type) {
+  return type == DataType::FLOAT || type == DataType::FLOAT16;
+}
+
+bool isPlainMatMul(const MatMulOp *matmul) {
+  const auto &serialisation = matmul->getSerialiseSettings();
+  return !matmul->isPow2ScaledMatMul() &&
+         (serialisation.factor <= 1 ||
+          serialisation.mode == MatMulBaseOp::SerialiseSettings::Mode::None);
+}
+
+// Do query, keyTransposed and value have the same rank of at least 2 and the
+// same leading dimensions, so the matmuls do not broadcast?
+bool haveSameGroups(const Tensor *query,
+                    const Tensor *keyTransposed,
+                    const Tensor *value) {
+  const auto &q = query->info.shape();
+  if (q.size() < 2) {
+    return false;
+  }
+  const Shape leading(q.begin(), q.end() - 2);
+  for (auto tensor : {keyTransposed, value}) {
+    const auto &shape = tensor->info.shape();
+    if (shape.size() != q.size() ||
+        Shape(shape.begin(), shape.end() - 2) != leading) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Walk back from the matmul `op` to the scores of an attention subgraph.
+bool matchAttention(Op *op, Attention &attention) {
+  if (!op->isConvertibleTo<MatMulOp>()) {
+    return false;
+  }
+  attention.out = static_cast<MatMulOp *>(op);
+
+  Op *producer =
+      getIntermediateProducer(op->inTensor(MatMulOp::getLhsInIndex()));
+  if (producer && producer->isConvertibleTo<DropoutOp>()) {
+    attention.dropout = static_cast<DropoutOp *>(producer);
+    if (!attention.dropout->canBeReplacedByIdentity()) {
+      return false;
+    }
+    producer = getIntermediateProducer(
+        producer->inTensor(DropoutOp::getInIndex()));
+  }
+
+  if (!producer || !producer->isConvertibleTo<SoftmaxOp>()) {
+    return false;
+  }
+  attention.softmax = static_cast<SoftmaxOp *>(producer);
+  const auto scoresRank = producer->inRank(SoftmaxOp::getInIndex());
+  if (attention.softmax->getAxis() != scoresRank - 1) {
+    return false;
+  }
+  Tensor *scores = producer->inTensor(SoftmaxOp::getInIndex());
+  producer       = getIntermediateProducer(scores);
+
+  float scale;
+  if (producer && producer->isConvertibleTo<AddOp>()) {
+    // The mask is whichever input is not the scaled scores.
+    for (InIndex i : {AddOp::getArg0InIndex(), AddOp::getArg1InIndex()}) {
+      auto scaled = getIntermediateProducer(producer->inTensor(i));
+      if (scaled && (scaled->isConvertibleTo<MatMulOp>() ||
+                     getScaledInput(scaled, scale))) {
+        attention.add       = static_cast<AddOp *>(producer);
+        attention.maskIndex = 1 - i;
+        producer            = scaled;
+        break;
+      }
+    }
+    if (!attention.add) {
+      return false;
+    }
+    const auto mask = attention.add->inTensor(attention.maskIndex);
+    // The mask may be broadcast to the scores, but not the other way round.
+    if (attention.add->inInfo(1 - attention.maskIndex) != scores->info ||
+        mask->info.dataType() != scores->info.dataType() ||
+        (op->getIr().isTraining() && dependsOnVariable(mask))) {
+      return false;
+    }
+  }
+
+  if (producer) {
+    if (auto scaled = getScaledInput(producer, scale)) {
+      attention.scaleOp = producer;
+      attention.scale   = scale;
+      producer          = getIntermediateProducer(scaled);
+    }
+  }
+
+  if (!producer || !producer->isConvertibleTo<MatMulOp>()) {
+    return false;
+  }
+  attention.scores = static_cast<MatMulOp *>(producer);
+  return true;
+}
+
+// Check the attention subgraph can be fused.
+bool canFuse(const Attention &attention) {
+  const auto query = attention.scores->inTensor(MatMulOp::getLhsInIndex());
+  const auto keyTransposed =
+      attention.scores->inTensor(MatMulOp::getRhsInIndex());
+  const auto value = attention.out->inTensor(MatMulOp::getRhsInIndex());
+
+  if (!isPlainMatMul(attention.scores) || !isPlainMatMul(attention.out) ||
+      !haveSameGroups(query, keyTransposed, value)) {
+    return false;
+  }
+
+  const auto type = query->info.dataType();
+  if (!isFloat(type) || keyTransposed->info.dataType() != type ||
+      value->info.dataType() != type ||
+      attention.scores->outInfo(MatMulOp::getOutIndex()).dataType() != type ||
+      attention.out->outInfo(MatMulOp::getOutIndex()).dataType() != type) {
+    return false;
+  }
+
+  const auto &graph = attention.out->getGraph();
+  const auto &first = attention.out->settings;
+  for (auto op : attention.ops()) {
+    if (graph.topoCons->hasConstraint(op) ||
+        op->settings.vgraphId != first.vgraphId ||
+        op->settings.pipelineStage != first.pipelineStage ||
+        op->settings.executionPhase != first.executionPhase) {
+      return false;
+    }
+  }
+  return true;
+}
+
+} // namespace
+
+bool FusedAttentionPattern::matches(Op *op) const {
+  // Only run in the fwd pass, so the grad of the subgraph is an
+  // AttentionGradOp.
+  if (op->getIr().hasConstructedBackwards()) {
+    return false;
+  }
+  Attention attention;
+  return matchAttention(op, attention) && canFuse(attention);
+}
+
+std::vector<const Tensor *> FusedAttentionPattern::touches(Op *) const {
+  return {};
+}
+
+bool FusedAttentionPattern::apply(Op *op) const {
+  Attention attention;
+  if (!matchAttention(op, attention)) {
+    throw internal_error("[FusedAttentionPattern] Can not find the attention "
+                         "subgraph of Op {}. Pattern should not have matched.",
+                         op->debugName());
+  }
+  logging::pattern::trace("[FusedAttentionPattern] Applying to Op {}",
+                          op->debugName());
+
+  auto &graph       = op->getGraph();
+  const auto outId  = op->outId(MatMulOp::getOutIndex());
+  const auto query  = attention.scores->inId(MatMulOp::getLhsInIndex());
+  const auto keyT   = attention.scores->inId(MatMulOp::getRhsInIndex());
+  const auto value  = attention.out->inId(MatMulOp::getRhsInIndex());
+  const bool masked = attention.add != nullptr;
+  const auto mask   = masked ? attention.add->inId(attention.maskIndex) : "";
+
+  auto fused = graph.createOp<AttentionOp>(
+      Onnx::CustomOperators::Attention,
+      attention.scale,
+      getTileSize(),
+      Op::Settings(graph, op->name() + "/Attention", op->debugInfo.getId()));
+  transferBaseProperties(op, fused);
+
+  for (auto subgraphOp : attention.ops()) {
+    std::vector<TensorId> outIds;
+    for (auto &index_id : subgraphOp->output->tensorIdMap()) {
+      outIds.push_back(index_id.second);
+    }
+    subgraphOp->disconnectAllInputs();
+    subgraphOp->disconnectAllOutputs();
+    graph.eraseOp(subgraphOp->id);
+    for (const auto &id : outIds) {
+      if (id != outId) {
+        graph.getTensors().remove(id);
+      }
+    }
+  }
+
+  fused->connectInTensor(AttentionOp::getQueryInIndex(), query);
+  fused->connectInTensor(AttentionOp::getKeyTransposedInIndex(), keyT);
+  fused->connectInTensor(AttentionOp::getValueInIndex(), value);
+  if (masked) {
+    fused->connectInTensor(AttentionOp::getMaskInIndex(), mask);
+  }
+  fused->connectOutTensor(AttentionOp::getOutIndex(), outId);
+  fused->createAndConnectOutTensor(
+      AttentionOp::getLogSumExpOutIndex(),
+      graph.getIr().createIntermediateTensorId(outId + "_logSumExp"));
+  fused->setup();
+
+  logging::pattern::debug("[FusedAttentionPattern] Replaced the attention "
+                          "subgraph of {} with {}, scale {}",
+                          outId,
+                          fused->debugName(),
+                          attention.scale);
+  return true;
+}
+
+namespace {
+PatternCreator<FusedAttentionPattern>
+    fusedAttentionPattern("FusedAttention",
+                          false,  // Off by default
+                          false); // Not mandatory
+} // namespace
+
+} // namespace popart
@@ -77,6 +77,7 @@ void PatternNames::addName(const std::type_info &patternInfo,
   auto found     = instance.names.find(std::type_index(patternInfo));
   if (found == instance.names.end()) {
     instance.names[std::type_index(patternInfo)] = name;
+    instance.types.insert({name, std::type_index(patternInfo)});
   } else {
     throw error("A name has already been added for pattern class {}",
                 patternInfo.name());
@@ -95,12 +96,7 @@ const std::string &PatternNames::getName(const std::type_info &patternInfo) {
 
 bool PatternNames::contains(const std::string &name) {
   auto &instance = getInstance();
-  for (auto &info_name : instance.names) {
-    if (name == info_name.second) {
-      return true;
-    }
-  }
-  return false;
+  return instance.types.find(name) != instance.types.end();
 }
 
 PreAliasPatternManager &PreAliasPatternManager::getInstance() {
@@ -577,13 +573,8 @@ bool Patterns::isMandatory(Pattern &pattern) {
 }
 
 bool Patterns::isMandatory(std::string &pattern_name) {
-  const auto &patternInfosMap = PreAliasPatternManager::getPatternInfos();
-  for (auto idx : patternInfosMap) {
-    if (idx.second.name == pattern_name) {
-      return idx.second.mandatory;
-    }
-  }
-  return false;
+  const auto ti = PreAliasPatternManager::tryGetTypeIndex(pattern_name);
+  return ti && PreAliasPatternManager::getInfo(*ti).mandatory;
 }
 
 std::vector<std::unique_ptr<PreAliasPattern>> Patterns::getPreAliasList() {
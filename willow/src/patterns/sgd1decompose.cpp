@@ -81,6 +81,42 @@ void addAcclInTensor(SGD1ComboOp &comboOp,
 
   graph.getTensors().addVarInit(acclIntoAccumulatorId, wgInfo, d.data());
 }
+
+// Half arithmetic converts to and from float for every element, so for FLOAT16
+// scale in float and convert the whole tensor in bulk instead.
+template <>
+void addAcclInTensor<float16_t>(SGD1ComboOp &comboOp,
+                                const Tensor &weight,
+                                const Tensor &weightGrad,
+                                const TensorId &acclIntoAccumulatorId) {
+
+  auto &graph = comboOp.getGraph();
+  auto wgInfo = weightGrad.info;
+  auto nelms  = wgInfo.nelms();
+
+  std::vector<char> tempData;
+  const uint16_t *weightVal0;
+  if (weight.hasTensorData()) {
+    weightVal0 = static_cast<const uint16_t *>(weight.tensorData()->data());
+  } else {
+    tempData   = weight.getDataViaGraphTraversal();
+    weightVal0 = reinterpret_cast<const uint16_t *>(tempData.data());
+  }
+
+  std::vector<float> f(nelms);
+  halfToFloat(weightVal0, f.data(), nelms);
+  // Recall, this scaling factor is (1-dm)*wd*vs. Round it to half first, to
+  // match the generic implementation.
+  const float swd1 =
+      static_cast<float>(static_cast<float16_t>(comboOp.initSwd1.val()));
+  for (auto &v : f) {
+    v *= swd1;
+  }
+
+  std::vector<uint16_t> d(nelms);
+  floatToHalf(f.data(), d.data(), nelms);
+  graph.getTensors().addVarInit(acclIntoAccumulatorId, wgInfo, d.data());
+}
 } // namespace
 
 bool SGD1Decompose::apply(Op *op) const {
@@ -4,8 +4,10 @@
 #include <boost/filesystem.hpp>
 #include <cstdint>
 #include <cstring>
+#include <deque>
 #include <fstream>
 #include <functional>
+#include <future>
 #include <gcl/CollectiveBalancedReorder.hpp>
 #include <iterator>
 #include <map>
@@ -27,8 +29,11 @@
 #include <poplar/StreamCallback.hpp>
 #include <poplar/exceptions.hpp>
 #include <poprithms/logging/timepartitionlogger.hpp>
+#include <popx/planningcaches.hpp>
 #include <popx/rng/rngstatelowering.hpp>
+#include <popx/weighttransferengine.hpp>
 #include <popart/devicemanager.hpp>
+#include <popart/enginecache.hpp>
 #include <popart/error.hpp>
 #include <popart/ir.hpp>
 #include <popart/logging.hpp>
@@ -248,7 +253,10 @@ void Devicex::weightsToHost() {
     logging::devicex::debug("Writing weights to host");
     pEngine->disableExecutionProfiling();
     // Weights on the IPU
-    run(PopPrograms::ProgramIndex::WeightsToHost, "WeightsToHost");
+    {
+      WeightTransferEngine::ScopedPhase phase("WeightsToHost program");
+      run(PopPrograms::ProgramIndex::WeightsToHost, "WeightsToHost");
+    }
     // Weights in the remote buffers
     remoteBufferWeightsToHost();
     logging::devicex::debug("Writing weights to host complete.");
@@ -297,12 +305,28 @@ void Devicex::popxlMarkHostWeightsInSync() {
 
 void Devicex::remoteBufferWeightsToHost() {
   POPART_TRACEPOINT();
+  auto &transfer = getWeightTransferEngine();
+  WeightTransferEngine::ScopedPhase phase("remoteBufferWeightsToHost");
+
+  // The remote buffer copies are issued from this thread. The host side work
+  // that follows them for sharded weights (undoing the collective balanced
+  // rearrangement and duplicating the result for each group member) is handed
+  // to the transfer engine, so that it overlaps with the remote buffer copies
+  // of the following groups and tensors.
+  std::vector<std::future<void>> pending;
+
+  // Remote weights that still need combining across instances once their
+  // host side work is complete.
+  std::vector<Tensor *> remoteWeights;
+
   for (auto *tensor : executable_.getWeightTensors()) {
     const auto &initId = tensor->id;
     if (tensor->tensorLocationInfo.isRemote()) {
       logging::devicex::debug("remoteBufferWeightsToHost: {}, [type={}]",
                               initId,
                               tensor->tensorType());
+      remoteWeights.push_back(tensor);
+
       // Collect information
       const auto remoteBufferInfo =
           tensor->tensorLocationInfo.getRemoteBufferInfo();
@@ -333,14 +357,17 @@ void Devicex::remoteBufferWeightsToHost() {
       const auto retrievalMode =
           tensor->getVariableSettings().getRetrievalMode();
 
+      phase.addBytes(data0Size);
+
       // Lambda expression that does the reading op automatically
+      const auto remoteBufferName =
+          lowering().getExchangeBundle().getRemoteBufferName(
+              remoteBufferInfo.first);
       auto copyFromRemoteBuffer = [&](char *to, unsigned replicaId) {
-        pEngine->copyFromRemoteBuffer(
-            lowering().getExchangeBundle().getRemoteBufferName(
-                remoteBufferInfo.first),
-            to,
-            static_cast<int>(remoteBufferInfo.second),
-            replicaId);
+        pEngine->copyFromRemoteBuffer(remoteBufferName,
+                                      to,
+                                      static_cast<int>(remoteBufferInfo.second),
+                                      replicaId);
       };
 
       if (tensor->tensorLocationInfo.isSharded()) {
@@ -365,23 +392,27 @@ void Devicex::remoteBufferWeightsToHost() {
         `groups` times more memory to be live at once. We choose to go with the
         more memory-efficient route, as memory is quite likely to be a problem
         for large models, and iterating over all the replicas is likely barely
-        a noticeable overhead.
+        a noticeable overhead. The staging buffers come from the transfer
+        engine's pool, which bounds how many groups are in flight at once.
        */
-        for (unsigned group = 0; group < numGroups; group++) {
-          // Replicated weight sharding, each replica holds parts of the
-          // weight
-          const auto &cbr =
-              executable_.getCollectiveBalancedHostRearrangement(tensor->id);
 
-          auto cbrNelms = cbr.getNumRearrangedTensorElems();
-          auto cbrSize  = cbr.getReplicationFactor();
-          // Throw internal_error because this should have been checked higher
-          // up the stack.
-          POPART_ASSERT_EQ(realGroupSize % cbrSize, 0);
+        // Replicated weight sharding, each replica holds parts of the
+        // weight
+        const auto &cbr =
+            executable_.getCollectiveBalancedHostRearrangement(tensor->id);
+
+        const auto cbrNelms = cbr.getNumRearrangedTensorElems();
+        const auto cbrSize  = cbr.getReplicationFactor();
+        // Throw internal_error because this should have been checked higher
+        // up the stack.
+        POPART_ASSERT_EQ(realGroupSize % cbrSize, 0);
 
+        for (unsigned group = 0; group < numGroups; group++) {
           // Temporary buffer that can hold the padded weight shards
-          // from all replicas in this group.
-          std::vector<char> tmp(cbrNelms * elemSize);
+          // from all replicas in this group. Shards of replicas on other
+          // instances must read as zero for the AllReduce below.
+          auto tmp = transfer.acquireBuffer(
+              cbrNelms * elemSize, distributedReplicatedGraphsEnabled());
 
           // Iterate over group members, collect the Tensor's shards.
           // When cbr_size < realGroupSize, we only collect shards from the
@@ -394,7 +425,7 @@ void Devicex::remoteBufferWeightsToHost() {
                 globalReplicaId < globalReplicaOffset + instanceReplicas) {
               const unsigned shardNelms = cbrNelms / cbrSize;
               const unsigned addr       = groupMember * shardNelms * elemSize;
-              copyFromRemoteBuffer(&tmp[addr], localReplicaId);
+              copyFromRemoteBuffer(&(*tmp)[addr], localReplicaId);
             }
           }
 
@@ -420,24 +451,37 @@ void Devicex::remoteBufferWeightsToHost() {
                 globalReplicas);
           }
 
-          cbr.undoRearrangeForCollective(&tmp[0],
-                                         tmp.size() * sizeof(tmp[0]),
-                                         &data0[address],
-                                         data0Size - address,
-                                         elemSize);
-
-          // Copy the contents of the collection to the space of the other
-          // replicas. This means their collection is synthesized and will
-          // always be the same.
-          // Note, if returning only OnePerGroup, this loop will never run.
-          for (unsigned groupMember = 1; groupMember < returnedPerGroup;
-               groupMember++) {
-            const unsigned replicaId =
-                grouping.getReplicaAt(group, groupMember);
-            const unsigned replicaAddr = replicaId * nelms * elemSize;
-            const unsigned elements    = elemSize * nelms;
-            memcpy(&data0[replicaAddr], &data0[address], elements);
-          }
+          // Each group writes to its own entries of data0, so the groups can
+          // be finished in parallel.
+          pending.push_back(transfer.async([&cbr,
+                                            tmp,
+                                            data0,
+                                            data0Size,
+                                            address,
+                                            grouping,
+                                            group,
+                                            returnedPerGroup,
+                                            nelms,
+                                            elemSize]() {
+            cbr.undoRearrangeForCollective(tmp->data(),
+                                           tmp->size(),
+                                           &data0[address],
+                                           data0Size - address,
+                                           elemSize);
+
+            // Copy the contents of the collection to the space of the other
+            // replicas. This means their collection is synthesized and will
+            // always be the same.
+            // Note, if returning only OnePerGroup, this loop will never run.
+            for (unsigned groupMember = 1; groupMember < returnedPerGroup;
+                 groupMember++) {
+              const unsigned replicaId =
+                  grouping.getReplicaAt(group, groupMember);
+              const unsigned replicaAddr = replicaId * nelms * elemSize;
+              const unsigned elements    = elemSize * nelms;
+              memcpy(&data0[replicaAddr], &data0[address], elements);
+            }
+          }));
 
           // If multi-instance, we later do an AllReduce on data0 to reconstruct
           // the full tensor. Recall, within each entry in data0, there will be
@@ -488,56 +532,80 @@ void Devicex::remoteBufferWeightsToHost() {
                                static_cast<int>(retrievalMode));
         }
       }
+    }
+  }
 
-      // The cases are (OnePerGroup, AllReplicas) x (sharded, unsharded).
-      // The above logic throughout the function explains what has happened to
-      // data0 so far in each case, and what is further required here to handle
-      // multiple instances.
-      if (distributedReplicatedGraphsEnabled()) {
-        if (retrievalMode == VariableRetrievalMode::OnePerGroup) {
-          // OnePerGroup, sharded or unsharded
-          // Note in OnePerGroup, data0 has numGroups entries.
-          popdist::collectives::allReduceSum(
-              data0, numGroups * nelms, popType(tensor->info));
-        } else if (tensor->tensorLocationInfo.isSharded()) {
-          // AllReplicas, sharded
-          // Note in AllReplicas, data0 has globalReplicas entries.
-          popdist::collectives::allReduceSum(
-              data0, globalReplicas * nelms, popType(tensor->info));
-
-          // TODO(T69345): AllGather then, per group: Reduce_Local then memcpy
-        } else {
-          // AllReplicas, unsharded
-          // Note in AllReplicas, data0 has globalReplicas entries, and we are
-          // gathering instanceReplicas entries from each instance.
-          popdist::collectives::allGather(nullptr,
-                                          data0,
-                                          instanceReplicas * nelms,
-                                          popType(tensor->info),
-                                          popdist::defaultCommunicatorId(),
-                                          true // inplace
-          );
-        }
-      }
+  // All host side work must be finished before data0 is combined across
+  // instances, or returned to the caller.
+  WeightTransferEngine::waitAll(pending);
+
+  if (!distributedReplicatedGraphsEnabled()) {
+    return;
+  }
+
+  // The cases are (OnePerGroup, AllReplicas) x (sharded, unsharded).
+  // The above logic throughout the function explains what has happened to
+  // data0 so far in each case, and what is further required here to handle
+  // multiple instances.
+  for (auto *tensor : remoteWeights) {
+    char *data0          = getD2hWeightData(tensor);
+    const unsigned nelms = tensor->info.nelms();
+
+    const unsigned instanceReplicas = getReplicationFactor();
+    const unsigned globalReplicas   = getGlobalReplicationFactor();
+    const auto grouping =
+        tensor->getVariableSettings().getReplicaGrouping(globalReplicas);
+    const unsigned numGroups = grouping.getNumGroups();
+
+    if (tensor->getVariableSettings().getRetrievalMode() ==
+        VariableRetrievalMode::OnePerGroup) {
+      // OnePerGroup, sharded or unsharded
+      // Note in OnePerGroup, data0 has numGroups entries.
+      popdist::collectives::allReduceSum(
+          data0, numGroups * nelms, popType(tensor->info));
+    } else if (tensor->tensorLocationInfo.isSharded()) {
+      // AllReplicas, sharded
+      // Note in AllReplicas, data0 has globalReplicas entries.
+      popdist::collectives::allReduceSum(
+          data0, globalReplicas * nelms, popType(tensor->info));
+
+      // TODO(T69345): AllGather then, per group: Reduce_Local then memcpy
+    } else {
+      // AllReplicas, unsharded
+      // Note in AllReplicas, data0 has globalReplicas entries, and we are
+      // gathering instanceReplicas entries from each instance.
+      popdist::collectives::allGather(nullptr,
+                                      data0,
+                                      instanceReplicas * nelms,
+                                      popType(tensor->info),
+                                      popdist::defaultCommunicatorId(),
+                                      true // inplace
+      );
     }
   }
 }
 
 void Devicex::readWeights(const IWeightsIO &weights) {
   POPART_TRACEPOINT();
+  WeightTransferEngine::ScopedPhase phase("readWeights");
   // Better to do this the other way round
+  std::vector<HostCopyJob> jobs;
   for (auto *tensor : executable_.getWeightTensors()) {
     const auto &id = tensor->id;
     if (weights.contains(id)) {
       logging::devicex::debug("Reading weights (host stream -> host) for {}",
                               id);
       MutableVoidData stepout = weights.weight(id);
-      hostStreamToHost(stepout, id, DownsampleStream::No);
+      appendHostStreamToHostCopies(stepout, id, DownsampleStream::No, jobs);
     } else {
       logging::devicex::debug(
           "Not reading weights (host stream -> host) for {}", id);
     }
   }
+  for (const auto &job : jobs) {
+    phase.addBytes(job.nbytes);
+  }
+  getWeightTransferEngine().copy(jobs);
 }
 
 void Devicex::writeWeights(const IWeightsIO &weights) {
@@ -570,7 +638,10 @@ void Devicex::weightsToHost(
 
     pEngine->disableExecutionProfiling();
     // Weights on the IPU
-    run(PopPrograms::ProgramIndex::WeightsToHost, "WeightsToHost");
+    {
+      WeightTransferEngine::ScopedPhase phase("WeightsToHost program");
+      run(PopPrograms::ProgramIndex::WeightsToHost, "WeightsToHost");
+    }
     // Weights in the remote buffers
     remoteBufferWeightsToHost();
 
@@ -611,8 +682,11 @@ void Devicex::d2hWeightBuffersToTensorData(
 
   if (ir().useSyntheticData() == false) {
     logging::devicex::debug("Writing weights to ONNX ModelProto");
+    WeightTransferEngine::ScopedPhase phase("d2hWeightBuffersToTensorData");
     // copy from the host stream memory points to the
-    // addresses on onnxModelData
+    // addresses on onnxModelData. All copies are collected first so that they
+    // can be spread over the transfer engine's threads.
+    std::vector<HostCopyJob> jobs;
     for (auto *tensor : executable_.getWeightTensors()) {
       const auto &id = tensor->id;
       if (!ir().storingIsDisabledForTensor(tensor)) {
@@ -628,9 +702,14 @@ void Devicex::d2hWeightBuffersToTensorData(
           throw runtime_error(oss.str());
         }
         MutableVoidData mv_data = found->second;
-        hostStreamToHost(mv_data, id, DownsampleStream::GroupPrimary);
+        appendHostStreamToHostCopies(
+            mv_data, id, DownsampleStream::GroupPrimary, jobs);
       }
     }
+    for (const auto &job : jobs) {
+      phase.addBytes(job.nbytes);
+    }
+    getWeightTransferEngine().copy(jobs);
   }
 }
 
@@ -652,8 +731,24 @@ std::map<std::string, std::vector<uint64_t>> Devicex::cycleCountTensorToHost() {
 
 Devicex::~Devicex() = default;
 
+namespace {
+
+std::shared_ptr<PlanningCaches> createPlanningCaches(Executablex &exe,
+                                                     const DeviceInfo &di) {
+  if (!exe.lowering().ir().getSessionOptions().enablePlanningCacheReuse) {
+    return std::make_shared<PlanningCaches>();
+  }
+  return PlanningCaches::getShared(PlanningCaches::getTargetKey(
+      di.getTarget(), exe.lowering().getReplicationFactor()));
+}
+
+} // namespace
+
 Devicex::Devicex(Executablex &exe, std::shared_ptr<DeviceInfo> deviceInfo_)
-    : executable_(exe), deviceInfo(deviceInfo_), prepareHasBeenCalled_(false) {
+    : executable_(exe), deviceInfo(deviceInfo_), prepareHasBeenCalled_(false),
+      planningCaches(createPlanningCaches(exe, *deviceInfo_)),
+      convCache(planningCaches->convCache),
+      matmulCache(planningCaches->matmulCache) {
   POPART_TRACEPOINT();
 
   logging::devicex::info("Setting selected device: {}", *deviceInfo);
@@ -671,6 +766,10 @@ Devicex::Devicex(Executablex &exe, std::shared_ptr<DeviceInfo> deviceInfo_)
   executable_.lowering().setDevicex(this);
 }
 
+std::unique_lock<std::mutex> Devicex::lockPlanningCaches() {
+  return std::unique_lock<std::mutex>(planningCaches->mutex);
+}
+
 const Ir &Devicex::ir() const { return lowering().ir(); }
 IrLowering &Devicex::lowering() { return executable_.lowering(); }
 const IrLowering &Devicex::lowering() const { return executable_.lowering(); }
@@ -684,8 +783,10 @@ void Devicex::weightsFromHost() {
     // Weights in the remote buffers
     remoteBufferWeightsFromHost();
     // Weights on the IPU
-
-    run(PopPrograms::ProgramIndex::WeightsFromHost, "WeightsFromHost");
+    {
+      WeightTransferEngine::ScopedPhase phase("WeightsFromHost program");
+      run(PopPrograms::ProgramIndex::WeightsFromHost, "WeightsFromHost");
+    }
 
     logging::devicex::debug("done.");
   }
@@ -696,6 +797,39 @@ void Devicex::remoteBufferWeightsFromHost() {
   if (isEngineLoaded() == false) {
     loadEngineAndConnectStreams();
   }
+  auto &transfer = getWeightTransferEngine();
+  WeightTransferEngine::ScopedPhase phase("remoteBufferWeightsFromHost");
+
+  // A group of a sharded weight whose collective balanced rearrangement has
+  // been handed to the transfer engine, and which is waiting to be copied to
+  // the remote buffers of the group members on this instance.
+  struct RearrangedGroup {
+    std::future<void> rearranged;
+    WeightTransferEngine::Buffer buffer;
+    std::string remoteBufferName;
+    int repeatIndex;
+    // The local replica and the byte offset into `buffer` of its shard.
+    std::vector<std::pair<unsigned, unsigned>> shards;
+  };
+
+  // Rearrangements of the next few groups run ahead on the worker threads
+  // while the remote buffer copies of the current group are issued here. One
+  // staging buffer is kept back so acquiring the next one never blocks.
+  std::deque<RearrangedGroup> inFlight;
+  const unsigned maxInFlight = std::max(1u, transfer.getMaxBuffers() - 1);
+
+  auto copyOldestToRemoteBuffers = [this, &inFlight]() {
+    auto &oldest = inFlight.front();
+    oldest.rearranged.get();
+    for (const auto &shard : oldest.shards) {
+      pEngine->copyToRemoteBuffer(&(*oldest.buffer)[shard.second],
+                                  oldest.remoteBufferName,
+                                  oldest.repeatIndex,
+                                  shard.first);
+    }
+    inFlight.pop_front();
+  };
+
   for (auto *tensor : executable_.getWeightTensors()) {
     const auto &initId = tensor->id;
     if (tensor->tensorLocationInfo.isRemote()) {
@@ -719,16 +853,12 @@ void Devicex::remoteBufferWeightsFromHost() {
       const unsigned numGroups     = grouping.getNumGroups();
       const unsigned realGroupSize = grouping.getGroupSize();
 
-      // Lambda expression that does the writing op automatically
-      const auto copyToRemoteBuffer =
-          [this, remoteBufferInfo](char *from, const unsigned replicaId) {
-            pEngine->copyToRemoteBuffer(
-                from,
-                lowering().getExchangeBundle().getRemoteBufferName(
-                    remoteBufferInfo.first),
-                static_cast<int>(remoteBufferInfo.second),
-                replicaId);
-          };
+      phase.addBytes(data0Size);
+
+      const auto remoteBufferName =
+          lowering().getExchangeBundle().getRemoteBufferName(
+              remoteBufferInfo.first);
+      const auto repeatIndex = static_cast<int>(remoteBufferInfo.second);
 
       if (tensor->tensorLocationInfo.isSharded()) {
         // Replicated weight sharding, each replica holds parts of the weight
@@ -750,24 +880,38 @@ void Devicex::remoteBufferWeightsFromHost() {
         // the cbr-rearranged data of all groups at once. These are both
         // prohibitive due to the sizes of these buffers, therefore we choose to
         // simply iterate over a larger space and skip whenever a replica is not
-        // on this instance.
+        // on this instance. The number of temporary buffers alive at once is
+        // bounded by maxInFlight.
         for (unsigned group = 0; group < numGroups; group++) {
+          while (inFlight.size() >= maxInFlight) {
+            copyOldestToRemoteBuffers();
+          }
+
+          RearrangedGroup next;
+          next.remoteBufferName = remoteBufferName;
+          next.repeatIndex      = repeatIndex;
 
-          std::vector<char> tmp(cbrNelms * elemSize);
+          // Zeroed, so that padding sent to the device is deterministic.
+          next.buffer =
+              transfer.acquireBuffer(cbrNelms * elemSize, /*zeroed=*/true);
 
           // Address in input buffer from which this group fetches their
           // weights.
           const unsigned address = group * nelms * elemSize;
 
           // Rearrange weights into tmp buffer
-          cbr.rearrangeForCollective(&data0[address],
-                                     data0Size - address,
-                                     &tmp[0],
-                                     tmp.size() * sizeof(tmp[0]),
-                                     elemSize);
-
-          // For each group member, copy the relevant shard into the remote
-          // buffer.
+          auto tmp        = next.buffer;
+          next.rearranged = transfer.async(
+              [&cbr, tmp, data0, data0Size, address, elemSize]() {
+                cbr.rearrangeForCollective(&data0[address],
+                                           data0Size - address,
+                                           tmp->data(),
+                                           tmp->size(),
+                                           elemSize);
+              });
+
+          // For each group member, find the relevant shard to copy into the
+          // remote buffer.
           for (unsigned groupMember = 0; groupMember < realGroupSize;
                groupMember++) {
             const unsigned globalReplicaId =
@@ -800,8 +944,10 @@ void Devicex::remoteBufferWeightsFromHost() {
             const unsigned addr =
                 shardDomainMember * cbrNelms * elemSize / shardDomainSize;
 
-            copyToRemoteBuffer(&tmp[addr], localReplicaId);
+            next.shards.push_back({localReplicaId, addr});
           }
+
+          inFlight.push_back(std::move(next));
         }
       } else {
         for (unsigned localReplicaId = 0; localReplicaId < instanceReplicas;
@@ -810,11 +956,16 @@ void Devicex::remoteBufferWeightsFromHost() {
           const auto group           = grouping.getGroupAt(globalReplicaId);
 
           const unsigned long index = group * nelms * elemSize;
-          copyToRemoteBuffer(&data0[index], localReplicaId);
+          pEngine->copyToRemoteBuffer(
+              &data0[index], remoteBufferName, repeatIndex, localReplicaId);
         }
       }
     }
   }
+
+  while (!inFlight.empty()) {
+    copyOldestToRemoteBuffers();
+  }
 }
 
 void Devicex::optimizerFromHost() {
@@ -831,62 +982,36 @@ void Devicex::hostStreamToHost(const MutableVoidData &mv_data,
                                TensorId id,
                                DownsampleStream downsample) {
   POPART_TRACEPOINT();
+  std::vector<HostCopyJob> jobs;
+  appendHostStreamToHostCopies(mv_data, id, downsample, jobs);
+  getWeightTransferEngine().copy(jobs);
+}
 
+void Devicex::appendHostStreamToHostCopies(const MutableVoidData &mv_data,
+                                           TensorId id,
+                                           DownsampleStream downsample,
+                                           std::vector<HostCopyJob> &jobs) {
   // The host end of the poplar::Stream,
   // we will try to copy from here
-  const void *src;
+  const auto segments = getHostWeightSegments(id, downsample);
 
-  // size of the host end of the poplar stream.
-  // It is a char vector, so this is in bytes.
-  int64_t nbytes_src;
+  auto dst = static_cast<char *>(mv_data.data);
 
-  Tensor *tensor        = executable_.getTensor(id);
-  auto variableSettings = tensor->getVariableSettings();
-
-  std::vector<char> tmp;
-
-  if (variableSettings.getRetrievalMode() ==
-          VariableRetrievalMode::AllReplicas &&
-      downsample == DownsampleStream::GroupPrimary) {
-    // Down-sample
-    auto groupCount =
-        variableSettings.getGroupCount(getGlobalReplicationFactor());
-    auto downSampledSize = groupCount * tensor->info.nbytes();
-
-    // Create temporary buffer
-    tmp = std::vector<char>(downSampledSize);
-
-    // Note, if ::AllReplicas, you may still not need a d2hWeightBuffer if
-    // enablesVariableCaching is off and the replica group size is 1 (and thus
-    // the num replicas returning a value is the same as the number of groups).
-    char *addr_src_base = getD2hWeightData(tensor);
-
-    // Copy the samples into the buffer
-    for (auto group = 0; group < groupCount; group++) {
-
-      auto replica  = variableSettings.getGroupRepresentative(group);
-      auto addr_dst = tmp.data() + (group * tensor->info.nbytes());
-      auto addr_src = addr_src_base + (replica * tensor->info.nbytes());
-      memcpy(addr_dst, addr_src, tensor->info.nbytes());
-    }
-    src        = static_cast<const void *>(tmp.data());
-    nbytes_src = downSampledSize;
-  } else {
-    // Do nothing special
-    src        = static_cast<const void *>(getD2hWeightData(tensor));
-    nbytes_src = getD2hWeightBufferSize(tensor);
-  }
-
-  auto dst = mv_data.data;
-
-  if (src == dst) {
+  if (segments.size() == 1 && segments.front().first == dst) {
     // Should only happen when this function is called as part of weightsToHost
     // to copy from the d2hWeightBuffer to the TensorData, but these buffers are
     // the same as the tensor did not need an intermediary d2hWeightBuffer.
-    POPART_ASSERT(!needsIntermediaryD2hWeightBuffer(tensor));
+    POPART_ASSERT(!needsIntermediaryD2hWeightBuffer(executable_.getTensor(id)));
     return;
   }
 
+  // size of the host end of the poplar stream.
+  // It is a char vector, so this is in bytes.
+  int64_t nbytes_src = 0;
+  for (const auto &segment : segments) {
+    nbytes_src += segment.second;
+  }
+
   // number of bytes of the destination.
   int64_t nbytes_dst = mv_data.info.nbytes();
 
@@ -902,7 +1027,41 @@ void Devicex::hostStreamToHost(const MutableVoidData &mv_data,
     throw runtime_error(errms.str());
   }
 
-  std::memcpy(dst, src, nbytes_src);
+  for (const auto &segment : segments) {
+    jobs.push_back({dst, segment.first, segment.second});
+    dst += segment.second;
+  }
+}
+
+std::vector<std::pair<const char *, size_t>>
+Devicex::getHostWeightSegments(const TensorId &id,
+                               DownsampleStream downsample) {
+  Tensor *tensor  = executable_.getTensor(id);
+  const char *src = getD2hWeightData(tensor);
+
+  auto variableSettings = tensor->getVariableSettings();
+
+  if (variableSettings.getRetrievalMode() ==
+          VariableRetrievalMode::AllReplicas &&
+      downsample == DownsampleStream::GroupPrimary) {
+    // Down-sample. Only the group representatives are used, each is a
+    // separate segment of the stream buffer.
+    // Note, if ::AllReplicas, you may still not need a d2hWeightBuffer if
+    // enablesVariableCaching is off and the replica group size is 1 (and thus
+    // the num replicas returning a value is the same as the number of groups).
+    const auto nbytes = static_cast<size_t>(tensor->info.nbytes());
+    const auto groupCount =
+        variableSettings.getGroupCount(getGlobalReplicationFactor());
+
+    std::vector<std::pair<const char *, size_t>> segments;
+    for (auto group = 0; group < groupCount; group++) {
+      auto replica = variableSettings.getGroupRepresentative(group);
+      segments.push_back({src + replica * nbytes, nbytes});
+    }
+    return segments;
+  }
+
+  return {{src, getD2hWeightBufferSize(tensor)}};
 }
 
 void Devicex::anchorsHostToHostStreams(IStepIO &stepio) {
@@ -1631,10 +1790,15 @@ void Devicex::prepare() {
 
       if (!executable_.isDeserialized() && executable_.shouldSerialize()) {
         static constexpr bool serializePopartMetadata = true;
-        const std::string cachePath = sessionOptions.cachePath;
-        serializeExecutable(executable_.getCachePath(cachePath),
-                            serializePopartMetadata,
-                            sessionOptions.enableVariablesCaching);
+        EngineCache(sessionOptions)
+            .publish(
+                ir().getHash(),
+                [&](std::ostream &out) {
+                  serializeExecutable(out,
+                                      serializePopartMetadata,
+                                      sessionOptions.enableVariablesCaching);
+                },
+                ir().getFingerprint());
       }
 
       logging::devicex::info(
@@ -1927,5 +2091,13 @@ char *Devicex::getD2hWeightData(Tensor *t) {
              : static_cast<char *>(t->tensorData()->data());
 }
 
+WeightTransferEngine &Devicex::getWeightTransferEngine() {
+  if (!weightTransferEngine) {
+    weightTransferEngine = std::make_unique<WeightTransferEngine>(
+        ir().getSessionOptions().weightTransferThreads);
+  }
+  return *weightTransferEngine;
+}
+
 } // namespace popx
 } // namespace popart
@@ -18,6 +18,7 @@
 #include <popart/optimizer.hpp>
 #include <popart/popx/executablex.hpp>
 #include <popart/popx/irlowering.hpp>
+#include <popart/shardedcheckpoint.hpp>
 
 #include "popart/devicemanager.hpp"
 #include "popart/logging.hpp"
@@ -290,6 +291,39 @@ void Executablex::resetWeights(
   }
 }
 
+void Executablex::resetWeights(
+    const shardedcheckpoint::Reader &checkpoint,
+    const bool ignoreWeightsInModelWithoutCorrespondingIrWeight) {
+  for (const auto &entry : checkpoint.getEntries()) {
+    const auto &tenId = entry.id;
+    if (!containsTensor(tenId)) {
+      if (ignoreWeightsInModelWithoutCorrespondingIrWeight) {
+        continue;
+      } else {
+        throw runtime_error("resetWeights, no tensor '" + tenId +
+                            "' in tensors");
+      }
+    }
+    auto tensor = getTensor(tenId);
+
+    // Grouped weights are stored with an extra outer dimension for the groups,
+    // which is checked by comparing the total size.
+    const auto &shape = tensor->info.shape();
+    const bool shapeMatches =
+        entry.info.shape().size() >= shape.size() &&
+        std::equal(shape.rbegin(), shape.rend(), entry.info.shape().rbegin());
+    if (tensor->info.dataType() != entry.info.dataType() || !shapeMatches ||
+        tensor->tensorData()->size() != entry.info.nbytes()) {
+      throw runtime_error("Trying to reset weights using tensor with non "
+                          "matching tensor info. Tensor ID: {}",
+                          tensor->id);
+    }
+    // Only this tensor's pages of the checkpoint are read.
+    const auto data = checkpoint.weight(tenId);
+    tensor->tensorData()->resetData(data.info, data.data);
+  }
+}
+
 void Executablex::updateOptimizerTensors() {
   for (auto *optTensor : optimizerTensors) {
     ir().getOptimizer().resetTensorData(*optTensor);
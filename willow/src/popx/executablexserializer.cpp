@@ -83,29 +83,20 @@ namespace serialization {
 namespace {
 
 /**
- * The function finds tensor data blob from vector of blobs that
- * matches passed tensor id.
+ * Reads the data of a tensor from its PopEF tensor data blob.
  *
- * \param tensorDataVec Vector of readable PopEF tensor data blobs.
- *                      They contain the serialized data for popart
- *                      tensors.
- * \param tensorId Tensor name that the function looks for in the
- *                 tensor readers.
- * \return Pointer to the tensor reader if tensor id matches with some
- *         tensor reader, nullptr otherwise.
+ * \param tensor The tensor to set the data of.
+ * \param tensorReader The blob that holds the serialized tensor data.
  */
-const popef::TensorReader *
-getTensorReader(const std::vector<popef::TensorReader> &tensorDataVec,
-                const std::string &tensorId) {
-  auto tensorDataIt =
-      std::find_if(tensorDataVec.cbegin(),
-                   tensorDataVec.cend(),
-                   [&tensorId](const popef::TensorReader &tensor) {
-                     return tensor.info.name() == tensorId;
-                   });
-  const popef::TensorReader *tensorReader =
-      tensorDataIt != tensorDataVec.cend() ? &(*tensorDataIt) : nullptr;
-  return tensorReader;
+void readTensorData(popart::Tensor &tensor,
+                    const popef::TensorReader &tensorReader) {
+  const size_t bufferSize = tensorReader.info.tensorInfo().sizeInBytes();
+  std::vector<char> tensorBuffer(bufferSize);
+  std::unique_ptr<std::istream> tensorStream(
+      tensorReader.getStandaloneDataStream());
+  tensorStream->read(tensorBuffer.data(), bufferSize);
+  POPART_ASSERT_EQ(static_cast<size_t>(tensorStream->gcount()), bufferSize);
+  tensor.setTensorDataByEmplaceOf(std::move(tensorBuffer));
 }
 
 } // namespace
@@ -407,13 +398,7 @@ deserializeTensor(popart::Ir &ir,
 
     tensor->setTensorDataFromCopyOf(constData.data, constData.info.nbytes());
   } else if (tensorReader) {
-    const size_t bufferSize = tensorReader->info.tensorInfo().sizeInBytes();
-    std::vector<char> tensorBuffer(bufferSize);
-    std::unique_ptr<std::istream> tensorStream(
-        tensorReader->getStandaloneDataStream());
-    tensorStream->read(tensorBuffer.data(), bufferSize);
-    POPART_ASSERT_EQ(tensorBuffer.size(), bufferSize);
-    tensor->setTensorDataByEmplaceOf(std::move(tensorBuffer));
+    readTensorData(*tensor, *tensorReader);
   }
 
   return tensor;
@@ -667,13 +652,23 @@ std::unique_ptr<popart::popx::Executablex> deserializePopartExecutable(
   std::unordered_map<TensorId, std::unique_ptr<popart::Tensor>>
       deserializedTensors;
   {
+    std::unordered_map<std::string, const popef::TensorReader *>
+        tensorDataReaders;
+    tensorDataReaders.reserve(tensorDataVec.size());
+    for (const auto &tensorData : tensorDataVec) {
+      tensorDataReaders.emplace(tensorData.info.name(), &tensorData);
+    }
+
     auto tensors = executablexReader.getTensors();
     deserializedTensors.reserve(tensors.size());
 
+    // The tensor data blobs are streams over the istreams the PopEF reader
+    // was given, so they are read one at a time.
     for (const auto capnpTensor : tensors) {
       const std::string id = capnpTensor.getId();
+      auto found           = tensorDataReaders.find(id);
       const popef::TensorReader *tensorDataReader =
-          getTensorReader(tensorDataVec, id);
+          found != tensorDataReaders.end() ? found->second : nullptr;
       auto tensor = deserializeTensor(ir, capnpTensor, tensorDataReader);
       deserializedTensors[tensor->id] = std::move(tensor);
     }
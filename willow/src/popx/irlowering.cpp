@@ -2,9 +2,11 @@
 #include <algorithm>
 #include <boost/algorithm/string.hpp>
 #include <boost/lexical_cast.hpp> // IWYU pragma: keep
+#include <chrono>
 #include <cmath>
 #include <cstdint>
 #include <cstring>
+#include <deque>
 #include <ext/new_allocator.h>
 #include <fstream>
 #include <functional>
@@ -2654,6 +2656,75 @@ void IrLowering::setStochasticRoundingBehaviour(snap::Graph &graph) {
   }
 }
 
+namespace {
+
+// Label for the graph of a group of convolution or matmul ops in log messages.
+std::string getPlanningGraphName(const std::vector<Op *> &ops,
+                                 const poplar::Target &target) {
+  const Op *op = ops.front();
+  return logging::format(
+      "virtual graph {} ({} tiles)",
+      op->hasVirtualGraphId() ? std::to_string(op->getVirtualGraphId())
+                              : std::string("-"),
+      target.getNumTiles());
+}
+
+// Identifies the target of a graph for deduplicating plans. Virtual graphs
+// usually have equal targets, so their plans are interchangeable.
+std::string getPlanningTargetKey(const poplar::Target &target) {
+  return logging::format("{}/{}x{}/{}",
+                         target.getTargetArchString(),
+                         target.getNumIPUs(),
+                         target.getTilesPerIPU(),
+                         target.getBytesPerTile());
+}
+
+std::string getPlanningOptionsKey(const poplar::OptionFlags &optionFlags) {
+  std::vector<std::pair<std::string, std::string>> options;
+  for (const auto &option : optionFlags) {
+    options.emplace_back(option.first, option.second);
+  }
+  std::sort(options.begin(), options.end());
+  std::string key;
+  for (const auto &option : options) {
+    key += option.first + '=' + option.second + ';';
+  }
+  return key;
+}
+
+// Runs the pre-planner for one graph and logs how long it took.
+template <typename PlanFn>
+double prePlanGraph(const std::string &what,
+                    const std::string &graphName,
+                    size_t numNew,
+                    PlanFn plan) {
+  const auto start = std::chrono::steady_clock::now();
+  if (numNew > 0) {
+    plan();
+  }
+  const std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+  logging::devicex::debug("Pre-planned {} new {} for {} in {} s",
+                          numNew,
+                          what,
+                          graphName,
+                          elapsed.count());
+  return elapsed.count();
+}
+
+void logPrePlanning(const std::string &what,
+                    size_t numGraphs,
+                    size_t numDistinct,
+                    double seconds) {
+  logging::devicex::info("Pre-planned {} distinct {} for {} graph(s) in {} s",
+                         numDistinct,
+                         what,
+                         numGraphs,
+                         seconds);
+}
+
+} // namespace
+
 void IrLowering::prePlanConvolutions() {
   // Get a map of conv ops on each poplar graph
   std::vector<Op *> convOps;
@@ -2675,16 +2746,31 @@ void IrLowering::prePlanConvolutions() {
     }
   }
 
-  if (convGraphsOps.size()) {
-    logging::devicex::debug("Pre-planning convolutions");
+  if (convGraphsOps.empty()) {
+    return;
   }
+  logging::devicex::debug("Pre-planning convolutions");
+
+  // Each graph is planned on its own poplar graph, and poplibs spreads the
+  // convolutions of a graph over its worker threads. Convolutions that are
+  // identical on several graphs are only planned for the first of them. The
+  // targets and options are kept alive until planning is complete.
+  std::deque<poplar::Target> targets;
+  std::deque<poplar::OptionFlags> allOptionFlags;
+  std::set<std::tuple<std::string, poplin::ConvParams, std::string>> seen;
+  size_t numDistinct  = 0;
+  double totalSeconds = 0.0;
 
   for (const auto &graph_op : convGraphsOps) {
     snap::Graph *graph    = graph_op.first;
     std::vector<Op *> ops = graph_op.second;
 
+    targets.push_back(graph->getTarget());
+    const poplar::Target &target = targets.back();
+    const auto targetKey         = getPlanningTargetKey(target);
+
     std::vector<poplin::ConvParams> allConvParams;
-    std::vector<poplar::OptionFlags> allOptionFlags;
+    std::vector<poplar::OptionFlags> optionFlags;
 
     for (Op *op : ops) {
       if (op->isConvertibleTo<MultiConvBaseOp>()) {
@@ -2693,7 +2779,7 @@ void IrLowering::prePlanConvolutions() {
         for (int i = 0; i < convOp->numConvs(); i++) {
           allConvParams.push_back(
               getPoplarConvParams(convOp->getParameters(i)));
-          allOptionFlags.push_back(convOpx->getConvOptions(i));
+          optionFlags.push_back(convOpx->getConvOptions(i));
         }
       } else if (op->isConvertibleTo<MultiConvWeightsGradBaseOp>()) {
         auto convOp = dynamic_cast<MultiConvWeightsGradBaseOp *>(op);
@@ -2703,22 +2789,35 @@ void IrLowering::prePlanConvolutions() {
           auto wuConvParams =
               getConvWeightUpdateParameters(convOp->getParameters(i));
           allConvParams.push_back(getPoplarConvParams(wuConvParams));
-          allOptionFlags.push_back(convOpx->getConvOptions(i));
+          optionFlags.push_back(convOpx->getConvOptions(i));
         }
       }
     }
-    const poplar::Target target = graph->getTarget();
-    std::set<ConvPlanParams> allConvPlanParams;
 
+    std::set<ConvPlanParams> convPlanParams;
     for (int i = 0; i < allConvParams.size(); i++) {
-      ConvPlanParams convPlanParams =
-          std::make_tuple(&target, allConvParams.at(i), &allOptionFlags.at(i));
-      allConvPlanParams.insert(convPlanParams);
+      if (seen.emplace(targetKey,
+                       allConvParams.at(i),
+                       getPlanningOptionsKey(optionFlags.at(i)))
+              .second) {
+        allOptionFlags.push_back(optionFlags.at(i));
+        convPlanParams.insert(std::make_tuple(
+            &target, allConvParams.at(i), &allOptionFlags.back()));
+      }
     }
-
-    poplin::preplanConvolutions(
-        graph->getPoplarGraph(), allConvPlanParams, dv_p->convCache);
-  }
+    numDistinct += convPlanParams.size();
+    totalSeconds += prePlanGraph(
+        "convolution(s)",
+        getPlanningGraphName(ops, target),
+        convPlanParams.size(),
+        [&]() {
+          poplin::preplanConvolutions(
+              graph->getPoplarGraph(), convPlanParams, dv_p->convCache);
+        });
+  }
+
+  logPrePlanning(
+      "convolution(s)", convGraphsOps.size(), numDistinct, totalSeconds);
 }
 
 void IrLowering::prePlanMatMuls() {
@@ -2741,23 +2840,34 @@ void IrLowering::prePlanMatMuls() {
     }
   }
 
-  if (matMulGraphsOps.size()) {
-    logging::devicex::debug("Pre-planning matmuls");
+  if (matMulGraphsOps.empty()) {
+    return;
   }
+  logging::devicex::debug("Pre-planning matmuls");
+
+  // As for convolutions, plan the matmuls of each graph in turn and only
+  // plan identical matmuls on equivalent targets once.
+  std::deque<poplar::Target> targets;
+  std::deque<poplar::OptionFlags> allOptionFlags;
+  std::set<std::tuple<std::string, poplin::MatMulParams, std::string>> seen;
+  size_t numDistinct  = 0;
+  double totalSeconds = 0.0;
 
   for (const auto &graph_op : matMulGraphsOps) {
     const snap::Graph *graph = graph_op.first;
 
-    std::vector<poplin::MatMulParams> allMatMulParams;
-    std::vector<poplar::OptionFlags> allOptionFlags;
+    targets.push_back(graph->getTarget());
+    const poplar::Target &target = targets.back();
+    const auto targetKey         = getPlanningTargetKey(target);
 
     // The input tensors to the matmul opx are reshaped before being passed
     // to the poplibs matmul call. These tensors don't exist at this point,
     // so we create a dummy graph, and perform these same transformations on
     // dummy input tensors, in order to get the correct input shapes from
     // which to generate the MatMulParams.
-    snap::Graph dummyGraph(graph->getTarget());
-    for (Op *op : matMulOps) {
+    snap::Graph dummyGraph(target);
+    std::set<MatMulPlanParams> matMulPlanParams;
+    for (Op *op : graph_op.second) {
       auto matMulOp  = dynamic_cast<MatMulOp *>(op);
       auto matMulOpx = dynamic_cast<MatMulOpx *>(getOpx(op->id));
 
@@ -2789,24 +2899,29 @@ void IrLowering::prePlanMatMuls() {
       matMulParams.outputType = outputType;
       matMulParams.aShape     = inputs.first.shape();
       matMulParams.bShape     = inputs.second.shape();
-      allMatMulParams.push_back(matMulParams);
 
       auto opts = matmulOptions;
       MatMulOpx::appendPoplarOptionsForOp(*matMulOp, opts);
-      allOptionFlags.push_back(opts);
-    }
 
-    const poplar::Target *target = &(graph->getTarget());
-    std::set<MatMulPlanParams> allMatMulPlanParams;
-
-    for (int i = 0; i < allMatMulParams.size(); i++) {
-      MatMulPlanParams matMulPlanParams =
-          std::make_tuple(target, allMatMulParams.at(i), &allOptionFlags.at(i));
-      allMatMulPlanParams.insert(matMulPlanParams);
+      if (seen.emplace(targetKey, matMulParams, getPlanningOptionsKey(opts))
+              .second) {
+        allOptionFlags.push_back(opts);
+        matMulPlanParams.insert(
+            std::make_tuple(&target, matMulParams, &allOptionFlags.back()));
+      }
     }
-
-    poplin::preplanMatMuls(allMatMulPlanParams, dv_p->matmulCache);
-  }
+    numDistinct += matMulPlanParams.size();
+    totalSeconds += prePlanGraph(
+        "matmul(s)",
+        getPlanningGraphName(graph_op.second, target),
+        matMulPlanParams.size(),
+        [&]() {
+          poplin::preplanMatMuls(matMulPlanParams, dv_p->matmulCache);
+        });
+  }
+
+  logPrePlanning(
+      "matmul(s)", matMulGraphsOps.size(), numDistinct, totalSeconds);
 }
 
 void IrLowering::prepareGraph() {
@@ -2821,6 +2936,9 @@ void IrLowering::prepareGraph() {
     return;
   }
 
+  // Held until the graph has been grown, which is the last use of the caches.
+  const auto planningCachesLock = dv_p->lockPlanningCaches();
+
   logging::devicex::info("Poplar version: {}", poplar::versionString());
   logging::devicex::info("Poplar release githash: {}", poplar::packageHash());
 
@@ -0,0 +1,334 @@
+// Copyright (c) 2022 Graphcore Ltd. All rights reserved.
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <snap/Graph.hpp>
+#include <snap/Program.hpp>
+#include <snap/Tensor.hpp>
+#include <snap/poplin/MatMul.hpp>
+#include <snap/popops/ElementWise.hpp>
+#include <vector>
+#include <poplar/OptionFlags.hpp>
+#include <poplar/Tensor.hpp>
+#include <poplar/Type.hpp>
+#include <popops/Expr.hpp>
+#include <popops/ExprOp.hpp>
+#include <popops/OperationDef.hpp>
+#include <popops/Reduce.hpp>
+#include <popart/op/attention.hpp>
+#include <popart/popx/devicex.hpp>
+#include <popart/popx/irlowering.hpp>
+#include <popart/popx/op/attentionx.hpp>
+#include <popart/popx/opxmanager.hpp>
+
+#include "popart/graphcoreoperators.hpp"
+#include "popart/names.hpp"
+#include "popart/op.hpp"
+#include "popart/popx/popopx.hpp"
+#include "popart/tensorinfo.hpp"
+
+namespace pe = popops::expr;
+
+namespace popart {
+namespace popx {
+
+AttentionBaseOpx::AttentionBaseOpx(Op *op, Devicex *devicex)
+    : PopOpx(op, devicex) {}
+
+snap::Tensor AttentionBaseOpx::flattenGroups(const snap::Tensor &t) const {
+  const auto rank = t.rank();
+  const auto rows = t.dim(rank - 2);
+  const auto cols = t.dim(rank - 1);
+  return t.reshape({t.numElements() / (rows * cols), rows, cols});
+}
+
+snap::Tensor AttentionBaseOpx::matMul(const snap::Tensor &a,
+                                      const snap::Tensor &b,
+                                      snap::program::Sequence &prog,
+                                      const std::string &debugName) const {
+  const auto type = popType(op_p->inInfo(0).dataType());
+  return snap::poplin::matMulGrouped(graph(),
+                                     a,
+                                     b,
+                                     prog,
+                                     type,
+                                     debugContext(debugName),
+                                     dv_p->lowering().matmulOptions,
+                                     &dv_p->matmulCache);
+}
+
+snap::Tensor AttentionBaseOpx::reduceRows(const snap::Tensor &t,
+                                          popops::Operation operation,
+                                          snap::program::Sequence &prog,
+                                          const std::string &debugName) const {
+  return snap::Tensor{popops::reduce(graph().getPoplarGraph(),
+                                     t.getPoplarTensor(),
+                                     {t.rank() - 1},
+                                     {operation},
+                                     prog.getPoplarSequence(),
+                                     debugContext(debugName)),
+                      graph()};
+}
+
+snap::Tensor AttentionBaseOpx::broadcastRows(const snap::Tensor &t,
+                                             std::size_t n) const {
+  const auto rank = t.rank();
+  return snap::Tensor{
+      t.getPoplarTensor().expand({rank}).broadcast(n, rank), graph()};
+}
+
+snap::Tensor AttentionBaseOpx::getMask(InIndex maskIndex,
+                                       InIndex queryIndex,
+                                       InIndex keyTransposedIndex) const {
+  if (!hasInput(maskIndex)) {
+    return {};
+  }
+  auto scores = inShape(queryIndex);
+  scores.back() = inShape(keyTransposedIndex).back();
+  return flattenGroups(snap::Tensor{
+      broadcast(scores, getInTensor(maskIndex).getPoplarTensor()), graph()});
+}
+
+snap::Tensor AttentionBaseOpx::scores(const snap::Tensor &query,
+                                      const snap::Tensor &keyTransposed,
+                                      const snap::Tensor &mask,
+                                      std::size_t begin,
+                                      std::size_t end,
+                                      float scale,
+                                      snap::program::Sequence &prog) const {
+  auto s = matMul(query, keyTransposed.slice(begin, end, 2), prog, "scores");
+  if (mask.valid()) {
+    return snap::popops::map(graph(),
+                             pe::Add(pe::Mul(pe::_1, pe::Const(scale)), pe::_2),
+                             {s, mask.slice(begin, end, 2)},
+                             prog,
+                             debugContext("scaleAndMask"));
+  }
+  snap::popops::mapInPlace(graph(),
+                           pe::Mul(pe::_1, pe::Const(scale)),
+                           {s},
+                           prog,
+                           debugContext("scale"));
+  return s;
+}
+
+AttentionOpx::AttentionOpx(Op *op, Devicex *devicex)
+    : AttentionBaseOpx(op, devicex) {
+  verifyOp<AttentionOp>(op, Onnx::CustomOperators::Attention);
+}
+
+void AttentionOpx::grow(snap::program::Sequence &prog) const {
+  auto &op = getOp<AttentionOp>();
+
+  const auto query = flattenGroups(getInTensor(AttentionOp::getQueryInIndex()));
+  const auto keyTransposed =
+      flattenGroups(getInTensor(AttentionOp::getKeyTransposedInIndex()));
+  const auto value = flattenGroups(getInTensor(AttentionOp::getValueInIndex()));
+
+  const auto mask = getMask(AttentionOp::getMaskInIndex(),
+                            AttentionOp::getQueryInIndex(),
+                            AttentionOp::getKeyTransposedInIndex());
+
+  const auto keys     = keyTransposed.dim(2);
+  const auto tileSize = static_cast<std::size_t>(op.getTileSize());
+
+  // The maximum of a fully masked tile is -inf, and exp(-inf - -inf) is NaN,
+  // so the maximum of each tile is kept finite.
+  const float lowest = query.elementType() == poplar::HALF
+                           ? -65504.0f
+                           : std::numeric_limits<float>::lowest();
+
+  // The running maximum and sum of the exponentiated scores of each row, and
+  // the output scaled by the running sum.
+  snap::Tensor rowMax;
+  snap::Tensor rowSum;
+  snap::Tensor out;
+  for (std::size_t begin = 0; begin < keys; begin += tileSize) {
+    const auto end = std::min(begin + tileSize, keys);
+    const auto s =
+        scores(query, keyTransposed, mask, begin, end, op.getScale(), prog);
+    const auto v = value.slice(begin, end, 1);
+
+    auto tileMax = reduceRows(s, popops::Operation::MAX, prog, "max");
+    snap::popops::mapInPlace(graph(),
+                             pe::Max(pe::_1, pe::Const(lowest)),
+                             {tileMax},
+                             prog,
+                             debugContext("finiteMax"));
+    if (begin == 0) {
+      rowMax = tileMax;
+      auto p = snap::popops::map(graph(),
+                                 pe::Exp(pe::Sub(pe::_1, pe::_2)),
+                                 {s, broadcastRows(rowMax, end - begin)},
+                                 prog,
+                                 debugContext("exp"));
+      rowSum = reduceRows(p, popops::Operation::ADD, prog, "sum");
+      out    = matMul(p, v, prog, "out");
+      continue;
+    }
+
+    const auto newMax = snap::popops::map(graph(),
+                                          pe::Max(pe::_1, pe::_2),
+                                          {rowMax, tileMax},
+                                          prog,
+                                          debugContext("newMax"));
+    const auto correction = snap::popops::map(graph(),
+                                              pe::Exp(pe::Sub(pe::_1, pe::_2)),
+                                              {rowMax, newMax},
+                                              prog,
+                                              debugContext("correction"));
+    auto p = snap::popops::map(graph(),
+                               pe::Exp(pe::Sub(pe::_1, pe::_2)),
+                               {s, broadcastRows(newMax, end - begin)},
+                               prog,
+                               debugContext("exp"));
+    snap::popops::mapInPlace(
+        graph(),
+        pe::Add(pe::Mul(pe::_1, pe::_2), pe::_3),
+        {rowSum,
+         correction,
+         reduceRows(p, popops::Operation::ADD, prog, "sum")},
+        prog,
+        debugContext("updateSum"));
+    snap::popops::mapInPlace(graph(),
+                             pe::Add(pe::Mul(pe::_1, pe::_2), pe::_3),
+                             {out,
+                              broadcastRows(correction, out.dim(2)),
+                              matMul(p, v, prog, "out")},
+                             prog,
+                             debugContext("updateOut"));
+    rowMax = newMax;
+  }
+
+  snap::popops::mapInPlace(graph(),
+                           pe::Divide(pe::_1, pe::_2),
+                           {out, broadcastRows(rowSum, out.dim(2))},
+                           prog,
+                           debugContext("normalise"));
+  auto logSumExp = snap::popops::map(graph(),
+                                     pe::Add(pe::_1, pe::Log(pe::_2)),
+                                     {rowMax, rowSum},
+                                     prog,
+                                     debugContext("logSumExp"));
+
+  setOutTensor(AttentionOp::getOutIndex(),
+               out.reshape(outShapeSzt(AttentionOp::getOutIndex())));
+  setOutTensor(
+      AttentionOp::getLogSumExpOutIndex(),
+      logSumExp.reshape(outShapeSzt(AttentionOp::getLogSumExpOutIndex())));
+}
+
+AttentionGradOpx::AttentionGradOpx(Op *op, Devicex *devicex)
+    : AttentionBaseOpx(op, devicex) {
+  verifyOp<AttentionGradOp>(op, Onnx::GradOperators::AttentionGrad);
+}
+
+void AttentionGradOpx::grow(snap::program::Sequence &prog) const {
+  auto &op = getOp<AttentionGradOp>();
+
+  const auto gradIn =
+      flattenGroups(getInTensor(AttentionGradOp::getGradInIndex()));
+  const auto query =
+      flattenGroups(getInTensor(AttentionGradOp::getQueryInIndex()));
+  const auto keyTransposed =
+      flattenGroups(getInTensor(AttentionGradOp::getKeyTransposedInIndex()));
+  const auto value =
+      flattenGroups(getInTensor(AttentionGradOp::getValueInIndex()));
+  const auto fwdOut =
+      flattenGroups(getInTensor(AttentionGradOp::getFwdOutInIndex()));
+  const auto logSumExp =
+      getInTensor(AttentionGradOp::getLogSumExpInIndex())
+          .reshape({query.dim(0), query.dim(1)});
+
+  const auto mask = getMask(AttentionGradOp::getMaskInIndex(),
+                            AttentionGradOp::getQueryInIndex(),
+                            AttentionGradOp::getKeyTransposedInIndex());
+
+  const auto keys     = keyTransposed.dim(2);
+  const auto tileSize = static_cast<std::size_t>(op.getTileSize());
+
+  // The sum over the keys of the probabilities times their grads, which is
+  // the same as that of the output times its grad.
+  const auto outDotGradIn =
+      reduceRows(snap::popops::map(graph(),
+                                   pe::Mul(pe::_1, pe::_2),
+                                   {gradIn, fwdOut},
+                                   prog,
+                                   debugContext("outTimesGradIn")),
+                 popops::Operation::ADD,
+                 prog,
+                 "outDotGradIn");
+
+  const auto queryTransposed = query.dimShuffle({0, 2, 1});
+
+  snap::Tensor queryGrad;
+  std::vector<poplar::Tensor> keyTransposedGrads;
+  std::vector<poplar::Tensor> valueGrads;
+  for (std::size_t begin = 0; begin < keys; begin += tileSize) {
+    const auto end = std::min(begin + tileSize, keys);
+    const auto s =
+        scores(query, keyTransposed, mask, begin, end, op.getScale(), prog);
+    const auto k = keyTransposed.slice(begin, end, 2);
+    const auto v = value.slice(begin, end, 1);
+
+    // The probabilities of the tile, recomputed from the log-sum-exp.
+    auto p = snap::popops::map(graph(),
+                               pe::Exp(pe::Sub(pe::_1, pe::_2)),
+                               {s, broadcastRows(logSumExp, end - begin)},
+                               prog,
+                               debugContext("probs"));
+    valueGrads.push_back(
+        matMul(p.dimShuffle({0, 2, 1}), gradIn, prog, "valueGrad")
+            .getPoplarTensor());
+
+    // The grad of the probabilities, which becomes that of the unscaled
+    // scores in place.
+    auto scoresGrad =
+        matMul(gradIn, v.dimShuffle({0, 2, 1}), prog, "probsGrad");
+    snap::popops::mapInPlace(
+        graph(),
+        pe::Mul(pe::Mul(pe::_2, pe::Sub(pe::_1, pe::_3)),
+                pe::Const(op.getScale())),
+        {scoresGrad, p, broadcastRows(outDotGradIn, end - begin)},
+        prog,
+        debugContext("scoresGrad"));
+
+    keyTransposedGrads.push_back(
+        matMul(queryTransposed, scoresGrad, prog, "keyTransposedGrad")
+            .getPoplarTensor());
+    auto tileQueryGrad =
+        matMul(scoresGrad, k.dimShuffle({0, 2, 1}), prog, "queryGrad");
+    if (begin == 0) {
+      queryGrad = tileQueryGrad;
+    } else {
+      snap::popops::mapInPlace(graph(),
+                               pe::Add(pe::_1, pe::_2),
+                               {queryGrad, tileQueryGrad},
+                               prog,
+                               debugContext("accumulateQueryGrad"));
+    }
+  }
+
+  setOutTensor(AttentionGradOp::getQueryOutIndex(),
+               queryGrad.reshape(
+                   outShapeSzt(AttentionGradOp::getQueryOutIndex())));
+  setOutTensor(AttentionGradOp::getKeyTransposedOutIndex(),
+               snap::Tensor{poplar::concat(keyTransposedGrads, 2), graph()}
+                   .reshape(outShapeSzt(
+                       AttentionGradOp::getKeyTransposedOutIndex())));
+  setOutTensor(
+      AttentionGradOp::getValueOutIndex(),
+      snap::Tensor{poplar::concat(valueGrads, 1), graph()}.reshape(
+          outShapeSzt(AttentionGradOp::getValueOutIndex())));
+}
+
+namespace {
+OpxCreator<AttentionOpx> attentionOpxCreator(Onnx::CustomOperators::Attention);
+OpxCreator<AttentionGradOpx>
+    attentionGradOpxCreator(Onnx::GradOperators::AttentionGrad);
+} // namespace
+
+} // namespace popx
+} // namespace popart
@@ -0,0 +1,158 @@
+// Copyright (c) 2022 Graphcore Ltd. All rights reserved.
+#include <memory>
+#include <snap/Graph.hpp>
+#include <snap/Program.hpp>
+#include <snap/Tensor.hpp>
+#include <snap/popops/ElementWise.hpp>
+#include <vector>
+#include <poplar/Tensor.hpp>
+#include <popops/Expr.hpp>
+#include <popops/ExprOp.hpp>
+#include <popart/error.hpp>
+#include <popart/op/fusedelementwise.hpp>
+#include <popart/popx/devicex.hpp>
+#include <popart/popx/op/fusedelementwisex.hpp>
+#include <popart/popx/opxmanager.hpp>
+
+#include "popart/graphcoreoperators.hpp"
+#include "popart/names.hpp"
+#include "popart/op.hpp"
+#include "popart/popx/popopx.hpp"
+#include "popart/region.hpp" // IWYU pragma: keep
+#include "popart/tensorinfo.hpp"
+
+namespace pe = popops::expr;
+
+namespace popart {
+namespace popx {
+
+namespace {
+
+using ExprType = FusedElementwiseExprType;
+
+pe::UnaryOpType getUnaryOpType(ExprType type) {
+  switch (type) {
+  case ExprType::Abs:
+    return pe::UnaryOpType::ABSOLUTE;
+  case ExprType::Exp:
+    return pe::UnaryOpType::EXPONENT;
+  case ExprType::Log:
+    return pe::UnaryOpType::LOGARITHM;
+  case ExprType::Neg:
+    return pe::UnaryOpType::NEGATE;
+  case ExprType::Reciprocal:
+    return pe::UnaryOpType::INVERSE;
+  case ExprType::Sigmoid:
+    return pe::UnaryOpType::SIGMOID;
+  case ExprType::Sqrt:
+    return pe::UnaryOpType::SQRT;
+  case ExprType::Tanh:
+    return pe::UnaryOpType::TANH;
+  default:
+    throw internal_error("{} is not a unary expression", toString(type));
+  }
+}
+
+pe::BinaryOpType getBinaryOpType(ExprType type) {
+  switch (type) {
+  case ExprType::Add:
+    return pe::BinaryOpType::ADD;
+  case ExprType::Div:
+    return pe::BinaryOpType::DIVIDE;
+  case ExprType::Max:
+    return pe::BinaryOpType::MAXIMUM;
+  case ExprType::Mul:
+    return pe::BinaryOpType::MULTIPLY;
+  case ExprType::Pow:
+    return pe::BinaryOpType::POWER;
+  case ExprType::Sub:
+    return pe::BinaryOpType::SUBTRACT;
+  default:
+    throw internal_error("{} is not a binary expression", toString(type));
+  }
+}
+
+} // namespace
+
+FusedElementwiseOpx::FusedElementwiseOpx(Op *op, Devicex *devicex)
+    : PopOpx(op, devicex) {
+  verifyOp<FusedElementwiseOp>(op, Onnx::CustomOperators::FusedElementwise);
+}
+
+InputCreatorType FusedElementwiseOpx::getInputCreatorType(InIndex index) const {
+  // Inputs which are broadcast or cast cannot be unwound.
+  const auto out = FusedElementwiseOp::getOutIndex();
+  if (op_p->inInfo(index) != op_p->outInfo(out)) {
+    return InputCreatorType::Deadend;
+  }
+  return InputCreatorType::CanUnwind;
+}
+
+snap::Tensor FusedElementwiseOpx::unwindTensorLayout(snap::Tensor tensor,
+                                                     InIndex,
+                                                     OutIndex) const {
+  return tensor;
+}
+
+view::RegMap FusedElementwiseOpx::unwindRegion(InIndex, OutIndex) const {
+  return [](const view::Region &r) { return view::Regions(1, r); };
+}
+
+void FusedElementwiseOpx::grow(snap::program::Sequence &prog) const {
+  auto &op       = getOp<FusedElementwiseOp>();
+  const auto out = FusedElementwiseOp::getOutIndex();
+
+  std::vector<snap::Tensor> ins;
+  for (int i = 0; i < op.input->n(); ++i) {
+    ins.push_back(snap::Tensor{
+        broadcast(op.outShape(out), getInTensor(i).getPoplarTensor()),
+        graph()});
+  }
+
+  // The nodes of the expression, built in the same order as those of the op.
+  std::vector<std::unique_ptr<pe::Expr>> nodes;
+  for (const auto &expr : op.getExprs()) {
+    switch (expr.type) {
+    case ExprType::Input:
+      nodes.push_back(pe::PlaceHolder(expr.inIndex + 1).clone());
+      break;
+    case ExprType::Const:
+      nodes.push_back(pe::Const(expr.value).clone());
+      break;
+    case ExprType::Cast:
+      nodes.push_back(
+          pe::Cast(*nodes.at(expr.args[0]), popType(expr.dataType)).clone());
+      break;
+    case ExprType::Add:
+    case ExprType::Div:
+    case ExprType::Max:
+    case ExprType::Mul:
+    case ExprType::Pow:
+    case ExprType::Sub:
+      nodes.push_back(pe::BinaryOp(getBinaryOpType(expr.type),
+                                   *nodes.at(expr.args[0]),
+                                   *nodes.at(expr.args[1]))
+                          .clone());
+      break;
+    default:
+      nodes.push_back(
+          pe::UnaryOp(getUnaryOpType(expr.type), *nodes.at(expr.args[0]))
+              .clone());
+    }
+  }
+
+  setOutTensor(out,
+               snap::popops::map(graph(),
+                                 *nodes.back(),
+                                 ins,
+                                 prog,
+                                 debugContext("fusedElementwise")));
+}
+
+namespace {
+OpxCreator<FusedElementwiseOpx>
+    fusedElementwiseOpxCreator(Onnx::CustomOperators::FusedElementwise);
+} // namespace
+
+} // namespace popx
+} // namespace popart
@@ -0,0 +1,48 @@
+// Copyright (c) 2022 Graphcore Ltd. All rights reserved.
+#include <algorithm>
+#include <map>
+#include <poplar/Target.hpp>
+#include <popx/planningcaches.hpp>
+#include <popart/logging.hpp>
+
+namespace popart {
+namespace popx {
+
+std::string PlanningCaches::getTargetKey(const poplar::Target &target,
+                                         unsigned replicationFactor) {
+  const unsigned ipusPerReplica =
+      target.getNumIPUs() / std::max(replicationFactor, 1u);
+  return logging::format("{}/{}/{}/{}x{}/{}B/{}w",
+                         static_cast<int>(target.getTargetType()),
+                         target.getTargetArchString(),
+                         target.getTargetSystemString(),
+                         ipusPerReplica,
+                         target.getTilesPerIPU(),
+                         target.getBytesPerTile(),
+                         target.getNumWorkerContexts());
+}
+
+std::shared_ptr<PlanningCaches>
+PlanningCaches::getShared(const std::string &targetKey) {
+  static std::mutex registryMutex;
+  static std::map<std::string, std::shared_ptr<PlanningCaches>> registry;
+
+  std::lock_guard<std::mutex> lock(registryMutex);
+  auto &caches = registry[targetKey];
+  if (caches) {
+    logging::devicex::debug(
+        "Reusing the convolution and matmul planning caches for target {}, "
+        "{} convolution plan(s) are already cached",
+        targetKey,
+        caches->convCache.size());
+  } else {
+    logging::devicex::debug(
+        "Creating shared convolution and matmul planning caches for target {}",
+        targetKey);
+    caches = std::make_shared<PlanningCaches>();
+  }
+  return caches;
+}
+
+} // namespace popx
+} // namespace popart
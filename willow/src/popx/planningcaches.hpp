@@ -0,0 +1,55 @@
+// Copyright (c) 2022 Graphcore Ltd. All rights reserved.
+#ifndef POPART_WILLOW_SRC_POPX_PLANNINGCACHES_HPP_
+#define POPART_WILLOW_SRC_POPX_PLANNINGCACHES_HPP_
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <poplin/Convolution.hpp>
+#include <poplin/MatMul.hpp>
+
+namespace poplar {
+class Target;
+} // namespace poplar
+
+namespace popart {
+namespace popx {
+
+/**
+ * The convolution and matmul planning caches that Devicex exposes to opxs.
+ *
+ * By default each Devicex owns its own caches. With
+ * SessionOptions::enablePlanningCacheReuse, all sessions in the process that
+ * lower for the same replica target share one set of caches, so plans made by
+ * earlier sessions, for example ones with a different batch size or
+ * replication factor, are reused rather than planned again.
+ */
+struct PlanningCaches {
+  poplin::PlanningCache convCache;
+  poplin::matmul::PlanningCache matmulCache;
+
+  // The poplibs planning caches are not thread safe, so shared caches are
+  // only used by one IrLowering at a time.
+  std::mutex mutex;
+
+  /**
+   * A key that identifies a replica target for the purpose of planning. The
+   * poplibs caches do not include the target in their keys, so caches must
+   * only be shared between lowerings with equal keys.
+   *
+   * \param target The target of the whole device.
+   * \param replicationFactor The local replication factor.
+   */
+  static std::string getTargetKey(const poplar::Target &target,
+                                  unsigned replicationFactor);
+
+  /// Get the caches for \p targetKey shared by all sessions in this process,
+  /// creating them on first use. They are kept until the process exits.
+  static std::shared_ptr<PlanningCaches>
+  getShared(const std::string &targetKey);
+};
+
+} // namespace popx
+} // namespace popart
+
+#endif // POPART_WILLOW_SRC_POPX_PLANNINGCACHES_HPP_
@@ -1,12 +1,21 @@
 // Copyright (c) 2020 Graphcore Ltd. All rights reserved.
 #include "popart/popx/popefserializer.hpp"
 
+#include <boost/interprocess/exceptions.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <boost/interprocess/streams/bufferstream.hpp>
 #include <iostream>
+#include <memory>
+#include <string>
 #include <utility>
+#include <vector>
 
 #include <poplar/Executable.hpp>
 
+#include "popart/error.hpp"
 #include "popart/ir.hpp"
+#include "popart/logging.hpp"
 #include "popart/popx/devicex.hpp"
 #include "popart/popx/executablex.hpp"
 #include "popart/popx/irlowering.hpp"
@@ -17,6 +26,44 @@ namespace popart {
 namespace popx {
 namespace serialization {
 
+namespace {
+
+struct MappedFile {
+  explicit MappedFile(const std::string &filePath)
+      : file(filePath.c_str(), boost::interprocess::read_only),
+        region(file, boost::interprocess::read_only) {
+    // The whole file is about to be read, start paging it in now.
+    region.advise(boost::interprocess::mapped_region::advice_willneed);
+  }
+
+  boost::interprocess::file_mapping file;
+  boost::interprocess::mapped_region region;
+};
+
+// A read only memory mapped file exposed as a std::istream. PopEF holds on to
+// the stream, and with it the mapping, for as long as any of its blob readers.
+class MappedFileStream : private MappedFile,
+                         public boost::interprocess::ibufferstream {
+public:
+  explicit MappedFileStream(const std::string &filePath)
+      : MappedFile(filePath),
+        boost::interprocess::ibufferstream(
+            static_cast<const char *>(region.get_address()),
+            region.get_size()) {}
+};
+
+std::shared_ptr<std::istream> openMappedFile(const std::string &filePath) {
+  try {
+    auto stream = std::make_shared<MappedFileStream>(filePath);
+    logging::session::debug("Mapped PopEF file {}", filePath);
+    return stream;
+  } catch (const boost::interprocess::interprocess_exception &e) {
+    throw error("Could not open file {}: {}", filePath, e.what());
+  }
+}
+
+} // namespace
+
 /** To see description go to the function declaration. */
 Writer::Writer(std::ostream &out, const popart::popx::Devicex &device)
     : _impl(std::make_unique<WriterImpl>(out, device)) {}
@@ -38,6 +85,10 @@ void Writer::serializeTensorData() { _impl->serializeTensorData(); }
 /** To see description go to the function declaration. */
 Reader::Reader(const std::vector<std::shared_ptr<std::istream>> &in_vec)
     : _impl(std::make_unique<ReaderImpl>(in_vec)) {}
+Reader::Reader(const std::string &filePath)
+    : _impl(std::make_unique<ReaderImpl>(
+          std::vector<std::shared_ptr<std::istream>>{
+              openMappedFile(filePath)})) {}
 Reader::Reader(Reader &&reader) : _impl(std::move(reader._impl)) {}
 Reader::~Reader() = default;
 
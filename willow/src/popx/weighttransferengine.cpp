@@ -0,0 +1,228 @@
+// Copyright (c) 2022 Graphcore Ltd. All rights reserved.
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <exception>
+#include <popx/weighttransferengine.hpp>
+#include <utility>
+#include <popart/logging.hpp>
+
+namespace popart {
+namespace popx {
+
+namespace {
+// Upper bound on the automatically chosen number of threads. Host memory
+// bandwidth is usually saturated well before this.
+constexpr unsigned maxAutoThreads = 16;
+} // namespace
+
+constexpr size_t WeightTransferEngine::defaultChunkBytes;
+
+WeightTransferEngine::WeightTransferEngine(unsigned numThreads_,
+                                           size_t chunkBytes_)
+    : numThreads(numThreads_), chunkBytes(std::max<size_t>(chunkBytes_, 1)),
+      pool(std::make_shared<BufferPool>()) {
+  if (numThreads == 0) {
+    numThreads = std::max(
+        1u, std::min(std::thread::hardware_concurrency(), maxAutoThreads));
+  }
+  // Enough staging buffers for every worker to be busy while the calling
+  // thread fills the next one.
+  maxBuffers = numThreads + 1;
+
+  logging::devicex::debug("[WeightTransferEngine] Using {} thread(s), {} byte "
+                          "chunks and at most {} staging buffers",
+                          numThreads,
+                          chunkBytes,
+                          maxBuffers);
+
+  for (unsigned i = 1; i < numThreads; ++i) {
+    workers.emplace_back([this]() { workerLoop(); });
+  }
+}
+
+WeightTransferEngine::~WeightTransferEngine() {
+  {
+    std::lock_guard<std::mutex> lock(tasksMutex);
+    stopping = true;
+  }
+  tasksCv.notify_all();
+  for (auto &worker : workers) {
+    worker.join();
+  }
+}
+
+void WeightTransferEngine::workerLoop() {
+  while (true) {
+    std::packaged_task<void()> task;
+    {
+      std::unique_lock<std::mutex> lock(tasksMutex);
+      tasksCv.wait(lock, [this]() { return stopping || !tasks.empty(); });
+      if (tasks.empty()) {
+        // Only reached when stopping.
+        return;
+      }
+      task = std::move(tasks.front());
+      tasks.pop_front();
+    }
+    // Exceptions are captured in the task's future.
+    task();
+  }
+}
+
+std::future<void> WeightTransferEngine::async(std::function<void()> fn) {
+  // The shared state of a packaged_task keeps its callable until the future is
+  // destroyed. Destroy fn as soon as it has run instead, so that the staging
+  // buffers it captures go back to the pool before the future is waited on.
+  std::packaged_task<void()> task([fn = std::move(fn)]() mutable {
+    auto run = std::move(fn);
+    fn       = nullptr;
+    run();
+  });
+  auto future = task.get_future();
+  if (workers.empty()) {
+    task();
+    return future;
+  }
+  {
+    std::lock_guard<std::mutex> lock(tasksMutex);
+    tasks.push_back(std::move(task));
+  }
+  tasksCv.notify_one();
+  return future;
+}
+
+void WeightTransferEngine::waitAll(std::vector<std::future<void>> &futures) {
+  std::exception_ptr first;
+  for (auto &future : futures) {
+    if (!future.valid()) {
+      continue;
+    }
+    try {
+      future.get();
+    } catch (...) {
+      if (!first) {
+        first = std::current_exception();
+      }
+    }
+  }
+  futures.clear();
+  if (first) {
+    std::rethrow_exception(first);
+  }
+}
+
+void WeightTransferEngine::copy(const std::vector<HostCopyJob> &jobs) {
+  // Split each job into chunks of at most chunkBytes.
+  std::vector<HostCopyJob> chunks;
+  size_t totalBytes = 0;
+  for (const auto &job : jobs) {
+    totalBytes += job.nbytes;
+    for (size_t offset = 0; offset < job.nbytes; offset += chunkBytes) {
+      const auto n = std::min(chunkBytes, job.nbytes - offset);
+      chunks.push_back({static_cast<char *>(job.dst) + offset,
+                        static_cast<const char *>(job.src) + offset,
+                        n});
+    }
+  }
+
+  std::atomic<size_t> next{0};
+  auto drain = [&chunks, &next]() {
+    for (size_t i = next++; i < chunks.size(); i = next++) {
+      std::memcpy(chunks[i].dst, chunks[i].src, chunks[i].nbytes);
+    }
+  };
+
+  // Only wake as many workers as there are chunks left for them.
+  const size_t numHelpers = std::min<size_t>(
+      workers.size(), chunks.empty() ? 0 : chunks.size() - 1);
+  std::vector<std::future<void>> helpers;
+  for (size_t i = 0; i < numHelpers; ++i) {
+    helpers.push_back(async(drain));
+  }
+  drain();
+  waitAll(helpers);
+
+  logging::devicex::trace("[WeightTransferEngine] Copied {} bytes in {} "
+                          "chunk(s) on {} thread(s)",
+                          totalBytes,
+                          chunks.size(),
+                          numHelpers + 1);
+}
+
+WeightTransferEngine::Buffer WeightTransferEngine::acquireBuffer(size_t nbytes,
+                                                                 bool zeroed) {
+  std::unique_ptr<std::vector<char>> storage;
+  {
+    std::unique_lock<std::mutex> lock(pool->mutex);
+    pool->cv.wait(lock, [this]() { return pool->inUse < maxBuffers; });
+    ++pool->inUse;
+
+    auto &idle = pool->idle;
+    if (!idle.empty()) {
+      // Prefer the smallest idle buffer that is already big enough, otherwise
+      // grow the biggest one.
+      auto best    = idle.end();
+      auto biggest = idle.begin();
+      for (auto it = idle.begin(); it != idle.end(); ++it) {
+        const auto capacity = (*it)->capacity();
+        if (capacity >= nbytes &&
+            (best == idle.end() || capacity < (*best)->capacity())) {
+          best = it;
+        }
+        if (capacity > (*biggest)->capacity()) {
+          biggest = it;
+        }
+      }
+      auto chosen = best != idle.end() ? best : biggest;
+      storage     = std::move(*chosen);
+      idle.erase(chosen);
+    }
+  }
+
+  if (!storage) {
+    storage.reset(new std::vector<char>());
+  }
+  storage->resize(nbytes);
+  if (zeroed) {
+    std::fill(storage->begin(), storage->end(), 0);
+  }
+
+  std::shared_ptr<BufferPool> owner = pool;
+  return Buffer(storage.release(), [owner](std::vector<char> *buffer) {
+    {
+      std::lock_guard<std::mutex> lock(owner->mutex);
+      owner->idle.emplace_back(buffer);
+      --owner->inUse;
+    }
+    owner->cv.notify_one();
+  });
+}
+
+size_t WeightTransferEngine::getNumPooledBuffers() const {
+  std::lock_guard<std::mutex> lock(pool->mutex);
+  return pool->idle.size();
+}
+
+WeightTransferEngine::ScopedPhase::ScopedPhase(std::string name_)
+    : name(std::move(name_)), start(std::chrono::steady_clock::now()) {}
+
+WeightTransferEngine::ScopedPhase::~ScopedPhase() {
+  const std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+  const double seconds = elapsed.count();
+  if (bytes == 0) {
+    logging::devicex::info(
+        "[WeightTransferEngine] {} took {} s", name, seconds);
+  } else {
+    logging::devicex::info(
+        "[WeightTransferEngine] {} took {} s for {} bytes ({} GB/s)",
+        name,
+        seconds,
+        bytes,
+        seconds > 0 ? static_cast<double>(bytes) / seconds / 1e9 : 0.0);
+  }
+}
+
+} // namespace popx
+} // namespace popart
@@ -0,0 +1,136 @@
+// Copyright (c) 2022 Graphcore Ltd. All rights reserved.
+#ifndef POPART_WILLOW_SRC_POPX_WEIGHTTRANSFERENGINE_HPP_
+#define POPART_WILLOW_SRC_POPX_WEIGHTTRANSFERENGINE_HPP_
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace popart {
+namespace popx {
+
+/// A single host to host copy of `nbytes` bytes from `src` to `dst`.
+struct HostCopyJob {
+  void *dst;
+  const void *src;
+  size_t nbytes;
+};
+
+/**
+ * Host side helper used by Devicex to move weight data between the d2h weight
+ * buffers, remote buffer staging areas and user memory.
+ *
+ * - Copies are split into chunks and shared out over a fixed pool of worker
+ *   threads.
+ * - Work can be handed off with async() so that host side rearrangements
+ *   overlap with the remote buffer copies issued by the calling thread.
+ * - Staging buffers are recycled between tensors rather than reallocated, and
+ *   the number of buffers alive at once is bounded to cap peak host memory.
+ *
+ * With one thread (or zero workers) everything runs inline on the calling
+ * thread, which reproduces the behaviour of a plain serial loop.
+ *
+ * Calls to poplar are not made by this class; it only ever runs host copies.
+ */
+class WeightTransferEngine {
+public:
+  using Buffer = std::shared_ptr<std::vector<char>>;
+
+  static constexpr size_t defaultChunkBytes = size_t{16} << 20;
+
+  /**
+   * \param numThreads The number of threads to spread work over, including
+   *        the calling thread. 0 picks a value based on the hardware
+   *        concurrency. 1 disables the worker threads.
+   * \param chunkBytes Copies larger than this are split into chunks of this
+   *        many bytes.
+   */
+  explicit WeightTransferEngine(unsigned numThreads,
+                                size_t chunkBytes = defaultChunkBytes);
+  ~WeightTransferEngine();
+
+  WeightTransferEngine(const WeightTransferEngine &) = delete;
+  WeightTransferEngine &operator=(const WeightTransferEngine &) = delete;
+
+  unsigned getNumThreads() const { return numThreads; }
+
+  /// Run `fn` on a worker thread, or inline if there are no workers.
+  /// Exceptions thrown by `fn` are rethrown by the returned future. `fn` is
+  /// destroyed once it has run, releasing anything it captures, such as a
+  /// staging buffer, without waiting for the future.
+  std::future<void> async(std::function<void()> fn);
+
+  /// Wait for all of `futures`, then rethrow the first exception, if any.
+  /// Always waits for every future so no task outlives the data it uses.
+  static void waitAll(std::vector<std::future<void>> &futures);
+
+  /// Perform all the copies, blocking until they are complete.
+  void copy(const std::vector<HostCopyJob> &jobs);
+
+  /**
+   * Get a staging buffer of exactly `nbytes` bytes. The buffer goes back to
+   * the pool once the last copy of the returned pointer is destroyed. Blocks
+   * if the maximum number of buffers is already in use.
+   *
+   * \param zeroed If true, the returned buffer is filled with zeros.
+   */
+  Buffer acquireBuffer(size_t nbytes, bool zeroed);
+
+  /// The maximum number of staging buffers alive at once.
+  unsigned getMaxBuffers() const { return maxBuffers; }
+
+  /// The number of idle buffers held by the pool.
+  size_t getNumPooledBuffers() const;
+
+  /**
+   * Logs the time taken and throughput of a named phase of a weight transfer
+   * when it goes out of scope.
+   */
+  class ScopedPhase {
+  public:
+    ScopedPhase(std::string name);
+    ~ScopedPhase();
+    void addBytes(size_t n) { bytes += n; }
+
+  private:
+    std::string name;
+    size_t bytes = 0;
+    std::chrono::steady_clock::time_point start;
+  };
+
+private:
+  void workerLoop();
+
+  unsigned numThreads;
+  size_t chunkBytes;
+  unsigned maxBuffers;
+
+  std::vector<std::thread> workers;
+  std::deque<std::packaged_task<void()>> tasks;
+  std::mutex tasksMutex;
+  std::condition_variable tasksCv;
+  bool stopping = false;
+
+  // Shared with the deleters of outstanding buffers, so they can return their
+  // storage even if they are (incorrectly) released after the engine.
+  struct BufferPool {
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::vector<std::unique_ptr<std::vector<char>>> idle;
+    unsigned inUse = 0;
+  };
+  std::shared_ptr<BufferPool> pool;
+};
+
+} // namespace popx
+} // namespace popart
+
+#endif // POPART_WILLOW_SRC_POPX_WEIGHTTRANSFERENGINE_HPP_
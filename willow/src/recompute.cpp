@@ -1,4 +1,5 @@
 // Copyright (c) 2019 Graphcore Ltd. All rights reserved.
+#include <algorithm>
 #include <array>
 #include <cstdint>
 #include <limits>
@@ -11,8 +12,11 @@
 #include <popart/intervals.hpp>
 #include <popart/ir.hpp>
 #include <popart/op.hpp>
+#include <popart/opcost.hpp>
 #include <popart/recompute.hpp>
 #include <popart/scheduler_requireoptimal.hpp>
+#include <popart/tensor.hpp>
+#include <popart/tensorindex.hpp>
 
 #include "popart/error.hpp"
 #include "popart/logging.hpp"
@@ -149,6 +153,412 @@ void annotateStandard(const Graph &graph) {
   }
 }
 
+VGraphId getVGraphIdOrZero(const Op *op) {
+  return op->hasVirtualGraphId() ? op->getVirtualGraphId() : 0;
+}
+
+// The forward pass activation memory of each virtual graph, for a set of ops
+// to recompute.
+//
+// An output of a forward op that is not recomputed is kept for the backward
+// pass if a backward op, or a recomputed op, consumes it. The outputs of a run
+// of consecutive recomputed ops on a virtual graph are live together while the
+// run is recomputed, so the memory of a virtual graph is the bytes it keeps
+// plus the bytes of its largest run.
+class ActivationModel {
+public:
+  ActivationModel(const std::vector<Op *> &fwdOps) {
+    for (auto op : fwdOps) {
+      auto &order   = orders[getVGraphIdOrZero(op)];
+      positions[op] = static_cast<int64_t>(order.size());
+      order.push_back(op);
+    }
+    for (auto &vgid_order : orders) {
+      auto vgid    = vgid_order.first;
+      auto &prefix = outputBytes[vgid];
+      prefix.push_back(0);
+      for (auto op : vgid_order.second) {
+        notRecomputed[vgid].insert(static_cast<int64_t>(prefix.size()) - 1);
+        prefix.push_back(prefix.back() + op->memOfOutputs());
+      }
+      maxRunBytes[vgid] = 0;
+    }
+    for (auto op : fwdOps) {
+      for (auto tensor : op->output->tensors()) {
+        for (auto consumer : tensor->consumers.getOps()) {
+          if (consumer->fromLoss == PathFromLoss::Yes) {
+            consumedByBwd.insert(tensor);
+          }
+        }
+        if (isKept(tensor)) {
+          keptBytes[getVGraphIdOrZero(op)] += tensor->info.nbytes();
+        }
+      }
+    }
+  }
+
+  bool isRecomputed(Op *op) const { return recomputed.count(op) > 0; }
+
+  bool isRecomputable(Op *op) const {
+    return positions.count(op) > 0 && op->fromLoss != PathFromLoss::Yes &&
+           !op->isIpuCopyOp() && op->canRecompute();
+  }
+
+  int64_t getMemory(VGraphId vgid) const {
+    auto found = keptBytes.find(vgid);
+    return (found == keptBytes.end() ? 0 : found->second) +
+           maxRunBytes.at(vgid);
+  }
+
+  // The bytes of the outputs of op that are kept.
+  int64_t getKeptBytes(Op *op) const {
+    int64_t bytes = 0;
+    for (auto tensor : op->output->tensors()) {
+      if (isKept(tensor)) {
+        bytes += tensor->info.nbytes();
+      }
+    }
+    return bytes;
+  }
+
+  // The ops to recompute with op: op, and the recomputable producers on its
+  // virtual graph of the inputs of the group that are not kept, so that they
+  // do not have to be kept instead.
+  std::vector<Op *> getGroup(Op *op) const {
+    auto vgid = getVGraphIdOrZero(op);
+    std::vector<Op *> group;
+    std::set<Op *> seen{op};
+    std::vector<Op *> toVisit{op};
+    while (!toVisit.empty()) {
+      auto x = toVisit.back();
+      toVisit.pop_back();
+      group.push_back(x);
+      for (auto tensor : getForwardInputs(x)) {
+        auto producer = tensor->getProducer();
+        if (!isKept(tensor) && !isRecomputed(producer) &&
+            isRecomputable(producer) &&
+            getVGraphIdOrZero(producer) == vgid &&
+            seen.insert(producer).second) {
+          toVisit.push_back(producer);
+        }
+      }
+    }
+    return group;
+  }
+
+  // The change in the bytes each virtual graph keeps if group is recomputed:
+  // the outputs of group are no longer kept, and its inputs from outside it
+  // are.
+  std::map<VGraphId, int64_t>
+  getKeptBytesDelta(const std::vector<Op *> &group) const {
+    std::set<Op *> inGroup(group.begin(), group.end());
+    std::set<Tensor *> newlyKept;
+    std::map<VGraphId, int64_t> delta;
+    for (auto op : group) {
+      delta[getVGraphIdOrZero(op)] -= getKeptBytes(op);
+      for (auto tensor : getForwardInputs(op)) {
+        auto producer = tensor->getProducer();
+        if (!isKept(tensor) && !isRecomputed(producer) &&
+            inGroup.count(producer) == 0 && newlyKept.insert(tensor).second) {
+          delta[getVGraphIdOrZero(producer)] += tensor->info.nbytes();
+        }
+      }
+    }
+    return delta;
+  }
+
+  // The bytes of the largest run on the virtual graph of group if it is
+  // recomputed. The ops of group are on the same virtual graph.
+  int64_t getMaxRunBytes(const std::vector<Op *> &group) const {
+    auto vgid         = getVGraphIdOrZero(group.front());
+    auto &checkpoints = notRecomputed.at(vgid);
+    auto &prefix      = outputBytes.at(vgid);
+    int64_t maxBytes  = maxRunBytes.at(vgid);
+    std::set<int64_t> groupPositions;
+    for (auto op : group) {
+      groupPositions.insert(positions.at(op));
+    }
+
+    // A run ends at the nearest ops either side that are not recomputed.
+    for (auto position : groupPositions) {
+      auto next = checkpoints.upper_bound(position);
+      while (next != checkpoints.end() && groupPositions.count(*next) > 0) {
+        ++next;
+      }
+      int64_t end = next == checkpoints.end()
+                        ? static_cast<int64_t>(prefix.size()) - 1
+                        : *next;
+
+      int64_t begin = 0;
+      auto previous = checkpoints.lower_bound(position);
+      while (previous != checkpoints.begin()) {
+        --previous;
+        if (groupPositions.count(*previous) == 0) {
+          begin = *previous + 1;
+          break;
+        }
+      }
+      maxBytes = std::max(maxBytes, prefix.at(end) - prefix.at(begin));
+    }
+    return maxBytes;
+  }
+
+  void recompute(const std::vector<Op *> &group) {
+    auto vgid = getVGraphIdOrZero(group.front());
+    for (auto &vgid_delta : getKeptBytesDelta(group)) {
+      keptBytes[vgid_delta.first] += vgid_delta.second;
+    }
+    maxRunBytes.at(vgid) = getMaxRunBytes(group);
+
+    // Record the new consumers after the deltas, which depend on them.
+    for (auto op : group) {
+      for (auto tensor : getForwardInputs(op)) {
+        recomputedConsumers[tensor]++;
+      }
+      notRecomputed.at(vgid).erase(positions.at(op));
+      recomputed.insert(op);
+    }
+  }
+
+private:
+  bool isForward(const Tensor *tensor) const {
+    return tensor->hasProducer() && positions.count(tensor->getProducer()) > 0;
+  }
+
+  bool isKept(Tensor *tensor) const {
+    if (!isForward(tensor) || isRecomputed(tensor->getProducer())) {
+      return false;
+    }
+    return consumedByBwd.count(tensor) > 0 ||
+           recomputedConsumers.count(tensor) > 0;
+  }
+
+  // The distinct inputs of op that are produced by the forward pass.
+  std::set<Tensor *> getForwardInputs(Op *op) const {
+    std::set<Tensor *> inputs;
+    for (auto tensor : op->input->tensors()) {
+      if (isForward(tensor)) {
+        inputs.insert(tensor);
+      }
+    }
+    return inputs;
+  }
+
+  // The position of each forward op in the order of its virtual graph.
+  std::map<Op *, int64_t> positions;
+  std::map<VGraphId, std::vector<Op *>> orders;
+
+  // The prefix sums of the bytes of the outputs of the ops of each virtual
+  // graph, in order, and the positions of the ops not recomputed.
+  std::map<VGraphId, std::vector<int64_t>> outputBytes;
+  std::map<VGraphId, std::set<int64_t>> notRecomputed;
+
+  std::set<Tensor *> consumedByBwd;
+  std::map<Tensor *, int> recomputedConsumers;
+  std::set<Op *> recomputed;
+  std::map<VGraphId, int64_t> keptBytes;
+  std::map<VGraphId, int64_t> maxRunBytes;
+};
+
+struct RecomputePlan {
+  std::vector<Op *> recomputed;
+  std::vector<std::pair<Op *, int64_t>> checkpoints;
+  std::map<VGraphId, int64_t> memory;
+  double flops = 0.0;
+
+  // The bytes over the budget, summed over the virtual graphs.
+  int64_t getExcess(int64_t budget) const {
+    int64_t excess = 0;
+    for (auto &vgid_memory : memory) {
+      excess += std::max<int64_t>(vgid_memory.second - budget, 0);
+    }
+    return excess;
+  }
+};
+
+// Recompute the groups of candidates in order, while the virtual graph of a
+// candidate does not fit in the budget, if the group saves bytes on the
+// virtual graph, makes no run larger than maxRunBytes, and does not take any
+// other virtual graph over the budget.
+RecomputePlan planRecomputation(const std::vector<Op *> &fwdOps,
+                                const std::vector<Op *> &candidates,
+                                int64_t budget,
+                                int64_t maxRunBytes) {
+  ActivationModel model(fwdOps);
+  for (auto op : candidates) {
+    auto vgid = getVGraphIdOrZero(op);
+    if (model.isRecomputed(op) || model.getMemory(vgid) <= budget) {
+      continue;
+    }
+    auto group = model.getGroup(op);
+    if (model.getMaxRunBytes(group) > maxRunBytes) {
+      continue;
+    }
+    bool accept = true;
+    for (auto &vgid_delta : model.getKeptBytesDelta(group)) {
+      if (vgid_delta.first == vgid) {
+        accept &= vgid_delta.second < 0;
+      } else {
+        accept &= vgid_delta.second <= 0 ||
+                  model.getMemory(vgid_delta.first) + vgid_delta.second <=
+                      budget;
+      }
+    }
+    if (accept) {
+      model.recompute(group);
+    }
+  }
+
+  RecomputePlan plan;
+  for (auto op : fwdOps) {
+    auto vgid         = getVGraphIdOrZero(op);
+    plan.memory[vgid] = model.getMemory(vgid);
+    if (model.isRecomputed(op)) {
+      plan.recomputed.push_back(op);
+      plan.flops += estimateOpCost(op).flops;
+    } else if (model.getKeptBytes(op) > 0) {
+      plan.checkpoints.push_back({op, model.getKeptBytes(op)});
+    }
+  }
+  return plan;
+}
+
+// Choose the forward ops to recompute that fit the activations of each
+// virtual graph in SessionOptions::autoRecomputationMemoryBudget, recomputing
+// as few floating point operations as possible.
+//
+// Ops are recomputed in groups, in order of the kept bytes they save per
+// floating point operation. Recomputing more ops saves kept bytes but makes
+// longer runs, so the groups are chosen for a range of limits on the bytes of
+// a run, halving from the budget, and the plan that fits with the fewest
+// floating point operations, or otherwise is the least over the budget, is
+// used.
+void annotateMemoryBudget(const Graph &graph) {
+  auto &opts        = graph.getIr().getSessionOptions();
+  const auto budget = opts.autoRecomputationMemoryBudget;
+  if (budget <= 0) {
+    throw error("SessionOptions::autoRecomputationMemoryBudget must be "
+                "positive with RecomputationType::MemoryBudget, not {}.",
+                budget);
+  }
+
+  std::vector<Op *> fwdOps;
+  for (auto op : graph.getOpSchedule({}, RequireOptimalSchedule::Yes)) {
+    if (op->toLoss == PathToLoss::Yes) {
+      fwdOps.push_back(op);
+    }
+  }
+  if (fwdOps.empty()) {
+    return;
+  }
+
+  ActivationModel model(fwdOps);
+  std::vector<std::pair<double, Op *>> scores;
+  int64_t minRunBytes = budget;
+  for (auto op : fwdOps) {
+    if (!model.isRecomputable(op) || model.getKeptBytes(op) == 0) {
+      continue;
+    }
+    auto group = model.getGroup(op);
+    auto saved = -model.getKeptBytesDelta(group).at(getVGraphIdOrZero(op));
+    if (saved <= 0) {
+      continue;
+    }
+    double flops = 0.0;
+    for (auto x : group) {
+      flops += estimateOpCost(x).flops;
+    }
+    scores.push_back({static_cast<double>(saved) / std::max(flops, 1.0), op});
+    minRunBytes =
+        std::min(minRunBytes, std::max<int64_t>(op->memOfOutputs(), 1));
+  }
+  std::stable_sort(
+      scores.begin(),
+      scores.end(),
+      [](const std::pair<double, Op *> &a, const std::pair<double, Op *> &b) {
+        return a.first > b.first;
+      });
+  std::vector<Op *> candidates;
+  for (auto &score_op : scores) {
+    candidates.push_back(score_op.second);
+  }
+
+  // With no runs, nothing is recomputed.
+  const auto initial      = planRecomputation(fwdOps, candidates, budget, 0);
+  auto best               = initial;
+  int64_t bestMaxRunBytes = 0;
+  for (int64_t maxRunBytes = budget; maxRunBytes >= minRunBytes;
+       maxRunBytes /= 2) {
+    auto plan = planRecomputation(fwdOps, candidates, budget, maxRunBytes);
+
+    auto excess     = plan.getExcess(budget);
+    auto bestExcess = best.getExcess(budget);
+    if (excess < bestExcess ||
+        (excess == bestExcess && plan.flops < best.flops)) {
+      best            = plan;
+      bestMaxRunBytes = maxRunBytes;
+    }
+  }
+
+  for (auto op : best.recomputed) {
+    op->settings.recomputeType = RecomputeType::Recompute;
+  }
+
+  struct Summary {
+    int64_t numOps         = 0;
+    int64_t numRecomputed  = 0;
+    int64_t numCheckpoints = 0;
+    double flops           = 0.0;
+    double recomputedFlops = 0.0;
+  };
+  std::map<VGraphId, Summary> summaries;
+  for (auto op : fwdOps) {
+    auto &summary = summaries[getVGraphIdOrZero(op)];
+    summary.numOps++;
+    summary.flops += estimateOpCost(op).flops;
+  }
+  for (auto op : best.recomputed) {
+    auto &summary = summaries[getVGraphIdOrZero(op)];
+    summary.numRecomputed++;
+    summary.recomputedFlops += estimateOpCost(op).flops;
+  }
+  for (auto &op_bytes : best.checkpoints) {
+    summaries[getVGraphIdOrZero(op_bytes.first)].numCheckpoints++;
+    logging::transform::debug("[MemoryBudget] Checkpoint {}, keeping {} bytes",
+                              op_bytes.first->debugName(),
+                              op_bytes.second);
+  }
+
+  for (auto &vgid_summary : summaries) {
+    auto vgid     = vgid_summary.first;
+    auto &summary = vgid_summary.second;
+    logging::transform::info(
+        "[MemoryBudget] Virtual graph {}: {} checkpoints, recomputing {} of {} "
+        "forward ops, {} of {} forward FLOPs. Predicted activation memory {} "
+        "bytes, from {} bytes without recomputation, for a budget of {} bytes.",
+        vgid,
+        summary.numCheckpoints,
+        summary.numRecomputed,
+        summary.numOps,
+        summary.recomputedFlops,
+        summary.flops,
+        best.memory.at(vgid),
+        initial.memory.at(vgid),
+        budget);
+    if (best.memory.at(vgid) > budget) {
+      logging::transform::warn(
+          "[MemoryBudget] The activations of virtual graph {} do not fit in "
+          "the budget of {} bytes with recomputation, predicted {} bytes.",
+          vgid,
+          budget,
+          best.memory.at(vgid));
+    }
+  }
+  logging::transform::debug(
+      "[MemoryBudget] Largest run of recomputed ops allowed: {} bytes",
+      bestMaxRunBytes);
+}
+
 void logAnnotations(Graph &graph) {
   std::stringstream ss;
   for (auto op : graph.getOpSchedule({}, RequireOptimalSchedule::No)) {
@@ -223,6 +633,11 @@ void autoAnnotate(Graph &graph, RecomputationType rctype) {
     annotateRecomputeAll(graph);
     break;
   }
+  case RecomputationType::MemoryBudget: {
+    logging::transform::info("Using 'MemoryBudget' auto-recompute method");
+    annotateMemoryBudget(graph);
+    break;
+  }
   case RecomputationType::Pipeline:
     if (graph.getIr().getSessionOptions().explicitPipeliningEnabled()) {
       annotateRecomputePipeline(graph);
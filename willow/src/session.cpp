@@ -1,5 +1,6 @@
 // Copyright (c) 2018 Graphcore Ltd. All rights reserved.
 #include <algorithm>
+#include <boost/algorithm/string/predicate.hpp>
 #include <boost/container_hash/hash.hpp>
 #include <boost/filesystem.hpp>
 
@@ -24,14 +25,17 @@
 #include <poprithms/memory/inplace/graph.hpp>
 #include <popart/alias/aliasmodelgrower.hpp>
 #include <popart/dotvisualizer.hpp>
+#include <popart/enginecache.hpp>
 #include <popart/error.hpp>
 #include <popart/ir.hpp>
 #include <popart/logging.hpp>
+#include <popart/memoryestimate.hpp>
 #include <popart/popx/devicex.hpp>
 #include <popart/popx/executablex.hpp>
 #include <popart/popx/popefserializer.hpp>
 #include <popart/session.hpp>
 #include <popart/sessionoptions.hpp>
+#include <popart/shardedcheckpoint.hpp>
 #include <popart/tensor.hpp>
 #include <popart/tensordata.hpp>
 #include <popart/version.hpp>
@@ -48,10 +52,10 @@
 #include "popart/popx/irlowering.hpp"
 #include "popart/tensordebuginfo.hpp"
 #include "popart/tensorinfo.hpp"
+#include "popart/variablesettings.hpp"
 #include "popart/voiddata.hpp"
 
 #include "engineoptionscreator.hpp"
-#include "popart/vendored/optional.hpp"
 
 namespace popart {
 class IStepIO;
@@ -61,54 +65,50 @@ class Optimizer;
 
 namespace {
 
-nonstd::optional<size_t>
-inferCacheEntryFromPath(const boost::filesystem::path &entry) {
-  const std::string &filePath = entry.string();
-  if (entry.extension().string().compare(".popef") != 0) {
-    logging::session::trace(
-        "File in cache path does not have extension '.popef': {}", filePath);
-    return {};
-  }
-
-  auto maybeStrHash = entry.stem().string();
-  auto isHash =
-      std::all_of(maybeStrHash.begin(), maybeStrHash.end(), ::isdigit);
-  if (!isHash) {
-    logging::session::trace("Cannot infer IR hash from PopEF file name: {}",
-                            maybeStrHash);
-    return {};
-  }
-
-  size_t hash;
-  std::stringstream sstream(maybeStrHash);
-  sstream >> hash;
-  logging::session::info(
-      "PopEF file inferred to have hash '{}' has been found: {}",
-      hash,
-      filePath);
-  return hash;
+HashesMap getCacheEntries(const SessionOptions &userOptions) {
+  return EngineCache(userOptions).getEntries();
 }
 
-HashesMap getCacheEntries(const std::string &cachePath) {
-  HashesMap cacheEntries;
-  if (!boost::filesystem::is_directory(cachePath)) {
-    return cacheEntries;
-  }
-  for (auto &entry : boost::filesystem::directory_iterator(cachePath)) {
-    if (boost::filesystem::is_regular_file(entry)) {
-      auto possibleHash = inferCacheEntryFromPath(entry.path());
-      if (!possibleHash) {
-        possibleHash =
-            popx::serialization::Reader::checkFileForValidPoplarExecutable(
-                entry.path().string());
-      }
-      if (possibleHash) {
-        cacheEntries.emplace(*possibleHash, entry.path().string());
-      }
-    }
+std::string joinComponents(const std::vector<std::string> &components) {
+  if (components.empty()) {
+    return "none";
+  }
+  std::string joined = components.front();
+  for (size_t i = 1; i < components.size(); ++i) {
+    joined += ", " + components[i];
+  }
+  return joined;
+}
+
+// Report which parts of the IR differ from the nearest executable in the
+// engine cache, so that unexpected misses can be tracked down.
+void explainCacheMiss(const EngineCache &engineCache, const Ir &ir) {
+  const auto explanation = engineCache.explainMiss(ir.getFingerprint());
+  if (!explanation) {
+    logging::session::info("Engine cache miss for hash {}. No executable in "
+                           "the cache has a fingerprint to compare with.",
+                           ir.getHash());
+    return;
+  }
+  logging::session::warn("Engine cache miss for hash {}. Compared to the "
+                         "nearest cached executable, {}, changed: {}; only in "
+                         "this IR: {}; only in the cached IR: {}.",
+                         ir.getHash(),
+                         explanation->nearestHash,
+                         joinComponents(explanation->changed),
+                         joinComponents(explanation->added),
+                         joinComponents(explanation->removed));
+
+  const auto &changed = explanation->changed;
+  if (std::any_of(changed.begin(), changed.end(), [](const std::string &c) {
+        return boost::algorithm::ends_with(c, ".opNames");
+      })) {
+    logging::session::warn("Op names do not change the compiled program. Set "
+                           "SessionOptions::engineCacheIgnoreOpNames to stop "
+                           "them causing engine cache misses.");
   }
-  return cacheEntries;
 }
+
 } // namespace
 
 void Session::ctorCommonLogic() {
@@ -132,7 +132,7 @@ Session::Session(std::shared_ptr<Ir> ir_,
   initProgressLogger(userOptions);
 
   if (userOptions.enableEngineCaching) {
-    cacheEntries = getCacheEntries(userOptions.cachePath);
+    cacheEntries = getCacheEntries(userOptions);
   }
 
   ir->setIsPrepared();
@@ -147,11 +147,36 @@ Session::Session(std::shared_ptr<Ir> ir_,
 void Session::updateEngineCache() {
   const SessionOptions userOptions = ir->getSessionOptions();
   if (userOptions.enableEngineCaching) {
-    cacheEntries = getCacheEntries(userOptions.cachePath);
+    cacheEntries = getCacheEntries(userOptions);
     ir->compareWithSavedHash(cacheEntries);
   }
 }
 
+void Session::setLoweringOptions(const SessionOptions &userOptions) {
+  POPART_TRACEPOINT();
+  if (!deviceInfo_) {
+    throw error("Must call setDevice before {}", __func__);
+  }
+  if (runCalled) {
+    throw error("Cannot change the lowering options after run() was called");
+  }
+  ir->setLoweringOptions(userOptions);
+  ir->updateHash(
+      getEngineCacheHashSeed(ir->getPassedSessionOptions(), *deviceInfo_));
+  logging::session::info("Lowering options changed, the hash of the IR is now "
+                         "{}",
+                         ir->getHash());
+
+  updateEngineCache();
+
+  // Lowering only reads the IR, so the prepared graphs can be lowered again.
+  device_.reset();
+  executable_.reset();
+  lowering_.reset();
+  weightsFromHostCalled = false;
+  setDevice(deviceInfo_);
+}
+
 void Session::setDevice(std::shared_ptr<DeviceInfo> deviceInfo) {
   POPART_TRACEPOINT();
   logging::session::trace("Session::setDevice({})", *deviceInfo);
@@ -210,15 +235,13 @@ bool Session::tryLoadExecutable() {
   }
 
   auto popartCachePath = cacheEntries.at(ir->getHash());
-  // NOTE: The ifstream constructor will call .open() on popartCachePath
-  //       If the file doesn't exist .is_open() will return false
-  auto executableFs =
-      std::make_shared<std::ifstream>(popartCachePath, std::ifstream::binary);
-  if (executableFs->is_open()) {
+  if (boost::filesystem::is_regular_file(popartCachePath)) {
     logging::session::info("Loading serialized PopART executable from {}",
                            popartCachePath);
     try {
-      loadExecutableFromStream(executableFs);
+      popx::serialization::Reader reader(popartCachePath);
+      loadExecutableFromReader(reader);
+      EngineCache(userOptions).recordHit(ir->getHash());
       return true;
     } catch (const std::exception &e) {
       logging::session::warn(
@@ -233,15 +256,14 @@ bool Session::tryLoadExecutable() {
 }
 
 void Session::loadExecutableFromFile(const std::string &filename) {
-  auto execFs =
-      std::make_shared<std::ifstream>(filename, std::ifstream::binary);
-  if (!execFs->is_open()) {
+  if (!boost::filesystem::is_regular_file(filename)) {
     throw error("Could not open file {}", filename);
   }
   logging::session::info("Loading serialized PopART executable from {}",
                          filename);
   try {
-    loadExecutableFromStream(execFs);
+    popx::serialization::Reader reader(filename);
+    loadExecutableFromReader(reader);
   } catch (...) {
     logging::session::err(
         "Failed to load serialized PopART executable from {}:", filename);
@@ -250,10 +272,14 @@ void Session::loadExecutableFromFile(const std::string &filename) {
 }
 
 void Session::loadExecutableFromStream(std::shared_ptr<std::istream> in) {
+  popx::serialization::Reader reader({in});
+  loadExecutableFromReader(reader);
+}
+
+void Session::loadExecutableFromReader(popx::serialization::Reader &reader) {
   bool skipGraphCompilation = true;
   lowering_.reset(new popx::IrLowering(*ir, deviceInfo_, skipGraphCompilation));
 
-  popx::serialization::Reader reader({in});
   lowering_->loadPoplarExecutable(reader);
   executable_ = reader.deserializeExecutable(*ir, *lowering_);
 
@@ -467,7 +493,27 @@ void Session::checkInplacingAmbiguity() const {
 
 void Session::prepareDevice(bool loadEngine) {
   POPART_TRACEPOINT();
-  if (!tryLoadExecutable()) {
+  const SessionOptions &userOptions = ir->getSessionOptions();
+
+  // On a cache miss, hold the compile lock until the executable has been
+  // published to the engine cache, so that other processes compiling the same
+  // graph wait to load it instead of compiling it again.
+  EngineCache::CompileLock compileLock;
+  bool loaded = tryLoadExecutable();
+  if (!loaded && userOptions.compileEngine &&
+      Ir::usingEngineCache(userOptions, deviceInfo_.get())) {
+    EngineCache engineCache(userOptions);
+    compileLock = engineCache.lockForCompile(ir->getHash());
+    if (compileLock.waited()) {
+      updateEngineCache();
+      loaded = tryLoadExecutable();
+    }
+    if (!loaded) {
+      engineCache.recordMiss(ir->getHash());
+      explainCacheMiss(engineCache, *ir);
+    }
+  }
+  if (!loaded) {
     lowering_->prepareGraph();
   }
 
@@ -481,6 +527,7 @@ void Session::prepareDevice(bool loadEngine) {
     throw runtime_error("Must call setDevice before {}", __func__);
   }
   device_->prepare();
+  compileLock.release();
 
   if (ir->getSessionOptions().compileEngine && loadEngine) {
     loadEngineAndConnectStreams();
@@ -748,6 +795,48 @@ void Session::modelToHost(const std::string &fn) {
   }
 }
 
+void Session::weightsToCheckpoint(const std::string &dir, unsigned numShards) {
+  POPART_TRACEPOINT();
+  logging::session::trace("Session::weightsToCheckpoint");
+
+  assertExecutableLoaded();
+
+  if (ir->useSyntheticData()) {
+    throw runtime_error("Cannot write a checkpoint when using synthetic data");
+  }
+
+  // Device -> host stream. The checkpoint is then written straight from the
+  // host stream buffers, without copying them into the ONNX model.
+  device_->weightsToHost();
+
+  std::vector<shardedcheckpoint::Source> sources;
+  for (auto *tensor : executable_->getWeightTensors()) {
+    if (ir->storingIsDisabledForTensor(tensor)) {
+      continue;
+    }
+    shardedcheckpoint::Source source;
+    source.id       = tensor->id;
+    source.segments = device_->getHostWeightSegments(
+        tensor->id, popx::DownsampleStream::GroupPrimary);
+
+    // One value per group, stored with an extra outer dimension for the
+    // groups, as returned by weightsToHost. The values are one segment, or
+    // one segment per group when down-sampled from all replicas.
+    const auto replicas = static_cast<unsigned>(
+        ir->getSessionOptions().getGlobalReplicationFactor());
+    source.info = TensorInfo(
+        tensor->info.dataType(),
+        tensor->getVariableSettings().shapeOnHost(tensor->info.shape(),
+                                                  replicas));
+    sources.push_back(std::move(source));
+  }
+
+  shardedcheckpoint::write(dir,
+                           sources,
+                           numShards,
+                           ir->getSessionOptions().weightTransferThreads);
+}
+
 std::string Session::getSummaryReport(bool resetProfile) const {
   POPART_TRACEPOINT();
   logging::session::trace("Session::getSummaryReport");
@@ -780,14 +869,29 @@ void Session::resetHostWeights(
     throw runtime_error("Cannot call resetHostWeights when constantWeights is "
                         "set");
   }
-  auto modelProto = onnxutil::getModelProto(modelProtoOrFilename);
-  executable_->resetWeights(modelProto,
-                            ignoreWeightsInModelWithoutCorrespondingHostWeight);
+  if (shardedcheckpoint::isShardedCheckpoint(modelProtoOrFilename)) {
+    shardedcheckpoint::Reader checkpoint(modelProtoOrFilename);
+    executable_->resetWeights(
+        checkpoint, ignoreWeightsInModelWithoutCorrespondingHostWeight);
+  } else {
+    auto modelProto = onnxutil::getModelProto(modelProtoOrFilename);
+    executable_->resetWeights(
+        modelProto, ignoreWeightsInModelWithoutCorrespondingHostWeight);
+  }
 
   // After the weights has been reset they must be rewritten to the target
   weightsFromHostCalled = false;
 }
 
+MemoryEstimate Session::getMemoryEstimate(unsigned numTopContributors) const {
+  logging::session::trace("Session::getMemoryEstimate");
+  if (ir->hashMatched()) {
+    throw error("The memory estimate is not available when the executable is "
+                "loaded from the cache, as the IR is not populated.");
+  }
+  return estimateMemory(*ir, numTopContributors);
+}
+
 std::string Session::serializeIr(IrSerializationFormat format) {
   (void)format;
 
@@ -824,20 +928,22 @@ void Session::configureFromOnnx(const std::string &modelProtoOrFilename,
   initProgressLogger(userOptions);
 
   auto &timePartitionLogger = ir->timePartitionLogger();
-  auto modelProto =
-      onnxutil::getModelProto(modelProtoOrFilename, timePartitionLogger);
+  // Move the model into the Ir, so that the initializers, which the weights
+  // are views of, are not copied.
+  ir->setOnnxModel(
+      onnxutil::getModelProto(modelProtoOrFilename, timePartitionLogger));
 
   if (userOptions.enableEngineCaching) {
     const auto cacheTimer =
         timePartitionLogger.scopedStopwatch("Retrieving cache entries");
-    cacheEntries = getCacheEntries(userOptions.cachePath);
+    cacheEntries = getCacheEntries(userOptions);
   }
 
   {
     const auto prepareTimer =
         timePartitionLogger.scopedStopwatch("Preparing IR");
     size_t hashSeed = getEngineCacheHashSeed(userOptions, *deviceInfo);
-    ir->prepare({modelProto,
+    ir->prepare({ir->getModel(),
                  perk,
                  df,
                  lossIn,
@@ -65,12 +65,13 @@ BatchSerializationSettings::BatchSerializationSettings(
     bool concatOnPipelineStageChange_,
     BatchSerializationTransformContext transformContext_,
     BatchSerializationMethod method_,
-    BatchSerializationBatchSchedule batchSchedule_)
+    BatchSerializationBatchSchedule batchSchedule_,
+    int64_t memoryBudget_)
     : factor{factor_}, concatOnVirtualGraphChange{concatOnVirtualGraphChange_},
       concatOnExecutionPhaseChange{concatOnExecutionPhaseChange_},
       concatOnPipelineStageChange{concatOnPipelineStageChange_},
       transformContext{transformContext_}, method{method_},
-      batchSchedule{batchSchedule_} {}
+      batchSchedule{batchSchedule_}, memoryBudget{memoryBudget_} {}
 
 ReplicatedCollectivesSettings::ReplicatedCollectivesSettings(
     bool prepareScheduleForMergingCollectives_,
@@ -92,6 +93,53 @@ std::size_t ReplicatedCollectivesSettings::hash() const {
   return seed;
 }
 
+AutocastSettings::AutocastSettings(
+    bool enabled_,
+    const std::vector<std::string> &allowOpTypes_,
+    const std::vector<std::string> &denyOpTypes_,
+    const std::vector<std::string> &promoteOpTypes_)
+    : enabled{enabled_}, allowOpTypes{allowOpTypes_},
+      denyOpTypes{denyOpTypes_}, promoteOpTypes{promoteOpTypes_} {}
+
+std::size_t AutocastSettings::hash() const {
+  std::size_t seed = 0;
+  boost::hash_combine(seed, enabled);
+  boost::hash_combine(seed, allowOpTypes);
+  boost::hash_combine(seed, denyOpTypes);
+  boost::hash_combine(seed, promoteOpTypes);
+  return seed;
+}
+
+AutoVirtualGraphSettings::AutoVirtualGraphSettings(bool balanceStages_,
+                                                   float maxMemoryProportion_)
+    : balanceStages{balanceStages_},
+      maxMemoryProportion{maxMemoryProportion_} {}
+
+std::size_t AutoVirtualGraphSettings::hash() const {
+  std::size_t seed = 0;
+  boost::hash_combine(seed, balanceStages);
+  boost::hash_combine(seed, maxMemoryProportion);
+  return seed;
+}
+
+TensorLocationPlannerSettings::TensorLocationPlannerSettings(
+    bool enabled_,
+    int64_t memoryBudget_,
+    double remoteBandwidth_,
+    double replicatedBandwidth_)
+    : enabled{enabled_}, memoryBudget{memoryBudget_},
+      remoteBandwidth{remoteBandwidth_},
+      replicatedBandwidth{replicatedBandwidth_} {}
+
+std::size_t TensorLocationPlannerSettings::hash() const {
+  std::size_t seed = 0;
+  boost::hash_combine(seed, enabled);
+  boost::hash_combine(seed, memoryBudget);
+  boost::hash_combine(seed, remoteBandwidth);
+  boost::hash_combine(seed, replicatedBandwidth);
+  return seed;
+}
+
 std::string toString(VirtualGraphMode v) {
   switch (v) {
   case VirtualGraphMode::Off:
@@ -126,6 +174,8 @@ std::string toString(RecomputationType r) {
     return "RecomputationType::NormOnly";
   case RecomputationType::RecomputeAll:
     return "RecomputationType::RecomputeAll";
+  case RecomputationType::MemoryBudget:
+    return "RecomputationType::MemoryBudget";
   case RecomputationType::N:
     throw error("Bad RecomputationType {}", static_cast<int>(r));
   default:
@@ -281,6 +331,166 @@ bool SessionOptions::shouldDelayVarUpdates() const {
          !enableExplicitMainLoops;
 }
 
+namespace {
+
+std::size_t hashOptionMap(const std::map<std::string, std::string> &options) {
+  std::size_t seed = 0;
+  for (auto key_val : options) {
+    boost::hash_combine(seed, key_val.first);
+    boost::hash_combine(seed, key_val.second);
+  }
+  return seed;
+}
+
+std::size_t hashTensorLocationSettings(const TensorLocationSettings &tls) {
+  std::size_t seed = 0;
+  boost::hash_combine(seed, tls.minElementsForOffChip);
+  boost::hash_combine(seed, tls.minElementsForReplicatedTensorSharding);
+  auto location = tls.location.serialize();
+  boost::hash_range(seed, location.begin(), location.end());
+  return seed;
+}
+
+} // namespace
+
+std::map<std::string, std::size_t> SessionOptions::getHashComponents() const {
+  // Hash based on all the SessionOptions attributes that
+  // can affect compiled program
+  std::map<std::string, std::size_t> components;
+  const auto add = [&components](const std::string &name, std::size_t hash) {
+    components[name] = hash;
+  };
+
+  add("rearrangeAnchorsOnHost", boost::hash_value(rearrangeAnchorsOnHost));
+  add("enableNonStableSoftmax", boost::hash_value(enableNonStableSoftmax));
+  add("replicatedGraphCount", boost::hash_value(replicatedGraphCount));
+  add("globalReplicationFactor", boost::hash_value(globalReplicationFactor));
+  add("enablePipelining", boost::hash_value(enablePipelining));
+  add("disableGradAccumulationTensorStreams",
+      boost::hash_value(disableGradAccumulationTensorStreams));
+  add("disableOptimizerStateTensorStreams",
+      boost::hash_value(disableOptimizerStateTensorStreams));
+  add("accumulationFactor", boost::hash_value(accumulationFactor));
+  add("accumulationAndReplicationReductionType",
+      boost::hash_value(
+          static_cast<int>(accumulationAndReplicationReductionType)));
+  add("meanAccumulationAndReplicationReductionStrategy",
+      boost::hash_value(
+          static_cast<int>(meanAccumulationAndReplicationReductionStrategy)));
+  add("enableFloatingPointChecks",
+      boost::hash_value(enableFloatingPointChecks));
+  add("enableStochasticRounding", boost::hash_value(enableStochasticRounding));
+  add("enableFullyConnectedPass", boost::hash_value(enableFullyConnectedPass));
+  add("syntheticDataMode",
+      boost::hash_value(static_cast<int>(syntheticDataMode)));
+  add("enableSerializedMatmuls", boost::hash_value(enableSerializedMatmuls));
+  add("aliasZeroCopy", boost::hash_value(aliasZeroCopy));
+  add("numIOTiles", boost::hash_value(static_cast<int>(numIOTiles)));
+  add("enableOutlining", boost::hash_value(enableOutlining));
+  add("enableElementwiseFusion", boost::hash_value(enableElementwiseFusion));
+  add("enableGlobalValueNumbering",
+      boost::hash_value(enableGlobalValueNumbering));
+  add("enableTransposeSinking", boost::hash_value(enableTransposeSinking));
+  add("enableOutliningCopyCostPruning",
+      boost::hash_value(enableOutliningCopyCostPruning));
+  add("outlineThreshold", boost::hash_value(outlineThreshold));
+  add("outlineSequenceBreakCost", boost::hash_value(outlineSequenceBreakCost));
+  add("subgraphCopyingStrategy", boost::hash_value(subgraphCopyingStrategy));
+  add("autoRecomputation",
+      boost::hash_value(static_cast<int>(autoRecomputation)));
+  add("autoRecomputationMemoryBudget",
+      boost::hash_value(autoRecomputationMemoryBudget));
+  add("mergeVarUpdate", boost::hash_value(static_cast<int>(mergeVarUpdate)));
+  add("mergeVarUpdateMemThreshold",
+      boost::hash_value(mergeVarUpdateMemThreshold));
+  add("looseThresholdAtPeak", boost::hash_value(looseThresholdAtPeak));
+  add("explicitRecomputation", boost::hash_value(explicitRecomputation));
+  add("partialsTypeMatMuls", boost::hash_value(partialsTypeMatMuls));
+  add("decomposeGradSum", boost::hash_value(decomposeGradSum));
+  add("replicatedCollectivesSettings", replicatedCollectivesSettings.hash());
+  add("virtualGraphMode",
+      boost::hash_value(static_cast<int>(virtualGraphMode)));
+  add("autoVirtualGraphSettings", autoVirtualGraphSettings.hash());
+  add("delayVarUpdates", boost::hash_value(delayVarUpdates));
+  add("scheduleNonWeightUpdateGradientConsumersEarly",
+      boost::hash_value(scheduleNonWeightUpdateGradientConsumersEarly));
+  add("enableStableNorm", boost::hash_value(enableStableNorm));
+  add("timeLimitScheduler", boost::hash_value(timeLimitScheduler));
+  add("swapLimitScheduler", boost::hash_value(swapLimitScheduler));
+  add("groupHostSync", boost::hash_value(groupHostSync));
+  add("enableLoadAndOffloadRNGState",
+      boost::hash_value(enableLoadAndOffloadRNGState));
+  add("kahnTieBreaker", boost::hash_value(kahnTieBreaker));
+  add("automaticLossScalingSettings", automaticLossScalingSettings.hash());
+  add("enableSupportedDataTypeCasting",
+      boost::hash_value(enableSupportedDataTypeCasting));
+  add("ensureFp32LossScaleTensor",
+      boost::hash_value(ensureFp32LossScaleTensor));
+  add("groupNormStridedChannelGrouping",
+      boost::hash_value(groupNormStridedChannelGrouping));
+
+  std::size_t seed = 0;
+  boost::hash_combine(
+      seed, static_cast<int>(accumulateOuterFragmentSettings.schedule));
+  boost::hash_range(
+      seed,
+      accumulateOuterFragmentSettings.excludedVirtualGraphs.begin(),
+      accumulateOuterFragmentSettings.excludedVirtualGraphs.end());
+  add("accumulateOuterFragmentSettings", seed);
+
+  seed = 0;
+  boost::hash_combine(seed, batchSerializationSettings.factor);
+  boost::hash_combine(seed,
+                      batchSerializationSettings.concatOnVirtualGraphChange);
+  boost::hash_combine(seed,
+                      batchSerializationSettings.concatOnExecutionPhaseChange);
+  boost::hash_combine(seed,
+                      batchSerializationSettings.concatOnPipelineStageChange);
+  boost::hash_combine(
+      seed, static_cast<int>(batchSerializationSettings.transformContext));
+  boost::hash_combine(seed,
+                      static_cast<int>(batchSerializationSettings.method));
+  boost::hash_combine(
+      seed, static_cast<int>(batchSerializationSettings.batchSchedule));
+  boost::hash_combine(seed, batchSerializationSettings.memoryBudget);
+  add("batchSerializationSettings", seed);
+
+  add("autodiffSettings", boost::hash_value(autodiffSettings.stitchStrategy));
+  add("autocastSettings", autocastSettings.hash());
+
+  seed = 0;
+  boost::hash_combine(seed, executionPhaseSettings.phases);
+  boost::hash_combine(seed, executionPhaseSettings.stages);
+  boost::hash_combine(
+      seed, static_cast<int>(executionPhaseSettings.weightIOSchedule));
+  boost::hash_combine(
+      seed, static_cast<int>(executionPhaseSettings.activationIOSchedule));
+  boost::hash_combine(
+      seed, static_cast<int>(executionPhaseSettings.optimizerStateIOSchedule));
+  boost::hash_combine(
+      seed, static_cast<int>(executionPhaseSettings.accumulatorIOSchedule));
+  boost::hash_combine(seed, static_cast<int>(executionPhaseSettings.schedule));
+  add("executionPhaseSettings", seed);
+
+  add("activationTensorLocationSettings",
+      hashTensorLocationSettings(activationTensorLocationSettings));
+  add("weightTensorLocationSettings",
+      hashTensorLocationSettings(weightTensorLocationSettings));
+  add("optimizerStateTensorLocationSettings",
+      hashTensorLocationSettings(optimizerStateTensorLocationSettings));
+  add("accumulatorTensorLocationSettings",
+      hashTensorLocationSettings(accumulatorTensorLocationSettings));
+  add("tensorLocationPlannerSettings", tensorLocationPlannerSettings.hash());
+
+  add("engineOptions", hashOptionMap(engineOptions));
+  add("convolutionOptions", hashOptionMap(convolutionOptions));
+  add("lstmOptions", hashOptionMap(lstmOptions));
+  add("matmulOptions", hashOptionMap(matmulOptions));
+  add("gclOptions", hashOptionMap(gclOptions));
+
+  return components;
+}
+
 std::string toString(const TensorLocationSettings &tls) {
   std::stringstream ss;
   ss << "(";
@@ -327,147 +537,11 @@ std::ostream &operator<<(std::ostream &os, const AutodiffStitchStrategy &s) {
 namespace std {
 std::size_t hash<popart::SessionOptions>::operator()(
     const popart::SessionOptions &so) const {
-  // Hash based on all the SessionOptions attributes that
-  // can affect compiled program
   std::size_t seed = 0;
-
-  boost::hash_combine(seed, so.rearrangeAnchorsOnHost);
-  boost::hash_combine(seed, so.enableNonStableSoftmax);
-  boost::hash_combine(seed, so.replicatedGraphCount);
-  boost::hash_combine(seed, so.globalReplicationFactor);
-  boost::hash_combine(seed, so.enablePipelining);
-  boost::hash_combine(seed, so.disableGradAccumulationTensorStreams);
-  boost::hash_combine(seed, so.disableOptimizerStateTensorStreams);
-  boost::hash_combine(seed, so.accumulationFactor);
-  boost::hash_combine(
-      seed, static_cast<int>(so.accumulationAndReplicationReductionType));
-  boost::hash_combine(
-      seed,
-      static_cast<int>(so.meanAccumulationAndReplicationReductionStrategy));
-  boost::hash_combine(seed, so.enableFloatingPointChecks);
-  boost::hash_combine(seed, so.enableStochasticRounding);
-  boost::hash_combine(seed, so.enableFullyConnectedPass);
-  boost::hash_combine(seed, static_cast<int>(so.syntheticDataMode));
-  boost::hash_combine(seed, so.enableSerializedMatmuls);
-  boost::hash_combine(seed, so.aliasZeroCopy);
-  boost::hash_combine(seed, static_cast<int>(so.numIOTiles));
-  boost::hash_combine(seed, so.enableOutlining);
-  boost::hash_combine(seed, so.enableOutliningCopyCostPruning);
-  boost::hash_combine(seed, so.outlineThreshold);
-  boost::hash_combine(seed, so.outlineSequenceBreakCost);
-  boost::hash_combine(seed, so.subgraphCopyingStrategy);
-  boost::hash_combine(seed, static_cast<int>(so.autoRecomputation));
-  boost::hash_combine(seed, static_cast<int>(so.mergeVarUpdate));
-  boost::hash_combine(seed, so.mergeVarUpdateMemThreshold);
-  boost::hash_combine(seed, so.looseThresholdAtPeak);
-  boost::hash_combine(seed, so.explicitRecomputation);
-  boost::hash_combine(seed, so.partialsTypeMatMuls);
-  boost::hash_combine(seed, so.decomposeGradSum);
-  boost::hash_combine(seed, so.replicatedCollectivesSettings.hash());
-  boost::hash_combine(seed, static_cast<int>(so.virtualGraphMode));
-  boost::hash_combine(seed, so.delayVarUpdates);
-  boost::hash_combine(seed, so.scheduleNonWeightUpdateGradientConsumersEarly);
-  boost::hash_combine(seed, so.enableStableNorm);
-  boost::hash_combine(seed, so.timeLimitScheduler);
-  boost::hash_combine(seed, so.swapLimitScheduler);
-  boost::hash_combine(seed, so.groupHostSync);
-  boost::hash_combine(seed, so.enableLoadAndOffloadRNGState);
-  boost::hash_combine(seed, so.kahnTieBreaker);
-  boost::hash_combine(seed, so.automaticLossScalingSettings.hash());
-  boost::hash_combine(seed, so.enableSupportedDataTypeCasting);
-  boost::hash_combine(seed, so.ensureFp32LossScaleTensor);
-
-  boost::hash_combine(seed, so.groupNormStridedChannelGrouping);
-  boost::hash_combine(
-      seed, static_cast<int>(so.accumulateOuterFragmentSettings.schedule));
-  boost::hash_range(
-      seed,
-      so.accumulateOuterFragmentSettings.excludedVirtualGraphs.begin(),
-      so.accumulateOuterFragmentSettings.excludedVirtualGraphs.end());
-
-  boost::hash_combine(seed, so.batchSerializationSettings.factor);
-  boost::hash_combine(seed,
-                      so.batchSerializationSettings.concatOnVirtualGraphChange);
-  boost::hash_combine(
-      seed, so.batchSerializationSettings.concatOnExecutionPhaseChange);
-  boost::hash_combine(
-      seed, so.batchSerializationSettings.concatOnPipelineStageChange);
-  boost::hash_combine(
-      seed, static_cast<int>(so.batchSerializationSettings.transformContext));
-  boost::hash_combine(seed,
-                      static_cast<int>(so.batchSerializationSettings.method));
-  boost::hash_combine(
-      seed, static_cast<int>(so.batchSerializationSettings.batchSchedule));
-
-  boost::hash_combine(seed, so.autodiffSettings.stitchStrategy);
-
-  boost::hash_combine(seed, so.executionPhaseSettings.phases);
-  boost::hash_combine(seed, so.executionPhaseSettings.stages);
-  boost::hash_combine(
-      seed, static_cast<int>(so.executionPhaseSettings.weightIOSchedule));
-  boost::hash_combine(
-      seed, static_cast<int>(so.executionPhaseSettings.activationIOSchedule));
-  boost::hash_combine(
-      seed,
-      static_cast<int>(so.executionPhaseSettings.optimizerStateIOSchedule));
-  boost::hash_combine(
-      seed, static_cast<int>(so.executionPhaseSettings.accumulatorIOSchedule));
-  boost::hash_combine(seed,
-                      static_cast<int>(so.executionPhaseSettings.schedule));
-
-  boost::hash_combine(
-      seed, so.activationTensorLocationSettings.minElementsForOffChip);
-  boost::hash_combine(seed,
-                      so.activationTensorLocationSettings
-                          .minElementsForReplicatedTensorSharding);
-  auto atls = so.activationTensorLocationSettings.location.serialize();
-  boost::hash_range(seed, atls.begin(), atls.end());
-
-  boost::hash_combine(seed,
-                      so.weightTensorLocationSettings.minElementsForOffChip);
-  boost::hash_combine(
-      seed,
-      so.weightTensorLocationSettings.minElementsForReplicatedTensorSharding);
-  auto wtls = so.weightTensorLocationSettings.location.serialize();
-  boost::hash_range(seed, wtls.begin(), wtls.end());
-
-  boost::hash_combine(
-      seed, so.optimizerStateTensorLocationSettings.minElementsForOffChip);
-  boost::hash_combine(seed,
-                      so.optimizerStateTensorLocationSettings
-                          .minElementsForReplicatedTensorSharding);
-  auto otls = so.optimizerStateTensorLocationSettings.location.serialize();
-  boost::hash_range(seed, otls.begin(), otls.end());
-
-  boost::hash_combine(
-      seed, so.accumulatorTensorLocationSettings.minElementsForOffChip);
-  boost::hash_combine(seed,
-                      so.accumulatorTensorLocationSettings
-                          .minElementsForReplicatedTensorSharding);
-  auto acctls = so.accumulatorTensorLocationSettings.location.serialize();
-  boost::hash_range(seed, acctls.begin(), acctls.end());
-
-  for (auto key_val : so.engineOptions) {
-    boost::hash_combine(seed, key_val.first);
-    boost::hash_combine(seed, key_val.second);
+  for (const auto &component : so.getHashComponents()) {
+    boost::hash_combine(seed, component.first);
+    boost::hash_combine(seed, component.second);
   }
-  for (auto key_val : so.convolutionOptions) {
-    boost::hash_combine(seed, key_val.first);
-    boost::hash_combine(seed, key_val.second);
-  }
-  for (auto key_val : so.lstmOptions) {
-    boost::hash_combine(seed, key_val.first);
-    boost::hash_combine(seed, key_val.second);
-  }
-  for (auto key_val : so.matmulOptions) {
-    boost::hash_combine(seed, key_val.first);
-    boost::hash_combine(seed, key_val.second);
-  }
-  for (auto key_val : so.gclOptions) {
-    boost::hash_combine(seed, key_val.first);
-    boost::hash_combine(seed, key_val.second);
-  }
-
   return seed;
 }
 
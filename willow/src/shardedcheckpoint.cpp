@@ -0,0 +1,429 @@
+// Copyright (c) 2022 Graphcore Ltd. All rights reserved.
+#include <algorithm>
+#include <atomic>
+#include <boost/filesystem.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <boost/property_tree/json_parser.hpp>
+#include <boost/property_tree/ptree.hpp>
+#include <cstdio>
+#include <exception>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <mutex>
+#include <set>
+#include <sstream>
+#include <thread>
+#include <popart/error.hpp>
+#include <popart/logging.hpp>
+#include <popart/shardedcheckpoint.hpp>
+
+namespace popart {
+namespace shardedcheckpoint {
+
+const char *const indexFileName = "popart_checkpoint.json";
+
+namespace {
+
+const char *const formatName = "popart-sharded-checkpoint";
+const int formatVersion      = 1;
+
+// Upper bound on the automatically chosen number of threads, and the size
+// above which more shards are used than there are threads.
+constexpr unsigned maxAutoThreads    = 16;
+constexpr uint64_t maxAutoShardBytes = uint64_t{4} << 30;
+
+unsigned getNumThreads(unsigned numThreads) {
+  if (numThreads != 0) {
+    return numThreads;
+  }
+  return std::max(
+      1u, std::min(std::thread::hardware_concurrency(), maxAutoThreads));
+}
+
+uint64_t alignUp(uint64_t n) {
+  return (n + tensorAlignment - 1) / tensorAlignment * tensorAlignment;
+}
+
+std::string shardFileName(unsigned shard, unsigned numShards) {
+  std::ostringstream oss;
+  oss << "shard_" << std::setw(5) << std::setfill('0') << shard << "_of_"
+      << std::setw(5) << std::setfill('0') << numShards << ".bin";
+  return oss.str();
+}
+
+boost::filesystem::path indexPath(const std::string &dir) {
+  return boost::filesystem::path(dir) / indexFileName;
+}
+
+bool isShardFile(const boost::filesystem::path &path) {
+  const auto name = path.filename().string();
+  return name.compare(0, 6, "shard_") == 0 &&
+         name.find("_of_") != std::string::npos && path.extension() == ".bin";
+}
+
+// Remove the shards of an earlier checkpoint in dir that are not about to be
+// overwritten, for example when it was written with more shards.
+void removeStaleShards(const std::string &dir,
+                       const std::vector<std::string> &shardNames) {
+  const std::set<std::string> current(shardNames.begin(), shardNames.end());
+  std::vector<boost::filesystem::path> stale;
+  for (auto &file : boost::filesystem::directory_iterator(dir)) {
+    if (isShardFile(file.path()) &&
+        current.count(file.path().filename().string()) == 0) {
+      stale.push_back(file.path());
+    }
+  }
+  for (const auto &path : stale) {
+    logging::session::debug("Removing stale checkpoint shard {}",
+                            path.string());
+    boost::filesystem::remove(path);
+  }
+}
+
+void writeShard(const boost::filesystem::path &path,
+                const std::vector<const Source *> &sources) {
+  std::ofstream ofs(path.string(),
+                    std::ofstream::binary | std::ofstream::trunc);
+  if (!ofs.is_open()) {
+    throw error("Failed to open checkpoint shard {} for writing",
+                path.string());
+  }
+
+  const char padding[tensorAlignment] = {};
+  uint64_t offset                     = 0;
+  for (const auto *source : sources) {
+    ofs.write(padding, alignUp(offset) - offset);
+    offset = alignUp(offset);
+    for (const auto &segment : source->segments) {
+      ofs.write(segment.first, segment.second);
+      offset += segment.second;
+    }
+  }
+
+  ofs.close();
+  if (ofs.fail()) {
+    throw error("Failed to write checkpoint shard {}", path.string());
+  }
+}
+
+void writeIndex(const std::string &dir,
+                const std::vector<std::string> &shardNames,
+                const std::vector<Entry> &entries) {
+  namespace pt = boost::property_tree;
+
+  pt::ptree root;
+  root.put("format", formatName);
+  root.put("version", formatVersion);
+
+  pt::ptree shards;
+  for (const auto &name : shardNames) {
+    pt::ptree shard;
+    shard.put_value(name);
+    shards.push_back({"", shard});
+  }
+  root.add_child("shards", shards);
+
+  pt::ptree tensors;
+  for (const auto &entry : entries) {
+    pt::ptree tensor;
+    tensor.put("id", entry.id);
+    tensor.put("dtype", entry.info.data_type());
+    pt::ptree shape;
+    for (auto dim : entry.info.shape()) {
+      pt::ptree d;
+      d.put_value(dim);
+      shape.push_back({"", d});
+    }
+    tensor.add_child("shape", shape);
+    tensor.put("shard", entry.shard);
+    tensor.put("offset", entry.offset);
+    tensors.push_back({"", tensor});
+  }
+  root.add_child("tensors", tensors);
+
+  // Write to a temporary file first, so the index only appears once complete.
+  const auto path    = indexPath(dir);
+  const auto tmpPath = boost::filesystem::path(path.string() + ".tmp");
+  {
+    std::ofstream ofs(tmpPath.string());
+    if (!ofs.is_open()) {
+      throw error("Failed to open checkpoint index {} for writing",
+                  tmpPath.string());
+    }
+    pt::write_json(ofs, root);
+    ofs.close();
+    if (ofs.fail()) {
+      throw error("Failed to write checkpoint index {}", tmpPath.string());
+    }
+  }
+  boost::filesystem::rename(tmpPath, path);
+}
+
+} // namespace
+
+bool isShardedCheckpoint(const std::string &path) {
+  boost::system::error_code ec;
+  return boost::filesystem::is_directory(path, ec) &&
+         boost::filesystem::is_regular_file(indexPath(path), ec);
+}
+
+std::vector<Entry> write(const std::string &dir,
+                         const std::vector<Source> &sources,
+                         unsigned numShards,
+                         unsigned numThreads) {
+  uint64_t totalBytes = 0;
+  for (const auto &source : sources) {
+    uint64_t nbytes = 0;
+    for (const auto &segment : source.segments) {
+      nbytes += segment.second;
+    }
+    if (nbytes != static_cast<uint64_t>(source.info.nbytes())) {
+      throw internal_error("Checkpoint source for tensor {} has {} bytes of "
+                           "data, but its info {} requires {}",
+                           source.id,
+                           nbytes,
+                           source.info,
+                           source.info.nbytes());
+    }
+    totalBytes += nbytes;
+  }
+
+  numThreads = getNumThreads(numThreads);
+  if (numShards == 0) {
+    const auto shardsBySize =
+        (totalBytes + maxAutoShardBytes - 1) / maxAutoShardBytes;
+
+    numShards = static_cast<unsigned>(
+        std::max<uint64_t>(numThreads, shardsBySize));
+    numShards = std::min<unsigned>(numShards, sources.size());
+    numShards = std::max(numShards, 1u);
+  }
+  numThreads = std::min(numThreads, numShards);
+
+  // Balance the shards by size: largest tensors first, each to the currently
+  // smallest shard. Within a shard, tensors keep the order of `sources`.
+  std::vector<size_t> bySize(sources.size());
+  for (size_t i = 0; i < sources.size(); ++i) {
+    bySize[i] = i;
+  }
+  std::stable_sort(
+      bySize.begin(), bySize.end(), [&sources](size_t a, size_t b) {
+        return sources[a].info.nbytes() > sources[b].info.nbytes();
+      });
+  std::vector<uint64_t> shardBytes(numShards, 0);
+  std::vector<unsigned> shardOf(sources.size());
+  for (auto i : bySize) {
+    const auto smallest =
+        std::min_element(shardBytes.begin(), shardBytes.end()) -
+        shardBytes.begin();
+    shardOf[i] = static_cast<unsigned>(smallest);
+    shardBytes[smallest] += alignUp(sources[i].info.nbytes());
+  }
+
+  std::vector<Entry> entries;
+  std::vector<std::vector<const Source *>> shardSources(numShards);
+  std::vector<uint64_t> shardOffsets(numShards, 0);
+  for (size_t i = 0; i < sources.size(); ++i) {
+    const auto shard = shardOf[i];
+    entries.push_back(
+        {sources[i].id, sources[i].info, shard, shardOffsets[shard]});
+    shardSources[shard].push_back(&sources[i]);
+    shardOffsets[shard] += alignUp(sources[i].info.nbytes());
+  }
+
+  std::vector<std::string> shardNames;
+  for (unsigned shard = 0; shard < numShards; ++shard) {
+    shardNames.push_back(shardFileName(shard, numShards));
+  }
+
+  logging::session::info("Writing {} tensors ({} bytes) to checkpoint {} in "
+                         "{} shard(s) using {} thread(s)",
+                         sources.size(),
+                         totalBytes,
+                         dir,
+                         numShards,
+                         numThreads);
+
+  boost::filesystem::create_directories(dir);
+  // Remove a previous index first, so that the directory is never seen as a
+  // complete checkpoint while its shards are being overwritten.
+  boost::filesystem::remove(indexPath(dir));
+  removeStaleShards(dir, shardNames);
+
+  std::atomic<unsigned> nextShard{0};
+  std::mutex exceptionMutex;
+  std::exception_ptr firstException;
+  auto writeShards = [&]() {
+    for (unsigned shard = nextShard++; shard < numShards; shard = nextShard++) {
+      try {
+        writeShard(boost::filesystem::path(dir) / shardNames[shard],
+                   shardSources[shard]);
+      } catch (...) {
+        std::lock_guard<std::mutex> lock(exceptionMutex);
+        if (!firstException) {
+          firstException = std::current_exception();
+        }
+      }
+    }
+  };
+
+  std::vector<std::thread> threads;
+  for (unsigned i = 1; i < numThreads; ++i) {
+    threads.emplace_back(writeShards);
+  }
+  writeShards();
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  if (firstException) {
+    std::rethrow_exception(firstException);
+  }
+
+  writeIndex(dir, shardNames, entries);
+  return entries;
+}
+
+class Reader::Impl {
+public:
+  explicit Impl(const std::string &dir_) : dir(dir_) {
+    namespace pt = boost::property_tree;
+
+    if (!isShardedCheckpoint(dir)) {
+      throw error("{} is not a checkpoint directory, it has no {}",
+                  dir,
+                  indexFileName);
+    }
+
+    pt::ptree root;
+    try {
+      pt::read_json(indexPath(dir).string(), root);
+    } catch (const pt::json_parser_error &e) {
+      throw error("Failed to parse checkpoint index {}: {}",
+                  indexPath(dir).string(),
+                  e.what());
+    }
+
+    if (root.get<std::string>("format", "") != formatName ||
+        root.get<int>("version", 0) != formatVersion) {
+      throw error("Checkpoint index {} has unsupported format {} version {}, "
+                  "expected {} version {}",
+                  indexPath(dir).string(),
+                  root.get<std::string>("format", ""),
+                  root.get<int>("version", 0),
+                  formatName,
+                  formatVersion);
+    }
+
+    for (const auto &shard : root.get_child("shards")) {
+      shardNames.push_back(shard.second.get_value<std::string>());
+    }
+    regions.resize(shardNames.size());
+
+    for (const auto &tensor : root.get_child("tensors")) {
+      const auto &t = tensor.second;
+      Shape shape;
+      for (const auto &dim : t.get_child("shape")) {
+        shape.push_back(dim.second.get_value<int64_t>());
+      }
+      Entry entry{t.get<std::string>("id"),
+                  TensorInfo(t.get<std::string>("dtype"), shape),
+                  t.get<unsigned>("shard"),
+                  t.get<uint64_t>("offset")};
+      if (entry.shard >= shardNames.size()) {
+        throw error("Checkpoint index {} places tensor {} in shard {}, but "
+                    "there are only {} shards",
+                    indexPath(dir).string(),
+                    entry.id,
+                    entry.shard,
+                    shardNames.size());
+      }
+      if (!indices.emplace(entry.id, entries.size()).second) {
+        throw error("Checkpoint index {} contains tensor {} more than once",
+                    indexPath(dir).string(),
+                    entry.id);
+      }
+      entries.push_back(std::move(entry));
+    }
+  }
+
+  const Entry &getEntry(const TensorId &id) const {
+    auto found = indices.find(id);
+    if (found == indices.end()) {
+      throw runtime_error("No TensorId {} in checkpoint {}", id, dir);
+    }
+    return entries.at(found->second);
+  }
+
+  // Map the shard on first use.
+  char *getShardData(unsigned shard, uint64_t &size) const {
+    namespace bip = boost::interprocess;
+
+    std::lock_guard<std::mutex> lock(regionsMutex);
+    auto &region = regions.at(shard);
+    if (!region) {
+      const auto path =
+          (boost::filesystem::path(dir) / shardNames.at(shard)).string();
+      if (boost::filesystem::file_size(path) == 0) {
+        // Empty files cannot be mapped.
+        size = 0;
+        return nullptr;
+      }
+      logging::session::debug("Mapping checkpoint shard {}", path);
+      bip::file_mapping file(path.c_str(), bip::read_only);
+      region.reset(new bip::mapped_region(file, bip::copy_on_write));
+    }
+    size = region->get_size();
+    return static_cast<char *>(region->get_address());
+  }
+
+  std::string dir;
+  std::vector<std::string> shardNames;
+  std::vector<Entry> entries;
+  std::map<TensorId, size_t> indices;
+
+  mutable std::mutex regionsMutex;
+  mutable std::vector<std::unique_ptr<boost::interprocess::mapped_region>>
+      regions;
+};
+
+Reader::Reader(const std::string &dir) : impl(new Impl(dir)) {}
+
+Reader::~Reader() = default;
+
+bool Reader::contains(TensorId id) const {
+  return impl->indices.find(id) != impl->indices.end();
+}
+
+MutableVoidData Reader::weight(TensorId id) const {
+  const auto &entry = impl->getEntry(id);
+
+  uint64_t shardSize    = 0;
+  char *shardData       = impl->getShardData(entry.shard, shardSize);
+  const uint64_t nbytes = entry.info.nbytes();
+  if (entry.offset + nbytes > shardSize) {
+    throw error("Checkpoint shard {} of {} is truncated, tensor {} needs "
+                "bytes [{}, {}) but the shard has {}",
+                impl->shardNames.at(entry.shard),
+                impl->dir,
+                id,
+                entry.offset,
+                entry.offset + nbytes,
+                shardSize);
+  }
+
+  MutableVoidData mvd;
+  mvd.info = entry.info;
+  mvd.data = nbytes == 0 ? nullptr : shardData + entry.offset;
+  return mvd;
+}
+
+const std::vector<Entry> &Reader::getEntries() const { return impl->entries; }
+
+unsigned Reader::getNumShards() const {
+  return static_cast<unsigned>(impl->shardNames.size());
+}
+
+} // namespace shardedcheckpoint
+} // namespace popart
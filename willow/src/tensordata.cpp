@@ -60,6 +60,10 @@ class TensorData::NonOwningData final : public TensorData::IData {
 public:
   NonOwningData(void *src, const std::size_t size_)
       : data_(src), size_(size_) {}
+  NonOwningData(void *src,
+                const std::size_t size_,
+                std::shared_ptr<void> owner_)
+      : data_(src), size_(size_), owner(std::move(owner_)) {}
 
   void *data() override { return data_; }
   std::size_t size() override { return size_; }
@@ -97,6 +101,8 @@ public:
 private:
   void *data_;
   std::size_t size_;
+  // Optionally keeps the viewed buffer alive.
+  std::shared_ptr<void> owner;
 };
 
 TensorData::~TensorData()                           = default;
@@ -114,6 +120,12 @@ TensorData TensorData::fromCopyOf(const void *src, const std::size_t size) {
 TensorData TensorData::fromViewOf(void *src, const std::size_t size) {
   return TensorData(std::make_shared<NonOwningData>(src, size));
 }
+TensorData TensorData::fromSharedViewOf(void *src,
+                                        const std::size_t size,
+                                        std::shared_ptr<void> owner) {
+  return TensorData(
+      std::make_shared<NonOwningData>(src, size, std::move(owner)));
+}
 TensorData TensorData::fromEmplaceOf(std::vector<char> &&data) {
   // In future could be generalised to other types too.
   // To help user, only binds to rvalue refs, as otherwise using this factory
@@ -38,22 +38,27 @@ TensorDebugInfo::TensorDebugInfo(const DebugContext &debugContext,
                                  const TensorId &tenid,
                                  const TensorInfo &info,
                                  const TensorType &tt)
-    : DebugInfo(debugContext, "popart") {
-  setValue("category", ProfileValue{"tensor"});
-  setValue("tensorId", ProfileValue{tenid});
-  setValue("shape", ProfileValue{to_string(info.shape())});
+    : DebugInfo(debugContext, "popart"), tensorId(tenid), shape(info.shape()),
+      type(tt) {
   if (info.getDataTypeInfo() != nullptr) {
-    setValue("elementType", ProfileValue{to_string(info.dataType())});
+    elementType = info.dataType();
   }
-  setValue("type", ProfileValue{to_string(tt)});
 }
 
 TensorDebugInfo::TensorDebugInfo(const DebugContext &debugContext,
                                  const TensorId &tenid,
                                  const TensorType &tt)
-    : DebugInfo(debugContext, "popart") {
+    : DebugInfo(debugContext, "popart"), tensorId(tenid), type(tt) {}
+
+TensorDebugInfo::~TensorDebugInfo() {
   setValue("category", ProfileValue{"tensor"});
-  setValue("tensorId", ProfileValue{tenid});
-  setValue("type", ProfileValue{to_string(tt)});
+  setValue("tensorId", ProfileValue{tensorId});
+  if (shape) {
+    setValue("shape", ProfileValue{to_string(*shape)});
+  }
+  if (elementType) {
+    setValue("elementType", ProfileValue{to_string(*elementType)});
+  }
+  setValue("type", ProfileValue{to_string(type)});
 }
 } // namespace popart
@@ -9,7 +9,6 @@
 #include <unordered_map>
 #include <utility>
 #include <vector>
-#include <poplar/Target.hpp>
 #include <popart/graph.hpp> // IWYU pragma: keep
 #include <popart/ir.hpp>
 #include <popart/names.hpp>
@@ -24,6 +23,7 @@
 #include "popart/datatype.hpp"
 #include "popart/debugcontext.hpp"
 #include "popart/error.hpp"
+#include "popart/half.hpp"
 #include "popart/logging.hpp"
 #include "popart/pointercomparators.hpp"
 #include "popart/scope.hpp"
@@ -313,12 +313,31 @@ void Tensors::addInit(const TensorId &name,
 }
 
 namespace {
-TensorData TensorDataFromOnnxProto(const ONNX_NAMESPACE::TensorProto &tp) {
+TensorData TensorDataFromOnnxProto(const ONNX_NAMESPACE::TensorProto &tp,
+                                   bool mapExternalData) {
+  if (mapExternalData && onnxutil::hasExternalData(tp)) {
+    // Pages are only read from disk when the data is first accessed.
+    return onnxutil::mapExternalTensorData(tp);
+  }
   ConstVoidData cv_data = onnxutil::getConstData(tp);
   // Would be able to emplace here if ConstVoidData was stored as a vector<char>
   // instead of raw pointer.
   return TensorData::fromCopyOf(cv_data.data, cv_data.info.nbytes());
 }
+
+// A view of the raw data of tp, which holds a reference to owner. If tp has
+// no raw data, as TensorDataFromOnnxProto.
+TensorData TensorDataFromViewOfOnnxProto(ONNX_NAMESPACE::TensorProto &tp,
+                                         std::shared_ptr<void> owner,
+                                         bool mapExternalData) {
+  const TensorInfo info(tp);
+  if (!tp.has_raw_data() || info.nbytes() == 0 ||
+      tp.raw_data().size() != info.nbytes()) {
+    return TensorDataFromOnnxProto(tp, mapExternalData);
+  }
+  return TensorData::fromSharedViewOf(
+      &(*tp.mutable_raw_data())[0], info.nbytes(), std::move(owner));
+}
 } // namespace
 
 void Tensors::addInit(const TensorId &name,
@@ -326,6 +345,44 @@ void Tensors::addInit(const TensorId &name,
                       TensorType tt,
                       const VariableSettings &vs,
                       const DebugInfo &di) {
+  Tensor *init = addInitTensor(name, *pt, tt, vs, di);
+  init->setTensorData(TensorDataFromOnnxProto(
+      *pt, graph.getIr().getSessionOptions().mapExternalTensorData));
+}
+
+void Tensors::addVarInitFromViewOf(const TensorId &name,
+                                   ONNX_NAMESPACE::TensorProto *pt,
+                                   std::shared_ptr<void> owner,
+                                   const VariableSettings &vs,
+                                   const DebugContext &debugContext) {
+  logging::debug("Adding VarInit Tensor {} as a view of its TensorProto", name);
+  popart::TensorDebugInfo di(debugContext, name, TensorType::Variable);
+  Tensor *init = addInitTensor(name, *pt, TensorType::Variable, vs, di);
+  init->setTensorData(TensorDataFromViewOfOnnxProto(
+      *pt,
+      std::move(owner),
+      graph.getIr().getSessionOptions().mapExternalTensorData));
+}
+
+void Tensors::addConstInitFromViewOf(const TensorId &name,
+                                     ONNX_NAMESPACE::TensorProto *pt,
+                                     std::shared_ptr<void> owner,
+                                     const DebugContext &debugContext) {
+  popart::TensorDebugInfo di(debugContext, name, TensorType::Const);
+  Tensor *init =
+      addInitTensor(name, *pt, TensorType::Const, VariableSettings(), di);
+  insertConstId(name);
+  init->setTensorData(TensorDataFromViewOfOnnxProto(
+      *pt,
+      std::move(owner),
+      graph.getIr().getSessionOptions().mapExternalTensorData));
+}
+
+Tensor *Tensors::addInitTensor(const TensorId &name,
+                               const ONNX_NAMESPACE::TensorProto &tp,
+                               TensorType tt,
+                               const VariableSettings &vs,
+                               const DebugInfo &di) {
   if (tt == TensorType::Variable) {
     insert(name, std::make_unique<Tensor>(name, vs, graph, di));
   } else {
@@ -335,14 +392,14 @@ void Tensors::addInit(const TensorId &name,
   // make sure the info shape match the shape it should have on the graph, and
   // not the total data unit
   Tensor *init    = get(name);
-  TensorInfo info = TensorInfo(*pt);
+  TensorInfo info = TensorInfo(tp);
   init->info      = TensorInfo(
       info.dataType(),
       vs.shapeOnReplica(
           info.shape(),
           graph.getIr().getSessionOptions().getGlobalReplicationFactor(),
           name));
-  init->setTensorData(TensorDataFromOnnxProto(*pt));
+  return init;
 }
 
 void Tensors::addStream(TensorId tenId,
@@ -391,10 +448,7 @@ void addConstInitFromFloat(float value,
     break;
   }
   case DataType::FLOAT16: {
-    std::vector<float> floatData(1, value);
-    std::vector<char> gradStarterData(2);
-    poplar::copyFloatToDeviceHalf(
-        poplar::Target(), floatData.data(), gradStarterData.data(), 1);
+    std::vector<uint16_t> gradStarterData(1, floatToHalf(value));
     tensors.addConstInit(
         valueId, tensorInfo, reinterpret_cast<void *>(gradStarterData.data()));
     break;
@@ -0,0 +1,204 @@
+// Copyright (c) 2022 Graphcore Ltd. All rights reserved.
+#include <cstddef>
+#include <map>
+#include <set>
+#include <string>
+#include <typeinfo>
+#include <utility>
+#include <vector>
+#include <popart/graph.hpp>
+#include <popart/ir.hpp>
+#include <popart/op.hpp>
+#include <popart/op/cast.hpp>
+#include <popart/sessionoptions.hpp>
+#include <popart/tensorindex.hpp>
+#include <popart/transforms/autocast.hpp>
+
+#include "popart/datatype.hpp"
+#include "popart/logging.hpp"
+#include "popart/names.hpp"
+#include "popart/operatoridentifier.hpp"
+#include "popart/operators.hpp"
+#include "popart/scheduler_requireoptimal.hpp"
+#include "popart/tensor.hpp"
+#include "popart/tensorinfo.hpp"
+#include "popart/tensors.hpp"
+#include "popart/transforms/transform.hpp"
+
+namespace popart {
+
+namespace {
+
+enum class Precision { Half, Float, Promote, Original };
+
+bool isFloat(DataType type) {
+  return type == DataType::FLOAT || type == DataType::FLOAT16;
+}
+
+// Must op consume and produce tensors of their original data types?
+bool keepsOriginalTypes(Op *op) {
+  if (op->hasSideEffect() || op->modifies() ||
+      !op->getCalledGraphs().empty()) {
+    return true;
+  }
+  for (auto tensor : op->output->tensors()) {
+    if (tensor->isGraphOutput() || tensor->isAnchored() ||
+        tensor->isModified() ||
+        tensor->id == op->getIr().getFinalLossId()) {
+      return true;
+    }
+  }
+  return false;
+}
+
+class AutocastLists {
+public:
+  explicit AutocastLists(const AutocastSettings &settings)
+      : allow(settings.allowOpTypes.begin(), settings.allowOpTypes.end()),
+        deny(settings.denyOpTypes.begin(), settings.denyOpTypes.end()),
+        promote(settings.promoteOpTypes.begin(),
+                settings.promoteOpTypes.end()) {}
+
+  Precision getPrecision(Op *op) const {
+    if (keepsOriginalTypes(op)) {
+      return Precision::Original;
+    }
+    if (allow.count(op->opid.type)) {
+      return Precision::Half;
+    }
+    if (deny.count(op->opid.type)) {
+      return Precision::Float;
+    }
+    if (promote.count(op->opid.type)) {
+      return Precision::Promote;
+    }
+    return Precision::Original;
+  }
+
+private:
+  std::set<std::string> allow;
+  std::set<std::string> deny;
+  std::set<std::string> promote;
+};
+
+bool isSamePlacement(const Op::Settings &a, const Op::Settings &b) {
+  return a.vgraphId == b.vgraphId && a.pipelineStage == b.pipelineStage &&
+         a.executionPhase == b.executionPhase &&
+         a.batchSerializedPhase == b.batchSerializedPhase &&
+         a.tileSet == b.tileSet;
+}
+
+using CastKey = std::pair<TensorId, DataType>;
+
+// Make op consume the input at index cast to type.
+void castInput(Op *op,
+               InIndex index,
+               DataType type,
+               std::map<CastKey, CastOp *> &casts) {
+  auto &graph = op->getGraph();
+  auto tensor = op->inTensor(index);
+  TensorId castId;
+
+  // Use a FLOAT16 tensor cast to FLOAT directly, rather than casting it back.
+  Op *producer = tensor->hasProducer() ? tensor->getProducer() : nullptr;
+  if (type == DataType::FLOAT16 && producer &&
+      producer->isConvertibleTo<CastOp>() &&
+      producer->inInfo(CastOp::getInIndex()).dataType() == type) {
+    castId = producer->inId(CastOp::getInIndex());
+  } else {
+    auto settings = op->getInSettings(index);
+    auto found    = casts.find({tensor->id, type});
+    if (found != casts.end() &&
+        isSamePlacement(found->second->settings, settings)) {
+      castId = found->second->outId(CastOp::getOutIndex());
+    } else {
+      castId   = graph.getIr().createIntermediateTensorId(tensor->id);
+      auto cast = graph.createConnectedOp<CastOp>(
+          {{CastOp::getInIndex(), tensor->id}},
+          {{CastOp::getOutIndex(), castId}},
+          Onnx::Operators::Cast_9,
+          type,
+          settings);
+      casts[{tensor->id, type}] = cast;
+    }
+  }
+
+  op->disconnectInTensor(index, tensor);
+  op->connectInTensor(index, castId);
+}
+
+} // namespace
+
+std::size_t Autocast::id() { return typeid(Autocast).hash_code(); }
+
+bool Autocast::apply(Graph &graph) const {
+  const AutocastLists lists(
+      graph.getIr().getSessionOptions().autocastSettings);
+
+  std::map<TensorId, DataType> originalTypes;
+  for (auto &id : graph.getTensors().getAllTensorIds()) {
+    originalTypes[id] = graph.getTensors().get(id)->info.dataType();
+  }
+
+  std::map<CastKey, CastOp *> casts;
+  int numChanged = 0;
+  for (auto op : graph.getOpSchedule({}, RequireOptimalSchedule::No)) {
+    // Casts produce the data type they are set to, whatever their input.
+    if (op->isConvertibleTo<CastOp>()) {
+      continue;
+    }
+    const auto precision = lists.getPrecision(op);
+
+    bool anyHalf = false;
+    for (auto tensor : op->input->tensors()) {
+      anyHalf = anyHalf || tensor->info.dataType() == DataType::FLOAT16;
+    }
+
+    bool changed = false;
+    const auto inputs = op->input->tensorMap();
+    for (auto &index_tensor : inputs) {
+      const auto type = index_tensor.second->info.dataType();
+      if (!isFloat(type)) {
+        continue;
+      }
+      auto newType = type;
+      switch (precision) {
+      case Precision::Half:
+        newType = DataType::FLOAT16;
+        break;
+      case Precision::Float:
+        newType = DataType::FLOAT;
+        break;
+      case Precision::Promote:
+        newType = anyHalf ? DataType::FLOAT16 : type;
+        break;
+      case Precision::Original:
+        newType = originalTypes.at(index_tensor.second->id);
+        break;
+      }
+      if (newType != type) {
+        castInput(op, index_tensor.first, newType, casts);
+        changed = true;
+      }
+    }
+
+    if (changed) {
+      op->setup();
+      numChanged++;
+    }
+  }
+
+  logging::transform::debug(
+      "[Autocast] Changed the input data types of {} ops with {} casts in "
+      "graph {}",
+      numChanged,
+      casts.size(),
+      graph.id.str());
+  return true;
+}
+
+namespace {
+bool init = Transform::registerTransform(new Autocast);
+}
+
+} // namespace popart
@@ -5,6 +5,7 @@
 #include <cstdint>
 #include <map>
 #include <memory>
+#include <numeric>
 #include <ostream>
 #include <set>
 #include <string>
@@ -41,10 +42,346 @@
 #include "popart/tensorinfo.hpp"
 #include "popart/transforms/transform.hpp"
 #include "popart/util.hpp"
+#include "popart/vendored/optional.hpp"
 #include "popart/vertex.hpp"
 
 namespace popart {
 
+namespace {
+
+VGraphId getVGraphIdOrZero(const Op *op) {
+  return op->hasVirtualGraphId() ? op->getVirtualGraphId() : 0;
+}
+
+bool isUnrolled(BatchSerializationMethod method) {
+  return method != BatchSerializationMethod::Loop;
+}
+
+bool isDynamic(BatchSerializationMethod method) {
+  return method != BatchSerializationMethod::UnrollStatic;
+}
+
+// The activations of a graph, and how they are serialized, to predict the
+// bytes of live activations for a batch serialization factor and method.
+class ActivationFootprint {
+public:
+  ActivationFootprint(const Graph &graph,
+                      const BatchSerializationSettings &settings) {
+    auto &ir      = graph.getIr();
+    auto schedule = graph.getOpSchedule({}, RequireOptimalSchedule::No);
+    numPositions  = static_cast<int64_t>(schedule.size());
+
+    // The tensors with a batch axis, as propagated by BatchSerialize.
+    std::set<Tensor *> tensorsWithBatch;
+    for (TensorId id : ir.getTensorIds(TensorType::Stream)) {
+      Tensor *t = graph.getTensors().get(id);
+      if (t->getBatchAxis() != -1) {
+        tensorsWithBatch.insert(t);
+        batchSize = std::gcd(batchSize, t->info.shape().at(t->getBatchAxis()));
+      }
+    }
+    for (auto hlt : ir.getHostLoadTensors()) {
+      for (Tensor *t : hlt.second) {
+        if (t->getGraph().id == graph.id && t->getBatchAxis() != -1) {
+          tensorsWithBatch.insert(t);
+        }
+      }
+    }
+
+    std::map<Op *, int64_t> positions;
+    for (int64_t i = 0; i < numPositions; i++) {
+      auto op       = schedule.at(i);
+      positions[op] = i;
+      numOps++;
+      if (op->canShard()) {
+        numShardedOps++;
+      }
+      for (auto t : op->input->tensors()) {
+        if (tensorsWithBatch.find(t) != tensorsWithBatch.end()) {
+          for (auto &index_tensor : op->output->tensorMap()) {
+            if (op->getOutBatchAxis(index_tensor.first) != -1) {
+              tensorsWithBatch.insert(index_tensor.second);
+            }
+          }
+          break;
+        }
+      }
+    }
+
+    auto anchors = ir.getAnchors();
+    const bool backwards =
+        ir.canTrain() &&
+        settings.transformContext == BatchSerializationTransformContext::Fwd;
+
+    for (auto t : graph.getTensors().getAll()) {
+      if (t->tensorType() == TensorType::Variable ||
+          t->tensorType() == TensorType::Const) {
+        continue;
+      }
+
+      Activation activation;
+      activation.bytes = t->info.nbytes();
+      activation.kept  = backwards && t->toLoss == PathToLoss::Yes;
+
+      Op *producer   = t->hasProducer() ? t->getProducer() : nullptr;
+      auto consumers = t->consumers.getOps();
+      if (producer && positions.find(producer) == positions.end()) {
+        continue;
+      }
+      activation.begin = producer ? positions.at(producer) : 0;
+      activation.end   = activation.begin;
+      for (auto consumer : consumers) {
+        activation.end = std::max(activation.end, positions.at(consumer));
+      }
+      bool isAnchor = anchors.find(t->id) != anchors.end();
+      if (activation.kept || isAnchor || consumers.empty()) {
+        activation.end = numPositions - 1;
+      }
+      activation.vgid = 0;
+      if (producer) {
+        activation.vgid = getVGraphIdOrZero(producer);
+      } else if (!consumers.empty()) {
+        activation.vgid = getVGraphIdOrZero(consumers.front());
+      }
+
+      // Consumers on another virtual graph see the concatenated tensor.
+      auto shardsWith = [&](Op *op) {
+        return op->canShard() &&
+               (!settings.concatOnVirtualGraphChange ||
+                getVGraphIdOrZero(op) == activation.vgid);
+      };
+      bool producerShards = producer && producer->canShard();
+      bool allConsumersShard =
+          !isAnchor && !consumers.empty() &&
+          std::all_of(consumers.begin(), consumers.end(), shardsWith);
+      bool anyConsumerShards =
+          std::any_of(consumers.begin(), consumers.end(), shardsWith);
+
+      if (tensorsWithBatch.find(t) == tensorsWithBatch.end()) {
+        activation.kind = Kind::Full;
+      } else if (producerShards && allConsumersShard) {
+        activation.kind = Kind::Serialized;
+      } else if (producerShards) {
+        activation.kind = Kind::Concatenated;
+      } else if (anyConsumerShards) {
+        activation.kind = Kind::Sliced;
+      } else {
+        activation.kind = Kind::Full;
+      }
+      activations.push_back(activation);
+    }
+  }
+
+  // The batch size, or 0 if no input has a batch axis.
+  int64_t getBatchSize() const { return batchSize; }
+
+  // The largest bytes of live activations of any virtual graph.
+  int64_t getPeakBytes(int64_t factor, BatchSerializationMethod method) const {
+    std::map<VGraphId, std::vector<int64_t>> deltas;
+    for (auto &activation : activations) {
+      auto &vgDeltas = deltas[activation.vgid];
+      vgDeltas.resize(numPositions + 1, 0);
+      auto bytes = getBytes(activation, factor, method);
+      vgDeltas.at(activation.begin) += bytes;
+      vgDeltas.at(activation.end + 1) -= bytes;
+    }
+
+    int64_t peak = 0;
+    for (auto &vgid_deltas : deltas) {
+      int64_t live = 0;
+      for (auto delta : vgid_deltas.second) {
+        live += delta;
+        peak = std::max(peak, live);
+      }
+    }
+    return peak;
+  }
+
+  // The bytes copied to and from the slices, which is the overhead of dynamic
+  // slicing and of concatenation.
+  int64_t getCopiedBytes(BatchSerializationMethod method) const {
+    int64_t copied = 0;
+    for (auto &activation : activations) {
+      if (activation.kind == Kind::Concatenated ||
+          (activation.kind == Kind::Sliced && isDynamic(method))) {
+        copied += activation.bytes;
+      }
+    }
+    return copied;
+  }
+
+  // The number of ops after serialization, not counting slices.
+  int64_t getNumOps(int64_t factor, BatchSerializationMethod method) const {
+    return numOps + (isUnrolled(method) ? factor - 1 : 0) * numShardedOps;
+  }
+
+private:
+  enum class Kind { Full, Serialized, Sliced, Concatenated };
+
+  struct Activation {
+    VGraphId vgid;
+    // The positions in the schedule the activation is live from and to.
+    int64_t begin;
+    int64_t end;
+    int64_t bytes;
+    // Live until the end of the schedule, for the backward pass.
+    bool kept;
+    Kind kind;
+  };
+
+  int64_t getBytes(const Activation &activation,
+                   int64_t factor,
+                   BatchSerializationMethod method) const {
+    if (factor < 2 || activation.kind == Kind::Full) {
+      return activation.bytes;
+    }
+    // The bytes of the live slices.
+    auto sliceBytes = activation.kept
+                          ? activation.bytes
+                          : (activation.bytes + factor - 1) / factor;
+    switch (activation.kind) {
+    case Kind::Serialized:
+      return sliceBytes;
+    case Kind::Sliced:
+      return activation.bytes + (isDynamic(method) ? sliceBytes : 0);
+    case Kind::Concatenated:
+      return activation.bytes +
+             (isDynamic(method) ? sliceBytes : activation.bytes);
+    case Kind::Full:
+    default:
+      return activation.bytes;
+    }
+  }
+
+  std::vector<Activation> activations;
+  int64_t numPositions  = 0;
+  int64_t batchSize     = 0;
+  int64_t numOps        = 0;
+  int64_t numShardedOps = 0;
+};
+
+struct Choice {
+  int64_t factor;
+  BatchSerializationMethod method;
+  int64_t peak;
+  int64_t copied;
+  int64_t numOps;
+};
+
+std::string toString(BatchSerializationMethod method) {
+  switch (method) {
+  case BatchSerializationMethod::UnrollDynamic:
+    return "UnrollDynamic";
+  case BatchSerializationMethod::UnrollStatic:
+    return "UnrollStatic";
+  case BatchSerializationMethod::Loop:
+    return "Loop";
+  case BatchSerializationMethod::N:
+  default:
+    throw internal_error("Unsupported BatchSerializationMethod");
+  }
+}
+
+} // namespace
+
+BatchSerializationSettings
+BatchSerialize::chooseSettings(const Graph &graph) {
+  auto &ir      = graph.getIr();
+  auto settings = ir.getSessionOptions().batchSerializationSettings;
+  auto budget   = settings.memoryBudget;
+
+  if (settings.factor > 1) {
+    throw error("[BatchSerialize] Both BatchSerializationSettings::factor ({}) "
+                "and BatchSerializationSettings::memoryBudget ({}) are set. "
+                "Set the factor, or the memory budget to choose the factor "
+                "for, not both.",
+                settings.factor,
+                budget);
+  }
+
+  ActivationFootprint footprint(graph, settings);
+  auto batchSize = footprint.getBatchSize();
+  auto original  = footprint.getPeakBytes(1, settings.method);
+
+  settings.factor = 0;
+  if (original <= budget || batchSize < 2) {
+    logging::transform::info(
+        "[BatchSerialize] Not serializing the batch: the predicted peak "
+        "activation memory of {} bytes per IPU {} the budget of {} bytes.",
+        original,
+        original <= budget ? "fits in" : "exceeds, but can not be split for,",
+        budget);
+    return settings;
+  }
+
+  std::vector<BatchSerializationMethod> methods{
+      BatchSerializationMethod::UnrollDynamic,
+      BatchSerializationMethod::UnrollStatic};
+  // Loop can not serialize the forward pass only when training.
+  if (!ir.canTrain() ||
+      settings.transformContext != BatchSerializationTransformContext::Fwd) {
+    methods.push_back(BatchSerializationMethod::Loop);
+  }
+
+  nonstd::optional<Choice> best;
+  nonstd::optional<Choice> smallest;
+  for (int64_t factor = 2; factor <= batchSize && !best; factor++) {
+    if (batchSize % factor != 0) {
+      continue;
+    }
+    for (auto method : methods) {
+      Choice choice{factor,
+                    method,
+                    footprint.getPeakBytes(factor, method),
+                    footprint.getCopiedBytes(method),
+                    footprint.getNumOps(factor, method)};
+      logging::transform::debug(
+          "[BatchSerialize] Factor {} with {}: predicted peak activation "
+          "memory {} bytes per IPU, {} bytes copied to and from slices, {} "
+          "ops.",
+          choice.factor,
+          toString(choice.method),
+          choice.peak,
+          choice.copied,
+          choice.numOps);
+
+      if (!smallest || choice.peak <= smallest->peak) {
+        smallest = choice;
+      }
+      if (choice.peak <= budget &&
+          (!best || choice.copied < best->copied ||
+           (choice.copied == best->copied && choice.numOps < best->numOps))) {
+        best = choice;
+      }
+    }
+  }
+
+  if (!best) {
+    logging::transform::warn(
+        "[BatchSerialize] No batch serialization factor fits the predicted "
+        "peak activation memory in the budget of {} bytes per IPU.",
+        budget);
+    best = smallest;
+  }
+
+  logging::transform::info(
+      "[BatchSerialize] Chose batch serialization factor {} with {}: the "
+      "predicted peak activation memory is {} bytes per IPU, from {} bytes "
+      "without serializing, for a budget of {} bytes. {} bytes are copied to "
+      "and from slices, and the serialized graph has {} ops.",
+      best->factor,
+      toString(best->method),
+      best->peak,
+      original,
+      budget,
+      best->copied,
+      best->numOps);
+
+  settings.factor = static_cast<int>(best->factor);
+  settings.method = best->method;
+  return settings;
+}
+
 std::size_t BatchSerialize::id(int pass) {
   return typeid(BatchSerialize).hash_code() + pass;
 }
@@ -9,7 +9,6 @@
 #include <typeinfo>
 #include <utility>
 #include <vector>
-#include <poplar/Target.hpp>
 #include <popart/graph.hpp>
 #include <popart/ir.hpp>
 #include <popart/op/accumulate.hpp>
@@ -32,6 +31,7 @@
 #include "popart/clipnormsettings.hpp"
 #include "popart/datatype.hpp"
 #include "popart/error.hpp"
+#include "popart/half.hpp"
 #include "popart/logging.hpp"
 #include "popart/names.hpp"
 #include "popart/op.hpp"
@@ -373,9 +373,7 @@ Tensor *createClipNorm(float maxNorm, popart::DataType dataType, Graph &graph) {
   if (dataType == DataType::FLOAT) {
     graph.getTensors().addConstInit(clipByNormId, info, floatData.data());
   } else {
-    std::vector<char> halfData(2);
-    poplar::copyFloatToDeviceHalf(
-        poplar::Target(), floatData.data(), halfData.data(), 1);
+    std::vector<uint16_t> halfData(1, floatToHalf(maxNorm));
     graph.getTensors().addConstInit(clipByNormId, info, halfData.data());
   }
 
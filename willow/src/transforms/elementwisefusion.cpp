@@ -0,0 +1,284 @@
+// Copyright (c) 2022 Graphcore Ltd. All rights reserved.
+#include <algorithm>
+#include <cstddef>
+#include <map>
+#include <set>
+#include <string>
+#include <typeindex>
+#include <typeinfo>
+#include <vector>
+#include <popart/graph.hpp>
+#include <popart/ir.hpp>
+#include <popart/op.hpp>
+#include <popart/op/abs.hpp>
+#include <popart/op/add.hpp>
+#include <popart/op/cast.hpp>
+#include <popart/op/div.hpp>
+#include <popart/op/exp.hpp>
+#include <popart/op/fusedelementwise.hpp>
+#include <popart/op/log.hpp>
+#include <popart/op/mul.hpp>
+#include <popart/op/negate.hpp>
+#include <popart/op/pow.hpp>
+#include <popart/op/reciprocal.hpp>
+#include <popart/op/relu.hpp>
+#include <popart/op/scale.hpp>
+#include <popart/op/sigmoid.hpp>
+#include <popart/op/sqrt.hpp>
+#include <popart/op/subtract.hpp>
+#include <popart/op/tanh.hpp>
+#include <popart/tensorindex.hpp>
+#include <popart/topocons.hpp>
+#include <popart/transforms/elementwisefusion.hpp>
+
+#include "popart/datatype.hpp"
+#include "popart/graphcoreoperators.hpp"
+#include "popart/logging.hpp"
+#include "popart/names.hpp"
+#include "popart/scheduler_requireoptimal.hpp"
+#include "popart/tensor.hpp"
+#include "popart/tensors.hpp"
+#include "popart/transforms/transform.hpp"
+
+namespace popart {
+
+namespace {
+
+using ExprType = FusedElementwiseExprType;
+
+// The ops that are one expression of their inputs. Only these exact types are
+// fused, so that ops which derive from them, such as grad ops, are not.
+const std::map<std::type_index, ExprType> &simpleExprTypes() {
+  static const std::map<std::type_index, ExprType> types{
+      {typeid(AbsOp), ExprType::Abs},
+      {typeid(ExpOp), ExprType::Exp},
+      {typeid(LogOp), ExprType::Log},
+      {typeid(NegateOp), ExprType::Neg},
+      {typeid(ReciprocalOp), ExprType::Reciprocal},
+      {typeid(SigmoidOp), ExprType::Sigmoid},
+      {typeid(SqrtOp), ExprType::Sqrt},
+      {typeid(TanhOp), ExprType::Tanh},
+      {typeid(AddOp), ExprType::Add},
+      {typeid(DivOp), ExprType::Div},
+      {typeid(MulOp), ExprType::Mul},
+      {typeid(PowOp), ExprType::Pow},
+      {typeid(SubtractOp), ExprType::Sub}};
+  return types;
+}
+
+bool isFloat(DataType type) {
+  return type == DataType::FLOAT || type == DataType::FLOAT16;
+}
+
+bool canFuse(Op *op) {
+  const std::type_index type = typeid(*op);
+  if (simpleExprTypes().count(type) == 0 && type != typeid(ReluOp) &&
+      type != typeid(ScaleOp) && type != typeid(CastOp)) {
+    return false;
+  }
+  if (op->output->n() != 1 || !isFloat(op->outInfo(0).dataType())) {
+    return false;
+  }
+  for (auto tensor : op->input->tensors()) {
+    if (!isFloat(tensor->info.dataType())) {
+      return false;
+    }
+  }
+  return !op->getGraph().topoCons->hasConstraint(op);
+}
+
+// Ops are only fused with ops that are placed and scheduled alike.
+bool haveSameSettings(const Op *a, const Op *b) {
+  const auto &x = a->settings;
+  const auto &y = b->settings;
+  return x.vgraphId == y.vgraphId && x.pipelineStage == y.pipelineStage &&
+         x.executionPhase == y.executionPhase &&
+         x.batchSerializedPhase == y.batchSerializedPhase &&
+         x.recomputeType == y.recomputeType &&
+         x.executionContext == y.executionContext &&
+         x.schedulePriority == y.schedulePriority && x.tileSet == y.tileSet &&
+         x.stochasticRoundingMethod == y.stochasticRoundingMethod &&
+         x.optimizerOp == y.optimizerOp &&
+         x.gradientClippingOp == y.gradientClippingOp;
+}
+
+// Can the producer of `tensor` be in the same group as its consumer, which is
+// in the group of `root`?
+bool canFuseProducer(Tensor *tensor, Op *root) {
+  if (!tensor->hasProducer() || tensor->consumers.getOps().size() != 1 ||
+      tensor->isAnchored() || tensor->isGraphOutput() ||
+      tensor->id == root->getIr().getFinalLossId()) {
+    return false;
+  }
+  auto producer = tensor->getProducer();
+  return canFuse(producer) && haveSameSettings(producer, root) &&
+         producer->outShape(0) == root->outShape(0);
+}
+
+// The group of ops with output `root`, in schedule order.
+std::vector<Op *> getGroup(Op *root,
+                           const std::set<Op *> &fused,
+                           const std::map<Op *, size_t> &schedulePositions) {
+  std::set<Op *> members{root};
+  std::vector<Op *> pending{root};
+  while (!pending.empty()) {
+    auto op = pending.back();
+    pending.pop_back();
+    for (auto tensor : op->input->tensors()) {
+      if (!canFuseProducer(tensor, root)) {
+        continue;
+      }
+      auto producer = tensor->getProducer();
+      // A tensor may be consumed more than once by its consumer.
+      if (fused.count(producer) == 0 && members.insert(producer).second) {
+        pending.push_back(producer);
+      }
+    }
+  }
+
+  std::vector<Op *> group(members.begin(), members.end());
+  std::sort(group.begin(), group.end(), [&](Op *a, Op *b) {
+    return schedulePositions.at(a) < schedulePositions.at(b);
+  });
+  return group;
+}
+
+int appendExpr(std::vector<FusedElementwiseExpr> &exprs,
+               ExprType type,
+               const std::vector<int> &args) {
+  FusedElementwiseExpr expr;
+  expr.type = type;
+  expr.args = args;
+  exprs.push_back(expr);
+  return exprs.size() - 1;
+}
+
+int appendConst(std::vector<FusedElementwiseExpr> &exprs, float value) {
+  FusedElementwiseExpr expr;
+  expr.type  = ExprType::Const;
+  expr.value = value;
+  exprs.push_back(expr);
+  return exprs.size() - 1;
+}
+
+// Append the expression of `op` of the nodes `args` to `exprs`, and return the
+// index of its output node.
+int appendOpExprs(const Op *op,
+                  const std::vector<int> &args,
+                  std::vector<FusedElementwiseExpr> &exprs) {
+  const std::type_index type = typeid(*op);
+  if (type == typeid(ReluOp)) {
+    return appendExpr(
+        exprs, ExprType::Max, {args.at(0), appendConst(exprs, 0.0f)});
+  }
+  if (type == typeid(ScaleOp)) {
+    const float scale = static_cast<const ScaleOp *>(op)->getScaleFactor();
+    return appendExpr(
+        exprs, ExprType::Mul, {args.at(0), appendConst(exprs, scale)});
+  }
+  if (type == typeid(CastOp)) {
+    const int index = appendExpr(exprs, ExprType::Cast, {args.at(0)});
+    exprs.back().dataType = op->outInfo(CastOp::getOutIndex()).dataType();
+    return index;
+  }
+  return appendExpr(exprs, simpleExprTypes().at(type), args);
+}
+
+// Replace the ops of `group` with a FusedElementwiseOp.
+void fuse(Graph &graph, const std::vector<Op *> &group) {
+  auto root            = group.back();
+  const TensorId outId = root->outId(0);
+  Op::Settings settings(root->settings);
+
+  std::vector<FusedElementwiseExpr> exprs;
+  std::map<TensorId, int> nodes;
+  std::vector<TensorId> inputs;
+  for (auto op : group) {
+    std::vector<int> args;
+    for (auto &index_id : op->input->tensorIdMap()) {
+      auto found = nodes.find(index_id.second);
+      if (found == nodes.end()) {
+        FusedElementwiseExpr input;
+        input.type    = ExprType::Input;
+        input.inIndex = inputs.size();
+        inputs.push_back(index_id.second);
+        exprs.push_back(input);
+        found = nodes.emplace(index_id.second, exprs.size() - 1).first;
+      }
+      args.push_back(found->second);
+    }
+    nodes[op->outId(0)] = appendOpExprs(op, args, exprs);
+  }
+
+  for (auto op : group) {
+    const TensorId opOutId = op->outId(0);
+    op->disconnectAllInputs();
+    op->disconnectAllOutputs();
+    graph.eraseOp(op->id);
+    if (opOutId != outId) {
+      graph.getTensors().remove(opOutId);
+    }
+  }
+
+  auto fusedOp = graph.createOp<FusedElementwiseOp>(
+      Onnx::CustomOperators::FusedElementwise, exprs, settings);
+  for (size_t i = 0; i < inputs.size(); ++i) {
+    fusedOp->connectInTensor(i, inputs[i]);
+  }
+  fusedOp->connectOutTensor(FusedElementwiseOp::getOutIndex(), outId);
+  fusedOp->setup();
+
+  logging::transform::trace("[ElementwiseFusion] Fused {} ops into {}: {}",
+                            group.size(),
+                            fusedOp->debugName(),
+                            fusedOp->getExprString());
+}
+
+} // namespace
+
+std::size_t ElementwiseFusion::id() {
+  return typeid(ElementwiseFusion).hash_code();
+}
+
+bool ElementwiseFusion::apply(Graph &graph) const {
+  const auto schedule = graph.getOpSchedule({}, RequireOptimalSchedule::No);
+  std::map<Op *, size_t> schedulePositions;
+  for (size_t i = 0; i < schedule.size(); ++i) {
+    schedulePositions[schedule[i]] = i;
+  }
+
+  // Grow the groups from their outputs, which are after all their other ops
+  // in the schedule.
+  std::set<Op *> fused;
+  std::vector<std::vector<Op *>> groups;
+  for (auto it = schedule.rbegin(); it != schedule.rend(); ++it) {
+    auto root = *it;
+    if (fused.count(root) != 0 || !canFuse(root)) {
+      continue;
+    }
+    auto group = getGroup(root, fused, schedulePositions);
+    if (group.size() > 1) {
+      fused.insert(group.begin(), group.end());
+      groups.push_back(group);
+    }
+  }
+
+  for (const auto &group : groups) {
+    fuse(graph, group);
+  }
+
+  // Each elementwise op is lowered to a compute set of its own.
+  logging::transform::debug("[ElementwiseFusion] Fused {} ops of graph {} "
+                            "into {} ops, saving {} compute sets",
+                            fused.size(),
+                            graph.id.str(),
+                            groups.size(),
+                            fused.size() - groups.size());
+  return true;
+}
+
+namespace {
+bool init = Transform::registerTransform(new ElementwiseFusion);
+}
+
+} // namespace popart
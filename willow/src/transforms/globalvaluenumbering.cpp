@@ -0,0 +1,261 @@
+// Copyright (c) 2022 Graphcore Ltd. All rights reserved.
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <typeinfo>
+#include <utility>
+#include <vector>
+#include <popart/error.hpp>
+#include <popart/graph.hpp>
+#include <popart/ir.hpp>
+#include <popart/op.hpp>
+#include <popart/op/call.hpp>
+#include <popart/op/ipucopy.hpp>
+#include <popart/tensorindex.hpp>
+#include <popart/topocons.hpp>
+#include <popart/transforms/globalvaluenumbering.hpp>
+
+#include "popart/graphid.hpp"
+#include "popart/logging.hpp"
+#include "popart/names.hpp"
+#include "popart/scheduler_requireoptimal.hpp"
+#include "popart/tensor.hpp"
+#include "popart/tensordata.hpp"
+#include "popart/tensorinfo.hpp"
+#include "popart/tensors.hpp"
+#include "popart/transforms/transform.hpp"
+#include "popart/vendored/any.hpp" // IWYU pragma: keep
+
+namespace popart {
+
+namespace {
+
+using ValueNumber = int64_t;
+
+// Do the ops of graph, and of the graphs they call, have no side effects and
+// no randomness? Modified graph inputs are seen by the calling op.
+bool isPure(const Graph &graph, std::map<GraphId, bool> &pureGraphs) {
+  auto found = pureGraphs.find(graph.id);
+  if (found != pureGraphs.end()) {
+    return found->second;
+  }
+  // Recursive calls are not pure.
+  pureGraphs[graph.id] = false;
+
+  bool pure = true;
+  for (auto &id_op : graph.getOps()) {
+    auto op = id_op.second.get();
+    if (op->hasSideEffect() || op->requiresRandomSeed()) {
+      pure = false;
+      break;
+    }
+    for (auto calledGraph : op->getCalledGraphs()) {
+      pure = pure && isPure(*calledGraph, pureGraphs);
+    }
+  }
+  pureGraphs[graph.id] = pure;
+  return pure;
+}
+
+// Can the value of tensor change during the schedule, through this or any
+// alias of it?
+bool isMutable(const Tensor *tensor) {
+  return tensor->isModified() || tensor->isAliased();
+}
+
+// Are the outputs of op a function of its inputs and attributes only?
+bool canNumber(Op *op, std::map<GraphId, bool> &pureGraphs) {
+  if (op->hasSideEffect() || op->requiresRandomSeed() ||
+      !op->isOutlineable() || op->modifies() || op->doesAlias() ||
+      op->isConvertibleTo<IpuCopyOp>()) {
+    return false;
+  }
+  for (auto tensor : op->input->tensors()) {
+    if (isMutable(tensor)) {
+      return false;
+    }
+  }
+  for (auto tensor : op->output->tensors()) {
+    if (isMutable(tensor)) {
+      return false;
+    }
+  }
+  for (auto calledGraph : op->getCalledGraphs()) {
+    if (!isPure(*calledGraph, pureGraphs)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// The key of the value computed by op, from its type, attributes, placement
+// and the value numbers of its inputs.
+std::string getKey(const Op *op,
+                   const std::map<TensorId, ValueNumber> &numbers) {
+  std::map<std::string, popart::any> attrs;
+  for (auto &index_id : op->input->tensorIdMap()) {
+    attrs["gvnInput" + std::to_string(index_id.first)] =
+        numbers.at(index_id.second);
+  }
+  attrs["gvnPipelineStage"] = static_cast<int64_t>(
+      op->hasPipelineStage() ? op->getPipelineStage() : -1);
+  attrs["gvnExecutionPhase"] = static_cast<int64_t>(
+      op->hasExecutionPhase() ? op->getExecutionPhase() : -1);
+  attrs["gvnBatchSerializedPhase"] = static_cast<int64_t>(
+      op->hasBatchSerializedPhase() ? op->getBatchSerializedPhase() : -1);
+  attrs["gvnExecutionContext"] =
+      static_cast<int64_t>(op->settings.executionContext);
+  return op->getSubgraphEquivId(attrs);
+}
+
+// The key of a constant, from its info and data.
+std::string getConstKey(const Tensor *tensor) {
+  auto data = tensor->tensorData();
+  std::stringstream ss;
+  ss << tensor->info << ":";
+  ss.write(static_cast<const char *>(data->data()), data->size());
+  return ss.str();
+}
+
+// Can op, which computes the same values as an earlier op, be removed?
+bool canRemove(Op *op) {
+  if (op->getGraph().topoCons->hasConstraint(op)) {
+    return false;
+  }
+  for (auto tensor : op->output->tensors()) {
+    if (tensor->isAnchored() || tensor->isGraphOutput() ||
+        tensor->id == op->getIr().getFinalLossId()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void reconnectConsumers(Tensor *from, Tensor *to) {
+  for (auto consumer : from->consumers.getOps()) {
+    auto indices = consumer->input->indices(from);
+    for (auto i : indices) {
+      if (auto copyOp = dynamic_cast<IpuCopyOp *>(consumer)) {
+        auto source = copyOp->getSourceIpu(from->id);
+        copyOp->disconnectInTensor(i, from);
+        copyOp->connectInTensor(i, to->id, source);
+      } else {
+        consumer->disconnectInTensor(i, from);
+        consumer->connectInTensor(i, to->id);
+      }
+    }
+  }
+}
+
+// Replace the outputs of duplicate with those of original, and remove it.
+void merge(Op *duplicate, Op *original) {
+  logging::transform::trace("[GlobalValueNumbering] Merging {} into {}",
+                            duplicate->debugName(),
+                            original->debugName());
+  auto &graph  = duplicate->getGraph();
+  auto outputs = duplicate->output->tensorMap();
+  for (auto &index_tensor : outputs) {
+    reconnectConsumers(index_tensor.second,
+                       original->outTensor(index_tensor.first));
+  }
+  duplicate->disconnectAllInputs();
+  duplicate->disconnectAllOutputs();
+  graph.eraseOp(duplicate->id);
+  for (auto &index_tensor : outputs) {
+    if (index_tensor.second->consumers.getTotal() > 0) {
+      throw internal_error("All the consumers of tensor {} should have had a "
+                           "replacement input connected already.",
+                           index_tensor.second->str());
+    }
+    graph.getTensors().remove(index_tensor.second->id);
+  }
+}
+
+} // namespace
+
+std::size_t GlobalValueNumbering::id() {
+  return typeid(GlobalValueNumbering).hash_code();
+}
+
+bool GlobalValueNumbering::apply(Graph &graph) const {
+  std::map<TensorId, ValueNumber> numbers;
+  ValueNumber nextNumber = 0;
+
+  std::map<std::string, ValueNumber> constNumbers;
+  for (auto &id : graph.getTensors().getNoProducerIds()) {
+    auto tensor = graph.getTensors().get(id);
+    if (tensor->tensorType() == TensorType::Const && tensor->hasTensorData()) {
+      auto found = constNumbers.emplace(getConstKey(tensor), nextNumber);
+      if (found.second) {
+        ++nextNumber;
+      }
+      numbers[id] = found.first->second;
+    } else {
+      numbers[id] = nextNumber++;
+    }
+  }
+
+  std::map<GraphId, bool> pureGraphs;
+  std::map<std::string, Op *> originals;
+  std::vector<std::pair<Op *, Op *>> duplicates;
+  const auto schedule = graph.getOpSchedule({}, RequireOptimalSchedule::No);
+  for (auto op : schedule) {
+    if (!canNumber(op, pureGraphs)) {
+      for (auto &index_id : op->output->tensorIdMap()) {
+        numbers[index_id.second] = nextNumber++;
+      }
+      continue;
+    }
+
+    auto found = originals.emplace(getKey(op, numbers), op);
+    if (found.second) {
+      for (auto &index_id : op->output->tensorIdMap()) {
+        numbers[index_id.second] = nextNumber++;
+      }
+      // A CallOp output which is an input of the called graph has the value
+      // of the corresponding CallOp input.
+      if (auto call = dynamic_cast<CallOp *>(op)) {
+        auto &callee = call->getCalledGraph();
+        for (auto &index_id : op->output->tensorIdMap()) {
+          const auto calleeOutId =
+              callee.getOutputId(call->opOutToSubgraphOutIndex(index_id.first));
+          if (callee.hasInputId(calleeOutId)) {
+            const auto opIn =
+                call->subgraphInToOpInIndex(callee.getInputIndex(calleeOutId));
+            numbers[index_id.second] = numbers.at(op->inId(opIn));
+          }
+        }
+      }
+      continue;
+    }
+
+    // The outputs of a duplicate have the values of those of the original
+    // whether or not it can be removed.
+    auto original = found.first->second;
+    for (auto &index_id : op->output->tensorIdMap()) {
+      numbers[index_id.second] = numbers.at(original->outId(index_id.first));
+    }
+    if (canRemove(op)) {
+      duplicates.push_back({op, original});
+    }
+  }
+
+  for (auto &duplicate_original : duplicates) {
+    merge(duplicate_original.first, duplicate_original.second);
+  }
+
+  logging::transform::debug("[GlobalValueNumbering] Removed {} duplicate ops "
+                            "of graph {}",
+                            duplicates.size(),
+                            graph.id.str());
+  return true;
+}
+
+namespace {
+bool init = Transform::registerTransform(new GlobalValueNumbering);
+}
+
+} // namespace popart
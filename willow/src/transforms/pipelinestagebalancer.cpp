@@ -0,0 +1,317 @@
+// Copyright (c) 2022 Graphcore Ltd. All rights reserved.
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <set>
+#include <typeinfo>
+#include <vector>
+#include <poplar/Target.hpp>
+#include <popart/devicemanager.hpp>
+#include <popart/error.hpp>
+#include <popart/graph.hpp>
+#include <popart/ir.hpp>
+#include <popart/op.hpp>
+#include <popart/opcost.hpp>
+#include <popart/optimizer.hpp>
+#include <popart/sessionoptions.hpp>
+#include <popart/tensor.hpp>
+#include <popart/tensorindex.hpp>
+#include <popart/transforms/pipelinestagebalancer.hpp>
+
+#include "popart/logging.hpp"
+#include "popart/names.hpp"
+#include "popart/region.hpp"
+#include "popart/scheduler_requireoptimal.hpp"
+#include "popart/tensordebuginfo.hpp"
+#include "popart/tensorinfo.hpp"
+#include "popart/tensors.hpp"
+#include "popart/transforms/transform.hpp"
+
+namespace popart {
+
+namespace {
+
+// The floating point operations an IPU does in the time it takes to copy one
+// byte to another IPU.
+constexpr double flopsPerCopiedByte = 512.0;
+
+constexpr double infinity = std::numeric_limits<double>::infinity();
+
+bool isWeight(const Tensor *tensor) {
+  return tensor->tensorType() == TensorType::Variable ||
+         tensor->tensorType() == TensorType::Const;
+}
+
+// Does the output of op at index alias one of its inputs?
+bool isAlias(const Op *op, OutIndex index) {
+  for (auto &in : op->input->tensorMap()) {
+    for (auto &region : op->aliases(in.first, index)) {
+      if (!region.isEmpty()) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+// The number of bytes of each weight, including its gradient and optimizer
+// state when training. Without an optimizer type, two state tensors are
+// counted, as for Adam.
+double getWeightFactor(const Ir &ir,
+                       const nonstd::optional<OptimizerType> &optimizerType) {
+  if (!ir.canTrain()) {
+    return 1.0;
+  }
+  double factor = 2.0;
+  if (ir.getSessionOptions().enableGradientAccumulation) {
+    factor += 1.0;
+  }
+  factor += optimizerType == OptimizerType::SGD ? 1.0 : 2.0;
+  return factor;
+}
+
+// The cost and memory of the stages made of contiguous ranges [begin, end) of
+// the schedule, from prefix sums over the ops.
+class StageModel {
+public:
+  StageModel(const Ir &ir,
+             const std::vector<Op *> &schedule,
+             const nonstd::optional<OptimizerType> &optimizerType)
+      : training(ir.canTrain()), costs(schedule.size() + 1, 0.0),
+        weights(schedule.size() + 1, 0.0),
+        activations(schedule.size() + 1, 0.0),
+        copiedBytes(schedule.size() + 1, 0.0) {
+    const auto weightFactor = getWeightFactor(ir, optimizerType);
+
+    std::map<Op *, int64_t> positions;
+    for (int64_t i = 0; i < schedule.size(); i++) {
+      positions[schedule.at(i)] = i;
+    }
+
+    std::vector<double> copiedDeltas(schedule.size() + 1, 0.0);
+    std::set<Tensor *> seenWeights;
+    for (int64_t i = 0; i < schedule.size(); i++) {
+      auto op = schedule.at(i);
+
+      double weightBytes = 0.0;
+      for (auto tensor : op->input->tensors()) {
+        if (isWeight(tensor) && seenWeights.insert(tensor).second) {
+          weightBytes += static_cast<double>(tensor->info.nbytes());
+        }
+      }
+
+      double activationBytes = 0.0;
+      for (auto &index_tensor : op->output->tensorMap()) {
+        auto tensor = index_tensor.second;
+        if (isAlias(op, index_tensor.first)) {
+          continue;
+        }
+        auto bytes = static_cast<double>(tensor->info.nbytes());
+        activationBytes += bytes;
+
+        // The tensor is copied to each stage between this op and its last
+        // consumer.
+        int64_t last = i;
+        for (auto consumer : tensor->consumers.getOps()) {
+          auto found = positions.find(consumer);
+          if (found != positions.end()) {
+            last = std::max(last, found->second);
+          }
+        }
+        copiedDeltas.at(i) += bytes;
+        copiedDeltas.at(last) -= bytes;
+      }
+
+      costs.at(i + 1)       = costs.at(i) + estimateOpCost(op).getCost();
+      weights.at(i + 1)     = weights.at(i) + weightFactor * weightBytes;
+      activations.at(i + 1) = activations.at(i) + activationBytes;
+    }
+
+    // copiedBytes[end] is the bytes that cross from position end - 1 to end.
+    for (int64_t i = 0; i < schedule.size(); i++) {
+      copiedBytes.at(i + 1) = copiedBytes.at(i) + copiedDeltas.at(i);
+    }
+  }
+
+  int64_t size() const { return static_cast<int64_t>(costs.size()) - 1; }
+
+  // The backward pass costs about twice as much as the forward pass, and
+  // copies the gradients of the tensors that cross between stages back.
+  double getCost(int64_t begin, int64_t end) const {
+    double cost = (costs.at(end) - costs.at(begin)) * (training ? 3 : 1);
+    if (end < size()) {
+      cost += getCopiedBytes(end) * flopsPerCopiedByte * (training ? 2 : 1);
+    }
+    return cost;
+  }
+
+  double getMemory(int64_t begin, int64_t end, int64_t stashDepth) const {
+    return weights.at(end) - weights.at(begin) +
+           stashDepth * (activations.at(end) - activations.at(begin));
+  }
+
+  double getCopiedBytes(int64_t end) const { return copiedBytes.at(end); }
+
+private:
+  bool training;
+  std::vector<double> costs;
+  std::vector<double> weights;
+  std::vector<double> activations;
+  std::vector<double> copiedBytes;
+};
+
+// The number of times the activations of a stage are stashed for the backward
+// pass. With pipelining, a stage has a batch in flight for each stage after it,
+// both ways, and its own.
+int64_t getStashDepth(const Ir &ir, int64_t stage, int64_t numStages) {
+  if (!ir.canTrain()) {
+    return 0;
+  }
+  if (!ir.getSessionOptions().enablePipelining) {
+    return 1;
+  }
+  return 2 * (numStages - 1 - stage) + 1;
+}
+
+// Split the schedule into numStages contiguous stages, minimising the cost of
+// the most expensive stage, with no stage using more than memoryLimit bytes.
+// Returns the first position of each stage, or nothing if no split fits.
+std::vector<int64_t> balance(const Ir &ir,
+                             const StageModel &model,
+                             int64_t numStages,
+                             double memoryLimit) {
+  const auto n = model.size();
+
+  // best[k][end] is the smallest cost of the most expensive of stages 0 to k,
+  // where stage k ends before position end, and begins[k][end] is the first
+  // position of stage k for it.
+  std::vector<std::vector<double>> best(numStages,
+                                        std::vector<double>(n + 1, infinity));
+  std::vector<std::vector<int64_t>> begins(numStages,
+                                           std::vector<int64_t>(n + 1, -1));
+
+  // The stages after the first have between minOps and maxOps ops, which
+  // includes the stages of an even split.
+  const int64_t evenOps = n / numStages;
+  const int64_t minOps =
+      std::max<int64_t>(1, evenOps - PipelineStageBalancer::maxStageOps);
+  const int64_t maxOps = evenOps + 1 + PipelineStageBalancer::maxStageOps;
+
+  for (int64_t k = 0; k < numStages; k++) {
+    const auto stashDepth = getStashDepth(ir, k, numStages);
+    for (int64_t end = k + 1; end <= n - (numStages - 1 - k); end++) {
+      // The cost and memory of stage k only grow as it begins earlier. The
+      // first stage begins at the start of the schedule.
+      const auto last  = k == 0 ? 0 : end - minOps;
+      const auto first = k == 0 ? 0 : std::max<int64_t>(k, end - maxOps);
+      for (int64_t begin = last; begin >= first; begin--) {
+        const auto cost = model.getCost(begin, end);
+        if (cost >= best.at(k).at(end) ||
+            model.getMemory(begin, end, stashDepth) > memoryLimit) {
+          break;
+        }
+        const auto previous = k == 0 ? 0.0 : best.at(k - 1).at(begin);
+        const auto candidate = std::max(previous, cost);
+        if (candidate < best.at(k).at(end)) {
+          best.at(k).at(end)   = candidate;
+          begins.at(k).at(end) = begin;
+        }
+      }
+    }
+  }
+
+  if (best.at(numStages - 1).at(n) == infinity) {
+    return {};
+  }
+
+  std::vector<int64_t> stageBegins(numStages);
+  for (int64_t k = numStages - 1, end = n; k >= 0; k--) {
+    stageBegins.at(k) = begins.at(k).at(end);
+    end               = stageBegins.at(k);
+  }
+  return stageBegins;
+}
+
+} // namespace
+
+std::size_t PipelineStageBalancer::id() {
+  return typeid(PipelineStageBalancer).hash_code();
+}
+
+bool PipelineStageBalancer::apply(Graph &graph) const {
+  auto &ir   = graph.getIr();
+  auto &opts = ir.getSessionOptions();
+  auto replicationDivisor =
+      opts.enableReplicatedGraphs ? opts.replicatedGraphCount : 1;
+  const int64_t numStages =
+      ir.getDeviceInfo()->getNumIpus() / replicationDivisor;
+
+  auto schedule = graph.getOpSchedule({}, RequireOptimalSchedule::Yes);
+  if (schedule.empty()) {
+    return true;
+  }
+  if (static_cast<int64_t>(schedule.size()) < numStages) {
+    throw error("[PipelineStageBalancer] Cannot split {} ops into {} stages.",
+                schedule.size(),
+                numStages);
+  }
+
+  const auto &target = ir.getDeviceInfo()->getTarget();
+  const double bytesPerIpu =
+      static_cast<double>(target.getBytesPerTile()) *
+      static_cast<double>(ir.getDeviceInfo()->getTilesPerIPU());
+  const double memoryLimit =
+      bytesPerIpu * opts.autoVirtualGraphSettings.maxMemoryProportion;
+
+  StageModel model(ir, schedule, optimizerType);
+  auto stageBegins = balance(ir, model, numStages, memoryLimit);
+  if (stageBegins.empty()) {
+    logging::transform::warn(
+        "[PipelineStageBalancer] No split of the model into {} stages fits in "
+        "{} bytes per IPU. Balancing the stages without a memory limit.",
+        numStages,
+        memoryLimit);
+    stageBegins = balance(ir, model, numStages, infinity);
+  }
+
+  double maxCost = 0.0;
+  for (int64_t k = 0; k < numStages; k++) {
+    const auto begin = stageBegins.at(k);
+    const auto end =
+        k + 1 < numStages ? stageBegins.at(k + 1) : model.size();
+    for (int64_t i = begin; i < end; i++) {
+      schedule.at(i)->setVirtualGraphId(k);
+      if (opts.enablePipelining) {
+        schedule.at(i)->setPipelineStage(k);
+      }
+    }
+
+    const auto cost = model.getCost(begin, end);
+    maxCost         = std::max(maxCost, cost);
+    logging::transform::info(
+        "[PipelineStageBalancer] Stage {}: {} ops, from {} to {}, predicted "
+        "cost {} FLOPs, memory {} bytes, {} bytes copied to the next stage",
+        k,
+        end - begin,
+        schedule.at(begin)->debugName(),
+        schedule.at(end - 1)->debugName(),
+        cost,
+        model.getMemory(begin, end, getStashDepth(ir, k, numStages)),
+        end < model.size() ? model.getCopiedBytes(end) : 0.0);
+  }
+  logging::transform::info(
+      "[PipelineStageBalancer] Predicted cost of the slowest stage {} FLOPs, "
+      "of all stages {} FLOPs",
+      maxCost,
+      model.getCost(0, model.size()));
+
+  return true;
+}
+
+namespace {
+bool init = Transform::registerTransform(new PipelineStageBalancer);
+}
+
+} // namespace popart
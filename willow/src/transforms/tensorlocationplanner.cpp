@@ -0,0 +1,404 @@
+// Copyright (c) 2022 Graphcore Ltd. All rights reserved.
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <typeinfo>
+#include <vector>
+#include <popart/error.hpp>
+#include <popart/graph.hpp>
+#include <popart/ir.hpp>
+#include <popart/memoryestimate.hpp>
+#include <popart/op.hpp>
+#include <popart/op/varupdate.hpp>
+#include <popart/sessionoptions.hpp>
+#include <popart/tensor.hpp>
+#include <popart/tensors.hpp>
+#include <popart/transforms/tensorlocationplanner.hpp>
+
+#include "popart/commgroup.hpp"
+#include "popart/logging.hpp"
+#include "popart/names.hpp"
+#include "popart/tensordebuginfo.hpp"
+#include "popart/tensorinfo.hpp"
+#include "popart/tensorlocation.hpp"
+#include "popart/transforms/transform.hpp"
+#include "popart/variablesettings.hpp"
+
+namespace popart {
+
+namespace {
+
+// A location of a tensor other than on chip, with the bytes of tile memory it
+// saves at the peak, and the seconds of streaming it adds per weight update.
+struct Placement {
+  TensorLocation location;
+  int64_t savedBytes;
+  double seconds;
+};
+
+// Is tensor updated by a VarUpdateOp?
+bool isUpdated(Tensor *tensor) {
+  for (auto consumer : tensor->consumers.getOps()) {
+    if (consumer->isConvertibleTo<VarUpdateOp>()) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// A tensor to plan the location of, and where it can be placed.
+struct Candidate {
+  Tensor *tensor;
+  VGraphId vgid;
+  std::vector<Placement> placements;
+};
+
+// The placements of the tensors to plan, and the peak bytes of each virtual
+// graph with all of them on chip.
+class PlacementModel {
+public:
+  PlacementModel(Graph &graph, const MemoryEstimate &estimate)
+      : opts(graph.getIr().getSessionOptions()),
+        settings(opts.tensorLocationPlannerSettings),
+        peakBytes(estimate.peakBytesPerVirtualGraph) {
+    replicas = opts.enableReplicatedGraphs ? opts.replicatedGraphCount : 1;
+    microBatches =
+        opts.enableGradientAccumulation ? opts.accumulationFactor : 1;
+    const bool training = graph.getIr().canTrain();
+
+    for (auto &vgid_contributors : estimate.topContributors) {
+      for (auto &contributor : vgid_contributors.second) {
+        peakTensors[vgid_contributors.first].insert(contributor);
+      }
+    }
+
+    for (auto tensor : graph.getTensors().getOfType(TensorType::Variable)) {
+      if (isSetByUser(tensor) || tensor->isOptimizerTensor()) {
+        continue;
+      }
+      auto vgid      = getVirtualGraphId(tensor);
+      auto liveBytes = getLiveBytesAtPeak(tensor, vgid);
+      if (liveBytes == 0) {
+        continue;
+      }
+      auto bytes = tensor->info.nbytes();
+
+      bool updated    = training && isUpdated(tensor);
+      int64_t repeats = tensor->isAccumulatorTensor() ? microBatches : 1;
+      int64_t streams = updated ? 2 : 1;
+
+      // Sharding is applied through the weight update.
+      bool shardable = updated && replicas > 1 &&
+                       tensor->getVariableSettings()
+                               .getSharedVariableDomain()
+                               .type != CommGroupType::None;
+
+      // The loaded or gathered copy of the tensor is on chip while it is
+      // used, which saves nothing if it is used at the peak.
+      auto copyBytes = isUsedAtPeak(tensor, vgid) ? bytes : 0;
+
+      Candidate candidate{tensor, vgid, {}};
+      candidate.placements.push_back(
+          {TensorLocation(TensorStorage::OffChip),
+           std::max<int64_t>(liveBytes - copyBytes, 0),
+           repeats * getRemoteSeconds(streams * bytes)});
+      if (shardable) {
+        auto shardBytes = (bytes + replicas - 1) / replicas;
+        auto gathered   = getGatherSeconds(bytes - shardBytes);
+        candidate.placements.push_back(
+            {TensorLocation(TensorStorage::OnChip,
+                            ReplicatedTensorSharding::On),
+             std::max<int64_t>(liveBytes - shardBytes - copyBytes, 0),
+             repeats * gathered});
+        candidate.placements.push_back(
+            {TensorLocation(TensorStorage::OffChip,
+                            ReplicatedTensorSharding::On),
+             std::max<int64_t>(liveBytes - copyBytes, 0),
+             repeats * (getRemoteSeconds(streams * shardBytes) + gathered)});
+      }
+      candidates.push_back(candidate);
+    }
+
+    if (opts.virtualGraphMode == VirtualGraphMode::ExecutionPhases &&
+        opts.executionPhaseSettings.phases > 1) {
+      addActivations(graph);
+    }
+  }
+
+  const std::vector<Candidate> &getCandidates() const { return candidates; }
+
+  const std::map<VGraphId, int64_t> &getPeakBytes() const { return peakBytes; }
+
+private:
+  // The location of the tensor is set by the user in the overrides, by the
+  // builder attribute of its producer, or by a location other than the
+  // default in the settings of its category.
+  bool isSetByUser(Tensor *tensor) const {
+    if (opts.tensorLocationSettingsOverride.count(tensor->id)) {
+      return true;
+    }
+    if (tensor->hasProducer() &&
+        tensor->getProducer()->settings.tensorLocation) {
+      return true;
+    }
+    return getCategorySettings(tensor).location != TensorLocation();
+  }
+
+  // The settings of the category of the tensor, as applied by
+  // StreamingMemory.
+  const TensorLocationSettings &getCategorySettings(Tensor *tensor) const {
+    if (tensor->tensorType() != TensorType::Variable) {
+      return opts.activationTensorLocationSettings;
+    }
+    if (tensor->isAccumulatorTensor()) {
+      return opts.accumulatorTensorLocationSettings;
+    }
+    if (tensor->isOptimizerStateTensor()) {
+      return opts.optimizerStateTensorLocationSettings;
+    }
+    return opts.weightTensorLocationSettings;
+  }
+
+  VGraphId getVirtualGraphId(Tensor *tensor) const {
+    return std::max<VGraphId>(tensor->getVirtualGraphIdUnsafe(), 0);
+  }
+
+  // The bytes the tensor adds to the peak of its virtual graph, or 0 if it is
+  // not live at the peak.
+  int64_t getLiveBytesAtPeak(Tensor *tensor, VGraphId vgid) const {
+    auto found = peakTensors.find(vgid);
+    if (found == peakTensors.end()) {
+      return 0;
+    }
+    auto contributor = found->second.find(tensor->id);
+    return contributor == found->second.end() ? 0 : contributor->second;
+  }
+
+  // Is an op that consumes the tensor running at the peak of its virtual
+  // graph? This is approximated by an output of the op being live at the
+  // peak.
+  bool isUsedAtPeak(Tensor *tensor, VGraphId vgid) const {
+    for (auto consumer : tensor->consumers.getOps()) {
+      for (auto output : consumer->output->tensors()) {
+        if (getLiveBytesAtPeak(output, vgid) > 0) {
+          return true;
+        }
+      }
+    }
+    return false;
+  }
+
+  double getRemoteSeconds(int64_t bytes) const {
+    return static_cast<double>(bytes) / settings.remoteBandwidth;
+  }
+
+  double getGatherSeconds(int64_t bytes) const {
+    return static_cast<double>(bytes) / settings.replicatedBandwidth;
+  }
+
+  // The activations that stay on chip for more than one execution phase, and
+  // are live at the peak of their virtual graph.
+  void addActivations(Graph &graph) {
+    for (auto tensor : graph.getTensors().getOfType(TensorType::ActGrad)) {
+      if (!tensor->hasProducer() || isSetByUser(tensor)) {
+        continue;
+      }
+      auto producer = tensor->getProducer();
+      if (!producer->hasExecutionPhase() ||
+          producer->settings.recomputeType == RecomputeType::Recompute) {
+        continue;
+      }
+      ExecutionPhase lastPhase = producer->getExecutionPhase();
+      for (auto consumer : tensor->consumers.getOps()) {
+        if (consumer->hasExecutionPhase()) {
+          lastPhase = std::max(lastPhase, consumer->getExecutionPhase());
+        }
+      }
+      if (lastPhase - producer->getExecutionPhase() < 2) {
+        continue;
+      }
+
+      auto vgid      = getVirtualGraphId(tensor);
+      auto liveBytes = getLiveBytesAtPeak(tensor, vgid);
+      if (liveBytes == 0) {
+        continue;
+      }
+      // Stored after it is produced, and loaded before it is consumed.
+      auto bytes     = tensor->info.nbytes();
+      auto copyBytes = isUsedAtPeak(tensor, vgid) ? bytes : 0;
+      Candidate candidate{tensor, vgid, {}};
+      candidate.placements.push_back(
+          {TensorLocation(TensorStorage::OffChip),
+           std::max<int64_t>(liveBytes - copyBytes, 0),
+           microBatches * getRemoteSeconds(2 * bytes)});
+      candidates.push_back(candidate);
+    }
+  }
+
+  const SessionOptions &opts;
+  const TensorLocationPlannerSettings &settings;
+  int64_t replicas;
+  int64_t microBatches;
+  std::map<VGraphId, std::map<TensorId, int64_t>> peakTensors;
+  std::vector<Candidate> candidates;
+  std::map<VGraphId, int64_t> peakBytes;
+};
+
+// The index of the placement chosen for each candidate, or -1 for on chip.
+// While a virtual graph exceeds the budget, the placement with the fewest
+// seconds per byte saved that saves more than the current placement of its
+// tensor is chosen.
+std::vector<int> plan(const PlacementModel &model, int64_t budget) {
+  auto &candidates = model.getCandidates();
+
+  struct Option {
+    std::size_t candidate;
+    int placement;
+    double secondsPerByte;
+  };
+  std::vector<Option> options;
+  for (std::size_t i = 0; i < candidates.size(); i++) {
+    auto &placements = candidates.at(i).placements;
+    for (std::size_t j = 0; j < placements.size(); j++) {
+      auto &placement = placements.at(j);
+      if (placement.savedBytes > 0) {
+        options.push_back(
+            {i,
+             static_cast<int>(j),
+             placement.seconds / static_cast<double>(placement.savedBytes)});
+      }
+    }
+  }
+  std::stable_sort(options.begin(), options.end(), [](auto &a, auto &b) {
+    return a.secondsPerByte < b.secondsPerByte;
+  });
+
+  std::map<VGraphId, int64_t> excessBytes;
+  for (auto &vgid_bytes : model.getPeakBytes()) {
+    excessBytes[vgid_bytes.first] = vgid_bytes.second - budget;
+  }
+
+  std::vector<int> chosen(candidates.size(), -1);
+  for (auto &option : options) {
+    auto &candidate = candidates.at(option.candidate);
+    auto &excess    = excessBytes[candidate.vgid];
+    if (excess <= 0) {
+      continue;
+    }
+    auto &current = chosen.at(option.candidate);
+    int64_t saved =
+        current < 0 ? 0 : candidate.placements.at(current).savedBytes;
+    auto &placement = candidate.placements.at(option.placement);
+    if (placement.savedBytes > saved) {
+      excess -= placement.savedBytes - saved;
+      current = option.placement;
+    }
+  }
+  return chosen;
+}
+
+} // namespace
+
+std::size_t TensorLocationPlanner::id() {
+  return typeid(TensorLocationPlanner).hash_code();
+}
+
+bool TensorLocationPlanner::apply(Graph &graph) const {
+  auto &ir       = graph.getIr();
+  auto estimate  = estimateMemory(ir, std::numeric_limits<unsigned>::max());
+  auto &settings = ir.getSessionOptions().tensorLocationPlannerSettings;
+  auto budget =
+      settings.memoryBudget > 0 ? settings.memoryBudget : estimate.bytesPerIpu;
+  if (budget <= 0) {
+    throw error("[TensorLocationPlanner] No memory budget to plan the tensor "
+                "locations for. Set "
+                "SessionOptions::tensorLocationPlannerSettings.memoryBudget.");
+  }
+
+  PlacementModel model(graph, estimate);
+  auto chosen      = plan(model, budget);
+  auto &candidates = model.getCandidates();
+
+  struct Report {
+    int64_t savedBytes = 0;
+    double seconds     = 0.0;
+    int numOffChip     = 0;
+    int numSharded     = 0;
+  };
+  std::map<VGraphId, Report> reports;
+
+  auto &overrides = ir.getSessionOptions().tensorLocationSettingsOverride;
+  for (std::size_t i = 0; i < candidates.size(); i++) {
+    auto &candidate = candidates.at(i);
+    auto &report    = reports[candidate.vgid];
+    if (chosen.at(i) < 0) {
+      continue;
+    }
+
+    auto &placement                 = candidate.placements.at(chosen.at(i));
+    overrides[candidate.tensor->id] = placement.location;
+    report.savedBytes += placement.savedBytes;
+    report.seconds += placement.seconds;
+    if (placement.location.isRemote()) {
+      report.numOffChip++;
+    }
+    if (placement.location.replicatedTensorSharding ==
+        ReplicatedTensorSharding::On) {
+      report.numSharded++;
+    }
+    logging::transform::debug(
+        "[TensorLocationPlanner] {} ({} bytes): {}, saving {} bytes, adding {} "
+        "us of streaming",
+        candidate.tensor->id,
+        candidate.tensor->info.nbytes(),
+        placement.location,
+        placement.savedBytes,
+        placement.seconds * 1e6);
+  }
+
+  int64_t totalSavedBytes = 0;
+  double totalSeconds     = 0.0;
+  for (auto &vgid_bytes : model.getPeakBytes()) {
+    auto vgid    = vgid_bytes.first;
+    auto &report = reports[vgid];
+    auto peak    = vgid_bytes.second - report.savedBytes;
+    logging::transform::info(
+        "[TensorLocationPlanner] Virtual graph {}: {} tensors off chip, {} "
+        "sharded. Predicted peak memory {} bytes, from {} bytes, for a budget "
+        "of {} bytes. Adds {} us of streaming per weight update.",
+        vgid,
+        report.numOffChip,
+        report.numSharded,
+        peak,
+        vgid_bytes.second,
+        budget,
+        report.seconds * 1e6);
+    if (peak > budget) {
+      logging::transform::warn(
+          "[TensorLocationPlanner] The predicted peak memory of virtual graph "
+          "{} is {} bytes, over the budget of {} bytes, even with every "
+          "planned tensor placed to save the most memory.",
+          vgid,
+          peak,
+          budget);
+    }
+    totalSavedBytes += report.savedBytes;
+    totalSeconds += report.seconds;
+  }
+  logging::transform::info(
+      "[TensorLocationPlanner] Planned {} tensors. Predicted memory saved {} "
+      "bytes, streaming time added {} us per weight update.",
+      candidates.size(),
+      totalSavedBytes,
+      totalSeconds * 1e6);
+
+  return true;
+}
+
+namespace {
+bool init = Transform::registerTransform(new TensorLocationPlanner);
+}
+
+} // namespace popart
@@ -0,0 +1,436 @@
+// Copyright (c) 2022 Graphcore Ltd. All rights reserved.
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <set>
+#include <typeindex>
+#include <typeinfo>
+#include <vector>
+#include <popart/error.hpp>
+#include <popart/graph.hpp>
+#include <popart/ir.hpp>
+#include <popart/op.hpp>
+#include <popart/op/abs.hpp>
+#include <popart/op/add.hpp>
+#include <popart/op/cast.hpp>
+#include <popart/op/concat.hpp>
+#include <popart/op/div.hpp>
+#include <popart/op/exp.hpp>
+#include <popart/op/log.hpp>
+#include <popart/op/matmul.hpp>
+#include <popart/op/mul.hpp>
+#include <popart/op/negate.hpp>
+#include <popart/op/pow.hpp>
+#include <popart/op/reciprocal.hpp>
+#include <popart/op/reduce.hpp>
+#include <popart/op/relu.hpp>
+#include <popart/op/reshape.hpp>
+#include <popart/op/scale.hpp>
+#include <popart/op/sigmoid.hpp>
+#include <popart/op/sqrt.hpp>
+#include <popart/op/subtract.hpp>
+#include <popart/op/tanh.hpp>
+#include <popart/op/transpose.hpp>
+#include <popart/tensorindex.hpp>
+#include <popart/topocons.hpp>
+#include <popart/transforms/transposesinking.hpp>
+
+#include "popart/logging.hpp"
+#include "popart/names.hpp"
+#include "popart/scheduler_requireoptimal.hpp"
+#include "popart/tensor.hpp"
+#include "popart/tensorinfo.hpp"
+#include "popart/tensors.hpp"
+#include "popart/transforms/transform.hpp"
+
+namespace popart {
+
+namespace {
+
+// The ops whose outputs are computed element by element, independently of
+// the layout of their inputs. Only these exact types are moved past, so that
+// ops which derive from them, such as grad ops, are not.
+bool isUnary(const Op *op) {
+  static const std::set<std::type_index> types{typeid(AbsOp),
+                                               typeid(CastOp),
+                                               typeid(ExpOp),
+                                               typeid(LogOp),
+                                               typeid(NegateOp),
+                                               typeid(ReciprocalOp),
+                                               typeid(ReluOp),
+                                               typeid(ScaleOp),
+                                               typeid(SigmoidOp),
+                                               typeid(SqrtOp),
+                                               typeid(TanhOp)};
+  return types.count(typeid(*op)) != 0 && op->input->n() == 1;
+}
+
+bool isBinary(const Op *op) {
+  static const std::set<std::type_index> types{typeid(AddOp),
+                                               typeid(DivOp),
+                                               typeid(MulOp),
+                                               typeid(PowOp),
+                                               typeid(SubtractOp)};
+  return types.count(typeid(*op)) != 0;
+}
+
+bool isTranspose(const Op *op) { return typeid(*op) == typeid(TransposeOp); }
+
+bool isReshape(const Op *op) { return typeid(*op) == typeid(ReshapeOp); }
+
+bool isView(const Op *op) { return isTranspose(op) || isReshape(op); }
+
+// Do view0 and view1 change the layout of their inputs in the same way?
+bool isSameView(Op *view0, Op *view1) {
+  if (isTranspose(view0) && isTranspose(view1)) {
+    return dynamic_cast<TransposeOp *>(view0)->getPerm() ==
+           dynamic_cast<TransposeOp *>(view1)->getPerm();
+  }
+  if (isReshape(view0) && isReshape(view1)) {
+    return view0->inShape(ReshapeOp::getInIndex()) ==
+               view1->inShape(ReshapeOp::getInIndex()) &&
+           view0->outShape(ReshapeOp::getOutIndex()) ==
+               view1->outShape(ReshapeOp::getOutIndex());
+  }
+  return false;
+}
+
+bool isSamePlacement(const Op *a, const Op *b) {
+  return a->getOptionalVGraphId() == b->getOptionalVGraphId() &&
+         a->getOptionalPipelineStage() == b->getOptionalPipelineStage() &&
+         a->getOptionalExecutionPhase() == b->getOptionalExecutionPhase() &&
+         a->getOptionalBatchSerializedPhase() ==
+             b->getOptionalBatchSerializedPhase() &&
+         a->settings.executionContext == b->settings.executionContext &&
+         a->settings.recomputeType == b->settings.recomputeType &&
+         a->settings.tileSet == b->settings.tileSet;
+}
+
+bool hasTopoCons(Op *op) { return op->getGraph().topoCons->hasConstraint(op); }
+
+// The op that consumes the output of view, if the output has no other use and
+// can be replaced, and nullptr otherwise.
+Op *getOnlyConsumer(Op *view) {
+  auto out       = view->outTensor(0);
+  auto consumers = out->consumers.getOps();
+  if (consumers.size() != 1 || out->isGraphOutput() || out->isAnchored() ||
+      hasTopoCons(view) || hasTopoCons(consumers.front()) ||
+      !isSamePlacement(view, consumers.front())) {
+    return nullptr;
+  }
+  return consumers.front();
+}
+
+// The view of a type like `like` that is moved past consumer with it, or
+// nullptr if there is none.
+Op *getPartner(Tensor *tensor, Op *like, Op *consumer) {
+  if (!tensor->hasProducer()) {
+    return nullptr;
+  }
+  auto producer = tensor->getProducer();
+  if (producer == like ||
+      (isSameView(producer, like) && getOnlyConsumer(producer) == consumer)) {
+    return producer;
+  }
+  return nullptr;
+}
+
+// Can tensor be broadcast against a tensor of the given rank, before or after
+// changing its layout, without changing the result?
+bool isSingleton(const Tensor *tensor, int rank) {
+  const auto &shape = tensor->info.shape();
+  return shape.size() <= rank &&
+         std::all_of(shape.begin(), shape.end(), [](int64_t dim) {
+           return dim == 1;
+         });
+}
+
+void removeOpAndOutputs(Op *op) {
+  auto &graph  = op->getGraph();
+  auto outputs = op->output->tensors();
+  op->disconnectAllInputs();
+  op->disconnectAllOutputs();
+  graph.eraseOp(op->id);
+  for (auto out : outputs) {
+    if (out->consumers.getTotal() > 0) {
+      throw internal_error("All the consumers of tensor {} should have had a "
+                           "replacement input connected already.",
+                           out->str());
+    }
+    graph.getTensors().remove(out->id);
+  }
+}
+
+// Make consumer consume the inputs of views instead of their outputs.
+void bypassViews(const std::vector<Op *> &views, Op *consumer) {
+  for (auto view : views) {
+    auto in      = view->inTensor(0);
+    auto out     = view->outTensor(0);
+    auto indices = consumer->input->indices(out);
+    for (auto i : indices) {
+      consumer->disconnectInTensor(i, out);
+      consumer->connectInTensor(i, in->id);
+    }
+  }
+}
+
+void setViewAttribute(Op *view, const Shape &attribute) {
+  if (auto transpose = dynamic_cast<TransposeOp *>(view)) {
+    transpose->setPerm(attribute);
+  } else {
+    dynamic_cast<ReshapeOp *>(view)->setOutShape(attribute);
+  }
+}
+
+// Replace
+//   in -- views[i] -- consumer -- out
+// in which the consumer has been made to consume the inputs of the views by
+// bypassViews, with
+//   in -- consumer -- views[0] -- out
+// where attribute is the permutation or shape of the moved view.
+Op *moveToOutput(const std::vector<Op *> &views,
+                 Op *consumer,
+                 const Shape &attribute) {
+  auto &graph = consumer->getGraph();
+  auto view   = views.front();
+  for (auto other : views) {
+    if (other != view) {
+      removeOpAndOutputs(other);
+    }
+  }
+  auto viewOut = view->outTensor(0);
+  view->disconnectAllInputs();
+  view->disconnectAllOutputs();
+  graph.getTensors().remove(viewOut->id);
+
+  auto out         = consumer->outTensor(0);
+  const auto outId = out->id;
+  const auto newId = graph.getIr().createIntermediateTensorId(outId);
+  consumer->disconnectOutTensor(out);
+  consumer->createAndConnectOutTensor(0, newId);
+  consumer->setup();
+
+  view->connectInTensor(0, newId);
+  view->connectOutTensor(0, outId);
+  setViewAttribute(view, attribute);
+  view->setup();
+  return view;
+}
+
+bool isLastTwoSwapped(const Shape &perm) {
+  const int64_t rank = perm.size();
+  if (rank < 2 || perm[rank - 2] != rank - 1 || perm[rank - 1] != rank - 2) {
+    return false;
+  }
+  for (int64_t i = 0; i < rank - 2; i++) {
+    if (perm[i] != i) {
+      return false;
+    }
+  }
+  return true;
+}
+
+Shape swapLastTwo(int64_t rank) {
+  Shape perm(rank);
+  for (int64_t i = 0; i < rank; i++) {
+    perm[i] = i;
+  }
+  std::swap(perm[rank - 2], perm[rank - 1]);
+  return perm;
+}
+
+// Views into the inputs of a binary op, which are moved to its output.
+std::vector<Op *> getBinaryViews(Op *view, Op *binary) {
+  std::vector<Op *> views{view};
+  const auto rank = std::min(view->inInfo(0).rank(), view->outInfo(0).rank());
+  for (auto tensor : binary->input->tensors()) {
+    auto partner = getPartner(tensor, view, binary);
+    if (partner) {
+      if (partner != view) {
+        views.push_back(partner);
+      }
+    } else if (!isSingleton(tensor, rank)) {
+      return {};
+    }
+  }
+  return views;
+}
+
+// Move view past its consumer, or combine it with it. Returns the op to move
+// further, or nullptr if nothing was done.
+Op *sink(Op *view) {
+  auto consumer = getOnlyConsumer(view);
+  if (!consumer) {
+    return nullptr;
+  }
+  const auto outShape = consumer->output->n() == 1
+                            ? consumer->outShape(0)
+                            : Shape{};
+
+  // Combine the view with the view consuming it.
+  if (typeid(*consumer) == typeid(*view)) {
+    Shape attribute = outShape;
+    if (isTranspose(view)) {
+      const auto &first  = dynamic_cast<TransposeOp *>(view)->getPerm();
+      const auto &second = dynamic_cast<TransposeOp *>(consumer)->getPerm();
+      attribute.clear();
+      for (auto dim : second) {
+        attribute.push_back(first.at(dim));
+      }
+    }
+    bypassViews({view}, consumer);
+    removeOpAndOutputs(view);
+    setViewAttribute(consumer, attribute);
+    consumer->setup();
+    return consumer;
+  }
+
+  if (consumer->output->n() != 1 || consumer->hasSideEffect()) {
+    return nullptr;
+  }
+  const auto attribute =
+      isTranspose(view) ? dynamic_cast<TransposeOp *>(view)->getPerm()
+                        : outShape;
+
+  if (isUnary(consumer)) {
+    bypassViews({view}, consumer);
+    return moveToOutput({view}, consumer, attribute);
+  }
+
+  if (isBinary(consumer)) {
+    auto views = getBinaryViews(view, consumer);
+    if (views.empty()) {
+      return nullptr;
+    }
+    bypassViews(views, consumer);
+    return moveToOutput(views, consumer, attribute);
+  }
+
+  if (!isTranspose(view)) {
+    return nullptr;
+  }
+  const auto &perm = dynamic_cast<TransposeOp *>(view)->getPerm();
+
+  if (auto reduce = dynamic_cast<ReduceOp *>(consumer)) {
+    // Reduce the input over the axes that are moved to the reduced axes. If
+    // the reduced axes are removed, permute the remaining axes as the
+    // transpose does, in their order in the input.
+    std::vector<int64_t> axes;
+    for (auto axis : reduce->getAxes()) {
+      axes.push_back(perm.at(axis));
+    }
+    Shape newPerm;
+    if (reduce->getKeepDims()) {
+      newPerm = perm;
+    } else {
+      for (int64_t i = 0; i < perm.size(); i++) {
+        if (std::count(reduce->getAxes().begin(), reduce->getAxes().end(), i)) {
+          continue;
+        }
+        int64_t position = 0;
+        for (int64_t j = 0; j < perm[i]; j++) {
+          position += std::count(axes.begin(), axes.end(), j) == 0;
+        }
+        newPerm.push_back(position);
+      }
+    }
+    reduce->setAxes(axes);
+    bypassViews({view}, reduce);
+    return moveToOutput({view}, reduce, newPerm);
+  }
+
+  if (typeid(*consumer) == typeid(ConcatOp)) {
+    auto concat = dynamic_cast<ConcatOp *>(consumer);
+    std::vector<Op *> views;
+    for (auto tensor : concat->input->tensors()) {
+      auto partner = getPartner(tensor, view, concat);
+      if (!partner) {
+        return nullptr;
+      }
+      if (std::find(views.begin(), views.end(), partner) == views.end()) {
+        views.push_back(partner);
+      }
+    }
+    concat->setAxis(perm.at(concat->getAxis()));
+    bypassViews(views, concat);
+    return moveToOutput(views, concat, perm);
+  }
+
+  if (typeid(*consumer) == typeid(MatMulOp)) {
+    // transpose(a) x transpose(b) = transpose(b x a), where the transposes
+    // swap the last two axes.
+    auto matmul = dynamic_cast<MatMulOp *>(consumer);
+    if (matmul->getPhase() != MatMulOp::Phase::Fwd ||
+        matmul->getSerialiseSettings().mode !=
+            MatMulOp::SerialiseSettings::Mode::None) {
+      return nullptr;
+    }
+    std::vector<Op *> views;
+    for (auto index : {MatMulOp::getLhsInIndex(), MatMulOp::getRhsInIndex()}) {
+      auto tensor = matmul->inTensor(index);
+      if (!tensor->hasProducer() || !isTranspose(tensor->getProducer())) {
+        return nullptr;
+      }
+      auto transpose = dynamic_cast<TransposeOp *>(tensor->getProducer());
+      if (!isLastTwoSwapped(transpose->getPerm()) ||
+          (transpose != view && getOnlyConsumer(transpose) != matmul)) {
+        return nullptr;
+      }
+      if (std::find(views.begin(), views.end(), transpose) == views.end()) {
+        views.push_back(transpose);
+      }
+    }
+    bypassViews(views, matmul);
+    auto lhs = matmul->inTensor(MatMulOp::getLhsInIndex());
+    auto rhs = matmul->inTensor(MatMulOp::getRhsInIndex());
+    matmul->disconnectAllInputs();
+    matmul->connectInTensor(MatMulOp::getLhsInIndex(), rhs->id);
+    matmul->connectInTensor(MatMulOp::getRhsInIndex(), lhs->id);
+    return moveToOutput(views, matmul, swapLastTwo(outShape.size()));
+  }
+
+  return nullptr;
+}
+
+} // namespace
+
+std::size_t TransposeSinking::id() {
+  return typeid(TransposeSinking).hash_code();
+}
+
+bool TransposeSinking::apply(Graph &graph) const {
+  std::deque<OpId> toSink;
+  for (auto op : graph.getOpSchedule({}, RequireOptimalSchedule::No)) {
+    if (isView(op)) {
+      toSink.push_back(op->id);
+    }
+  }
+
+  int numMoves = 0;
+  while (!toSink.empty()) {
+    auto found = graph.getOps().find(toSink.front());
+    toSink.pop_front();
+    // The view has been removed by combining it with another.
+    if (found == graph.getOps().end()) {
+      continue;
+    }
+    auto moved = sink(found->second.get());
+    if (moved) {
+      toSink.push_front(moved->id);
+      numMoves++;
+    }
+  }
+
+  logging::transform::debug(
+      "[TransposeSinking] Moved transposes and reshapes {} times in graph {}",
+      numMoves,
+      graph.id.str());
+  return true;
+}
+
+namespace {
+bool init = Transform::registerTransform(new TransposeSinking);
+}
+
+} // namespace popart
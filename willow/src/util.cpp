@@ -438,6 +438,28 @@ cast(DataType src, DataType dst, const void *data, size_t nbytes) {
         err();
       }
       break;
+    case DataType::FLOAT:
+      switch (dst) {
+      case DataType::FLOAT16:
+        floatToHalf(static_cast<const float *>(srcData),
+                    static_cast<uint16_t *>(dstData),
+                    nelms);
+        break;
+      default:
+        err();
+      }
+      break;
+    case DataType::FLOAT16:
+      switch (dst) {
+      case DataType::FLOAT:
+        halfToFloat(static_cast<const uint16_t *>(srcData),
+                    static_cast<float *>(dstData),
+                    nelms);
+        break;
+      default:
+        err();
+      }
+      break;
     default:
       err();
     }